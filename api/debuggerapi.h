@@ -276,6 +276,11 @@ namespace BinaryNinjaDebuggerAPI {
 	{
 		std::uint32_t m_pid {};
 		std::string m_processName {};
+		// These are left empty, or 0, when the platform does not report them
+		std::uint32_t m_parentPid {};
+		std::string m_user {};
+		std::string m_arch {};
+		std::string m_commandLine {};
 
 		DebugProcess() {}
 
@@ -358,6 +363,62 @@ namespace BinaryNinjaDebuggerAPI {
 		uint64_t offset;
 		uint64_t address;
 		bool enabled;
+		// Empty for an unconditional breakpoint
+		std::string condition;
+		uint64_t hitCount;
+		uint64_t skipCount;
+		bool isTracepoint;
+		std::string traceCaptures;
+	};
+
+
+	struct DebugBreakpointChange
+	{
+		std::string module;
+		uint64_t offset;
+		uint64_t address;
+		bool added;
+	};
+
+
+	typedef BNDebugWatchpointType DebugWatchpointType;
+
+
+	struct DebugWatchpoint
+	{
+		uint64_t address;
+		size_t size;
+		DebugWatchpointType type;
+		bool record;
+		uint64_t hitCount;
+	};
+
+
+	struct DebugWatchpointHit
+	{
+		uint64_t address;
+		uint64_t pc;
+		uint32_t threadId;
+		uint64_t timestamp;
+		uint64_t oldValue;
+		uint64_t newValue;
+	};
+
+
+	struct DebugTraceValue
+	{
+		bool valid;
+		uint64_t value;
+		std::vector<uint8_t> data;
+	};
+
+
+	struct DebugTraceRecord
+	{
+		uint64_t address;
+		uint32_t threadId;
+		uint64_t timestamp;
+		std::vector<DebugTraceValue> values;
 	};
 
 
@@ -469,9 +530,17 @@ namespace BinaryNinjaDebuggerAPI {
 		uint64_t StackPointer();
 
 		DataBuffer ReadMemory(std::uintptr_t address, std::size_t size);
+		// Copies the memory into dest, up to the first byte that cannot be read. Returns the number of bytes copied.
+		size_t ReadMemory(std::uintptr_t address, void* dest, std::size_t size);
+		// Reads every range into dest, one after another. bytesRead receives the number of bytes read from each range,
+		// and the total is returned.
+		size_t ReadMemoryRanges(const std::vector<std::pair<uint64_t, size_t>>& ranges, void* dest,
+			std::vector<size_t>& bytesRead);
 		bool WriteMemory(std::uintptr_t address, const DataBuffer& buffer);
 
 		std::vector<DebugProcess> GetProcessList();
+		// Like GetProcessList(), but never creates the adapter, so it can be called off the main thread
+		std::vector<DebugProcess> GetAdapterProcessList();
 
 		std::vector<DebugThread> GetThreads();
 		DebugThread GetActiveThread();
@@ -481,7 +550,9 @@ namespace BinaryNinjaDebuggerAPI {
 		bool ResumeThread(std::uint32_t tid);
 
 		std::vector<DebugModule> GetModules();
-		std::vector<DebugRegister> GetRegisters();
+		// The hints are computed by reading target memory, which can be slow on remote targets. Pass withHints = false
+		// and use GetAddressInformation() on the values that are actually needed instead.
+		std::vector<DebugRegister> GetRegisters(bool withHints = true);
 		uint64_t GetRegisterValue(const std::string& name);
 		bool SetRegisterValue(const std::string& name, uint64_t value);
 
@@ -554,12 +625,41 @@ namespace BinaryNinjaDebuggerAPI {
 		void SetPIDAttach(int32_t pid);
 
 		std::vector<DebugBreakpoint> GetBreakpoints();
+		uint64_t GetBreakpointVersion();
+		// Retrieves the breakpoints added or removed since the version, and the current version. Returns false if the
+		// whole list must be retrieved again with GetBreakpoints().
+		bool GetBreakpointChanges(uint64_t version, uint64_t& newVersion, std::vector<DebugBreakpointChange>& changes);
 		void DeleteBreakpoint(uint64_t address);
 		void DeleteBreakpoint(const ModuleNameAndOffset& breakpoint);
 		void AddBreakpoint(uint64_t address);
 		void AddBreakpoint(const ModuleNameAndOffset& breakpoint);
+		// Bulk versions, which post a single BreakpointsChangedEvent and return the number of breakpoints changed
+		size_t AddBreakpoints(const std::vector<uint64_t>& addresses);
+		size_t AddBreakpoints(const std::vector<ModuleNameAndOffset>& breakpoints);
+		size_t DeleteBreakpoints(const std::vector<uint64_t>& addresses);
+		size_t DeleteBreakpoints(const std::vector<ModuleNameAndOffset>& breakpoints);
 		bool ContainsBreakpoint(uint64_t address);
 		bool ContainsBreakpoint(const ModuleNameAndOffset& breakpoint);
+		bool SetBreakpointCondition(uint64_t address, const std::string& condition);
+		bool SetBreakpointCondition(const ModuleNameAndOffset& breakpoint, const std::string& condition);
+		bool AddTracepoint(uint64_t address, const std::string& captures);
+		bool AddTracepoint(const ModuleNameAndOffset& breakpoint, const std::string& captures);
+		std::vector<DebugTraceRecord> DrainTraceRecords(size_t maxCount = 0);
+		uint64_t GetDroppedTraceRecordCount();
+
+		bool AddWatchpoint(uint64_t address, size_t size, DebugWatchpointType type, bool record = false);
+		bool DeleteWatchpoint(uint64_t address);
+		std::vector<DebugWatchpoint> GetWatchpoints();
+		std::vector<DebugWatchpointHit> DrainWatchpointHits(size_t maxCount = 0);
+		uint64_t GetDroppedWatchpointHitCount();
+
+		// Adds the basic blocks of the functions at the given addresses, or of all functions if the list is empty, to
+		// the coverage. Each block is hit at most once without stopping the target.
+		size_t AddCoverage(const std::vector<uint64_t>& functions = {});
+		void ClearCoverage();
+		size_t GetCoverageBlockCount();
+		size_t GetCoverageHitCount();
+		std::vector<uint64_t> GetCoverageHits(size_t start = 0);
 
 		uint64_t IP();
 		uint64_t GetLastIP();
@@ -591,6 +691,7 @@ namespace BinaryNinjaDebuggerAPI {
 		std::string GetAddressInformation(uint64_t address);
 		bool IsFirstLaunch();
 		bool IsTTD();
+		bool IsReverseExecutionSupported();
 
 		void PostDebuggerEvent(const DebuggerEvent& event);
 
@@ -598,6 +699,9 @@ namespace BinaryNinjaDebuggerAPI {
 		bool ReAddDebuggerMemoryRegion();
 
 		uint64_t GetViewFileSegmentsStart();
+		bool IsImageTranslated();
+		uint64_t ViewToLiveAddress(uint64_t address);
+		uint64_t LiveToViewAddress(uint64_t address);
 
 		bool ComputeExprValue(const Ref<LowLevelILFunction>& func, const LowLevelILInstruction& expr,
 			  uint64_t & value);
@@ -127,16 +127,38 @@ DataBuffer DebuggerController::ReadMemory(std::uintptr_t address, std::size_t si
 }
 
 
+size_t DebuggerController::ReadMemory(std::uintptr_t address, void* dest, std::size_t size)
+{
+	return BNDebuggerReadMemoryInto(m_object, address, (uint8_t*)dest, size);
+}
+
+
+size_t DebuggerController::ReadMemoryRanges(
+	const std::vector<std::pair<uint64_t, size_t>>& ranges, void* dest, std::vector<size_t>& bytesRead)
+{
+	std::vector<uint64_t> addresses;
+	std::vector<size_t> sizes;
+	addresses.reserve(ranges.size());
+	sizes.reserve(ranges.size());
+	for (const auto& [address, size] : ranges)
+	{
+		addresses.push_back(address);
+		sizes.push_back(size);
+	}
+
+	bytesRead.resize(ranges.size());
+	return BNDebuggerReadMemoryRanges(
+		m_object, addresses.data(), sizes.data(), ranges.size(), (uint8_t*)dest, bytesRead.data());
+}
+
+
 bool DebuggerController::WriteMemory(std::uintptr_t address, const DataBuffer& buffer)
 {
 	return BNDebuggerWriteMemory(m_object, address, buffer.GetBufferObject());
 }
 
-std::vector<DebugProcess> DebuggerController::GetProcessList()
+static std::vector<DebugProcess> ConvertProcessList(BNDebugProcess* processes, size_t count)
 {
-	size_t count;
-	BNDebugProcess* processes = BNDebuggerGetProcessList(m_object, &count);
-
 	vector<DebugProcess> result;
 	result.reserve(count);
 	for (size_t i = 0; i < count; i++)
@@ -144,6 +166,10 @@ std::vector<DebugProcess> DebuggerController::GetProcessList()
 		DebugProcess process;
 		process.m_pid = processes[i].m_pid;
 		process.m_processName = processes[i].m_processName;
+		process.m_parentPid = processes[i].m_parentPid;
+		process.m_user = processes[i].m_user;
+		process.m_arch = processes[i].m_arch;
+		process.m_commandLine = processes[i].m_commandLine;
 		result.push_back(process);
 	}
 	BNDebuggerFreeProcessList(processes, count);
@@ -152,6 +178,22 @@ std::vector<DebugProcess> DebuggerController::GetProcessList()
 }
 
 
+std::vector<DebugProcess> DebuggerController::GetProcessList()
+{
+	size_t count;
+	BNDebugProcess* processes = BNDebuggerGetProcessList(m_object, &count);
+	return ConvertProcessList(processes, count);
+}
+
+
+std::vector<DebugProcess> DebuggerController::GetAdapterProcessList()
+{
+	size_t count;
+	BNDebugProcess* processes = BNDebuggerGetAdapterProcessList(m_object, &count);
+	return ConvertProcessList(processes, count);
+}
+
+
 std::vector<DebugThread> DebuggerController::GetThreads()
 {
 	size_t count;
@@ -253,10 +295,11 @@ std::vector<DebugModule> DebuggerController::GetModules()
 }
 
 
-std::vector<DebugRegister> DebuggerController::GetRegisters()
+std::vector<DebugRegister> DebuggerController::GetRegisters(bool withHints)
 {
 	size_t count;
-	BNDebugRegister* registers = BNDebuggerGetRegisters(m_object, &count);
+	BNDebugRegister* registers = withHints ? BNDebuggerGetRegisters(m_object, &count) :
+											 BNDebuggerGetRegistersWithoutHints(m_object, &count);
 
 	vector<DebugRegister> result;
 	result.reserve(count);
@@ -682,6 +725,11 @@ std::vector<DebugBreakpoint> DebuggerController::GetBreakpoints()
 		bp.offset = breakpoints[i].offset;
 		bp.address = breakpoints[i].address;
 		bp.enabled = breakpoints[i].enabled;
+		bp.condition = breakpoints[i].condition;
+		bp.hitCount = breakpoints[i].hitCount;
+		bp.skipCount = breakpoints[i].skipCount;
+		bp.isTracepoint = breakpoints[i].isTracepoint;
+		bp.traceCaptures = breakpoints[i].traceCaptures;
 		result[i] = bp;
 	}
 
@@ -690,6 +738,37 @@ std::vector<DebugBreakpoint> DebuggerController::GetBreakpoints()
 }
 
 
+uint64_t DebuggerController::GetBreakpointVersion()
+{
+	return BNDebuggerGetBreakpointVersion(m_object);
+}
+
+
+bool DebuggerController::GetBreakpointChanges(
+	uint64_t version, uint64_t& newVersion, std::vector<DebugBreakpointChange>& changes)
+{
+	size_t count;
+	bool complete;
+	BNDebugBreakpointChange* result =
+		BNDebuggerGetBreakpointChanges(m_object, version, &newVersion, &complete, &count);
+
+	changes.clear();
+	changes.reserve(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		DebugBreakpointChange change;
+		change.module = result[i].module;
+		change.offset = result[i].offset;
+		change.address = result[i].address;
+		change.added = result[i].added;
+		changes.push_back(change);
+	}
+
+	BNDebuggerFreeBreakpointChanges(result, count);
+	return complete;
+}
+
+
 void DebuggerController::DeleteBreakpoint(uint64_t address)
 {
 	BNDebuggerDeleteAbsoluteBreakpoint(m_object, address);
@@ -714,6 +793,48 @@ void DebuggerController::AddBreakpoint(const ModuleNameAndOffset& breakpoint)
 }
 
 
+size_t DebuggerController::AddBreakpoints(const std::vector<uint64_t>& addresses)
+{
+	return BNDebuggerAddAbsoluteBreakpoints(m_object, addresses.data(), addresses.size());
+}
+
+
+size_t DebuggerController::AddBreakpoints(const std::vector<ModuleNameAndOffset>& breakpoints)
+{
+	std::vector<const char*> modules;
+	std::vector<uint64_t> offsets;
+	modules.reserve(breakpoints.size());
+	offsets.reserve(breakpoints.size());
+	for (const auto& breakpoint : breakpoints)
+	{
+		modules.push_back(breakpoint.module.c_str());
+		offsets.push_back(breakpoint.offset);
+	}
+	return BNDebuggerAddRelativeBreakpoints(m_object, modules.data(), offsets.data(), breakpoints.size());
+}
+
+
+size_t DebuggerController::DeleteBreakpoints(const std::vector<uint64_t>& addresses)
+{
+	return BNDebuggerDeleteAbsoluteBreakpoints(m_object, addresses.data(), addresses.size());
+}
+
+
+size_t DebuggerController::DeleteBreakpoints(const std::vector<ModuleNameAndOffset>& breakpoints)
+{
+	std::vector<const char*> modules;
+	std::vector<uint64_t> offsets;
+	modules.reserve(breakpoints.size());
+	offsets.reserve(breakpoints.size());
+	for (const auto& breakpoint : breakpoints)
+	{
+		modules.push_back(breakpoint.module.c_str());
+		offsets.push_back(breakpoint.offset);
+	}
+	return BNDebuggerDeleteRelativeBreakpoints(m_object, modules.data(), offsets.data(), breakpoints.size());
+}
+
+
 bool DebuggerController::ContainsBreakpoint(uint64_t address)
 {
 	return BNDebuggerContainsAbsoluteBreakpoint(m_object, address);
@@ -726,6 +847,164 @@ bool DebuggerController::ContainsBreakpoint(const ModuleNameAndOffset& breakpoin
 }
 
 
+bool DebuggerController::SetBreakpointCondition(uint64_t address, const std::string& condition)
+{
+	return BNDebuggerSetAbsoluteBreakpointCondition(m_object, address, condition.c_str());
+}
+
+
+bool DebuggerController::SetBreakpointCondition(const ModuleNameAndOffset& breakpoint, const std::string& condition)
+{
+	return BNDebuggerSetRelativeBreakpointCondition(
+		m_object, breakpoint.module.c_str(), breakpoint.offset, condition.c_str());
+}
+
+
+bool DebuggerController::AddTracepoint(uint64_t address, const std::string& captures)
+{
+	return BNDebuggerAddAbsoluteTracepoint(m_object, address, captures.c_str());
+}
+
+
+bool DebuggerController::AddTracepoint(const ModuleNameAndOffset& breakpoint, const std::string& captures)
+{
+	return BNDebuggerAddRelativeTracepoint(m_object, breakpoint.module.c_str(), breakpoint.offset, captures.c_str());
+}
+
+
+std::vector<DebugTraceRecord> DebuggerController::DrainTraceRecords(size_t maxCount)
+{
+	size_t count;
+	BNDebuggerTraceRecord* records = BNDebuggerDrainTraceRecords(m_object, maxCount, &count);
+
+	std::vector<DebugTraceRecord> result;
+	result.resize(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		result[i].address = records[i].address;
+		result[i].threadId = records[i].threadId;
+		result[i].timestamp = records[i].timestamp;
+		result[i].values.resize(records[i].valueCount);
+		for (size_t j = 0; j < records[i].valueCount; j++)
+		{
+			const BNDebuggerTraceValue& value = records[i].values[j];
+			result[i].values[j].valid = value.valid;
+			result[i].values[j].value = value.value;
+			if (value.data)
+				result[i].values[j].data.assign(value.data, value.data + value.dataSize);
+		}
+	}
+
+	BNDebuggerFreeTraceRecords(records);
+	return result;
+}
+
+
+uint64_t DebuggerController::GetDroppedTraceRecordCount()
+{
+	return BNDebuggerGetDroppedTraceRecordCount(m_object);
+}
+
+
+bool DebuggerController::AddWatchpoint(uint64_t address, size_t size, DebugWatchpointType type, bool record)
+{
+	return BNDebuggerAddWatchpoint(m_object, address, size, type, record);
+}
+
+
+bool DebuggerController::DeleteWatchpoint(uint64_t address)
+{
+	return BNDebuggerDeleteWatchpoint(m_object, address);
+}
+
+
+std::vector<DebugWatchpoint> DebuggerController::GetWatchpoints()
+{
+	size_t count;
+	BNDebugWatchpoint* watchpoints = BNDebuggerGetWatchpoints(m_object, &count);
+
+	std::vector<DebugWatchpoint> result;
+	result.reserve(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		DebugWatchpoint watchpoint;
+		watchpoint.address = watchpoints[i].address;
+		watchpoint.size = watchpoints[i].size;
+		watchpoint.type = watchpoints[i].type;
+		watchpoint.record = watchpoints[i].record;
+		watchpoint.hitCount = watchpoints[i].hitCount;
+		result.push_back(watchpoint);
+	}
+
+	BNDebuggerFreeWatchpoints(watchpoints);
+	return result;
+}
+
+
+std::vector<DebugWatchpointHit> DebuggerController::DrainWatchpointHits(size_t maxCount)
+{
+	size_t count;
+	BNDebugWatchpointHit* hits = BNDebuggerDrainWatchpointHits(m_object, maxCount, &count);
+
+	std::vector<DebugWatchpointHit> result;
+	result.reserve(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		DebugWatchpointHit hit;
+		hit.address = hits[i].address;
+		hit.pc = hits[i].pc;
+		hit.threadId = hits[i].threadId;
+		hit.timestamp = hits[i].timestamp;
+		hit.oldValue = hits[i].oldValue;
+		hit.newValue = hits[i].newValue;
+		result.push_back(hit);
+	}
+
+	BNDebuggerFreeWatchpointHits(hits);
+	return result;
+}
+
+
+uint64_t DebuggerController::GetDroppedWatchpointHitCount()
+{
+	return BNDebuggerGetDroppedWatchpointHitCount(m_object);
+}
+
+
+size_t DebuggerController::AddCoverage(const std::vector<uint64_t>& functions)
+{
+	return BNDebuggerAddCoverage(m_object, functions.data(), functions.size());
+}
+
+
+void DebuggerController::ClearCoverage()
+{
+	BNDebuggerClearCoverage(m_object);
+}
+
+
+size_t DebuggerController::GetCoverageBlockCount()
+{
+	return BNDebuggerGetCoverageBlockCount(m_object);
+}
+
+
+size_t DebuggerController::GetCoverageHitCount()
+{
+	return BNDebuggerGetCoverageHitCount(m_object);
+}
+
+
+std::vector<uint64_t> DebuggerController::GetCoverageHits(size_t start)
+{
+	size_t count;
+	uint64_t* hits = BNDebuggerGetCoverageHits(m_object, start, &count);
+	std::vector<uint64_t> result(hits, hits + count);
+	BNDebuggerFreeCoverageHits(hits);
+	return result;
+}
+
+
 uint64_t DebuggerController::RelativeAddressToAbsolute(const ModuleNameAndOffset& address)
 {
 	return BNDebuggerRelativeAddressToAbsolute(m_object, address.module.c_str(), address.offset);
@@ -881,36 +1160,37 @@ bool DebuggerController::IsTTD()
 }
 
 
-void DebuggerController::PostDebuggerEvent(const DebuggerEvent &event)
+bool DebuggerController::IsReverseExecutionSupported()
 {
-	BNDebuggerEvent* evt = new BNDebuggerEvent;
+	return BNDebuggerIsReverseExecutionSupported(m_object);
+}
 
-	evt->type = event.type;
-	evt->data.targetStoppedData.reason = event.data.targetStoppedData.reason;
-	evt->data.targetStoppedData.exitCode = event.data.targetStoppedData.exitCode;
-	evt->data.targetStoppedData.lastActiveThread = event.data.targetStoppedData.lastActiveThread;
-	evt->data.targetStoppedData.data = event.data.targetStoppedData.data;
 
-	evt->data.errorData.error = BNDebuggerAllocString(event.data.errorData.error.c_str());
-	evt->data.errorData.shortError = BNDebuggerAllocString(event.data.errorData.shortError.c_str());
-	evt->data.errorData.data = event.data.errorData.data;
+void DebuggerController::PostDebuggerEvent(const DebuggerEvent &event)
+{
+	// The core copies what it needs before BNDebuggerPostDebuggerEvent returns, so the strings can be borrowed
+	BNDebuggerEvent evt {};
+
+	evt.type = event.type;
+	evt.data.targetStoppedData.reason = event.data.targetStoppedData.reason;
+	evt.data.targetStoppedData.exitCode = event.data.targetStoppedData.exitCode;
+	evt.data.targetStoppedData.lastActiveThread = event.data.targetStoppedData.lastActiveThread;
+	evt.data.targetStoppedData.data = event.data.targetStoppedData.data;
 
-	evt->data.exitData.exitCode = event.data.exitData.exitCode;
+	evt.data.errorData.error = const_cast<char*>(event.data.errorData.error.c_str());
+	evt.data.errorData.shortError = const_cast<char*>(event.data.errorData.shortError.c_str());
+	evt.data.errorData.data = event.data.errorData.data;
 
-	evt->data.relativeAddress.module = BNDebuggerAllocString(event.data.relativeAddress.module.c_str());
-	evt->data.relativeAddress.offset = event.data.relativeAddress.offset;
+	evt.data.exitData.exitCode = event.data.exitData.exitCode;
 
-	evt->data.absoluteAddress = event.data.absoluteAddress;
+	evt.data.relativeAddress.module = const_cast<char*>(event.data.relativeAddress.module.c_str());
+	evt.data.relativeAddress.offset = event.data.relativeAddress.offset;
 
-	evt->data.messageData.message = BNDebuggerAllocString(event.data.messageData.message.c_str());
+	evt.data.absoluteAddress = event.data.absoluteAddress;
 
-	BNDebuggerPostDebuggerEvent(m_object, evt);
+	evt.data.messageData.message = const_cast<char*>(event.data.messageData.message.c_str());
 
-	BNDebuggerFreeString(evt->data.errorData.error);
-	BNDebuggerFreeString(evt->data.errorData.shortError);
-	BNDebuggerFreeString(evt->data.relativeAddress.module);
-	BNDebuggerFreeString(evt->data.messageData.message);
-	delete evt;
+	BNDebuggerPostDebuggerEvent(m_object, &evt);
 }
 
 
@@ -932,6 +1212,24 @@ uint64_t DebuggerController::GetViewFileSegmentsStart()
 }
 
 
+bool DebuggerController::IsImageTranslated()
+{
+	return BNDebuggerIsImageTranslated(m_object);
+}
+
+
+uint64_t DebuggerController::ViewToLiveAddress(uint64_t address)
+{
+	return BNDebuggerViewToLiveAddress(m_object, address);
+}
+
+
+uint64_t DebuggerController::LiveToViewAddress(uint64_t address)
+{
+	return BNDebuggerLiveToViewAddress(m_object, address);
+}
+
+
 bool DebuggerController::ComputeExprValue(const Ref<LowLevelILFunction>& func,
 	const BinaryNinja::LowLevelILInstruction &expr, uint64_t &value)
 {
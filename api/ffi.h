@@ -83,6 +83,10 @@ extern "C"
 	{
 		uint32_t m_pid;
 		char* m_processName;
+		uint32_t m_parentPid;
+		char* m_user;
+		char* m_arch;
+		char* m_commandLine;
 	} BNDebugProcess;
 
 	typedef struct BNDebugThread
@@ -131,9 +135,76 @@ extern "C"
 		uint64_t offset;
 		uint64_t address;
 		bool enabled;
+		// Empty for an unconditional breakpoint
+		char* condition;
+		uint64_t hitCount;
+		uint64_t skipCount;
+		bool isTracepoint;
+		// The captures of a tracepoint, e.g., "rdi, rsi:32"
+		char* traceCaptures;
 	} BNDebugBreakpoint;
 
 
+	// A breakpoint that was added or removed, see BNDebuggerGetBreakpointChanges()
+	typedef struct BNDebugBreakpointChange
+	{
+		char* module;
+		uint64_t offset;
+		uint64_t address;
+		bool added;
+	} BNDebugBreakpointChange;
+
+
+	typedef enum BNDebugWatchpointType
+	{
+		ReadWatchpoint = 1,
+		WriteWatchpoint = 2,
+		ReadWriteWatchpoint = 3,
+	} BNDebugWatchpointType;
+
+
+	typedef struct BNDebugWatchpoint
+	{
+		uint64_t address;
+		size_t size;
+		BNDebugWatchpointType type;
+		// Whether hits are recorded and the target resumed, rather than stopping
+		bool record;
+		uint64_t hitCount;
+	} BNDebugWatchpoint;
+
+
+	typedef struct BNDebugWatchpointHit
+	{
+		uint64_t address;
+		uint64_t pc;
+		uint32_t threadId;
+		uint64_t timestamp;
+		uint64_t oldValue;
+		uint64_t newValue;
+	} BNDebugWatchpointHit;
+
+
+	typedef struct BNDebuggerTraceValue
+	{
+		bool valid;
+		uint64_t value;
+		// The snippet of a capture with a size, nullptr otherwise
+		uint8_t* data;
+		size_t dataSize;
+	} BNDebuggerTraceValue;
+
+
+	typedef struct BNDebuggerTraceRecord
+	{
+		uint64_t address;
+		uint32_t threadId;
+		uint64_t timestamp;
+		BNDebuggerTraceValue* values;
+		size_t valueCount;
+	} BNDebuggerTraceRecord;
+
+
 	typedef struct BNModuleNameAndOffset
 	{
 		char* module;
@@ -196,7 +267,9 @@ extern "C"
 
 		UserRequestedBreak,
 
-		OperationNotSupported
+		OperationNotSupported,
+
+		Watchpoint
 	} BNDebugStopReason;
 
 
@@ -264,6 +337,16 @@ extern "C"
 
 		ForceMemoryCacheUpdateEvent,
 		ModuleLoadedEvent,
+
+		WatchpointAddedEvent,
+		WatchpointRemovedEvent,
+
+		// Posted once for breakpoints added or removed in bulk, instead of one event per breakpoint. The message data
+		// holds a summary of the change.
+		BreakpointsChangedEvent,
+		// Posted when blocks are added to the coverage, or when it is cleared, with a summary in the message data. Hits
+		// do not post any event.
+		CoverageChangedEvent,
 	} BNDebuggerEventType;
 
 
@@ -296,7 +379,8 @@ extern "C"
 	} BNStdoutMessageEventData;
 
 
-	// This should really be a union, but gcc complains...
+	// Only the member matching the event type is meaningful; the others are zero, and their strings are empty. The
+	// strings are borrowed from the event and only live as long as the callback or the post call.
 	typedef struct BNDebuggerEventData
 	{
 		BNTargetStoppedEventData targetStoppedData;
@@ -357,10 +441,16 @@ extern "C"
 
 	DEBUGGER_FFI_API BNDataBuffer* BNDebuggerReadMemory(
 		BNDebuggerController* controller, uint64_t address, size_t size);
+	DEBUGGER_FFI_API size_t BNDebuggerReadMemoryInto(
+		BNDebuggerController* controller, uint64_t address, uint8_t* dest, size_t size);
+	DEBUGGER_FFI_API size_t BNDebuggerReadMemoryRanges(BNDebuggerController* controller, const uint64_t* addresses,
+		const size_t* sizes, size_t count, uint8_t* dest, size_t* bytesRead);
 	DEBUGGER_FFI_API bool BNDebuggerWriteMemory(
 		BNDebuggerController* controller, uint64_t address, BNDataBuffer* buffer);
 
 	DEBUGGER_FFI_API BNDebugProcess* BNDebuggerGetProcessList(BNDebuggerController* controller, size_t* count);
+	DEBUGGER_FFI_API BNDebugProcess* BNDebuggerGetAdapterProcessList(
+		BNDebuggerController* controller, size_t* count);
 	DEBUGGER_FFI_API void BNDebuggerFreeProcessList(BNDebugProcess* processes, size_t count);
 
 	DEBUGGER_FFI_API BNDebugThread* BNDebuggerGetThreads(BNDebuggerController* controller, size_t* count);
@@ -379,6 +469,8 @@ extern "C"
 	DEBUGGER_FFI_API void BNDebuggerFreeModules(BNDebugModule* modules, size_t count);
 
 	DEBUGGER_FFI_API BNDebugRegister* BNDebuggerGetRegisters(BNDebuggerController* controller, size_t* count);
+	DEBUGGER_FFI_API BNDebugRegister* BNDebuggerGetRegistersWithoutHints(
+		BNDebuggerController* controller, size_t* count);
 	DEBUGGER_FFI_API void BNDebuggerFreeRegisters(BNDebugRegister* modules, size_t count);
 	DEBUGGER_FFI_API bool BNDebuggerSetRegisterValue(
 		BNDebuggerController* controller, const char* name, uint64_t value);
@@ -458,6 +550,13 @@ extern "C"
 
 	DEBUGGER_FFI_API BNDebugBreakpoint* BNDebuggerGetBreakpoints(BNDebuggerController* controller, size_t* count);
 	DEBUGGER_FFI_API void BNDebuggerFreeBreakpoints(BNDebugBreakpoint* breakpoints, size_t count);
+	// The breakpoint list has a version that is bumped on every change. The changes since a version can be retrieved
+	// instead of the whole list. If they are not all available, or the addresses of the breakpoints have changed,
+	// complete is set to false and the whole list must be retrieved again.
+	DEBUGGER_FFI_API uint64_t BNDebuggerGetBreakpointVersion(BNDebuggerController* controller);
+	DEBUGGER_FFI_API BNDebugBreakpointChange* BNDebuggerGetBreakpointChanges(
+		BNDebuggerController* controller, uint64_t version, uint64_t* newVersion, bool* complete, size_t* count);
+	DEBUGGER_FFI_API void BNDebuggerFreeBreakpointChanges(BNDebugBreakpointChange* changes, size_t count);
 
 	DEBUGGER_FFI_API void BNDebuggerDeleteAbsoluteBreakpoint(BNDebuggerController* controller, uint64_t address);
 	DEBUGGER_FFI_API void BNDebuggerDeleteRelativeBreakpoint(
@@ -465,9 +564,50 @@ extern "C"
 	DEBUGGER_FFI_API void BNDebuggerAddAbsoluteBreakpoint(BNDebuggerController* controller, uint64_t address);
 	DEBUGGER_FFI_API void BNDebuggerAddRelativeBreakpoint(
 		BNDebuggerController* controller, const char* module, uint64_t offset);
+	// Bulk versions of the above, which return the number of breakpoints added or removed
+	DEBUGGER_FFI_API size_t BNDebuggerAddAbsoluteBreakpoints(
+		BNDebuggerController* controller, const uint64_t* addresses, size_t count);
+	DEBUGGER_FFI_API size_t BNDebuggerAddRelativeBreakpoints(
+		BNDebuggerController* controller, const char** modules, const uint64_t* offsets, size_t count);
+	DEBUGGER_FFI_API size_t BNDebuggerDeleteAbsoluteBreakpoints(
+		BNDebuggerController* controller, const uint64_t* addresses, size_t count);
+	DEBUGGER_FFI_API size_t BNDebuggerDeleteRelativeBreakpoints(
+		BNDebuggerController* controller, const char** modules, const uint64_t* offsets, size_t count);
 	DEBUGGER_FFI_API bool BNDebuggerContainsAbsoluteBreakpoint(BNDebuggerController* controller, uint64_t address);
 	DEBUGGER_FFI_API bool BNDebuggerContainsRelativeBreakpoint(
 		BNDebuggerController* controller, const char* module, uint64_t offset);
+	DEBUGGER_FFI_API bool BNDebuggerSetAbsoluteBreakpointCondition(
+		BNDebuggerController* controller, uint64_t address, const char* condition);
+	DEBUGGER_FFI_API bool BNDebuggerSetRelativeBreakpointCondition(
+		BNDebuggerController* controller, const char* module, uint64_t offset, const char* condition);
+	DEBUGGER_FFI_API bool BNDebuggerAddAbsoluteTracepoint(
+		BNDebuggerController* controller, uint64_t address, const char* captures);
+	DEBUGGER_FFI_API bool BNDebuggerAddRelativeTracepoint(
+		BNDebuggerController* controller, const char* module, uint64_t offset, const char* captures);
+	// The records, their values and the snippets come in a single allocation, freed by BNDebuggerFreeTraceRecords
+	DEBUGGER_FFI_API BNDebuggerTraceRecord* BNDebuggerDrainTraceRecords(
+		BNDebuggerController* controller, size_t maxCount, size_t* count);
+	DEBUGGER_FFI_API void BNDebuggerFreeTraceRecords(BNDebuggerTraceRecord* records);
+	DEBUGGER_FFI_API uint64_t BNDebuggerGetDroppedTraceRecordCount(BNDebuggerController* controller);
+
+	DEBUGGER_FFI_API bool BNDebuggerAddWatchpoint(
+		BNDebuggerController* controller, uint64_t address, size_t size, BNDebugWatchpointType type, bool record);
+	DEBUGGER_FFI_API bool BNDebuggerDeleteWatchpoint(BNDebuggerController* controller, uint64_t address);
+	DEBUGGER_FFI_API BNDebugWatchpoint* BNDebuggerGetWatchpoints(BNDebuggerController* controller, size_t* count);
+	DEBUGGER_FFI_API void BNDebuggerFreeWatchpoints(BNDebugWatchpoint* watchpoints);
+	DEBUGGER_FFI_API BNDebugWatchpointHit* BNDebuggerDrainWatchpointHits(
+		BNDebuggerController* controller, size_t maxCount, size_t* count);
+	DEBUGGER_FFI_API void BNDebuggerFreeWatchpointHits(BNDebugWatchpointHit* hits);
+	DEBUGGER_FFI_API uint64_t BNDebuggerGetDroppedWatchpointHitCount(BNDebuggerController* controller);
+
+	// An empty list of functions covers all functions of the view
+	DEBUGGER_FFI_API size_t BNDebuggerAddCoverage(
+		BNDebuggerController* controller, const uint64_t* functions, size_t count);
+	DEBUGGER_FFI_API void BNDebuggerClearCoverage(BNDebuggerController* controller);
+	DEBUGGER_FFI_API size_t BNDebuggerGetCoverageBlockCount(BNDebuggerController* controller);
+	DEBUGGER_FFI_API size_t BNDebuggerGetCoverageHitCount(BNDebuggerController* controller);
+	DEBUGGER_FFI_API uint64_t* BNDebuggerGetCoverageHits(BNDebuggerController* controller, size_t start, size_t* count);
+	DEBUGGER_FFI_API void BNDebuggerFreeCoverageHits(uint64_t* hits);
 
 	DEBUGGER_FFI_API uint64_t BNDebuggerGetIP(BNDebuggerController* controller);
 	DEBUGGER_FFI_API uint64_t BNDebuggerGetLastIP(BNDebuggerController* controller);
@@ -492,6 +632,7 @@ extern "C"
 	DEBUGGER_FFI_API char* BNDebuggerGetAddressInformation(BNDebuggerController* controller, uint64_t address);
 	DEBUGGER_FFI_API bool BNDebuggerIsFirstLaunch(BNDebuggerController* controller);
 	DEBUGGER_FFI_API bool BNDebuggerIsTTD(BNDebuggerController* controller);
+	DEBUGGER_FFI_API bool BNDebuggerIsReverseExecutionSupported(BNDebuggerController* controller);
 
 	DEBUGGER_FFI_API void BNDebuggerPostDebuggerEvent(BNDebuggerController* controller, BNDebuggerEvent* event);
 
@@ -499,6 +640,9 @@ extern "C"
 	DEBUGGER_FFI_API bool BNDebuggerReAddMemoryRegion(BNDebuggerController* controller);
 
 	DEBUGGER_FFI_API uint64_t BNDebuggerGetViewFileSegmentsStart(BNDebuggerController* controller);
+	DEBUGGER_FFI_API bool BNDebuggerIsImageTranslated(BNDebuggerController* controller);
+	DEBUGGER_FFI_API uint64_t BNDebuggerViewToLiveAddress(BNDebuggerController* controller, uint64_t address);
+	DEBUGGER_FFI_API uint64_t BNDebuggerLiveToViewAddress(BNDebuggerController* controller, uint64_t address);
 
 	// DebugAdapterType
 	DEBUGGER_FFI_API BNDebugAdapterType* BNGetDebugAdapterTypeByName(const char* name);
@@ -512,6 +656,8 @@ extern "C"
 
 
 	// Debugger events
+	// The event passed to the callback is a borrowed view: copy anything needed after the callback returns, and do
+	// not free its strings.
 	DEBUGGER_FFI_API size_t BNDebuggerRegisterEventCallback(BNDebuggerController* controller,
 		void (*callback)(void* ctx, BNDebuggerEvent* event), const char* name, void* ctx);
 	DEBUGGER_FFI_API void BNDebuggerRemoveEventCallback(BNDebuggerController* controller, size_t index);
@@ -20,7 +20,7 @@ import binaryninja
 # import debugger
 from . import _debuggercore as dbgcore
 from .debugger_enums import *
-from typing import Callable, List, Union
+from typing import Callable, List, Optional, Tuple, Union
 
 
 class DebugProcess:
@@ -29,12 +29,22 @@ class DebugProcess:
 
     * ``pid``: the ID of the process
     * ``name``: the name of the process
+    * ``parent_pid``: the ID of the parent process, or 0 if it is unknown
+    * ``user``: the user that owns the process, or the user ID if the name is unknown
+    * ``arch``: the architecture of the process, e.g., ``x86_64``
+    * ``command_line``: the command line of the process. Remote platforms may only report the path of the executable.
+
+    The last four fields are empty when the platform does not report them.
 
     """
 
-    def __init__(self, pid, name):
+    def __init__(self, pid, name, parent_pid=0, user='', arch='', command_line=''):
         self.pid = pid
         self.name = name
+        self.parent_pid = parent_pid
+        self.user = user
+        self.arch = arch
+        self.command_line = command_line
 
     def __eq__(self, other):
         if not isinstance(other, self.__class__):
@@ -226,13 +236,24 @@ class DebugBreakpoint:
     * ``offset``: the offset of the breakpoint to the start of the module
     * ``address``: the absolute address of the breakpoint
     * ``enabled``: not used
+    * ``condition``: the condition of the breakpoint, or an empty string for an unconditional breakpoint
+    * ``hit_count``: how many times the condition held and the target stopped at the breakpoint
+    * ``skip_count``: how many times the condition did not hold and the target was resumed right away
+    * ``is_tracepoint``: whether the breakpoint records its hits instead of stopping the target
+    * ``trace_captures``: the values a tracepoint records, e.g., ``rdi, rsi:32``
 
     """
-    def __init__(self, module, offset, address, enabled):
+    def __init__(self, module, offset, address, enabled, condition='', hit_count=0, skip_count=0,
+                 is_tracepoint=False, trace_captures=''):
         self.module = module
         self.offset = offset
         self.address = address
         self.enabled = enabled
+        self.condition = condition
+        self.hit_count = hit_count
+        self.skip_count = skip_count
+        self.is_tracepoint = is_tracepoint
+        self.trace_captures = trace_captures
 
     def __eq__(self, other):
         if not isinstance(other, self.__class__):
@@ -258,6 +279,94 @@ class DebugBreakpoint:
         return f"<DebugBreakpoint: {self.module}:{self.offset:#x}, {self.address:#x}>"
 
 
+class DebugBreakpointChange:
+    """
+    DebugBreakpointChange is a breakpoint that was added or removed. It has the following fields:
+
+    * ``module``: the name of the module for which the breakpoint is in
+    * ``offset``: the offset of the breakpoint to the start of the module
+    * ``address``: the absolute address of the breakpoint
+    * ``added``: True if the breakpoint was added, False if it was removed
+
+    """
+    def __init__(self, module, offset, address, added):
+        self.module = module
+        self.offset = offset
+        self.address = address
+        self.added = added
+
+    def __repr__(self):
+        action = 'added' if self.added else 'removed'
+        return f"<DebugBreakpointChange: {action} {self.module}:{self.offset:#x}, {self.address:#x}>"
+
+
+class DebugWatchpoint:
+    """
+    DebugWatchpoint represents a hardware watchpoint in the target. It has the following fields:
+
+    * ``address``: the address of the watched memory
+    * ``size``: the number of watched bytes, 1, 2, 4 or 8
+    * ``type``: a ``DebugWatchpointType``, i.e., whether reads, writes, or both trigger it
+    * ``record``: whether hits are recorded and the target resumed, rather than stopping
+    * ``hit_count``: how many times the watchpoint triggered
+
+    """
+    def __init__(self, address, size, type, record, hit_count):
+        self.address = address
+        self.size = size
+        self.type = type
+        self.record = record
+        self.hit_count = hit_count
+
+    def __repr__(self):
+        return f"<DebugWatchpoint: {self.address:#x}, {self.size} bytes, {self.type.name}>"
+
+
+class WatchpointHit:
+    """
+    WatchpointHit is one hit of a recording watchpoint. It has the following fields:
+
+    * ``address``: the address of the watchpoint
+    * ``pc``: the instruction pointer when the watchpoint triggered. On x86, this is the instruction after the access
+    * ``thread_id``: the thread that made the access
+    * ``timestamp``: nanoseconds of a monotonic clock, only meaningful relative to other records
+    * ``old_value``: the value at the previous hit, or when the watchpoint was added
+    * ``new_value``: the value after the access
+
+    """
+    def __init__(self, address, pc, thread_id, timestamp, old_value, new_value):
+        self.address = address
+        self.pc = pc
+        self.thread_id = thread_id
+        self.timestamp = timestamp
+        self.old_value = old_value
+        self.new_value = new_value
+
+    def __repr__(self):
+        return f"<WatchpointHit: {self.address:#x} at {self.pc:#x}, {self.old_value:#x} -> {self.new_value:#x}>"
+
+
+class TraceRecord:
+    """
+    TraceRecord is one hit of a tracepoint. It has the following fields:
+
+    * ``address``: the address of the tracepoint
+    * ``thread_id``: the thread that hit it
+    * ``timestamp``: nanoseconds of a monotonic clock, only meaningful relative to other records
+    * ``values``: one entry per capture of the tracepoint, in order. It is an int for a value capture, bytes for a \
+        snippet capture, or None if the register or memory could not be read
+
+    """
+    def __init__(self, address, thread_id, timestamp, values):
+        self.address = address
+        self.thread_id = thread_id
+        self.timestamp = timestamp
+        self.values = values
+
+    def __repr__(self):
+        return f"<TraceRecord: {self.address:#x}, thread {self.thread_id:#x}, {len(self.values)} values>"
+
+
 class ModuleNameAndOffset:
     """
     ModuleNameAndOffset represents an address that is relative to the start of module. It is useful when ASLR is on.
@@ -602,6 +711,65 @@ class DebuggerController:
             return None
         return binaryninja.DataBuffer(handle=buffer)
 
+    @staticmethod
+    def _writable_bytes(buffer, size: int):
+        view = memoryview(buffer)
+        if view.readonly:
+            raise TypeError('the buffer must be writable')
+        view = view.cast('B')
+        if size > view.nbytes:
+            raise ValueError(f'the buffer holds {view.nbytes:#x} bytes, which is less than {size:#x}')
+        return (ctypes.c_ubyte * size).from_buffer(view)
+
+    def read_memory_into(self, address: int, buffer, size: Optional[int] = None) -> int:
+        """
+        Read memory from the target into a buffer supplied by the caller
+
+        Unlike ``read_memory``, this copies the memory straight into the buffer, without creating a DataBuffer. This is
+        much faster when scanning large regions, e.g., for a signature. Reading the same buffer repeatedly does not
+        allocate anything.
+
+        The read stops at the first byte that cannot be read, so the number of bytes read can be less than the size.
+
+        :param address: address to read from
+        :param buffer: a writable, contiguous object that supports the buffer protocol, e.g., a bytearray, a memoryview,
+         or a numpy array
+        :param size: number of bytes to read. By default, the size of the buffer in bytes.
+        :return: the number of bytes read
+        """
+        if size is None:
+            size = memoryview(buffer).nbytes
+        if size == 0:
+            return 0
+        dest = self._writable_bytes(buffer, size)
+        return dbgcore.BNDebuggerReadMemoryInto(self.handle, address, dest, size)
+
+    def read_memory_ranges(self, ranges: List[Tuple[int, int]], buffer) -> List[int]:
+        """
+        Read many ranges of memory from the target into a buffer supplied by the caller, with a single call into the
+        debugger core
+
+        The ranges are stored one after another into the buffer, i.e., the first range at offset 0, the second one
+        right after the size of the first one, and so on. See ``read_memory_into``.
+
+        :param ranges: a list of (address, size) tuples
+        :param buffer: a writable, contiguous object that supports the buffer protocol, which can hold the sum of the
+         sizes of the ranges
+        :return: the number of bytes read from each range
+        """
+        count = len(ranges)
+        if count == 0:
+            return []
+        total = sum(size for _, size in ranges)
+        if total == 0:
+            return [0] * count
+        addresses = (ctypes.c_uint64 * count)(*[address for address, _ in ranges])
+        sizes = (ctypes.c_ulonglong * count)(*[size for _, size in ranges])
+        bytes_read = (ctypes.c_ulonglong * count)()
+        dest = self._writable_bytes(buffer, total)
+        dbgcore.BNDebuggerReadMemoryRanges(self.handle, addresses, sizes, count, dest, bytes_read)
+        return list(bytes_read)
+
     def write_memory(self, address: int, buffer) -> bool:
         """
         Write memory of the target.
@@ -627,7 +795,8 @@ class DebuggerController:
         process_list = dbgcore.BNDebuggerGetProcessList(self.handle, count)
         result = []
         for i in range(0, count.value):
-            process = DebugProcess(process_list[i].m_pid, process_list[i].m_processName)
+            process = DebugProcess(process_list[i].m_pid, process_list[i].m_processName, process_list[i].m_parentPid,
+                                   process_list[i].m_user, process_list[i].m_arch, process_list[i].m_commandLine)
             result.append(process)
 
         dbgcore.BNDebuggerFreeProcessList(process_list, count.value)
@@ -1331,12 +1500,47 @@ class DebuggerController:
         breakpoints = dbgcore.BNDebuggerGetBreakpoints(self.handle, count)
         result = []
         for i in range(0, count.value):
-            bp = DebugBreakpoint(breakpoints[i].module, breakpoints[i].offset, breakpoints[i].address, breakpoints[i].enabled)
+            bp = DebugBreakpoint(breakpoints[i].module, breakpoints[i].offset, breakpoints[i].address,
+                                 breakpoints[i].enabled, breakpoints[i].condition, breakpoints[i].hitCount,
+                                 breakpoints[i].skipCount, breakpoints[i].isTracepoint,
+                                 breakpoints[i].traceCaptures)
             result.append(bp)
 
         dbgcore.BNDebuggerFreeBreakpoints(breakpoints, count.value)
         return result
 
+    @property
+    def breakpoint_version(self) -> int:
+        """
+        The version of the breakpoint list, which changes every time a breakpoint is added or removed (read-only)
+        """
+        return dbgcore.BNDebuggerGetBreakpointVersion(self.handle)
+
+    def get_breakpoint_changes(self, version: int) -> Tuple[int, Optional[List[DebugBreakpointChange]]]:
+        """
+        Get the breakpoints added or removed since a version of the breakpoint list. This is much cheaper than getting
+        all breakpoints again when there are a lot of them.
+
+        If the changes are not all available, or the addresses of the breakpoints have changed since the version, e.g.,
+        because the target is launched, the list of changes is None, and ``breakpoints`` must be read again.
+
+        :param version: a version previously returned by ``breakpoint_version`` or this function
+        :return: the current version, and the changes in the order they happened, or None
+        """
+        new_version = ctypes.c_ulonglong()
+        complete = ctypes.c_bool()
+        count = ctypes.c_ulonglong()
+        changes = dbgcore.BNDebuggerGetBreakpointChanges(self.handle, version, new_version, complete, count)
+        result = []
+        for i in range(0, count.value):
+            result.append(DebugBreakpointChange(changes[i].module, changes[i].offset, changes[i].address,
+                                                changes[i].added))
+
+        dbgcore.BNDebuggerFreeBreakpointChanges(changes, count.value)
+        if not complete.value:
+            return new_version.value, None
+        return new_version.value, result
+
     def delete_breakpoint(self, address):
         """
         Delete a breakpoint
@@ -1369,6 +1573,52 @@ class DebuggerController:
         else:
             raise NotImplementedError
 
+    @staticmethod
+    def _split_breakpoint_addresses(addresses):
+        absolute = [address for address in addresses if isinstance(address, int)]
+        relative = [address for address in addresses if isinstance(address, ModuleNameAndOffset)]
+        if len(absolute) + len(relative) != len(addresses):
+            raise NotImplementedError
+
+        absolute_list = (ctypes.c_uint64 * len(absolute))(*absolute)
+        modules = (ctypes.c_char_p * len(relative))(*[address.module.encode('utf-8') for address in relative])
+        offsets = (ctypes.c_uint64 * len(relative))(*[address.offset for address in relative])
+        return absolute_list, len(absolute), modules, offsets, len(relative)
+
+    def add_breakpoints(self, addresses) -> int:
+        """
+        Add many breakpoints at once
+
+        This is much faster than calling ``add_breakpoint`` in a loop, e.g., when restoring thousands of coverage
+        breakpoints. The breakpoints are created in one pass, and a single ``BreakpointsChangedEvent`` is sent
+        instead of one event per breakpoint.
+
+        :param addresses: a list of absolute addresses and/or ModuleNameAndOffset
+        :return: the number of breakpoints added, not counting the ones that already exist
+        """
+        absolute, absolute_count, modules, offsets, relative_count = self._split_breakpoint_addresses(addresses)
+        count = 0
+        if absolute_count > 0:
+            count += dbgcore.BNDebuggerAddAbsoluteBreakpoints(self.handle, absolute, absolute_count)
+        if relative_count > 0:
+            count += dbgcore.BNDebuggerAddRelativeBreakpoints(self.handle, modules, offsets, relative_count)
+        return count
+
+    def delete_breakpoints(self, addresses) -> int:
+        """
+        Delete many breakpoints at once. See ``add_breakpoints``.
+
+        :param addresses: a list of absolute addresses and/or ModuleNameAndOffset
+        :return: the number of breakpoints deleted
+        """
+        absolute, absolute_count, modules, offsets, relative_count = self._split_breakpoint_addresses(addresses)
+        count = 0
+        if absolute_count > 0:
+            count += dbgcore.BNDebuggerDeleteAbsoluteBreakpoints(self.handle, absolute, absolute_count)
+        if relative_count > 0:
+            count += dbgcore.BNDebuggerDeleteRelativeBreakpoints(self.handle, modules, offsets, relative_count)
+        return count
+
     def has_breakpoint(self, address) -> bool:
         """
         Checks whether a breakpoint exists at the specified address
@@ -1385,6 +1635,215 @@ class DebuggerController:
         else:
             raise NotImplementedError
 
+    def set_breakpoint_condition(self, address, condition: str) -> bool:
+        """
+        Make an existing breakpoint conditional
+
+        The condition is compiled once and evaluated by the debugger core every time the breakpoint is hit. The target
+        only stops if the condition is non-zero; otherwise it is resumed right away, without any stop event being
+        sent. The condition can use registers (``rax`` or ``$rax``), integers, memory reads (``[expr]`` for a
+        pointer-sized value, or ``byte``/``word``/``dword``/``qword[expr]``), and the C operators, e.g.,
+        ``rdi != 0 && dword[rdi] == 0x41414141``. An empty condition makes the breakpoint unconditional again.
+
+        The input address can be either an absolute address, or a ModuleNameAndOffset, which specifies a relative
+        address to the start of a module. The latter is useful for ASLR.
+
+        :param address: the address of the breakpoint
+        :param condition: the condition
+        :return: False if there is no breakpoint at the address, or the condition is invalid
+        """
+        if isinstance(address, int):
+            return dbgcore.BNDebuggerSetAbsoluteBreakpointCondition(self.handle, address, condition)
+        elif isinstance(address, ModuleNameAndOffset):
+            return dbgcore.BNDebuggerSetRelativeBreakpointCondition(self.handle, address.module, address.offset,
+                                                                    condition)
+        else:
+            raise NotImplementedError
+
+    def add_tracepoint(self, address, captures: str = '') -> bool:
+        """
+        Add a tracepoint, or turn an existing breakpoint into one
+
+        A tracepoint does not stop the target. Every time it is hit, the debugger core records the captures into a
+        bounded buffer and resumes the target right away, without any stop event being sent. The records are retrieved
+        with ``drain_trace_records``. The captures are a comma-separated list of expressions, in the syntax of
+        ``set_breakpoint_condition``. An expression followed by ``:size`` records that many bytes of memory at the
+        address it evaluates to, e.g., ``rdi, [rsp+8], rsi:32``. A condition set on the breakpoint still applies: the
+        hit is only recorded if it holds.
+
+        The input address can be either an absolute address, or a ModuleNameAndOffset, which specifies a relative
+        address to the start of a module. The latter is useful for ASLR.
+
+        :param address: the address of the tracepoint
+        :param captures: the values to record on every hit
+        :return: False if the captures are invalid
+        """
+        if isinstance(address, int):
+            return dbgcore.BNDebuggerAddAbsoluteTracepoint(self.handle, address, captures)
+        elif isinstance(address, ModuleNameAndOffset):
+            return dbgcore.BNDebuggerAddRelativeTracepoint(self.handle, address.module, address.offset, captures)
+        else:
+            raise NotImplementedError
+
+    def drain_trace_records(self, max_count: int = 0) -> List[TraceRecord]:
+        """
+        Remove and return the oldest tracepoint records, up to ``max_count`` of them, or all of them if it is 0
+
+        :param max_count: the maximum number of records to return
+        :return: the records, oldest first
+        """
+        count = ctypes.c_ulonglong()
+        records = dbgcore.BNDebuggerDrainTraceRecords(self.handle, max_count, count)
+        result = []
+        for i in range(0, count.value):
+            values = []
+            for j in range(0, records[i].valueCount):
+                value = records[i].values[j]
+                if not value.valid:
+                    values.append(None)
+                elif value.data:
+                    values.append(ctypes.string_at(value.data, value.dataSize))
+                else:
+                    values.append(value.value)
+            result.append(TraceRecord(records[i].address, records[i].threadId, records[i].timestamp, values))
+
+        if records:
+            dbgcore.BNDebuggerFreeTraceRecords(records)
+        return result
+
+    @property
+    def dropped_trace_record_count(self) -> int:
+        """
+        The number of tracepoint records that were overwritten because the buffer was full before they were drained.
+        The size of the buffer is set by the ``debugger.tracepointBufferSize`` setting.
+        """
+        return dbgcore.BNDebuggerGetDroppedTraceRecordCount(self.handle)
+
+    def add_watchpoint(self, address: int, size: int,
+                       type: DebugWatchpointType = DebugWatchpointType.WriteWatchpoint, record: bool = False) -> bool:
+        """
+        Add a hardware watchpoint, which triggers when the target accesses the memory at the address
+
+        Watchpoints can only be added while the target is running, and they are removed when it exits. The number of
+        hardware watchpoints is limited, e.g., four on x86, and the address should be aligned to the size.
+
+        When ``record`` is True, the target does not stop at the watchpoint. Every hit is recorded by the debugger core
+        along with the old and new value, and the target is resumed right away, without any stop event being sent. The
+        records are retrieved with ``drain_watchpoint_hits``.
+
+        :param address: the address to watch
+        :param size: the number of bytes to watch, 1, 2, 4 or 8
+        :param type: whether reads, writes, or both trigger the watchpoint
+        :param record: record the hits instead of stopping the target
+        :return: whether the watchpoint is added
+        """
+        return dbgcore.BNDebuggerAddWatchpoint(self.handle, address, size, type, record)
+
+    def delete_watchpoint(self, address: int) -> bool:
+        """
+        Delete the watchpoint at the address
+
+        :param address: the address of the watchpoint
+        :return: False if there is no watchpoint at the address
+        """
+        return dbgcore.BNDebuggerDeleteWatchpoint(self.handle, address)
+
+    @property
+    def watchpoints(self) -> List[DebugWatchpoint]:
+        """
+        The list of watchpoints
+        """
+        count = ctypes.c_ulonglong()
+        watchpoints = dbgcore.BNDebuggerGetWatchpoints(self.handle, count)
+        result = []
+        for i in range(0, count.value):
+            result.append(DebugWatchpoint(watchpoints[i].address, watchpoints[i].size,
+                                          DebugWatchpointType(watchpoints[i].type), watchpoints[i].record,
+                                          watchpoints[i].hitCount))
+
+        dbgcore.BNDebuggerFreeWatchpoints(watchpoints)
+        return result
+
+    def drain_watchpoint_hits(self, max_count: int = 0) -> List[WatchpointHit]:
+        """
+        Remove and return the oldest hits of recording watchpoints, up to ``max_count`` of them, or all of them if it
+        is 0
+
+        :param max_count: the maximum number of hits to return
+        :return: the hits, oldest first
+        """
+        count = ctypes.c_ulonglong()
+        hits = dbgcore.BNDebuggerDrainWatchpointHits(self.handle, max_count, count)
+        result = []
+        for i in range(0, count.value):
+            result.append(WatchpointHit(hits[i].address, hits[i].pc, hits[i].threadId, hits[i].timestamp,
+                                        hits[i].oldValue, hits[i].newValue))
+
+        dbgcore.BNDebuggerFreeWatchpointHits(hits)
+        return result
+
+    @property
+    def dropped_watchpoint_hit_count(self) -> int:
+        """
+        The number of watchpoint hits that were overwritten because the buffer was full before they were drained. The
+        size of the buffer is set by the ``debugger.watchpointBufferSize`` setting.
+        """
+        return dbgcore.BNDebuggerGetDroppedWatchpointHitCount(self.handle)
+
+    def add_coverage(self, functions=None) -> int:
+        """
+        Add basic blocks to the coverage
+
+        Every block start gets a one-shot breakpoint. The first time a block is hit, the debugger core records the hit
+        and removes the breakpoint, and the target is resumed right away without stopping, so each block costs at most
+        one round trip to the backend. Hits accumulate across launches until ``clear_coverage`` is called, and the hit
+        blocks are highlighted in the UI when the target stops or exits.
+
+        :param functions: a function, a function start address, or a list of them. If omitted, all functions of the
+            binary are covered.
+        :return: the number of blocks added
+        """
+        if functions is None:
+            functions = []
+        if not isinstance(functions, list):
+            functions = [functions]
+        starts = [f.start if isinstance(f, binaryninja.Function) else f for f in functions]
+        func_list = (ctypes.c_uint64 * len(starts))(*starts)
+        return dbgcore.BNDebuggerAddCoverage(self.handle, func_list, len(starts))
+
+    def clear_coverage(self) -> None:
+        """
+        Remove all blocks and hits from the coverage, along with the breakpoints of the blocks not hit yet
+        """
+        dbgcore.BNDebuggerClearCoverage(self.handle)
+
+    @property
+    def coverage_block_count(self) -> int:
+        """
+        The number of basic blocks in the coverage
+        """
+        return dbgcore.BNDebuggerGetCoverageBlockCount(self.handle)
+
+    @property
+    def coverage_hit_count(self) -> int:
+        """
+        The number of basic blocks hit so far
+        """
+        return dbgcore.BNDebuggerGetCoverageHitCount(self.handle)
+
+    def get_coverage_hits(self, start: int = 0) -> List[int]:
+        """
+        The start addresses of the blocks hit so far, in the order they were hit
+
+        :param start: skip this many hits, e.g., the number of hits already retrieved
+        :return: a list of addresses in the input view
+        """
+        count = ctypes.c_ulonglong()
+        hits = dbgcore.BNDebuggerGetCoverageHits(self.handle, start, count)
+        result = [hits[i] for i in range(count.value)]
+        dbgcore.BNDebuggerFreeCoverageHits(hits)
+        return result
+
     @property
     def ip(self) -> int:
         """
@@ -1526,6 +1985,44 @@ class DebuggerController:
     def is_ttd(self):
         return dbgcore.BNDebuggerIsTTD(self.handle)
 
+    @property
+    def is_reverse_execution_supported(self) -> bool:
+        """
+        Whether the target can step and run backwards (read-only). This is the case with time travel debugging, and
+        with the execution journal when ``debugger.recordExecution`` is enabled.
+        """
+        return dbgcore.BNDebuggerIsReverseExecutionSupported(self.handle)
+
+    @property
+    def is_image_translated(self) -> bool:
+        """
+        Whether the input view was left at its original base when the target loaded the input file elsewhere. This
+        happens when the ``debugger.translateImageBase`` setting is on. In that case, addresses in the input file differ
+        between the view and the target, and must be converted with ``view_to_live_address`` and
+        ``live_to_view_address``.
+        """
+        return dbgcore.BNDebuggerIsImageTranslated(self.handle)
+
+    def view_to_live_address(self, address: int) -> int:
+        """
+        Converts an address in the input view to the address in the target. Addresses outside the input file are
+        returned as is.
+
+        :param address: the address in the view
+        :return: the address in the target
+        """
+        return dbgcore.BNDebuggerViewToLiveAddress(self.handle, address)
+
+    def live_to_view_address(self, address: int) -> int:
+        """
+        Converts an address in the target, e.g., the IP, to the address in the input view. Addresses outside the input
+        file are returned as is.
+
+        :param address: the address in the target
+        :return: the address in the view
+        """
+        return dbgcore.BNDebuggerLiveToViewAddress(self.handle, address)
+
     def __del__(self):
         if dbgcore is not None:
             dbgcore.BNDebuggerFreeController(self.handle)
@@ -0,0 +1,482 @@
+/*
+Copyright 2020-2024 Vector 35 Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+// Measures the debugger core through the C++ API, against the test binaries, and prints the results as JSON so they
+// can be compared run over run. This is a benchmark, not a unit test.
+//
+// Usage: debugger-benchmark [--binaries <dir>] [--iterations <count>] [--output <file>]
+// By default, it uses the test binaries of the current platform under test/binaries, and 5 iterations.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "binaryninjaapi.h"
+#include "debuggerapi.h"
+#include "fmt/format.h"
+
+using namespace BinaryNinja;
+using namespace BinaryNinjaDebuggerAPI;
+
+// Bump this whenever the meaning of a result changes, so it is not compared to older runs
+static constexpr uint32_t BenchmarkVersion = 1;
+
+#if defined(_WIN32)
+static constexpr auto PlatformName = "Windows";
+#elif defined(__APPLE__)
+static constexpr auto PlatformName = "Darwin";
+#else
+static constexpr auto PlatformName = "Linux";
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64)
+static constexpr auto ArchitectureName = "x86_64";
+#elif defined(__aarch64__) || defined(_M_ARM64)
+static constexpr auto ArchitectureName = "arm64";
+#else
+static constexpr auto ArchitectureName = "x86";
+#endif
+
+// The number of operations timed together as one sample, for the operations that are too fast to time one by one
+static constexpr size_t StepsPerSample = 200;
+static constexpr size_t HitsPerSample = 200;
+static constexpr size_t ScatteredReadsPerSample = 4096;
+static constexpr size_t SequentialReadSize = 0x1000;
+static constexpr size_t MaxSequentialBytes = 0x1000000;
+static constexpr size_t ExtraEventCallbacks = 64;
+
+
+struct BenchmarkResult
+{
+	std::string name;
+	std::string unit;
+	std::vector<double> samples;
+	// Context for the numbers, e.g., the number of threads that were enumerated
+	std::vector<std::pair<std::string, double>> parameters;
+	std::string error;
+};
+
+
+static double ElapsedSeconds(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+
+static double Median(std::vector<double> samples)
+{
+	std::sort(samples.begin(), samples.end());
+	size_t middle = samples.size() / 2;
+	if (samples.size() % 2 == 0)
+		return (samples[middle - 1] + samples[middle]) / 2;
+	return samples[middle];
+}
+
+
+static std::string JsonString(const std::string& value)
+{
+	std::string result = "\"";
+	for (char c : value)
+	{
+		if ((c == '"') || (c == '\\'))
+			result += '\\';
+		if ((unsigned char)c < 0x20)
+			result += fmt::format("\\u{:04x}", (unsigned char)c);
+		else
+			result += c;
+	}
+	return result + "\"";
+}
+
+
+static std::string ToJson(const BenchmarkResult& result)
+{
+	std::string json = fmt::format("{{\"name\": {}", JsonString(result.name));
+	if (!result.error.empty())
+		return json + fmt::format(", \"error\": {}}}", JsonString(result.error));
+
+	json += fmt::format(", \"unit\": {}", JsonString(result.unit));
+	for (const auto& [name, value] : result.parameters)
+		json += fmt::format(", {}: {:.3f}", JsonString(name), value);
+	if (!result.samples.empty())
+	{
+		json += fmt::format(", \"min\": {:.3f}, \"median\": {:.3f}, \"max\": {:.3f}",
+			*std::min_element(result.samples.begin(), result.samples.end()), Median(result.samples),
+			*std::max_element(result.samples.begin(), result.samples.end()));
+	}
+	json += ", \"samples\": [";
+	for (size_t i = 0; i < result.samples.size(); i++)
+		json += fmt::format("{}{:.3f}", (i == 0) ? "" : ", ", result.samples[i]);
+	return json + "]}";
+}
+
+
+// A target that is loaded and analyzed once, and launched by every benchmark that uses it
+class Target
+{
+	Ref<BinaryView> m_view;
+	DbgRef<DebuggerController> m_controller;
+
+public:
+	bool Load(const std::string& path)
+	{
+		m_view = BinaryNinja::Load(path);
+		if (!m_view)
+			return false;
+		m_controller = DebuggerController::GetController(m_view);
+		return m_controller;
+	}
+
+	~Target()
+	{
+		if (m_controller)
+		{
+			if (m_controller->IsConnected())
+				m_controller->QuitAndWait();
+			m_controller->Destroy();
+		}
+		if (m_view)
+			m_view->GetFile()->Close();
+	}
+
+	DbgRef<DebuggerController> Controller() const { return m_controller; }
+
+	bool Launch(const std::string& arguments = "")
+	{
+		m_controller->SetCommandLineArguments(arguments);
+		auto reason = m_controller->LaunchAndWait();
+		return (reason != ProcessExited) && (reason != InternalError) && m_controller->IsConnected();
+	}
+
+	bool FindFunction(const std::string& name, ModuleNameAndOffset& location) const
+	{
+		// Mach-O symbols carry a leading underscore
+		for (const auto& candidate : {name, "_" + name})
+		{
+			for (const auto& symbol : m_view->GetSymbolsByName(candidate))
+			{
+				if (symbol->GetType() != FunctionSymbol)
+					continue;
+				location.module = m_view->GetFile()->GetOriginalFilename();
+				location.offset = symbol->GetAddress() - m_view->GetStart();
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool FindMainModule(DebugModule& module) const
+	{
+		for (const auto& candidate : m_controller->GetModules())
+		{
+			if (candidate.IsSameBaseModule(m_view->GetFile()->GetOriginalFilename()))
+			{
+				module = candidate;
+				return true;
+			}
+		}
+		return false;
+	}
+};
+
+
+static BenchmarkResult LaunchToFirstStop(const std::string& path, size_t iterations)
+{
+	BenchmarkResult result {"launch_to_first_stop", "ms"};
+	Target target;
+	if (!target.Load(path))
+	{
+		result.error = "failed to load " + path;
+		return result;
+	}
+
+	for (size_t i = 0; i < iterations; i++)
+	{
+		auto start = std::chrono::steady_clock::now();
+		if (!target.Launch())
+		{
+			result.error = "failed to launch the target";
+			return result;
+		}
+		result.samples.push_back(ElapsedSeconds(start) * 1000);
+		target.Controller()->QuitAndWait();
+	}
+	return result;
+}
+
+
+static BenchmarkResult SingleStepRate(const std::string& path, size_t iterations)
+{
+	BenchmarkResult result {"single_step_rate", "steps/s"};
+	Target target;
+	if (!target.Load(path) || !target.Launch())
+	{
+		result.error = "failed to launch " + path;
+		return result;
+	}
+
+	auto controller = target.Controller();
+	for (size_t i = 0; i < iterations; i++)
+	{
+		auto start = std::chrono::steady_clock::now();
+		for (size_t step = 0; step < StepsPerSample; step++)
+		{
+			if (controller->StepIntoAndWait() == ProcessExited)
+			{
+				result.error = "the target exited while stepping";
+				return result;
+			}
+		}
+		result.samples.push_back(StepsPerSample / ElapsedSeconds(start));
+	}
+	return result;
+}
+
+
+static BenchmarkResult BreakpointHitRate(const std::string& path, size_t iterations)
+{
+	BenchmarkResult result {"breakpoint_hit_rate", "hits/s"};
+	Target target;
+	ModuleNameAndOffset fib;
+	if (!target.Load(path) || !target.FindFunction("fib", fib))
+	{
+		result.error = "failed to find fib() in " + path;
+		return result;
+	}
+
+	// fib(25) calls itself a quarter million times, which is more than enough hits
+	auto controller = target.Controller();
+	controller->AddBreakpoint(fib);
+	if (!target.Launch("25"))
+	{
+		controller->DeleteBreakpoint(fib);
+		result.error = "failed to launch " + path;
+		return result;
+	}
+
+	for (size_t i = 0; (i < iterations) && result.error.empty(); i++)
+	{
+		auto start = std::chrono::steady_clock::now();
+		for (size_t hit = 0; hit < HitsPerSample; hit++)
+		{
+			if (controller->GoAndWait() != Breakpoint)
+			{
+				result.error = "the target stopped for a reason other than the breakpoint";
+				break;
+			}
+		}
+		if (result.error.empty())
+			result.samples.push_back(HitsPerSample / ElapsedSeconds(start));
+	}
+
+	controller->DeleteBreakpoint(fib);
+	return result;
+}
+
+
+static std::vector<BenchmarkResult> MemoryReadThroughput(const std::string& path, size_t iterations)
+{
+	BenchmarkResult sequential {"sequential_read_throughput", "MB/s"};
+	BenchmarkResult scattered {"scattered_read_rate", "reads/s"};
+	Target target;
+	DebugModule module;
+	if (!target.Load(path) || !target.Launch() || !target.FindMainModule(module) || (module.m_size == 0))
+	{
+		sequential.error = scattered.error = "failed to launch " + path;
+		return {sequential, scattered};
+	}
+
+	auto controller = target.Controller();
+	size_t length = std::min<size_t>(module.m_size, MaxSequentialBytes);
+	sequential.parameters.emplace_back("bytes", (double)length);
+	scattered.parameters.emplace_back("read_size", 8);
+
+	// The memory cache is dropped whenever the target stops, so every sample steps once first to read it cold. The
+	// offsets of the scattered reads come from a fixed seed, so every run reads the same addresses.
+	uint64_t seed = 0x9e3779b97f4a7c15;
+	for (size_t i = 0; i < iterations; i++)
+	{
+		controller->StepIntoAndWait();
+		auto start = std::chrono::steady_clock::now();
+		size_t bytesRead = 0;
+		for (size_t offset = 0; offset < length; offset += SequentialReadSize)
+			bytesRead += controller->ReadMemory(module.m_address + offset, SequentialReadSize).GetLength();
+		sequential.samples.push_back(bytesRead / ElapsedSeconds(start) / (1024 * 1024));
+
+		controller->StepIntoAndWait();
+		start = std::chrono::steady_clock::now();
+		for (size_t read = 0; read < ScatteredReadsPerSample; read++)
+		{
+			seed ^= seed << 13;
+			seed ^= seed >> 7;
+			seed ^= seed << 17;
+			controller->ReadMemory(module.m_address + (seed % (length - 8)), 8);
+		}
+		scattered.samples.push_back(ScatteredReadsPerSample / ElapsedSeconds(start));
+	}
+	return {sequential, scattered};
+}
+
+
+static BenchmarkResult ThreadAndFrameEnumeration(const std::string& path, size_t iterations)
+{
+	BenchmarkResult result {"thread_and_frame_enumeration", "ms"};
+	Target target;
+	if (!target.Load(path) || !target.Launch())
+	{
+		result.error = "failed to launch " + path;
+		return result;
+	}
+
+	// The threads and frames are cached until the target resumes, so it runs for a while before every sample
+	auto controller = target.Controller();
+	size_t threadCount = 0;
+	size_t frameCount = 0;
+	for (size_t i = 0; i < iterations; i++)
+	{
+		controller->Go();
+		std::this_thread::sleep_for(std::chrono::milliseconds(200));
+		if (controller->PauseAndWait() == ProcessExited)
+		{
+			result.error = "the target exited before it was paused";
+			return result;
+		}
+
+		auto start = std::chrono::steady_clock::now();
+		auto threads = controller->GetThreads();
+		frameCount = 0;
+		for (const auto& thread : threads)
+			frameCount += controller->GetFramesOfThread(thread.m_tid).size();
+		result.samples.push_back(ElapsedSeconds(start) * 1000);
+		threadCount = threads.size();
+	}
+
+	result.parameters.emplace_back("threads", (double)threadCount);
+	result.parameters.emplace_back("frames", (double)frameCount);
+	return result;
+}
+
+
+static BenchmarkResult EventDispatchOverhead(const std::string& path, size_t iterations)
+{
+	BenchmarkResult result {"event_dispatch_overhead", "us/callback"};
+	Target target;
+	if (!target.Load(path) || !target.Launch())
+	{
+		result.error = "failed to launch " + path;
+		return result;
+	}
+
+	// Every step dispatches a handful of events to every callback. The overhead is the difference of the time of a
+	// step with and without extra callbacks that do nothing.
+	auto controller = target.Controller();
+	auto timeStep = [&]() {
+		auto start = std::chrono::steady_clock::now();
+		for (size_t step = 0; step < StepsPerSample; step++)
+			controller->StepIntoAndWait();
+		return ElapsedSeconds(start) / StepsPerSample;
+	};
+
+	for (size_t i = 0; i < iterations; i++)
+	{
+		double baseline = timeStep();
+
+		std::vector<size_t> callbacks;
+		for (size_t j = 0; j < ExtraEventCallbacks; j++)
+			callbacks.push_back(controller->RegisterEventCallback([](const DebuggerEvent&) {}, "Benchmark"));
+		double loaded = timeStep();
+		for (size_t callback : callbacks)
+			controller->RemoveEventCallback(callback);
+
+		result.samples.push_back((loaded - baseline) / ExtraEventCallbacks * 1000000);
+	}
+
+	result.parameters.emplace_back("callbacks", ExtraEventCallbacks);
+	return result;
+}
+
+
+int main(int argc, const char* argv[])
+{
+	std::string binaries = fmt::format("binaries/{}-{}", PlatformName, ArchitectureName);
+	size_t iterations = 5;
+	std::string outputPath;
+	for (int i = 1; i + 1 < argc; i += 2)
+	{
+		if (strcmp(argv[i], "--binaries") == 0)
+			binaries = argv[i + 1];
+		else if (strcmp(argv[i], "--iterations") == 0)
+			iterations = std::max(std::stoul(argv[i + 1]), 1UL);
+		else if (strcmp(argv[i], "--output") == 0)
+			outputPath = argv[i + 1];
+	}
+	if (argc % 2 == 0)
+	{
+		fprintf(stderr, "usage: %s [--binaries <dir>] [--iterations <count>] [--output <file>]\n", argv[0]);
+		return -1;
+	}
+
+	LogToStderr(WarningLog);
+	SetBundledPluginDirectory(GetBundledPluginDirectory());
+	InitPlugins();
+
+	auto binary = [&](const std::string& name) {
+		std::string path = (std::filesystem::path(binaries) / name).string();
+#ifdef _WIN32
+		path += ".exe";
+#endif
+		return path;
+	};
+
+	std::vector<BenchmarkResult> results;
+	results.push_back(LaunchToFirstStop(binary("helloworld"), iterations));
+	results.push_back(SingleStepRate(binary("helloworld_recursion"), iterations));
+	results.push_back(BreakpointHitRate(binary("helloworld_recursion"), iterations));
+	for (auto& result : MemoryReadThroughput(binary("helloworld_loop"), iterations))
+		results.push_back(std::move(result));
+	results.push_back(ThreadAndFrameEnumeration(binary("helloworld_thread"), iterations));
+	results.push_back(EventDispatchOverhead(binary("helloworld_recursion"), iterations));
+
+	std::string json = fmt::format(
+		"{{\n\t\"version\": {},\n\t\"platform\": \"{}-{}\",\n\t\"iterations\": {},\n\t\"results\": [\n",
+		BenchmarkVersion, PlatformName, ArchitectureName, iterations);
+	for (size_t i = 0; i < results.size(); i++)
+		json += fmt::format("\t\t{}{}\n", ToJson(results[i]), (i + 1 < results.size()) ? "," : "");
+	json += "\t]\n}\n";
+
+	FILE* file = stdout;
+	if (!outputPath.empty())
+	{
+		file = fopen(outputPath.c_str(), "w");
+		if (!file)
+		{
+			fprintf(stderr, "Could not open the output %s\n", outputPath.c_str());
+			return -1;
+		}
+	}
+	fmt::print(file, "{}", json);
+	if (file != stdout)
+		fclose(file);
+
+	BNShutdown();
+	return 0;
+}
@@ -0,0 +1,413 @@
+/*
+Copyright 2020-2024 Vector 35 Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "batch.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+#include "fmt/format.h"
+
+using namespace BinaryNinja;
+using namespace BinaryNinjaDebuggerAPI;
+
+
+static std::string JsonString(const std::string& value)
+{
+	std::string result = "\"";
+	for (char c : value)
+	{
+		switch (c)
+		{
+		case '"':
+			result += "\\\"";
+			break;
+		case '\\':
+			result += "\\\\";
+			break;
+		case '\n':
+			result += "\\n";
+			break;
+		case '\r':
+			result += "\\r";
+			break;
+		case '\t':
+			result += "\\t";
+			break;
+		default:
+			if ((unsigned char)c < 0x20)
+				result += fmt::format("\\u{:04x}", (unsigned char)c);
+			else
+				result += c;
+			break;
+		}
+	}
+	result += "\"";
+	return result;
+}
+
+
+// A JSON object whose fields are appended in order. Addresses and register values are written as hex strings, since
+// many JSON parsers cannot hold a 64-bit integer.
+class JsonObject
+{
+	std::string m_text;
+
+	JsonObject& Field(const std::string& key, const std::string& json)
+	{
+		if (!m_text.empty())
+			m_text += ",";
+		m_text += JsonString(key) + ":" + json;
+		return *this;
+	}
+
+public:
+	JsonObject() = default;
+	JsonObject(const std::string& type) { String("type", type); }
+
+	JsonObject& String(const std::string& key, const std::string& value) { return Field(key, JsonString(value)); }
+	JsonObject& Number(const std::string& key, uint64_t value) { return Field(key, std::to_string(value)); }
+	JsonObject& Address(const std::string& key, uint64_t value) { return Field(key, fmt::format("\"0x{:x}\"", value)); }
+	JsonObject& Bool(const std::string& key, bool value) { return Field(key, value ? "true" : "false"); }
+	JsonObject& Array(const std::string& key, const std::vector<JsonObject>& items)
+	{
+		std::string json = "[";
+		for (size_t i = 0; i < items.size(); i++)
+		{
+			if (i != 0)
+				json += ",";
+			json += items[i].ToString();
+		}
+		json += "]";
+		return Field(key, json);
+	}
+
+	std::string ToString() const { return "{" + m_text + "}"; }
+};
+
+
+// Writes one record per line. The target output arrives on the event thread, so writes are serialized.
+class RecordWriter
+{
+	std::mutex m_mutex;
+	FILE* m_file;
+	size_t m_target = 0;
+
+public:
+	RecordWriter(FILE* file) : m_file(file) {}
+
+	void SetTarget(size_t target)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_target = target;
+	}
+
+	void Write(JsonObject& record)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		record.Number("target", m_target);
+		fmt::print(m_file, "{}\n", record.ToString());
+		fflush(m_file);
+	}
+
+	void WriteError(const std::string& command, const std::string& message)
+	{
+		JsonObject record("error");
+		record.String("command", command).String("message", message);
+		Write(record);
+	}
+};
+
+
+static void WriteStop(DbgRef<DebuggerController> debugger, RecordWriter& writer, DebugStopReason reason)
+{
+	JsonObject record("stop");
+	record.String("reason", DebuggerController::GetDebugStopReasonString(reason));
+	if (reason == ProcessExited)
+		record.Number("exit_code", debugger->GetExitCode());
+	else if (debugger->IsConnected())
+		record.Number("thread", debugger->GetActiveThread().m_tid).Address("ip", debugger->IP());
+	writer.Write(record);
+}
+
+
+static void WriteRegisters(DbgRef<DebuggerController> debugger, RecordWriter& writer)
+{
+	std::vector<JsonObject> registers;
+	for (const auto& reg : debugger->GetRegisters(false))
+	{
+		JsonObject entry;
+		entry.String("name", reg.m_name).Address("value", reg.m_value).Number("width", reg.m_width);
+		registers.push_back(std::move(entry));
+	}
+
+	JsonObject record("registers");
+	record.Array("registers", registers);
+	writer.Write(record);
+}
+
+
+static void WriteModules(DbgRef<DebuggerController> debugger, RecordWriter& writer)
+{
+	std::vector<JsonObject> modules;
+	for (const auto& module : debugger->GetModules())
+	{
+		JsonObject entry;
+		entry.String("name", module.m_name)
+			.String("short_name", module.m_short_name)
+			.Address("address", module.m_address)
+			.Number("size", module.m_size)
+			.Bool("loaded", module.m_loaded);
+		modules.push_back(std::move(entry));
+	}
+
+	JsonObject record("modules");
+	record.Array("modules", modules);
+	writer.Write(record);
+}
+
+
+static void WriteThreads(DbgRef<DebuggerController> debugger, RecordWriter& writer)
+{
+	std::vector<JsonObject> threads;
+	for (const auto& thread : debugger->GetThreads())
+	{
+		JsonObject entry;
+		entry.Number("tid", thread.m_tid).Address("ip", thread.m_rip).Bool("frozen", thread.m_isFrozen);
+		threads.push_back(std::move(entry));
+	}
+
+	JsonObject record("threads");
+	record.Number("active", debugger->GetActiveThread().m_tid).Array("threads", threads);
+	writer.Write(record);
+}
+
+
+static void WriteFrames(DbgRef<DebuggerController> debugger, RecordWriter& writer, uint32_t tid)
+{
+	std::vector<JsonObject> frames;
+	for (const auto& frame : debugger->GetFramesOfThread(tid))
+	{
+		JsonObject entry;
+		entry.Number("index", frame.m_index)
+			.Address("pc", frame.m_pc)
+			.Address("sp", frame.m_sp)
+			.Address("fp", frame.m_fp)
+			.String("function", frame.m_functionName)
+			.Address("function_start", frame.m_functionStart)
+			.String("module", frame.m_module);
+		frames.push_back(std::move(entry));
+	}
+
+	JsonObject record("frames");
+	record.Number("tid", tid).Array("frames", frames);
+	writer.Write(record);
+}
+
+
+static void WriteBreakpoints(DbgRef<DebuggerController> debugger, RecordWriter& writer)
+{
+	std::vector<JsonObject> breakpoints;
+	for (const auto& breakpoint : debugger->GetBreakpoints())
+	{
+		JsonObject entry;
+		entry.Address("address", breakpoint.address)
+			.String("module", breakpoint.module)
+			.Address("offset", breakpoint.offset)
+			.Bool("enabled", breakpoint.enabled);
+		breakpoints.push_back(std::move(entry));
+	}
+
+	JsonObject record("breakpoints");
+	record.Array("breakpoints", breakpoints);
+	writer.Write(record);
+}
+
+
+// Runs one line of the script. The commands are the ones of the interactive mode, minus the ones that only make sense
+// to a human, plus "bt [tid]" for the stack frames. Throws std::invalid_argument or std::out_of_range if an argument
+// cannot be parsed.
+static void RunCommand(DbgRef<DebuggerController> debugger, RecordWriter& writer, const std::string& line)
+{
+	if (line[0] == '.')
+	{
+		JsonObject record("backend");
+		record.String("command", line.substr(1)).String("output", debugger->InvokeBackendCommand(line.substr(1)));
+		writer.Write(record);
+		return;
+	}
+
+	std::string command = line;
+	std::string argument;
+	if (auto pos = line.find(' '); pos != std::string::npos)
+	{
+		command = line.substr(0, pos);
+		argument = line.substr(pos + 1);
+	}
+
+	if (command == "reg")
+		WriteRegisters(debugger, writer);
+	else if (command == "lm")
+		WriteModules(debugger, writer);
+	else if (command == "lt")
+		WriteThreads(debugger, writer);
+	else if (command == "bt")
+		WriteFrames(debugger, writer,
+			argument.empty() ? debugger->GetActiveThread().m_tid : (uint32_t)std::stoul(argument, nullptr, 10));
+	else if (command == "lbp")
+		WriteBreakpoints(debugger, writer);
+	else if (command == "sr")
+		WriteStop(debugger, writer, debugger->StopReason());
+	else if (command == "es")
+	{
+		JsonObject record("status");
+		record.Number("status", debugger->GetTargetStatus());
+		writer.Write(record);
+	}
+	else if (command == "bp")
+		debugger->AddBreakpoint(std::stoull(argument, nullptr, 16));
+	else if (command == "bpr")
+		debugger->DeleteBreakpoint(std::stoull(argument, nullptr, 16));
+	else if (command == "ts")
+		debugger->SetActiveThread(DebugThread((uint32_t)std::stoul(argument, nullptr, 10)));
+	else if (command == "c")
+		WriteStop(debugger, writer, debugger->GoAndWait());
+	else if (command == "ni")
+		WriteStop(debugger, writer, debugger->StepOverAndWait());
+	else if (command == "si")
+		WriteStop(debugger, writer, debugger->StepIntoAndWait());
+	else if ((command == "finish") || (command == "sot"))
+		WriteStop(debugger, writer, debugger->StepReturnAndWait());
+	else if (command == "st")
+		WriteStop(debugger, writer, debugger->RunToAndWait(std::stoull(argument, nullptr, 16)));
+	else if (command == "kill")
+		debugger->QuitAndWait();
+	else if (command == "detach")
+		debugger->Detach();
+	else
+		writer.WriteError(line, "unknown command");
+}
+
+
+static bool ReadLines(std::istream& stream, std::vector<std::string>& lines)
+{
+	std::string line;
+	while (std::getline(stream, line))
+	{
+		if (!line.empty() && (line.back() == '\r'))
+			line.pop_back();
+		// Blank lines and comments are skipped
+		if (line.empty() || (line[0] == '#'))
+			continue;
+		lines.push_back(line);
+	}
+	return !stream.bad();
+}
+
+
+static bool ReadLines(const std::string& path, std::vector<std::string>& lines)
+{
+	if (path == "-")
+		return ReadLines(std::cin, lines);
+
+	std::ifstream file(path);
+	if (!file)
+		return false;
+	return ReadLines(file, lines);
+}
+
+
+int RunBatch(DbgRef<DebuggerController> debugger, const BatchOptions& options)
+{
+	// The script is read in full first, since it is run once per target
+	std::vector<std::string> commands;
+	if (!ReadLines(options.scriptPath, commands))
+	{
+		fmt::print(stderr, "Could not read the script {}\n", options.scriptPath);
+		return -1;
+	}
+
+	std::vector<std::string> targets;
+	if (options.targetsPath.empty())
+		targets.push_back(debugger->GetCommandLineArguments());
+	else if (!ReadLines(options.targetsPath, targets))
+	{
+		fmt::print(stderr, "Could not read the targets {}\n", options.targetsPath);
+		return -1;
+	}
+
+	FILE* file = stdout;
+	if (!options.outputPath.empty())
+	{
+		file = fopen(options.outputPath.c_str(), "w");
+		if (!file)
+		{
+			fmt::print(stderr, "Could not open the output {}\n", options.outputPath);
+			return -1;
+		}
+	}
+
+	RecordWriter writer(file);
+	size_t callback = debugger->RegisterEventCallback(
+		[&](const DebuggerEvent& event) {
+			if (event.type != StdoutMessageEventType)
+				return;
+			JsonObject record("stdout");
+			record.String("text", event.data.messageData.message);
+			writer.Write(record);
+		},
+		"Batch Output");
+
+	for (size_t i = 0; i < targets.size(); i++)
+	{
+		writer.SetTarget(i);
+		debugger->SetCommandLineArguments(targets[i]);
+
+		JsonObject record("launch");
+		record.String("arguments", targets[i]);
+		writer.Write(record);
+
+		WriteStop(debugger, writer, debugger->LaunchAndWait());
+
+		// Once the target is gone, the rest of the script has nothing to act on
+		for (const auto& command : commands)
+		{
+			if (!debugger->IsConnected())
+				break;
+			try
+			{
+				RunCommand(debugger, writer, command);
+			}
+			catch (const std::exception&)
+			{
+				writer.WriteError(command, "invalid argument");
+			}
+		}
+
+		if (debugger->IsConnected())
+			debugger->QuitAndWait();
+
+		JsonObject end("end");
+		writer.Write(end);
+	}
+
+	debugger->RemoveEventCallback(callback);
+	if (file != stdout)
+		fclose(file);
+	return 0;
+}
@@ -0,0 +1,36 @@
+/*
+Copyright 2020-2024 Vector 35 Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <string>
+#include "debuggerapi.h"
+
+struct BatchOptions
+{
+	// The commands to run against every target, or "-" to read them from stdin
+	std::string scriptPath;
+	// One line of command line arguments per target. If empty, the script is run against a single target, launched
+	// with the arguments already set on the controller.
+	std::string targetsPath;
+	// Where the records are written. If empty, they go to stdout.
+	std::string outputPath;
+};
+
+// Runs the commands of the script against every target in turn, and writes the result of each command as a line of
+// JSON. All targets are launched from the same controller, so the input file is only loaded and analyzed once.
+int RunBatch(BinaryNinjaDebuggerAPI::DbgRef<BinaryNinjaDebuggerAPI::DebuggerController> debugger,
+	const BatchOptions& options);
@@ -29,6 +29,7 @@ limitations under the License.
 #include "highlevelilinstruction.h"
 #include "debuggerapi.h"
 #include "log.h"
+#include "batch.h"
 #include "fmt/format.h"
 
 using namespace BinaryNinja;
@@ -320,14 +321,36 @@ void PrintStopReason(DbgRef<DebuggerController> controller, DebugStopReason reas
 
 int main(int argc, const char* argv[])
 {
+	// In batch mode, stdout only carries the records, so the log goes to stderr
+	bool batch = (argc >= 4) && (strcmp(argv[2], "--batch") == 0);
+	BatchOptions batchOptions;
+	if (batch)
+	{
+		batchOptions.scriptPath = argv[3];
+		for (int i = 4; i < argc; i += 2)
+		{
+			if ((i + 1 < argc) && (strcmp(argv[i], "--targets") == 0))
+				batchOptions.targetsPath = argv[i + 1];
+			else if ((i + 1 < argc) && (strcmp(argv[i], "--output") == 0))
+				batchOptions.outputPath = argv[i + 1];
+			else
+				batch = false;
+		}
+	}
+
 	Log::SetupAnsi();
-	LogToStdout(WarningLog);
+	if (batch)
+		LogToStderr(WarningLog);
+	else
+		LogToStdout(WarningLog);
 
-	if (argc != 2 && argc != 4)
+	if (!batch && argc != 2 && argc != 4)
 	{
 		Log::print<Log::Error>("usage: {} <debuggee_path>\n", argv[0]);
 		Log::print<Log::Error>("usage: {} <debuggee_path> --attach <debuggee_pid>\n", argv[0]);
 		Log::print<Log::Error>("usage: {} <debuggee_path> --connect <host:port>\n", argv[0]);
+		Log::print<Log::Error>(
+			"usage: {} <debuggee_path> --batch <script|-> [--targets <file>] [--output <file>]\n", argv[0]);
 		return 0;
 	}
 
@@ -374,6 +397,14 @@ int main(int argc, const char* argv[])
 	if (!debugger)
 		LogError("Failed to create a debugger for the BinaryView\n");
 
+	if (batch)
+	{
+		debugger->SetExecutablePath(argv[1]);
+		int result = RunBatch(debugger, batchOptions);
+		BNShutdown();
+		return result;
+	}
+
 	if (argc == 2)
 	{
 		debugger->SetExecutablePath(argv[1]);
@@ -0,0 +1,865 @@
+/*
+Copyright 2020-2024 Vector 35 Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <map>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "elfcorefile.h"
+
+using namespace BinaryNinjaDebugger;
+using namespace std;
+
+// The layouts below are spelled out rather than taken from <elf.h>/<sys/procfs.h>, since the host we run on is not
+// necessarily the architecture the core was dumped on. Only 64-bit little-endian cores are handled for now.
+static constexpr uint8_t ELF_CLASS_64 = 2;
+static constexpr uint8_t ELF_DATA_2LSB = 1;
+static constexpr uint16_t ELF_TYPE_CORE = 4;
+static constexpr uint16_t ELF_MACHINE_X86_64 = 62;
+static constexpr uint16_t ELF_MACHINE_AARCH64 = 183;
+static constexpr uint32_t PT_LOAD_TYPE = 1;
+static constexpr uint32_t PT_NOTE_TYPE = 4;
+static constexpr uint32_t NT_PRSTATUS_TYPE = 1;
+static constexpr uint32_t NT_PRPSINFO_TYPE = 3;
+static constexpr uint32_t NT_FILE_TYPE = 0x46494c45;
+
+// struct elf_prstatus: siginfo (12) + pr_cursig (2) + padding (2) + pr_sigpend (8) + pr_sighold (8) + pr_pid,
+// pr_ppid, pr_pgrp, pr_sid (4 * 4) + four timevals (4 * 16), followed by pr_reg
+static constexpr size_t PRSTATUS_CURSIG_OFFSET = 12;
+static constexpr size_t PRSTATUS_PID_OFFSET = 32;
+static constexpr size_t PRSTATUS_REGS_OFFSET = 112;
+// struct elf_prpsinfo: pr_fname is 16 bytes at offset 40 on both x86_64 and aarch64
+static constexpr size_t PRPSINFO_FNAME_OFFSET = 40;
+static constexpr size_t PRPSINFO_FNAME_SIZE = 16;
+
+// Order of struct user_regs_struct on x86_64
+static const char* g_x86_64RegisterNames[] = {"r15", "r14", "r13", "r12", "rbp", "rbx", "r11", "r10", "r9",
+	"r8", "rax", "rcx", "rdx", "rsi", "rdi", "orig_rax", "rip", "cs", "rflags", "rsp", "ss", "fsbase", "gsbase", "ds",
+	"es", "fs", "gs"};
+
+// Order of struct user_pt_regs on aarch64
+static const char* g_aarch64RegisterNames[] = {"x0", "x1", "x2", "x3", "x4", "x5", "x6", "x7", "x8", "x9", "x10",
+	"x11", "x12", "x13", "x14", "x15", "x16", "x17", "x18", "x19", "x20", "x21", "x22", "x23", "x24", "x25", "x26",
+	"x27", "x28", "x29", "x30", "sp", "pc", "cpsr"};
+
+
+template <typename T>
+static T ReadValue(const uint8_t* data)
+{
+	T value;
+	memcpy(&value, data, sizeof(T));
+	return value;
+}
+
+
+static uint64_t AlignUp4(uint64_t value)
+{
+	return (value + 3) & ~(uint64_t)3;
+}
+
+
+static DebugStopReason GetStopReasonFromLinuxSignal(int signal)
+{
+	// Signal numbers as defined by the Linux kernel, which differ from the BSD/macOS ones for a few signals
+	static const std::unordered_map<int, DebugStopReason> signalLookup = {
+		{1, DebugStopReason::SignalHup},
+		{2, DebugStopReason::SignalInt},
+		{3, DebugStopReason::SignalQuit},
+		{4, DebugStopReason::SignalIll},
+		{5, DebugStopReason::Breakpoint},
+		{6, DebugStopReason::SignalAbrt},
+		{7, DebugStopReason::SignalBus},
+		{8, DebugStopReason::SignalFpe},
+		{9, DebugStopReason::SignalKill},
+		{10, DebugStopReason::SignalUsr1},
+		{11, DebugStopReason::SignalSegv},
+		{12, DebugStopReason::SignalUsr2},
+		{13, DebugStopReason::SignalPipe},
+		{14, DebugStopReason::SignalAlrm},
+		{15, DebugStopReason::SignalTerm},
+		{16, DebugStopReason::SignalStkflt},
+		{17, DebugStopReason::SignalChld},
+		{18, DebugStopReason::SignalCont},
+		{19, DebugStopReason::SignalStop},
+		{20, DebugStopReason::SignalTstp},
+		{21, DebugStopReason::SignalTtin},
+		{22, DebugStopReason::SignalTtou},
+		{23, DebugStopReason::SignalUrg},
+		{24, DebugStopReason::SignalXcpu},
+		{25, DebugStopReason::SignalXfsz},
+		{26, DebugStopReason::SignalVtalrm},
+		{27, DebugStopReason::SignalProf},
+		{28, DebugStopReason::SignalWinch},
+		{29, DebugStopReason::SignalPoll},
+		{31, DebugStopReason::SignalSys},
+	};
+
+	if (auto iter = signalLookup.find(signal); iter != signalLookup.end())
+		return iter->second;
+
+	return DebugStopReason::UnknownReason;
+}
+
+
+ElfCoreFileAdapter::ElfCoreFileAdapter(BinaryView* data) : DebugAdapter(data) {}
+
+
+ElfCoreFileAdapter::~ElfCoreFileAdapter()
+{
+	CloseCoreFile();
+}
+
+
+bool ElfCoreFileAdapter::OpenCoreFile(const std::string& path)
+{
+	CloseCoreFile();
+
+	m_fd = open(path.c_str(), O_RDONLY);
+	if (m_fd < 0)
+	{
+		LogWarn("Failed to open core file %s: %s", path.c_str(), strerror(errno));
+		return false;
+	}
+
+	struct stat st;
+	if ((fstat(m_fd, &st) != 0) || (st.st_size < 64))
+	{
+		LogWarn("Core file %s is too small to be an ELF file", path.c_str());
+		CloseCoreFile();
+		return false;
+	}
+
+	// Map the whole file but let the kernel page it in on demand. Nothing below walks the PT_LOAD contents, so the
+	// cost of opening the core is proportional to the number of program headers and notes, not the file size.
+	m_mappingSize = (size_t)st.st_size;
+	void* mapping = mmap(nullptr, m_mappingSize, PROT_READ, MAP_PRIVATE, m_fd, 0);
+	if (mapping == MAP_FAILED)
+	{
+		LogWarn("Failed to map core file %s: %s", path.c_str(), strerror(errno));
+		m_mappingSize = 0;
+		CloseCoreFile();
+		return false;
+	}
+	m_mapping = (uint8_t*)mapping;
+	// Memory reads jump around the address space, so read-ahead would mostly pull in pages nobody asked for
+	madvise(m_mapping, m_mappingSize, MADV_RANDOM);
+
+	if (memcmp(m_mapping, "\x7f" "ELF", 4) != 0 || m_mapping[4] != ELF_CLASS_64 || m_mapping[5] != ELF_DATA_2LSB)
+	{
+		LogWarn("%s is not a 64-bit little-endian ELF file", path.c_str());
+		CloseCoreFile();
+		return false;
+	}
+
+	if (ReadValue<uint16_t>(m_mapping + 16) != ELF_TYPE_CORE)
+	{
+		LogWarn("%s is not an ELF core file", path.c_str());
+		CloseCoreFile();
+		return false;
+	}
+
+	switch (ReadValue<uint16_t>(m_mapping + 18))
+	{
+	case ELF_MACHINE_X86_64:
+		m_architecture = "x86_64";
+		break;
+	case ELF_MACHINE_AARCH64:
+		m_architecture = "aarch64";
+		break;
+	default:
+		LogWarn("Unsupported machine type 0x%x in core file %s", ReadValue<uint16_t>(m_mapping + 18), path.c_str());
+		CloseCoreFile();
+		return false;
+	}
+
+	const uint64_t programHeaderOffset = ReadValue<uint64_t>(m_mapping + 32);
+	const uint16_t programHeaderSize = ReadValue<uint16_t>(m_mapping + 54);
+	const uint16_t programHeaderCount = ReadValue<uint16_t>(m_mapping + 56);
+	if ((programHeaderSize < 56) || (programHeaderOffset > m_mappingSize)
+		|| ((uint64_t)programHeaderSize * programHeaderCount > m_mappingSize - programHeaderOffset))
+	{
+		LogWarn("Core file %s has a truncated program header table", path.c_str());
+		CloseCoreFile();
+		return false;
+	}
+
+	for (size_t i = 0; i < programHeaderCount; i++)
+	{
+		const uint8_t* header = m_mapping + programHeaderOffset + i * programHeaderSize;
+		const uint32_t type = ReadValue<uint32_t>(header);
+		const uint64_t offset = ReadValue<uint64_t>(header + 8);
+		const uint64_t address = ReadValue<uint64_t>(header + 16);
+		const uint64_t fileSize = ReadValue<uint64_t>(header + 32);
+		const uint64_t memorySize = ReadValue<uint64_t>(header + 40);
+
+		if (type == PT_LOAD_TYPE)
+		{
+			if (memorySize == 0)
+				continue;
+
+			CoreSegment segment;
+			segment.address = address;
+			segment.memorySize = memorySize;
+			segment.fileOffset = offset;
+			// Cores written by a crashing process can be cut short, e.g., by a ulimit. Treat whatever is missing
+			// from the file as unreadable rather than reading past the end of the mapping.
+			if (offset >= m_mappingSize)
+				segment.fileSize = 0;
+			else
+				segment.fileSize = std::min(fileSize, m_mappingSize - offset);
+			m_segments.push_back(segment);
+		}
+		else if (type == PT_NOTE_TYPE)
+		{
+			if ((offset > m_mappingSize) || (fileSize > m_mappingSize - offset))
+			{
+				LogWarn("Core file %s has a truncated PT_NOTE segment", path.c_str());
+				continue;
+			}
+			ParseNotes(offset, fileSize);
+		}
+	}
+
+	std::sort(m_segments.begin(), m_segments.end(),
+		[](const CoreSegment& a, const CoreSegment& b) { return a.address < b.address; });
+
+	if (m_threads.empty())
+	{
+		LogWarn("Core file %s does not contain any NT_PRSTATUS note", path.c_str());
+		CloseCoreFile();
+		return false;
+	}
+
+	// The kernel writes the thread that received the fatal signal first
+	m_activeThreadId = m_threads[0].tid;
+	m_coreFilePath = path;
+	return true;
+}
+
+
+void ElfCoreFileAdapter::CloseCoreFile()
+{
+	std::unique_lock<std::shared_mutex> lock(m_mappingMutex);
+	if (m_mapping)
+	{
+		munmap(m_mapping, m_mappingSize);
+		m_mapping = nullptr;
+	}
+	m_mappingSize = 0;
+
+	if (m_fd >= 0)
+	{
+		close(m_fd);
+		m_fd = -1;
+	}
+
+	m_segments.clear();
+	m_threads.clear();
+	m_modules.clear();
+	m_coreFilePath.clear();
+	m_activeThreadId = 0;
+}
+
+
+bool ElfCoreFileAdapter::ParseNotes(uint64_t offset, uint64_t size)
+{
+	const uint8_t* cursor = m_mapping + offset;
+	const uint8_t* end = cursor + size;
+	while (end - cursor >= 12)
+	{
+		const uint32_t nameSize = ReadValue<uint32_t>(cursor);
+		const uint32_t descSize = ReadValue<uint32_t>(cursor + 4);
+		const uint32_t type = ReadValue<uint32_t>(cursor + 8);
+		cursor += 12;
+
+		const uint64_t descOffset = AlignUp4(nameSize);
+		const uint64_t noteSize = descOffset + AlignUp4(descSize);
+		if (noteSize > (uint64_t)(end - cursor))
+			return false;
+
+		const uint8_t* desc = cursor + descOffset;
+		// Only the "CORE" owner carries the notes we care about; "LINUX" holds the FPU/xstate blobs
+		if ((nameSize >= 4) && (memcmp(cursor, "CORE", 4) == 0))
+		{
+			switch (type)
+			{
+			case NT_PRSTATUS_TYPE:
+				ParsePrStatus(desc, descSize);
+				break;
+			case NT_PRPSINFO_TYPE:
+				ParsePrPsInfo(desc, descSize);
+				break;
+			case NT_FILE_TYPE:
+				ParseFileNote(desc, descSize);
+				break;
+			default:
+				break;
+			}
+		}
+
+		cursor += noteSize;
+	}
+
+	return true;
+}
+
+
+void ElfCoreFileAdapter::ParsePrStatus(const uint8_t* desc, size_t size)
+{
+	const char** names = nullptr;
+	size_t count = 0;
+	if (m_architecture == "x86_64")
+	{
+		names = g_x86_64RegisterNames;
+		count = sizeof(g_x86_64RegisterNames) / sizeof(g_x86_64RegisterNames[0]);
+	}
+	else
+	{
+		names = g_aarch64RegisterNames;
+		count = sizeof(g_aarch64RegisterNames) / sizeof(g_aarch64RegisterNames[0]);
+	}
+
+	if (size < PRSTATUS_REGS_OFFSET + count * sizeof(uint64_t))
+		return;
+
+	CoreThread thread;
+	thread.signal = ReadValue<int16_t>(desc + PRSTATUS_CURSIG_OFFSET);
+	thread.tid = ReadValue<uint32_t>(desc + PRSTATUS_PID_OFFSET);
+	thread.registers.reserve(count);
+	for (size_t i = 0; i < count; i++)
+		thread.registers.emplace_back(names[i], ReadValue<uint64_t>(desc + PRSTATUS_REGS_OFFSET + i * 8));
+
+	m_threads.push_back(std::move(thread));
+}
+
+
+void ElfCoreFileAdapter::ParsePrPsInfo(const uint8_t* desc, size_t size)
+{
+	if (size < PRPSINFO_FNAME_OFFSET + PRPSINFO_FNAME_SIZE)
+		return;
+
+	m_pid = ReadValue<uint32_t>(desc + 24);
+	const char* name = (const char*)desc + PRPSINFO_FNAME_OFFSET;
+	m_processName = std::string(name, strnlen(name, PRPSINFO_FNAME_SIZE));
+}
+
+
+void ElfCoreFileAdapter::ParseFileNote(const uint8_t* desc, size_t size)
+{
+	// Layout: count, page_size, count * {start, end, file_offset_in_pages}, then count NUL-terminated paths
+	if (size < 16)
+		return;
+
+	const uint64_t count = ReadValue<uint64_t>(desc);
+	if (count > (size - 16) / 24)
+		return;
+
+	const char* names = (const char*)desc + 16 + count * 24;
+	const char* namesEnd = (const char*)desc + size;
+
+	// A file is usually mapped several times (text, rodata, data, ...). Collapse them into one module spanning all
+	// the mappings, keyed by path so the module list comes out ordered and de-duplicated.
+	std::map<std::string, std::pair<uint64_t, uint64_t>> ranges;
+	for (uint64_t i = 0; i < count; i++)
+	{
+		if (names >= namesEnd)
+			break;
+
+		const size_t length = strnlen(names, namesEnd - names);
+		std::string path(names, length);
+		names += length + 1;
+
+		const uint8_t* entry = desc + 16 + i * 24;
+		const uint64_t start = ReadValue<uint64_t>(entry);
+		const uint64_t end = ReadValue<uint64_t>(entry + 8);
+
+		auto iter = ranges.find(path);
+		if (iter == ranges.end())
+		{
+			ranges[path] = {start, end};
+		}
+		else
+		{
+			iter->second.first = std::min(iter->second.first, start);
+			iter->second.second = std::max(iter->second.second, end);
+		}
+	}
+
+	for (const auto& [path, range]: ranges)
+	{
+		m_modules.emplace_back(
+			path, DebugModule::GetPathBaseName(path), range.first, range.second - range.first, true);
+	}
+
+	std::sort(m_modules.begin(), m_modules.end(),
+		[](const DebugModule& a, const DebugModule& b) { return a.m_address < b.m_address; });
+}
+
+
+const ElfCoreFileAdapter::CoreThread* ElfCoreFileAdapter::GetCoreThread(std::uint32_t tid) const
+{
+	for (const auto& thread: m_threads)
+	{
+		if (thread.tid == tid)
+			return &thread;
+	}
+	return nullptr;
+}
+
+
+uint64_t ElfCoreFileAdapter::GetThreadRegister(const CoreThread& thread, const std::string& name) const
+{
+	for (const auto& [regName, value]: thread.registers)
+	{
+		if (regName == name)
+			return value;
+	}
+	return 0;
+}
+
+
+std::string ElfCoreFileAdapter::GetInstructionPointerName() const
+{
+	return m_architecture == "x86_64" ? "rip" : "pc";
+}
+
+
+std::string ElfCoreFileAdapter::GetStackPointerName() const
+{
+	return m_architecture == "x86_64" ? "rsp" : "sp";
+}
+
+
+std::string ElfCoreFileAdapter::GetFramePointerName() const
+{
+	return m_architecture == "x86_64" ? "rbp" : "x29";
+}
+
+
+bool ElfCoreFileAdapter::Execute(const std::string& path, const LaunchConfigurations& configs)
+{
+	return ExecuteWithArgs(path, "", "", configs);
+}
+
+
+bool ElfCoreFileAdapter::ExecuteWithArgs(const std::string& path, const std::string& args,
+	const std::string& workingDir, const LaunchConfigurations& configs)
+{
+	// Like the Windows dump file adapter, the "executable path" is the core file to load
+	if (!OpenCoreFile(path))
+	{
+		DebuggerEvent event;
+		event.type = LaunchFailureEventType;
+		event.data.ErrorData().error = fmt::format("Failed to load ELF core file {}", path);
+		event.data.ErrorData().shortError = fmt::format("Failed to load core file");
+		PostDebuggerEvent(event);
+		return false;
+	}
+
+	DebuggerEvent event;
+	event.type = AdapterStoppedEventType;
+	event.data.TargetStoppedData().reason = StopReason();
+	event.data.TargetStoppedData().lastActiveThread = m_activeThreadId;
+	PostDebuggerEvent(event);
+	return true;
+}
+
+
+bool ElfCoreFileAdapter::Attach(std::uint32_t pid)
+{
+	return false;
+}
+
+
+bool ElfCoreFileAdapter::Connect(const std::string& server, std::uint32_t port)
+{
+	return false;
+}
+
+
+bool ElfCoreFileAdapter::Detach()
+{
+	CloseCoreFile();
+	DebuggerEvent event;
+	event.type = DetachedEventType;
+	PostDebuggerEvent(event);
+	return true;
+}
+
+
+bool ElfCoreFileAdapter::Quit()
+{
+	CloseCoreFile();
+	DebuggerEvent event;
+	event.type = TargetExitedEventType;
+	event.data.ExitData().exitCode = 0;
+	PostDebuggerEvent(event);
+	return true;
+}
+
+
+std::vector<DebugProcess> ElfCoreFileAdapter::GetProcessList()
+{
+	// The only process there is to report is the one that was dumped
+	if (m_pid == 0)
+		return {};
+
+	return {DebugProcess(m_pid, m_processName)};
+}
+
+
+std::vector<DebugThread> ElfCoreFileAdapter::GetThreadList()
+{
+	std::vector<DebugThread> result;
+	result.reserve(m_threads.size());
+	const auto ipName = GetInstructionPointerName();
+	for (const auto& thread: m_threads)
+		result.emplace_back(thread.tid, GetThreadRegister(thread, ipName));
+	return result;
+}
+
+
+DebugThread ElfCoreFileAdapter::GetActiveThread() const
+{
+	const CoreThread* thread = GetCoreThread(m_activeThreadId);
+	if (!thread)
+		return DebugThread {};
+
+	return DebugThread(thread->tid, GetThreadRegister(*thread, GetInstructionPointerName()));
+}
+
+
+std::uint32_t ElfCoreFileAdapter::GetActiveThreadId() const
+{
+	return m_activeThreadId;
+}
+
+
+bool ElfCoreFileAdapter::SetActiveThread(const DebugThread& thread)
+{
+	return SetActiveThreadId(thread.m_tid);
+}
+
+
+bool ElfCoreFileAdapter::SetActiveThreadId(std::uint32_t tid)
+{
+	if (!GetCoreThread(tid))
+		return false;
+
+	m_activeThreadId = tid;
+	return true;
+}
+
+
+bool ElfCoreFileAdapter::SuspendThread(std::uint32_t tid)
+{
+	return false;
+}
+
+
+bool ElfCoreFileAdapter::ResumeThread(std::uint32_t tid)
+{
+	return false;
+}
+
+
+std::vector<DebugFrame> ElfCoreFileAdapter::GetFramesOfThread(std::uint32_t tid)
+{
+	const CoreThread* thread = GetCoreThread(tid);
+	if (!thread)
+		return {};
+
+	// There is no unwinder behind this adapter, so walk the frame pointer chain. This is exact for code built with
+	// frame pointers and degrades to the first frame otherwise.
+	std::vector<DebugFrame> frames;
+	uint64_t pc = GetThreadRegister(*thread, GetInstructionPointerName());
+	uint64_t sp = GetThreadRegister(*thread, GetStackPointerName());
+	uint64_t fp = GetThreadRegister(*thread, GetFramePointerName());
+	frames.emplace_back(0, pc, sp, fp, "", 0, "");
+
+	static constexpr size_t maxFrames = 256;
+	while (frames.size() < maxFrames && fp != 0)
+	{
+		DataBuffer buffer = ReadMemory(fp, 16);
+		if (buffer.GetLength() != 16)
+			break;
+
+		const uint64_t nextFp = ReadValue<uint64_t>((const uint8_t*)buffer.GetData());
+		const uint64_t returnAddress = ReadValue<uint64_t>((const uint8_t*)buffer.GetData() + 8);
+		if (returnAddress == 0)
+			break;
+
+		frames.emplace_back(frames.size(), returnAddress, fp + 16, nextFp, "", 0, "");
+		// The stack grows down, so a sane caller frame always lives above the current one
+		if (nextFp <= fp)
+			break;
+		fp = nextFp;
+	}
+
+	for (auto& frame: frames)
+	{
+		auto iter = std::upper_bound(m_modules.begin(), m_modules.end(), frame.m_pc,
+			[](uint64_t address, const DebugModule& module) { return address < module.m_address; });
+		if (iter == m_modules.begin())
+			continue;
+		--iter;
+		if (frame.m_pc < iter->m_address + iter->m_size)
+			frame.m_module = iter->m_short_name;
+	}
+
+	return frames;
+}
+
+
+DebugBreakpoint ElfCoreFileAdapter::AddBreakpoint(const std::uintptr_t address, unsigned long breakpoint_type)
+{
+	return DebugBreakpoint {};
+}
+
+
+DebugBreakpoint ElfCoreFileAdapter::AddBreakpoint(const ModuleNameAndOffset& address, unsigned long breakpoint_type)
+{
+	return DebugBreakpoint {};
+}
+
+
+bool ElfCoreFileAdapter::RemoveBreakpoint(const DebugBreakpoint& breakpoint)
+{
+	return false;
+}
+
+
+std::vector<DebugBreakpoint> ElfCoreFileAdapter::GetBreakpointList() const
+{
+	return {};
+}
+
+
+std::unordered_map<std::string, DebugRegister> ElfCoreFileAdapter::ReadAllRegisters()
+{
+	std::unordered_map<std::string, DebugRegister> result;
+	const CoreThread* thread = GetCoreThread(m_activeThreadId);
+	if (!thread)
+		return result;
+
+	size_t index = 0;
+	for (const auto& [name, value]: thread->registers)
+		result[name] = DebugRegister(name, value, 64, index++);
+
+	return result;
+}
+
+
+DebugRegister ElfCoreFileAdapter::ReadRegister(const std::string& reg)
+{
+	const CoreThread* thread = GetCoreThread(m_activeThreadId);
+	if (!thread)
+		return DebugRegister {};
+
+	for (size_t i = 0; i < thread->registers.size(); i++)
+	{
+		if (thread->registers[i].first == reg)
+			return DebugRegister(reg, thread->registers[i].second, 64, i);
+	}
+
+	return DebugRegister {};
+}
+
+
+bool ElfCoreFileAdapter::WriteRegister(const std::string& reg, std::uintptr_t value)
+{
+	return false;
+}
+
+
+DataBuffer ElfCoreFileAdapter::ReadMemory(std::uintptr_t address, std::size_t size)
+{
+	std::shared_lock<std::shared_mutex> lock(m_mappingMutex);
+	if (!m_mapping || (size == 0))
+		return DataBuffer {};
+
+	// Find the last segment that starts at or below the address
+	auto iter = std::upper_bound(m_segments.begin(), m_segments.end(), (uint64_t)address,
+		[](uint64_t address, const CoreSegment& segment) { return address < segment.address; });
+	if (iter == m_segments.begin())
+		return DataBuffer {};
+	--iter;
+
+	// The read may straddle adjacent segments. Copy straight out of the mapping and stop at the first hole, so the
+	// caller gets the readable prefix just like a partial read from a live process.
+	DataBuffer result;
+	uint64_t current = address;
+	size_t remaining = size;
+	while (remaining > 0 && iter != m_segments.end())
+	{
+		if ((current < iter->address) || (current - iter->address >= iter->memorySize))
+			break;
+
+		const uint64_t offsetInSegment = current - iter->address;
+		const size_t chunk = (size_t)std::min<uint64_t>(remaining, iter->memorySize - offsetInSegment);
+		if (offsetInSegment < iter->fileSize)
+		{
+			const size_t backed = (size_t)std::min<uint64_t>(chunk, iter->fileSize - offsetInSegment);
+			result.Append(m_mapping + iter->fileOffset + offsetInSegment, backed);
+			if (backed < chunk)
+			{
+				// Pages the kernel chose not to dump (or that were truncated away) are not readable
+				break;
+			}
+		}
+		else
+		{
+			break;
+		}
+
+		current += chunk;
+		remaining -= chunk;
+		++iter;
+	}
+
+	return result;
+}
+
+
+bool ElfCoreFileAdapter::WriteMemory(std::uintptr_t address, const DataBuffer& buffer)
+{
+	return false;
+}
+
+
+std::vector<DebugModule> ElfCoreFileAdapter::GetModuleList()
+{
+	return m_modules;
+}
+
+
+std::string ElfCoreFileAdapter::GetTargetArchitecture()
+{
+	return m_architecture;
+}
+
+
+DebugStopReason ElfCoreFileAdapter::StopReason()
+{
+	const CoreThread* thread = GetCoreThread(m_activeThreadId);
+	if (!thread)
+		return UnknownReason;
+
+	return GetStopReasonFromLinuxSignal(thread->signal);
+}
+
+
+uint64_t ElfCoreFileAdapter::ExitCode()
+{
+	return 0;
+}
+
+
+bool ElfCoreFileAdapter::BreakInto()
+{
+	return false;
+}
+
+
+bool ElfCoreFileAdapter::Go()
+{
+	LogWarn("Cannot resume a core file");
+	return false;
+}
+
+
+bool ElfCoreFileAdapter::StepInto()
+{
+	LogWarn("Cannot step a core file");
+	return false;
+}
+
+
+bool ElfCoreFileAdapter::StepOver()
+{
+	LogWarn("Cannot step a core file");
+	return false;
+}
+
+
+std::string ElfCoreFileAdapter::InvokeBackendCommand(const std::string& command)
+{
+	return "The ELF core file adapter does not have a backend to send commands to\n";
+}
+
+
+uint64_t ElfCoreFileAdapter::GetInstructionOffset()
+{
+	return ReadRegister(GetInstructionPointerName()).m_value;
+}
+
+
+uint64_t ElfCoreFileAdapter::GetStackPointer()
+{
+	return ReadRegister(GetStackPointerName()).m_value;
+}
+
+
+bool ElfCoreFileAdapter::SupportFeature(DebugAdapterCapacity feature)
+{
+	switch (feature)
+	{
+	case DebugAdapterSupportModules:
+	case DebugAdapterSupportThreads:
+		return true;
+	default:
+		return false;
+	}
+}
+
+
+ElfCoreFileAdapterType::ElfCoreFileAdapterType() : DebugAdapterType("ELF_CORE_FILE") {}
+
+
+DebugAdapter* ElfCoreFileAdapterType::Create(BinaryNinja::BinaryView* data)
+{
+	// TODO: someone should free this.
+	return new ElfCoreFileAdapter(data);
+}
+
+
+bool ElfCoreFileAdapterType::IsValidForData(BinaryNinja::BinaryView* data)
+{
+	return data->GetTypeName() == "ELF" || data->GetTypeName() == "Raw" || data->GetTypeName() == "Mapped";
+}
+
+
+bool ElfCoreFileAdapterType::CanConnect(BinaryNinja::BinaryView* data)
+{
+	return false;
+}
+
+
+bool ElfCoreFileAdapterType::CanExecute(BinaryNinja::BinaryView* data)
+{
+	return true;
+}
+
+
+void BinaryNinjaDebugger::InitElfCoreFileAdapterType()
+{
+	static ElfCoreFileAdapterType localType;
+	DebugAdapterType::Register(&localType);
+}
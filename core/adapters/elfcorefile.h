@@ -0,0 +1,139 @@
+/*
+Copyright 2020-2024 Vector 35 Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+#include <shared_mutex>
+#include "../debugadapter.h"
+#include "../debugadaptertype.h"
+
+namespace BinaryNinjaDebugger {
+	// Post-mortem adapter for Linux ELF core files. The core is memory-mapped read-only and never read as a whole:
+	// only the ELF header, the program headers and the PT_NOTE segments are touched during load, and memory reads
+	// copy straight out of the mapping for the requested range. This keeps multi-GB cores cheap to open.
+	class ElfCoreFileAdapter : public DebugAdapter
+	{
+		// A PT_LOAD segment of the core. Only the first fileSize bytes are backed by the file; the kernel leaves out
+		// the rest (e.g., file-backed text filtered by coredump_filter), so that part of the segment is unreadable.
+		struct CoreSegment
+		{
+			uint64_t address;
+			uint64_t memorySize;
+			uint64_t fileOffset;
+			uint64_t fileSize;
+		};
+
+		struct CoreThread
+		{
+			std::uint32_t tid;
+			int signal;
+			std::vector<std::pair<std::string, uint64_t>> registers;
+		};
+
+		std::string m_coreFilePath;
+		int m_fd = -1;
+		uint8_t* m_mapping = nullptr;
+		size_t m_mappingSize = 0;
+		// Held shared by ReadMemory and exclusively while the mapping is torn down
+		std::shared_mutex m_mappingMutex;
+
+		// Sorted by address, so ReadMemory can binary search it
+		std::vector<CoreSegment> m_segments;
+		std::vector<CoreThread> m_threads;
+		std::vector<DebugModule> m_modules;
+		std::string m_architecture;
+		std::uint32_t m_pid = 0;
+		std::string m_processName;
+		std::uint32_t m_activeThreadId = 0;
+
+		bool OpenCoreFile(const std::string& path);
+		void CloseCoreFile();
+		bool ParseNotes(uint64_t offset, uint64_t size);
+		void ParsePrStatus(const uint8_t* desc, size_t size);
+		void ParseFileNote(const uint8_t* desc, size_t size);
+		void ParsePrPsInfo(const uint8_t* desc, size_t size);
+		const CoreThread* GetCoreThread(std::uint32_t tid) const;
+		uint64_t GetThreadRegister(const CoreThread& thread, const std::string& name) const;
+		std::string GetInstructionPointerName() const;
+		std::string GetStackPointerName() const;
+		std::string GetFramePointerName() const;
+
+	public:
+		ElfCoreFileAdapter(BinaryView* data);
+		~ElfCoreFileAdapter();
+
+		bool Execute(const std::string& path, const LaunchConfigurations& configs = {}) override;
+		bool ExecuteWithArgs(const std::string& path, const std::string& args, const std::string& workingDir,
+			const LaunchConfigurations& configs = {}) override;
+		bool Attach(std::uint32_t pid) override;
+		bool Connect(const std::string& server, std::uint32_t port) override;
+
+		bool Detach() override;
+		bool Quit() override;
+
+		std::vector<DebugProcess> GetProcessList() override;
+		std::vector<DebugThread> GetThreadList() override;
+		DebugThread GetActiveThread() const override;
+		std::uint32_t GetActiveThreadId() const override;
+		bool SetActiveThread(const DebugThread& thread) override;
+		bool SetActiveThreadId(std::uint32_t tid) override;
+		bool SuspendThread(std::uint32_t tid) override;
+		bool ResumeThread(std::uint32_t tid) override;
+		std::vector<DebugFrame> GetFramesOfThread(std::uint32_t tid) override;
+
+		DebugBreakpoint AddBreakpoint(const std::uintptr_t address, unsigned long breakpoint_type = 0) override;
+		DebugBreakpoint AddBreakpoint(const ModuleNameAndOffset& address, unsigned long breakpoint_type = 0) override;
+		bool RemoveBreakpoint(const DebugBreakpoint& breakpoint) override;
+		std::vector<DebugBreakpoint> GetBreakpointList() const override;
+
+		std::unordered_map<std::string, DebugRegister> ReadAllRegisters() override;
+		DebugRegister ReadRegister(const std::string& reg) override;
+		bool WriteRegister(const std::string& reg, std::uintptr_t value) override;
+
+		DataBuffer ReadMemory(std::uintptr_t address, std::size_t size) override;
+		bool WriteMemory(std::uintptr_t address, const DataBuffer& buffer) override;
+
+		std::vector<DebugModule> GetModuleList() override;
+		std::string GetTargetArchitecture() override;
+
+		DebugStopReason StopReason() override;
+		uint64_t ExitCode() override;
+
+		bool BreakInto() override;
+		bool Go() override;
+		bool StepInto() override;
+		bool StepOver() override;
+
+		std::string InvokeBackendCommand(const std::string& command) override;
+		uint64_t GetInstructionOffset() override;
+		uint64_t GetStackPointer() override;
+
+		bool SupportFeature(DebugAdapterCapacity feature) override;
+	};
+
+
+	class ElfCoreFileAdapterType : public DebugAdapterType
+	{
+	public:
+		ElfCoreFileAdapterType();
+		virtual DebugAdapter* Create(BinaryNinja::BinaryView* data);
+		virtual bool IsValidForData(BinaryNinja::BinaryView* data);
+		virtual bool CanExecute(BinaryNinja::BinaryView* data);
+		virtual bool CanConnect(BinaryNinja::BinaryView* data);
+	};
+
+
+	void InitElfCoreFileAdapterType();
+};  // namespace BinaryNinjaDebugger
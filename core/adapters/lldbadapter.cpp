@@ -14,13 +14,31 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
+#include <algorithm>
+#include <cstring>
 #include <inttypes.h>
+#include <set>
+#include <unordered_map>
 #include "lldbadapter.h"
 #include "thread"
 
+#ifndef WIN32
+	#include <pwd.h>
+	#include <unistd.h>
+#endif
+#ifdef __linux__
+	#include <dirent.h>
+	#include <elf.h>
+	#include <fstream>
+	#include <sys/stat.h>
+#endif
+
 using namespace lldb;
 using namespace BinaryNinjaDebugger;
 
+// The only event type of LldbAdapter::m_interruptBroadcaster
+static constexpr uint32_t InterruptEventBit = 1;
+
 std::string lldbArchNameForBinaryNinjaArchName(std::string name)
 {
 	if (name == "x86_64")
@@ -40,8 +58,17 @@ std::string lldbArchNameForBinaryNinjaArchName(std::string name)
 LldbAdapter::LldbAdapter(BinaryView* data) : DebugAdapter(data)
 {
 	m_targetActive = false;
-	SBDebugger::Initialize();
-	m_debugger = SBDebugger::Create();
+	m_multiTarget = Settings::Instance()->Get<bool>("debugger.lldbMultiTarget");
+	if (m_multiTarget)
+	{
+		m_debugger = LldbSession::Get()->GetDebugger();
+	}
+	else
+	{
+		SBDebugger::Initialize();
+		m_debugger = SBDebugger::Create();
+		m_interruptBroadcaster = SBBroadcaster("binaryninja.debugger.interrupt");
+	}
 	if (!m_debugger.IsValid())
 		LogWarn("Invalid debugger");
 
@@ -51,14 +78,184 @@ LldbAdapter::LldbAdapter(BinaryView* data) : DebugAdapter(data)
 	// Otherwise, the confirmation prompt will be sent to the terminal that BN is launched from, which is a very
 	// confusing behavior.
 	InvokeBackendCommand("settings set auto-confirm true");
-	m_debugger.SetAsync(false);
+	// The shared debugger always stays in async mode, since the targets of other adapters may be running
+	if (!m_multiTarget)
+		m_debugger.SetAsync(false);
 }
 
 
 LldbAdapter::~LldbAdapter()
 {
 	m_process.Destroy();
-	SBDebugger::Destroy(m_debugger);
+	InterruptEventListener();
+	if (m_multiTarget)
+	{
+		LldbSession::Get()->RemoveAdapter(this);
+		if (m_target.IsValid())
+			m_debugger.DeleteTarget(m_target);
+	}
+	else
+	{
+		JoinEventListener();
+		SBDebugger::Destroy(m_debugger);
+	}
+	// The events not posted yet are dropped along with m_worker
+}
+
+
+SerialWorker::SerialWorker() : m_queue(std::make_shared<Queue>())
+{
+	std::thread([queue = m_queue]() { Run(queue); }).detach();
+}
+
+
+SerialWorker::~SerialWorker()
+{
+	// The adapter may be destroyed on the main thread while a task waits for it, so this must not wait for the task
+	std::unique_lock<std::mutex> lock(m_queue->mutex);
+	m_queue->stop = true;
+	m_queue->tasks.clear();
+	lock.unlock();
+	m_queue->condition.notify_all();
+}
+
+
+void SerialWorker::Enqueue(std::function<void()> task)
+{
+	std::unique_lock<std::mutex> lock(m_queue->mutex);
+	m_queue->tasks.push_back(std::move(task));
+	lock.unlock();
+	m_queue->condition.notify_all();
+}
+
+
+void SerialWorker::Run(std::shared_ptr<Queue> queue)
+{
+	std::unique_lock<std::mutex> lock(queue->mutex);
+	while (true)
+	{
+		queue->condition.wait(lock, [&]() { return queue->stop || !queue->tasks.empty(); });
+		if (queue->stop)
+			return;
+
+		auto task = std::move(queue->tasks.front());
+		queue->tasks.pop_front();
+		lock.unlock();
+		task();
+		lock.lock();
+	}
+}
+
+
+LldbSession::LldbSession()
+{
+	SBDebugger::Initialize();
+	m_debugger = SBDebugger::Create();
+	if (!m_debugger.IsValid())
+		LogWarn("Invalid debugger");
+	m_debugger.SetAsync(true);
+}
+
+
+LldbSession* LldbSession::Get()
+{
+	// Created on first use, and never destroyed, like the debugger of an adapter that is never freed
+	static LldbSession* session = new LldbSession();
+	return session;
+}
+
+
+void LldbSession::AddTarget(const SBTarget& target, LldbAdapter* adapter)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_targets.emplace_back(target, adapter);
+	if (m_listenerStarted)
+		return;
+
+	m_listenerStarted = true;
+	std::thread thread([this]() { EventListener(); });
+	m_listenerThreadId = thread.get_id();
+	thread.detach();
+}
+
+
+void LldbSession::RemoveTarget(const SBTarget& target)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_targets.erase(std::remove_if(m_targets.begin(), m_targets.end(),
+						[&](const std::pair<SBTarget, LldbAdapter*>& entry) { return entry.first == target; }),
+		m_targets.end());
+}
+
+
+void LldbSession::RemoveAdapter(LldbAdapter* adapter)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_targets.erase(std::remove_if(m_targets.begin(), m_targets.end(),
+						[&](const std::pair<SBTarget, LldbAdapter*>& entry) { return entry.second == adapter; }),
+		m_targets.end());
+	// The adapter is about to be destroyed, so it must not be handling an event. Handling one only queries LLDB, so
+	// this is short. The listener itself never destroys an adapter, but must not wait for itself if it ever does.
+	if (std::this_thread::get_id() != m_listenerThreadId)
+		m_dispatchDone.wait(lock, [&]() { return m_dispatching != adapter; });
+}
+
+
+bool LldbSession::FindTarget(SBEvent& event, SBTarget& target, LldbAdapter*& adapter)
+{
+	if (SBProcess::EventIsProcessEvent(event))
+		target = SBProcess::GetProcessFromEvent(event).GetTarget();
+	else if (SBTarget::EventIsTargetEvent(event))
+		target = SBTarget::GetTargetFromEvent(event);
+	else if (SBBreakpoint::EventIsBreakpointEvent(event))
+		target = SBBreakpoint::GetBreakpointFromEvent(event).GetTarget();
+
+	for (const auto& [candidate, owner] : m_targets)
+	{
+		// Other events, e.g., the watchpoint ones, are sent by the target itself
+		if (target.IsValid() ? (candidate == target) : event.BroadcasterMatchesRef(candidate.GetBroadcaster()))
+		{
+			target = candidate;
+			adapter = owner;
+			return true;
+		}
+	}
+	return false;
+}
+
+
+void LldbSession::EventListener()
+{
+	auto listener = m_debugger.GetListener();
+	while (true)
+	{
+		SBEvent event;
+		// The session never ends, so this can block until there is an event
+		if (!listener.WaitForEvent(UINT32_MAX, event))
+			continue;
+
+		SBTarget target;
+		LldbAdapter* adapter = nullptr;
+		std::unique_lock<std::mutex> lock(m_mutex);
+		// Events of targets that are not added yet, e.g., the module loads while creating it, are of no interest
+		if (!FindTarget(event, target, adapter))
+			continue;
+		m_dispatching = adapter;
+		lock.unlock();
+
+		bool done = adapter->HandleEvent(event);
+
+		lock.lock();
+		m_dispatching = nullptr;
+		if (done)
+		{
+			m_targets.erase(std::remove_if(m_targets.begin(), m_targets.end(),
+								[&](const std::pair<SBTarget, LldbAdapter*>& entry) { return entry.first == target; }),
+				m_targets.end());
+		}
+		lock.unlock();
+		m_dispatchDone.notify_all();
+	}
 }
 
 
@@ -126,13 +323,53 @@ void BinaryNinjaDebugger::InitLldbAdapterType()
 
 void LldbAdapter::ApplyBreakpoints()
 {
-	for (const auto& bp : m_pendingBreakpoints)
-	{
-		AddBreakpoint(bp);
-	}
 	// Clear the pending breakpoint list so that when the adapter launch/attach/connect to the target for the next time,
 	// it always gets a clean list of breakpoints from the controller.
-	m_pendingBreakpoints.clear();
+	std::vector<ModuleNameAndOffset> pending;
+	pending.swap(m_pendingBreakpoints);
+	AddBreakpoints(pending);
+
+	pending.clear();
+	pending.swap(m_pendingOneShotBreakpoints);
+	AddOneShotBreakpoints(pending);
+}
+
+
+void LldbAdapter::StartEventListener()
+{
+	if (!m_multiTarget)
+	{
+		// The previous listener clears the listener when it ends, so it must be gone before listening again
+		JoinEventListener();
+		m_debugger.SetAsync(true);
+		// SBListener::Clear() at the end of the previous listener also stops listening to the interrupts
+		m_debugger.GetListener().StartListeningForEvents(m_interruptBroadcaster, InterruptEventBit);
+		// We must start the event listener before calling CreateTarget, since CreateTarget will send out the initial
+		// batch of module load events.
+		uint64_t generation = ++m_listenerGeneration;
+		m_listenerThread = std::thread([this, generation]() { EventListener(generation); });
+		return;
+	}
+
+	// The session is already listening to the shared debugger. Only the target of the previous launch needs to go, so
+	// the targets do not pile up in it.
+	if (m_target.IsValid())
+	{
+		LldbSession::Get()->RemoveTarget(m_target);
+		m_debugger.DeleteTarget(m_target);
+		m_target.Clear();
+	}
+}
+
+
+void LldbAdapter::OnTargetCreated()
+{
+	if (m_multiTarget)
+		LldbSession::Get()->AddTarget(m_target, this);
+
+	// LLDB follows only one side of a fork, and detaches from the other one, which keeps running on its own
+	auto followForkMode = Settings::Instance()->Get<std::string>("debugger.followForkMode");
+	InvokeBackendCommand(fmt::format("settings set target.process.follow-fork-mode {}", followForkMode));
 }
 
 
@@ -159,12 +396,7 @@ bool LldbAdapter::Execute(const std::string& path, const LaunchConfigurations& c
 bool LldbAdapter::ExecuteWithArgs(const std::string& path, const std::string& args, const std::string& workingDir,
 	const LaunchConfigurations& configs)
 {
-	m_debugger.SetAsync(true);
-
-	// We must start the event listener before calling CreateTarget, since CreateTarget will send out the initial
-	// batch of module load events.
-	std::thread thread([&]() { EventListener(); });
-	thread.detach();
+	StartEventListener();
 
 	SBError err;
 
@@ -191,13 +423,15 @@ bool LldbAdapter::ExecuteWithArgs(const std::string& path, const std::string& ar
 	{
 		DebuggerEvent event;
 		event.type = LaunchFailureEventType;
-		event.data.errorData.shortError = "LLDB failed to create target.";
-		event.data.errorData.error =
+		event.data.ErrorData().shortError = "LLDB failed to create target.";
+		event.data.ErrorData().error =
 			fmt::format("LLDB Failed to create target with \"{}\"", err.GetCString() ? err.GetCString() : "");
 		PostDebuggerEvent(event);
+		InterruptEventListener();
 		return false;
 	}
 
+	OnTargetCreated();
 	m_targetActive = true;
 	// Breakpoints are added to this adapter right after the adapter gets created. However, at that time, the target is
 	// not created yet, so there is no way the adapter could apply the breakpoints to the target. Instead, the adapter
@@ -233,7 +467,7 @@ bool LldbAdapter::ExecuteWithArgs(const std::string& path, const std::string& ar
 	auto result = InvokeBackendCommand(launchCommand);
 	DebuggerEvent evt;
 	evt.type = BackendMessageEventType;
-	evt.data.messageData.message = result;
+	evt.data.MessageData().message = result;
 	PostDebuggerEvent(evt);
 
 	m_process = m_target.GetProcess();
@@ -243,9 +477,10 @@ bool LldbAdapter::ExecuteWithArgs(const std::string& path, const std::string& ar
 		result.erase(it + 1);
 		DebuggerEvent event;
 		event.type = LaunchFailureEventType;
-		event.data.errorData.shortError = fmt::format("LLDB failed to launch target.");
-		event.data.errorData.error = fmt::format("LLDB Failed to launch target with \"{}\"", result.c_str());
+		event.data.ErrorData().shortError = fmt::format("LLDB failed to launch target.");
+		event.data.ErrorData().error = fmt::format("LLDB Failed to launch target with \"{}\"", result.c_str());
 		PostDebuggerEvent(event);
+		InterruptEventListener();
 		return false;
 	}
 	return true;
@@ -254,10 +489,7 @@ bool LldbAdapter::ExecuteWithArgs(const std::string& path, const std::string& ar
 
 bool LldbAdapter::Attach(std::uint32_t pid)
 {
-	m_debugger.SetAsync(true);
-
-	std::thread thread([&]() { EventListener(); });
-	thread.detach();
+	StartEventListener();
 
 	SBError err;
 
@@ -284,13 +516,15 @@ bool LldbAdapter::Attach(std::uint32_t pid)
 	{
 		DebuggerEvent event;
 		event.type = LaunchFailureEventType;
-		event.data.errorData.shortError = fmt::format("LLDB failed to attach to target.");
-		event.data.errorData.error =
+		event.data.ErrorData().shortError = fmt::format("LLDB failed to attach to target.");
+		event.data.ErrorData().error =
 			fmt::format("LLDB failed to attach to target with \"{}\"", err.GetCString() ? err.GetCString() : "");
 		PostDebuggerEvent(event);
+		InterruptEventListener();
 		return false;
 	}
 
+	OnTargetCreated();
 	m_targetActive = true;
 	ApplyBreakpoints();
 
@@ -300,10 +534,11 @@ bool LldbAdapter::Attach(std::uint32_t pid)
 	{
 		DebuggerEvent event;
 		event.type = LaunchFailureEventType;
-		event.data.errorData.shortError = fmt::format("LLDB failed to attach to target.");
-		event.data.errorData.error =
+		event.data.ErrorData().shortError = fmt::format("LLDB failed to attach to target.");
+		event.data.ErrorData().error =
 			fmt::format("LLDB Failed to attach to target with \"{}\"", err.GetCString() ? err.GetCString() : "");
 		PostDebuggerEvent(event);
+		InterruptEventListener();
 		return false;
 	}
 
@@ -311,7 +546,7 @@ bool LldbAdapter::Attach(std::uint32_t pid)
 	// This is NOT needed for Connect(), since LLDB event listener sends an event in that case.
 	DebuggerEvent dbgevt;
 	dbgevt.type = AdapterStoppedEventType;
-	dbgevt.data.targetStoppedData.reason = InitialBreakpoint;
+	dbgevt.data.TargetStoppedData().reason = InitialBreakpoint;
 	PostDebuggerEvent(dbgevt);
 	return true;
 }
@@ -319,10 +554,7 @@ bool LldbAdapter::Attach(std::uint32_t pid)
 
 bool LldbAdapter::Connect(const std::string& server, std::uint32_t port)
 {
-	m_debugger.SetAsync(true);
-
-	std::thread thread([&]() { EventListener(); });
-	thread.detach();
+	StartEventListener();
 
 	SBError err;
 
@@ -349,13 +581,15 @@ bool LldbAdapter::Connect(const std::string& server, std::uint32_t port)
 	{
 		DebuggerEvent event;
 		event.type = LaunchFailureEventType;
-		event.data.errorData.shortError = fmt::format("LLDB failed to connect to target.");
-		event.data.errorData.error =
+		event.data.ErrorData().shortError = fmt::format("LLDB failed to connect to target.");
+		event.data.ErrorData().error =
 			fmt::format("LLDB failed to connect to target with \"{}\"", err.GetCString() ? err.GetCString() : "");
 		PostDebuggerEvent(event);
+		InterruptEventListener();
 		return false;
 	}
 
+	OnTargetCreated();
 	m_targetActive = true;
 	ApplyBreakpoints();
 
@@ -372,10 +606,11 @@ bool LldbAdapter::Connect(const std::string& server, std::uint32_t port)
 	{
 		DebuggerEvent event;
 		event.type = LaunchFailureEventType;
-		event.data.errorData.shortError = fmt::format("LLDB failed to connect to target.");
-		event.data.errorData.error =
+		event.data.ErrorData().shortError = fmt::format("LLDB failed to connect to target.");
+		event.data.ErrorData().error =
 			fmt::format("LLDB Failed to connect to target with \"{}\"", err.GetCString() ? err.GetCString() : "");
 		PostDebuggerEvent(event);
+		InterruptEventListener();
 		return false;
 	}
 	return true;
@@ -385,6 +620,9 @@ bool LldbAdapter::Connect(const std::string& server, std::uint32_t port)
 bool LldbAdapter::Detach()
 {
 	std::unique_lock<std::mutex> lock(m_quitingMutex);
+	// Without a process, there will be no detached event to end the listener
+	if (!m_process.IsValid())
+		InterruptEventListener();
 	SBError error = m_process.Detach();
 	return error.Success();
 }
@@ -393,47 +631,194 @@ bool LldbAdapter::Detach()
 bool LldbAdapter::Quit()
 {
 	std::unique_lock<std::mutex> lock(m_quitingMutex);
+	// Without a process, there will be no exited event to end the listener
+	if (!m_process.IsValid())
+		InterruptEventListener();
 	SBError error = m_process.Kill();
 	return error.Success();
 }
 
 
-std::vector<DebugProcess> LldbAdapter::GetProcessList()
+#ifndef WIN32
+// The name of the user, or the user ID if it has none. The names are cached, since many processes share a user.
+static std::string GetUserName(uint32_t uid, std::unordered_map<uint32_t, std::string>& users)
 {
-	std::vector<DebugProcess> debug_processes {};
+	auto iter = users.find(uid);
+	if (iter != users.end())
+		return iter->second;
+
+	std::string name = std::to_string(uid);
+	struct passwd entry;
+	struct passwd* result = nullptr;
+	std::vector<char> buffer(0x4000);
+	if ((getpwuid_r(uid, &entry, buffer.data(), buffer.size(), &result) == 0) && result && result->pw_name)
+		name = result->pw_name;
+
+	users[uid] = name;
+	return name;
+}
+#endif
 
-	std::istringstream processList(InvokeBackendCommand("platform process list"));
-	std::string line;
 
-	while (getline(processList, line, '\n'))
+#ifdef __linux__
+// The architecture of an executable, from its ELF header, in the naming of LLDB triples
+static std::string GetExecutableArchitecture(const std::string& path)
+{
+	std::ifstream file(path, std::ios::binary);
+	unsigned char header[EI_NIDENT + 4];
+	if (!file.read((char*)header, sizeof(header)) || (memcmp(header, ELFMAG, SELFMAG) != 0))
+		return "";
+
+	// e_type is followed by e_machine, at the same offset for both classes
+	bool littleEndian = header[EI_DATA] == ELFDATA2LSB;
+	uint16_t machine = littleEndian ? (header[EI_NIDENT + 2] | (header[EI_NIDENT + 3] << 8)) :
+									  ((header[EI_NIDENT + 2] << 8) | header[EI_NIDENT + 3]);
+	bool is64Bit = header[EI_CLASS] == ELFCLASS64;
+	switch (machine)
 	{
-		uint32_t pid{};
+	case EM_X86_64:
+		return "x86_64";
+	case EM_386:
+		return "i386";
+	case EM_AARCH64:
+		return "aarch64";
+	case EM_ARM:
+		return "arm";
+	case EM_PPC:
+		return "powerpc";
+	case EM_PPC64:
+		return littleEndian ? "powerpc64le" : "powerpc64";
+	case EM_MIPS:
+		return is64Bit ? "mips64" : "mips";
+	case EM_RISCV:
+		return is64Bit ? "riscv64" : "riscv32";
+	default:
+		return "";
+	}
+}
 
-		// skip header lines and lines that have len <= 56
-		if (line.rfind("matching processes were found on") != std::string::npos
-			|| line.rfind("PID    PARENT USER") != std::string::npos
-			|| line.rfind("====== ======") != std::string::npos
-			|| line.size() <= 56)
-		{
+
+// Reads the processes of the local machine straight from /proc. This is much faster than the `platform process list`
+// command, and every field is read on its own, so a long user name cannot push the others out of their columns.
+static std::vector<DebugProcess> GetLocalProcessList()
+{
+	std::vector<DebugProcess> processes;
+	DIR* dir = opendir("/proc");
+	if (!dir)
+		return processes;
+
+	std::unordered_map<uint32_t, std::string> users;
+	while (struct dirent* entry = readdir(dir))
+	{
+		char* end = nullptr;
+		unsigned long pid = strtoul(entry->d_name, &end, 10);
+		if ((end == entry->d_name) || (*end != '\0') || (pid == 0))
+			continue;
+
+		// A process can exit at any point while it is being read, in which case it is skipped
+		std::string path = fmt::format("/proc/{}", pid);
+		std::ifstream statFile(path + "/stat");
+		std::string stat;
+		if (!std::getline(statFile, stat))
 			continue;
-		}
 
-		if (sscanf(line.c_str(), "%d", &pid) == 0)
+		// The name is in parentheses, and can contain both spaces and parentheses itself. The fields after it are the
+		// state and the parent pid.
+		size_t nameStart = stat.find('(');
+		size_t nameEnd = stat.rfind(')');
+		if ((nameStart == std::string::npos) || (nameEnd == std::string::npos) || (nameEnd < nameStart))
 			continue;
 
-		// example output lines:
-		//	1268   944                                              csrss.exe
-		//  37635  9677   xusheng    arm64-apple-*                  Code Helper (Renderer)
-		//
-		// we've 56 bytes until process name which is calculated like this:
-		// (6 + 1) + (6 + 1) + (10 + 1) + (30 + 1)
+		DebugProcess process((uint32_t)pid, stat.substr(nameStart + 1, nameEnd - nameStart - 1));
+		char state;
+		uint32_t parentPid;
+		if (sscanf(stat.c_str() + nameEnd + 1, " %c %u", &state, &parentPid) == 2)
+			process.m_parentPid = parentPid;
+
+		// The name in stat is cut at 15 characters, so the one of the executable is used when it can be read
+		char exePath[4096];
+		ssize_t exePathLength = readlink((path + "/exe").c_str(), exePath, sizeof(exePath) - 1);
+		if (exePathLength > 0)
+		{
+			std::string exe(exePath, exePathLength);
+			process.m_processName = exe.substr(exe.find_last_of('/') + 1);
+			process.m_arch = GetExecutableArchitecture(path + "/exe");
+		}
+
+		// The arguments are separated by, and end with, NUL characters
+		std::ifstream cmdlineFile(path + "/cmdline", std::ios::binary);
+		std::string cmdline((std::istreambuf_iterator<char>(cmdlineFile)), std::istreambuf_iterator<char>());
+		while (!cmdline.empty() && (cmdline.back() == '\0'))
+			cmdline.pop_back();
+		std::replace(cmdline.begin(), cmdline.end(), '\0', ' ');
+		process.m_commandLine = cmdline;
+
+		struct stat info;
+		if (::stat(path.c_str(), &info) == 0)
+			process.m_user = GetUserName(info.st_uid, users);
+
+		processes.push_back(std::move(process));
+	}
+
+	closedir(dir);
+	return processes;
+}
+#endif
+
 
-		std::string processName(std::next(line.begin(), 56), line.end());
+std::vector<DebugProcess> LldbAdapter::GetProcessList()
+{
+	SBPlatform platform = m_debugger.GetSelectedPlatform();
+	bool isHost = platform.IsValid() && (strcmp(platform.GetName(), "host") == 0);
+#ifdef __linux__
+	if (isHost)
+		return GetLocalProcessList();
+#endif
 
-		debug_processes.emplace_back(pid, processName);
+	SBError error;
+	SBProcessInfoList processInfos = platform.GetAllProcesses(error);
+	if (error.Fail())
+	{
+		LogWarn("Failed to list the processes: %s", error.GetCString() ? error.GetCString() : "");
+		return {};
 	}
 
-	return debug_processes;
+	std::vector<DebugProcess> processes;
+	[[maybe_unused]] std::unordered_map<uint32_t, std::string> users;
+	for (uint32_t i = 0; i < processInfos.GetSize(); i++)
+	{
+		SBProcessInfo info;
+		if (!processInfos.GetProcessInfoAtIndex(i, info))
+			continue;
+
+		DebugProcess process((uint32_t)info.GetProcessID(), info.GetName() ? info.GetName() : "");
+		if (info.ParentProcessIDIsValid())
+			process.m_parentPid = (uint32_t)info.GetParentProcessID();
+		if (info.UserIDIsValid())
+		{
+			// The user names are only known for the local machine
+#ifndef WIN32
+			if (isHost)
+				process.m_user = GetUserName(info.GetUserID(), users);
+			else
+#endif
+				process.m_user = std::to_string(info.GetUserID());
+		}
+
+		if (auto triple = info.GetTriple(); triple && triple[0])
+		{
+			std::string arch = triple;
+			process.m_arch = arch.substr(0, arch.find('-'));
+		}
+
+		// The platforms do not report the arguments, so this is only the path of the executable
+		char path[4096];
+		if (info.GetExecutableFile().GetPath(path, sizeof(path)) > 0)
+			process.m_commandLine = path;
+
+		processes.push_back(std::move(process));
+	}
+	return processes;
 }
 
 
@@ -615,7 +1000,7 @@ DebugBreakpoint LldbAdapter::AddBreakpoint(const ModuleNameAndOffset& address, u
 		auto ret = InvokeBackendCommand(entryBreakpointCommand);
 		DebuggerEvent evt;
 		evt.type = BackendMessageEventType;
-		evt.data.messageData.message = ret;
+		evt.data.MessageData().message = ret;
 		PostDebuggerEvent(evt);
 	}
 
@@ -669,6 +1054,275 @@ std::vector<DebugBreakpoint> LldbAdapter::GetBreakpointList() const
 }
 
 
+size_t LldbAdapter::AddBreakpoints(const std::vector<ModuleNameAndOffset>& breakpoints)
+{
+	return CreateBreakpoints(breakpoints, false);
+}
+
+
+size_t LldbAdapter::AddOneShotBreakpoints(const std::vector<ModuleNameAndOffset>& breakpoints)
+{
+	return CreateBreakpoints(breakpoints, true);
+}
+
+
+void LldbAdapter::OneShotBreakpointHit(uint64_t address)
+{
+	// LLDB has already deleted the breakpoint when it was hit
+}
+
+
+size_t LldbAdapter::CreateBreakpoints(const std::vector<ModuleNameAndOffset>& breakpoints, bool oneShot)
+{
+	if (breakpoints.empty())
+		return 0;
+
+	if (!m_targetActive)
+	{
+		auto& pendingList = oneShot ? m_pendingOneShotBreakpoints : m_pendingBreakpoints;
+		std::set<ModuleNameAndOffset> pending(pendingList.begin(), pendingList.end());
+		size_t added = 0;
+		for (const auto& breakpoint : breakpoints)
+		{
+			if (pending.insert(breakpoint).second)
+			{
+				pendingList.push_back(breakpoint);
+				added++;
+			}
+		}
+		return added;
+	}
+
+	// Look up every module once, and create the breakpoints through the SB API rather than formatting and running a
+	// "b -s" command for each of them. The IDs are only known once each breakpoint exists, so while any of them is
+	// missing, the listener thread holds back the events of unknown breakpoints instead of forwarding them.
+	{
+		std::unique_lock<std::mutex> lock(m_quietBreakpointMutex);
+		m_quietBreakpointWriters++;
+	}
+
+	std::map<std::string, SBModule> modules;
+	std::vector<break_id_t> ids;
+	ids.reserve(breakpoints.size());
+	size_t failed = 0;
+	for (const auto& breakpoint : breakpoints)
+	{
+		auto iter = modules.find(breakpoint.module);
+		if (iter == modules.end())
+			iter = modules.emplace(breakpoint.module, m_target.FindModule(SBFileSpec(breakpoint.module.c_str()))).first;
+
+		// Same file address as in AddBreakpoint() above
+		uint64_t fileAddress = breakpoint.offset + m_originalImageBase;
+		SBBreakpoint bp;
+		if (iter->second.IsValid())
+		{
+			SBAddress address = iter->second.ResolveFileAddress(fileAddress);
+			if (address.IsValid())
+				bp = m_target.BreakpointCreateBySBAddress(address);
+		}
+		else
+		{
+			// The module is not loaded yet. "b -s" creates a breakpoint that gets resolved when it is loaded.
+			uint32_t count = m_target.GetNumBreakpoints();
+			InvokeBackendCommand(fmt::format("b -s \"{}\" -a 0x{:x}", breakpoint.module, fileAddress));
+			if (m_target.GetNumBreakpoints() > count)
+				bp = m_target.GetBreakpointAtIndex(m_target.GetNumBreakpoints() - 1);
+		}
+
+		if (bp.IsValid())
+		{
+			if (oneShot)
+				bp.SetOneShot(true);
+			ids.push_back(bp.GetID());
+		}
+		else
+		{
+			failed++;
+		}
+	}
+
+	std::vector<std::pair<SBBreakpoint, lldb::BreakpointEventType>> deferred;
+	{
+		std::unique_lock<std::mutex> lock(m_quietBreakpointMutex);
+		for (auto id : ids)
+		{
+			m_quietBreakpointIds.insert(id);
+			if (oneShot)
+				m_oneShotBreakpointIds.insert(id);
+		}
+		if (--m_quietBreakpointWriters == 0)
+			deferred.swap(m_deferredBreakpointEvents);
+	}
+
+	// The events held back meanwhile are either of the new breakpoints, or of ones added or removed elsewhere, e.g.,
+	// from the LLDB console
+	for (const auto& [bp, bpEventType] : deferred)
+	{
+		if (!ConsumeQuietBreakpoint(bp, bpEventType))
+			ForwardBreakpointEvent(bp, bpEventType);
+	}
+
+	size_t added = ids.size();
+	DebuggerEvent evt;
+	evt.type = BackendMessageEventType;
+	const char* kind = oneShot ? "one-shot breakpoint(s)" : "breakpoint(s)";
+	if (failed == 0)
+		evt.data.MessageData().message = fmt::format("Added {} {}\n", added, kind);
+	else
+		evt.data.MessageData().message = fmt::format("Added {} {}, {} failed\n", added, kind, failed);
+	PostDebuggerEvent(evt);
+	return added;
+}
+
+
+size_t LldbAdapter::RemoveBreakpoints(const std::vector<uint64_t>& addresses)
+{
+	if (addresses.empty())
+		return 0;
+
+	// Scan the breakpoints of the target once, instead of once per address like RemoveBreakpoint() does
+	std::unordered_set<uint64_t> toRemove(addresses.begin(), addresses.end());
+	std::unordered_set<uint64_t> removed;
+	std::vector<break_id_t> ids;
+	for (size_t i = 0; i < m_target.GetNumBreakpoints(); i++)
+	{
+		auto bp = m_target.GetBreakpointAtIndex(i);
+		for (size_t j = 0; j < bp.GetNumLocations(); j++)
+		{
+			uint64_t bpAddress = bp.GetLocationAtIndex(j).GetAddress().GetLoadAddress(m_target);
+			if (toRemove.find(bpAddress) != toRemove.end())
+			{
+				ids.push_back(bp.GetID());
+				removed.insert(bpAddress);
+				break;
+			}
+		}
+	}
+
+	std::unique_lock<std::mutex> lock(m_quietBreakpointMutex);
+	for (auto id : ids)
+	{
+		m_quietBreakpointIds.insert(id);
+		if (!m_target.BreakpointDelete(id))
+			m_quietBreakpointIds.erase(id);
+	}
+	lock.unlock();
+
+	DebuggerEvent evt;
+	evt.type = BackendMessageEventType;
+	evt.data.MessageData().message = fmt::format("Removed {} breakpoint(s)\n", removed.size());
+	PostDebuggerEvent(evt);
+	return removed.size();
+}
+
+
+bool LldbAdapter::ConsumeQuietBreakpoint(SBBreakpoint bp, lldb::BreakpointEventType type)
+{
+	std::unique_lock<std::mutex> lock(m_quietBreakpointMutex);
+	break_id_t id = bp.GetID();
+	bool quiet = m_quietBreakpointIds.erase(id) != 0;
+	if (type == lldb::eBreakpointEventTypeRemoved)
+		quiet = (m_oneShotBreakpointIds.erase(id) != 0) || quiet;
+	if (quiet)
+		return true;
+
+	// The breakpoint may be one that CreateBreakpoints() has not recorded yet. Waiting for it would stall the
+	// listener, which is shared by all targets in multi-target mode, so the event is decided on once it is done.
+	if (m_quietBreakpointWriters > 0)
+	{
+		m_deferredBreakpointEvents.emplace_back(bp, type);
+		return true;
+	}
+	return false;
+}
+
+
+void LldbAdapter::ForwardBreakpointEvent(SBBreakpoint bp, lldb::BreakpointEventType type)
+{
+	// Resolving the locations can take a while for a breakpoint with many of them. Going through the worker also
+	// keeps the breakpoint events in order with the stops.
+	m_worker.Enqueue([post = m_eventCallback, bp, type]() { PostBreakpointEvents(bp, type, post); });
+}
+
+
+void LldbAdapter::ClearQuietBreakpoints()
+{
+	std::unique_lock<std::mutex> lock(m_quietBreakpointMutex);
+	m_quietBreakpointIds.clear();
+	m_oneShotBreakpointIds.clear();
+}
+
+
+bool LldbAdapter::AddWatchpoint(std::uintptr_t address, std::size_t size, DebugWatchpointType type)
+{
+	SBError error;
+	SBWatchpoint watchpoint =
+		m_target.WatchAddress(address, size, (type & ReadWatchpoint) != 0, (type & WriteWatchpoint) != 0, error);
+	if (!watchpoint.IsValid())
+	{
+		LogWarn("Failed to add a watchpoint at 0x%" PRIx64 ": %s", (uint64_t)address,
+			error.GetCString() ? error.GetCString() : "unknown error");
+		return false;
+	}
+	return true;
+}
+
+
+bool LldbAdapter::RemoveWatchpoint(std::uintptr_t address)
+{
+	bool ok = false;
+	for (size_t i = 0; i < m_target.GetNumWatchpoints(); i++)
+	{
+		auto watchpoint = m_target.GetWatchpointAtIndex(i);
+		if (watchpoint.GetWatchAddress() == address)
+		{
+			ok = m_target.DeleteWatchpoint(watchpoint.GetID());
+			break;
+		}
+	}
+	return ok;
+}
+
+
+bool LldbAdapter::GetStoppedWatchpoint(std::uintptr_t& address)
+{
+	// For a watchpoint stop, the first stop reason datum of the thread is the id of the watchpoint
+	size_t numThreads = m_process.GetNumThreads();
+	for (size_t i = 0; i < numThreads; i++)
+	{
+		SBThread thread = m_process.GetThreadAtIndex(i);
+		if ((thread.GetStopReason() != lldb::eStopReasonWatchpoint) || (thread.GetStopReasonDataCount() == 0))
+			continue;
+
+		auto watchpoint = m_target.FindWatchpointByID(thread.GetStopReasonDataAtIndex(0));
+		if (!watchpoint.IsValid())
+			continue;
+
+		address = watchpoint.GetWatchAddress();
+		return true;
+	}
+	return false;
+}
+
+
+bool LldbAdapter::GetWatchpointInfo(std::uintptr_t address, std::size_t& size, DebugWatchpointType& type)
+{
+	for (size_t i = 0; i < m_target.GetNumWatchpoints(); i++)
+	{
+		auto watchpoint = m_target.GetWatchpointAtIndex(i);
+		if (watchpoint.GetWatchAddress() != address)
+			continue;
+
+		size = watchpoint.GetWatchSize();
+		int flags = (watchpoint.IsWatchingReads() ? ReadWatchpoint : 0)
+			| (watchpoint.IsWatchingWrites() ? WriteWatchpoint : 0);
+		type = (DebugWatchpointType)flags;
+		return true;
+	}
+	return false;
+}
+
+
 std::unordered_map<std::string, DebugRegister> LldbAdapter::ReadAllRegisters()
 {
 	std::unordered_map<std::string, DebugRegister> result;
@@ -732,21 +1386,14 @@ DebugRegister LldbAdapter::ReadRegister(const std::string& name)
 	if (!frame.IsValid())
 		return result;
 
-	SBValueList regGroups = frame.GetRegisters();
-	size_t numGroups = regGroups.GetSize();
-	for (size_t i = 0; i < numGroups; i++)
-	{
-		SBValue regGroupInfo = regGroups.GetValueAtIndex(i);
-		size_t numRegs = regGroupInfo.GetNumChildren();
-		for (size_t j = 0; j < numRegs; j++)
-		{
-			SBValue reg = regGroupInfo.GetChildAtIndex(j);
-			if (name == reg.GetName())
-				// TODO: register width and internal index
-				return DebugRegister(name, reg.GetValueAsUnsigned(), 0, 0);
-		}
-	}
-	return result;
+	// LLDB looks the register up in its own register info table, which also knows about the aliases, e.g., fp and x29.
+	// This is much faster than walking every register group and comparing the names.
+	SBValue reg = frame.FindRegister(name.c_str());
+	if (!reg.IsValid())
+		return result;
+
+	// TODO: internal index
+	return DebugRegister(name, reg.GetValueAsUnsigned(), reg.GetByteSize() * 8, 0);
 }
 
 
@@ -1028,6 +1675,10 @@ DebugStopReason LldbAdapter::StopReason()
 			{
 				reason = DebugStopReason::Breakpoint;
 			}
+			else if (threadReason == lldb::eStopReasonWatchpoint)
+			{
+				reason = DebugStopReason::Watchpoint;
+			}
 			else if (threadReason == lldb::eStopReasonSignal)
 			{
 				size_t dataCount = thread.GetStopReasonDataCount();
@@ -1083,8 +1734,8 @@ bool LldbAdapter::BreakInto()
 	{
 		DebuggerEvent event;
 		event.type = ErrorEventType;
-		event.data.errorData.shortError = "pause failed";
-		event.data.errorData.error = fmt::format("LLDB: pause failed, process state is not running");
+		event.data.ErrorData().shortError = "pause failed";
+		event.data.ErrorData().error = fmt::format("LLDB: pause failed, process state is not running");
 		PostDebuggerEvent(event);
 		return false;
 	}
@@ -1101,8 +1752,8 @@ bool LldbAdapter::Go()
 	{
 		DebuggerEvent event;
 		event.type = ErrorEventType;
-		event.data.errorData.shortError = "Go failed";
-		event.data.errorData.error = fmt::format("LLDB: go failed, process state is not stopped");
+		event.data.ErrorData().shortError = "Go failed";
+		event.data.ErrorData().error = fmt::format("LLDB: go failed, process state is not stopped");
 		PostDebuggerEvent(event);
 		return false;
 	}
@@ -1124,8 +1775,8 @@ bool LldbAdapter::StepInto()
 	{
 		DebuggerEvent event;
 		event.type = ErrorEventType;
-		event.data.errorData.shortError = "step into failed";
-		event.data.errorData.error = fmt::format("LLDB: step into failed, process state is not stopped");
+		event.data.ErrorData().shortError = "step into failed";
+		event.data.ErrorData().error = fmt::format("LLDB: step into failed, process state is not stopped");
 		PostDebuggerEvent(event);
 		return false;
 	}
@@ -1136,8 +1787,8 @@ bool LldbAdapter::StepInto()
 	{
 		DebuggerEvent event;
 		event.type = ErrorEventType;
-		event.data.errorData.shortError = "Step into failed";
-		event.data.errorData.error = fmt::format("LLDB: step into failed, invalid thread");
+		event.data.ErrorData().shortError = "Step into failed";
+		event.data.ErrorData().error = fmt::format("LLDB: step into failed, invalid thread");
 		PostDebuggerEvent(event);
 		return false;
 	}
@@ -1148,8 +1799,8 @@ bool LldbAdapter::StepInto()
 	{
 		DebuggerEvent event;
 		event.type = ErrorEventType;
-		event.data.errorData.shortError = "Step into failed";
-		event.data.errorData.error =
+		event.data.ErrorData().shortError = "Step into failed";
+		event.data.ErrorData().error =
 			fmt::format("LLDB: step into failed {}", error.GetCString() ? error.GetCString() : "");
 		PostDebuggerEvent(event);
 		return false;
@@ -1167,8 +1818,8 @@ bool LldbAdapter::StepOver()
 	{
 		DebuggerEvent event;
 		event.type = ErrorEventType;
-		event.data.errorData.shortError = "Step over failed";
-		event.data.errorData.error = fmt::format("LLDB: step over failed, process state is not stopped");
+		event.data.ErrorData().shortError = "Step over failed";
+		event.data.ErrorData().error = fmt::format("LLDB: step over failed, process state is not stopped");
 		PostDebuggerEvent(event);
 		return false;
 	}
@@ -1179,8 +1830,8 @@ bool LldbAdapter::StepOver()
 	{
 		DebuggerEvent event;
 		event.type = ErrorEventType;
-		event.data.errorData.shortError = "Step over failed";
-		event.data.errorData.error = fmt::format("LLDB: step over failed, invalid thread");
+		event.data.ErrorData().shortError = "Step over failed";
+		event.data.ErrorData().error = fmt::format("LLDB: step over failed, invalid thread");
 		PostDebuggerEvent(event);
 		return false;
 	}
@@ -1191,8 +1842,8 @@ bool LldbAdapter::StepOver()
 	{
 		DebuggerEvent event;
 		event.type = ErrorEventType;
-		event.data.errorData.shortError = "Step over failed";
-		event.data.errorData.error =
+		event.data.ErrorData().shortError = "Step over failed";
+		event.data.ErrorData().error =
 			fmt::format("LLDB: step over failed {}", error.GetCString() ? error.GetCString() : "");
 		PostDebuggerEvent(event);
 		return false;
@@ -1210,8 +1861,8 @@ bool LldbAdapter::StepReturn()
 	{
 		DebuggerEvent event;
 		event.type = ErrorEventType;
-		event.data.errorData.shortError = "Step return failed";
-		event.data.errorData.error = fmt::format("LLDB: step return failed, process state is not stopped");
+		event.data.ErrorData().shortError = "Step return failed";
+		event.data.ErrorData().error = fmt::format("LLDB: step return failed, process state is not stopped");
 		PostDebuggerEvent(event);
 		return false;
 	}
@@ -1240,8 +1891,8 @@ bool LldbAdapter::StepReturn()
 	{
 		DebuggerEvent event;
 		event.type = ErrorEventType;
-		event.data.errorData.shortError = "Step return failed";
-		event.data.errorData.error = fmt::format("LLDB: step return failed, {}", result);
+		event.data.ErrorData().shortError = "Step return failed";
+		event.data.ErrorData().error = fmt::format("LLDB: step return failed, {}", result);
 		PostDebuggerEvent(event);
 		return false;
 	}
@@ -1256,6 +1907,15 @@ std::string LldbAdapter::InvokeBackendCommand(const std::string& command)
 	// Since the `kill` command can cause the target to quit, we must guard this function with the mutex as well
 	std::unique_lock<std::mutex> lock(m_quitingMutex);
 
+	// Commands apply to the selected target of the shared debugger, so select ours for the duration of the command
+	std::unique_lock<std::recursive_mutex> commandLock;
+	if (m_multiTarget)
+	{
+		commandLock = std::unique_lock<std::recursive_mutex>(LldbSession::Get()->GetCommandMutex());
+		if (m_target.IsValid())
+			m_debugger.SetSelectedTarget(m_target);
+	}
+
 	SBCommandInterpreter interpreter = m_debugger.GetCommandInterpreter();
 	SBCommandReturnObject commandResult;
 	interpreter.HandleCommand(command.c_str(), commandResult);
@@ -1311,7 +1971,7 @@ uint64_t LldbAdapter::GetStackPointer()
 
 bool LldbAdapter::SupportFeature(DebugAdapterCapacity feature)
 {
-	return false;
+	return (feature == DebugAdapterSupportStopFilter) || (feature == DebugAdapterSupportStepReturn);
 }
 
 
@@ -1357,7 +2017,7 @@ void LldbAdapter::FixActiveThread()
 }
 
 
-void LldbAdapter::EventListener()
+void LldbAdapter::EventListener(uint64_t generation)
 {
 	auto listener = m_debugger.GetListener();
 
@@ -1365,190 +2025,299 @@ void LldbAdapter::EventListener()
 	while (!done)
 	{
 		SBEvent event;
-		if (!listener.WaitForEvent(1, event))
+		// Block until there is an event, rather than polling. UINT32_MAX means no timeout.
+		if (!listener.WaitForEvent(UINT32_MAX, event))
 			continue;
 
-		uint32_t event_type = event.GetType();
-		if (lldb::SBProcess::EventIsProcessEvent(event))
+		if (event.BroadcasterMatchesRef(m_interruptBroadcaster))
 		{
-			SBProcess process = lldb::SBProcess::GetProcessFromEvent(event);
-			if (event_type & lldb::SBProcess::eBroadcastBitStateChanged)
-			{
-				// This can solve the problem that if the user resumes/steps the target from the console,
-				// the UI is not updated. However, in order to receive the eBroadcastBitStateChanged notification,
-				// We need to turn on async mode, which requires other changes as well.
+			const char* target = SBEvent::GetCStringFromEvent(event);
+			done = target && (std::to_string(generation) == target);
+			continue;
+		}
 
-				StateType state = SBProcess::GetStateFromEvent(event);
-				switch (state)
-				{
-				case lldb::eStateRunning:
-				{
-					DebuggerEvent dbgevt;
-					dbgevt.type = ResumeEventType;
-					PostDebuggerEvent(dbgevt);
-					break;
-				}
-				// LLDB seems to always report eStateRunning instead of eStateStepping
-				case lldb::eStateStepping:
-				{
-					DebuggerEvent dbgevt;
-					dbgevt.type = StepIntoEventType;
-					PostDebuggerEvent(dbgevt);
-					break;
-				}
-				case lldb::eStateStopped:
-				{
-					FixActiveThread();
-					DebuggerEvent dbgevt;
-					dbgevt.type = AdapterStoppedEventType;
-					// LLDB sometimes fails to update the process status when it is already sending eStateStopped event.
-					// When we restart the process, the target will appear to have exited
-					auto reason = StopReason();
-					if (reason == ProcessExited)
-						reason = UnknownReason;
-					dbgevt.data.targetStoppedData.reason = reason;
-					PostDebuggerEvent(dbgevt);
-					break;
-				}
-				case lldb::eStateExited:
+		done = HandleEvent(event);
+	}
+
+	listener.Clear();
+}
+
+
+void LldbAdapter::InterruptEventListener()
+{
+	if (m_multiTarget)
+		return;
+
+	std::string generation = std::to_string(m_listenerGeneration.load());
+	SBEvent event(InterruptEventBit, generation.c_str(), (uint32_t)generation.size());
+	m_interruptBroadcaster.BroadcastEvent(event);
+}
+
+
+void LldbAdapter::JoinEventListener()
+{
+	if (!m_listenerThread.joinable())
+		return;
+
+	// The listener stops once the target exits or detaches, or once it is interrupted. Handling an event never waits
+	// for another thread, so this does not wait for long.
+	InterruptEventListener();
+	if (m_listenerThread.get_id() == std::this_thread::get_id())
+		m_listenerThread.detach();
+	else
+		m_listenerThread.join();
+}
+
+
+void LldbAdapter::EnqueueEvent(const DebuggerEvent& event)
+{
+	auto post = m_eventCallback;
+	m_worker.Enqueue([post, event]() {
+		if (post)
+			post(event);
+	});
+}
+
+
+bool LldbAdapter::HandleEvent(SBEvent& event)
+{
+	bool done = false;
+	uint32_t event_type = event.GetType();
+	if (lldb::SBProcess::EventIsProcessEvent(event))
+	{
+		SBProcess process = lldb::SBProcess::GetProcessFromEvent(event);
+		if (event_type & lldb::SBProcess::eBroadcastBitStateChanged)
+		{
+			// This can solve the problem that if the user resumes/steps the target from the console,
+			// the UI is not updated. However, in order to receive the eBroadcastBitStateChanged notification,
+			// We need to turn on async mode, which requires other changes as well.
+
+			StateType state = SBProcess::GetStateFromEvent(event);
+			switch (state)
+			{
+			case lldb::eStateRunning:
+			{
+				if (m_resumedByStopFilter)
 				{
-					done = true;
-					m_targetActive = false;
-					DebuggerEvent dbgevt;
-					dbgevt.type = TargetExitedEventType;
-					dbgevt.data.exitData.exitCode = ExitCode();
-					PostDebuggerEvent(dbgevt);
+					m_resumedByStopFilter = false;
 					break;
 				}
-				case lldb::eStateDetached:
+				DebuggerEvent dbgevt;
+				dbgevt.type = ResumeEventType;
+				EnqueueEvent(dbgevt);
+				break;
+			}
+			// LLDB seems to always report eStateRunning instead of eStateStepping
+			case lldb::eStateStepping:
+			{
+				DebuggerEvent dbgevt;
+				dbgevt.type = StepIntoEventType;
+				EnqueueEvent(dbgevt);
+				break;
+			}
+			case lldb::eStateStopped:
+			{
+				FixActiveThread();
+				// LLDB sometimes fails to update the process status when it is already sending eStateStopped event.
+				// When we restart the process, the target will appear to have exited
+				auto reason = StopReason();
+				if (reason == ProcessExited)
+					reason = UnknownReason;
+				// A tracepoint, a breakpoint whose condition does not hold, and the like are resumed right here.
+				// Neither the controller nor the main thread ever sees the stop.
+				if (((reason == Breakpoint) || (reason == Watchpoint)) && m_stopFilter && m_stopFilter(reason)
+					&& m_process.Continue().Success())
 				{
-					done = true;
-					m_targetActive = false;
-					DebuggerEvent dbgevt;
-					dbgevt.type = DetachedEventType;
-					PostDebuggerEvent(dbgevt);
-					break;
-				}
-				default:
+					m_resumedByStopFilter = true;
 					break;
 				}
+				DebuggerEvent dbgevt;
+				dbgevt.type = AdapterStoppedEventType;
+				dbgevt.data.TargetStoppedData().reason = reason;
+				EnqueueEvent(dbgevt);
+				break;
 			}
-			else if ((event_type & lldb::SBProcess::eBroadcastBitSTDOUT)
-				|| (event_type & lldb::SBProcess::eBroadcastBitSTDERR))
+			case lldb::eStateExited:
 			{
-				char buffer[1024];
-				size_t count = 0;
-				std::string output {};
-				// TODO: we should differentiate stdout and stderr
-				while ((count = process.GetSTDOUT(buffer, 1024)) > 0)
-					output += std::string(buffer, count);
-
-				DebuggerEvent event;
-				event.type = StdoutMessageEventType;
-				event.data.messageData.message = output;
-				PostDebuggerEvent(event);
-
-				output.clear();
-				while ((count = process.GetSTDERR(buffer, 1024)) > 0)
-					output += std::string(buffer, count);
-
-				event.type = StdoutMessageEventType;
-				event.data.messageData.message = output;
-				PostDebuggerEvent(event);
+				done = true;
+				m_targetActive = false;
+				m_resumedByStopFilter = false;
+				ClearQuietBreakpoints();
+				DebuggerEvent dbgevt;
+				dbgevt.type = TargetExitedEventType;
+				dbgevt.data.ExitData().exitCode = ExitCode();
+				EnqueueEvent(dbgevt);
+				break;
 			}
-		}
-		else if (lldb::SBTarget::EventIsTargetEvent(event))
-		{
-			SBTarget target = lldb::SBTarget::GetTargetFromEvent(event);
-			if (event_type & lldb::SBTarget::eBroadcastBitModulesLoaded)
+			case lldb::eStateDetached:
 			{
-				[[maybe_unused]] size_t numModules = SBTarget::GetNumModulesFromEvent(event);
+				done = true;
+				m_targetActive = false;
+				m_resumedByStopFilter = false;
+				ClearQuietBreakpoints();
+				DebuggerEvent dbgevt;
+				dbgevt.type = DetachedEventType;
+				EnqueueEvent(dbgevt);
+				break;
 			}
-		}
-		else if (lldb::SBBreakpoint::EventIsBreakpointEvent(event))
-		{
-			if (event_type & lldb::SBTarget::eBroadcastBitBreakpointChanged)
-			{
-				auto bpEventType = lldb::SBBreakpoint::GetBreakpointEventTypeFromEvent(event);
-				auto bp = lldb::SBBreakpoint::GetBreakpointFromEvent(event);
-				for (size_t i = 0; i < bp.GetNumLocations(); i++)
-				{
-					if (bpEventType == lldb::eBreakpointEventTypeAdded)
-					{
-						auto location = bp.GetLocationAtIndex(i);
-						auto address = location.GetAddress();
-						auto module = address.GetModule();
-						if (module.IsValid())
-						{
-							SBAddress headerAddress = module.GetObjectFileHeaderAddress();
-							uint64_t moduleBase = headerAddress.GetLoadAddress(m_target);
-							uint64_t bpAddress = location.GetAddress().GetLoadAddress(m_target);
-							auto fileSpec = module.GetFileSpec();
-							char path[1024];
-							size_t bytes = fileSpec.GetPath(path, sizeof(path));
-							DebuggerEvent evt;
-							evt.type = RelativeBreakpointAddedEvent;
-							evt.data.relativeAddress.module = std::string(path, bytes);
-							evt.data.relativeAddress.offset = bpAddress - moduleBase;
-							PostDebuggerEvent(evt);
-						}
-						else
-						{
-							DebuggerEvent evt;
-							evt.type = AbsoluteBreakpointAddedEvent;
-							evt.data.absoluteAddress = location.GetAddress().GetLoadAddress(m_target);
-							PostDebuggerEvent(evt);
-						}
-					}
-					else if (bpEventType == lldb::eBreakpointEventTypeRemoved)
-					{
-						auto location = bp.GetLocationAtIndex(i);
-						auto address = location.GetAddress();
-						auto module = address.GetModule();
-						if (module.IsValid())
-						{
-							SBAddress headerAddress = module.GetObjectFileHeaderAddress();
-							uint64_t moduleBase = headerAddress.GetLoadAddress(m_target);
-							uint64_t bpAddress = location.GetAddress().GetLoadAddress(m_target);
-							auto fileSpec = module.GetFileSpec();
-							char path[1024];
-							size_t bytes = fileSpec.GetPath(path, sizeof(path));
-							DebuggerEvent evt;
-							evt.type = RelativeBreakpointRemovedEvent;
-							evt.data.relativeAddress.module = std::string(path, bytes);
-							evt.data.relativeAddress.offset = bpAddress - moduleBase;
-							PostDebuggerEvent(evt);
-						}
-						else
-						{
-							DebuggerEvent evt;
-							evt.type = AbsoluteBreakpointRemovedEvent;
-							evt.data.absoluteAddress = location.GetAddress().GetLoadAddress(m_target);
-							PostDebuggerEvent(evt);
-						}
-					}
-				}
+			default:
+				break;
 			}
 		}
-		else if (lldb::SBCommandInterpreter::EventIsCommandInterpreterEvent(event))
+		else if ((event_type & lldb::SBProcess::eBroadcastBitSTDOUT)
+			|| (event_type & lldb::SBProcess::eBroadcastBitSTDERR))
 		{
-			LogDebug("command line interpreter event");
+			// A chatty target can produce a lot of output, which must not hold up its other events
+			m_worker.Enqueue([post = m_eventCallback, process]() { PostOutput(process, post); });
 		}
-		else if (lldb::SBThread::EventIsThreadEvent(event))
+	}
+	else if (lldb::SBTarget::EventIsTargetEvent(event))
+	{
+		SBTarget target = lldb::SBTarget::GetTargetFromEvent(event);
+		if (event_type & lldb::SBTarget::eBroadcastBitModulesLoaded)
 		{
-			LogDebug("thread events");
+			[[maybe_unused]] size_t numModules = SBTarget::GetNumModulesFromEvent(event);
 		}
-		else if (lldb::SBWatchpoint::EventIsWatchpointEvent(event))
+	}
+	else if (lldb::SBBreakpoint::EventIsBreakpointEvent(event))
+	{
+		if (event_type & lldb::SBTarget::eBroadcastBitBreakpointChanged)
 		{
-			LogDebug("watchpoint event");
+			auto bpEventType = lldb::SBBreakpoint::GetBreakpointEventTypeFromEvent(event);
+			auto bp = lldb::SBBreakpoint::GetBreakpointFromEvent(event);
+			// Breakpoints added or removed in bulk are reported with a single summary message
+			if ((bpEventType == lldb::eBreakpointEventTypeAdded) || (bpEventType == lldb::eBreakpointEventTypeRemoved))
+			{
+				if (ConsumeQuietBreakpoint(bp, bpEventType))
+					return false;
+				ForwardBreakpointEvent(bp, bpEventType);
+			}
 		}
-		else if (lldb::SBProcess::EventIsStructuredDataEvent(event))
+	}
+	else if (lldb::SBCommandInterpreter::EventIsCommandInterpreterEvent(event))
+	{
+		LogDebug("command line interpreter event");
+	}
+	else if (lldb::SBThread::EventIsThreadEvent(event))
+	{
+		LogDebug("thread events");
+	}
+	else if (lldb::SBWatchpoint::EventIsWatchpointEvent(event))
+	{
+		// This also covers watchpoints added or removed from the LLDB console
+		auto watchpointEventType = lldb::SBWatchpoint::GetWatchpointEventTypeFromEvent(event);
+		auto watchpoint = lldb::SBWatchpoint::GetWatchpointFromEvent(event);
+		if (watchpoint.IsValid() && ((watchpointEventType == lldb::eWatchpointEventTypeAdded)
+			|| (watchpointEventType == lldb::eWatchpointEventTypeRemoved)))
 		{
-			LogDebug("structured data event");
+			DebuggerEvent evt;
+			evt.type = (watchpointEventType == lldb::eWatchpointEventTypeAdded) ? WatchpointAddedEvent :
+				WatchpointRemovedEvent;
+			evt.data.AbsoluteAddress() = watchpoint.GetWatchAddress();
+			EnqueueEvent(evt);
 		}
 	}
+	else if (lldb::SBProcess::EventIsStructuredDataEvent(event))
+	{
+		LogDebug("structured data event");
+	}
 
-	listener.Clear();
+	return done;
+}
+
+
+void LldbAdapter::PostOutput(SBProcess process, const std::function<void(const DebuggerEvent&)>& post)
+{
+	if (!post)
+		return;
+
+	char buffer[1024];
+	size_t count = 0;
+	std::string output {};
+	// TODO: we should differentiate stdout and stderr
+	while ((count = process.GetSTDOUT(buffer, 1024)) > 0)
+		output += std::string(buffer, count);
+
+	DebuggerEvent event;
+	event.type = StdoutMessageEventType;
+	event.data.MessageData().message = output;
+	post(event);
+
+	output.clear();
+	while ((count = process.GetSTDERR(buffer, 1024)) > 0)
+		output += std::string(buffer, count);
+
+	event.type = StdoutMessageEventType;
+	event.data.MessageData().message = output;
+	post(event);
+}
+
+
+void LldbAdapter::PostBreakpointEvents(
+	SBBreakpoint breakpoint, BreakpointEventType type, const std::function<void(const DebuggerEvent&)>& post)
+{
+	if (!post)
+		return;
+
+	// The target may have been replaced by a new launch since the event was received
+	SBTarget target = breakpoint.GetTarget();
+	for (size_t i = 0; i < breakpoint.GetNumLocations(); i++)
+	{
+		if (type == lldb::eBreakpointEventTypeAdded)
+		{
+			auto location = breakpoint.GetLocationAtIndex(i);
+			auto address = location.GetAddress();
+			auto module = address.GetModule();
+			if (module.IsValid())
+			{
+				SBAddress headerAddress = module.GetObjectFileHeaderAddress();
+				uint64_t moduleBase = headerAddress.GetLoadAddress(target);
+				uint64_t bpAddress = location.GetAddress().GetLoadAddress(target);
+				auto fileSpec = module.GetFileSpec();
+				char path[1024];
+				size_t bytes = fileSpec.GetPath(path, sizeof(path));
+				DebuggerEvent evt;
+				evt.type = RelativeBreakpointAddedEvent;
+				evt.data.RelativeAddress().module = std::string(path, bytes);
+				evt.data.RelativeAddress().offset = bpAddress - moduleBase;
+				post(evt);
+			}
+			else
+			{
+				DebuggerEvent evt;
+				evt.type = AbsoluteBreakpointAddedEvent;
+				evt.data.AbsoluteAddress() = location.GetAddress().GetLoadAddress(target);
+				post(evt);
+			}
+		}
+		else if (type == lldb::eBreakpointEventTypeRemoved)
+		{
+			auto location = breakpoint.GetLocationAtIndex(i);
+			auto address = location.GetAddress();
+			auto module = address.GetModule();
+			if (module.IsValid())
+			{
+				SBAddress headerAddress = module.GetObjectFileHeaderAddress();
+				uint64_t moduleBase = headerAddress.GetLoadAddress(target);
+				uint64_t bpAddress = location.GetAddress().GetLoadAddress(target);
+				auto fileSpec = module.GetFileSpec();
+				char path[1024];
+				size_t bytes = fileSpec.GetPath(path, sizeof(path));
+				DebuggerEvent evt;
+				evt.type = RelativeBreakpointRemovedEvent;
+				evt.data.RelativeAddress().module = std::string(path, bytes);
+				evt.data.RelativeAddress().offset = bpAddress - moduleBase;
+				post(evt);
+			}
+			else
+			{
+				DebuggerEvent evt;
+				evt.type = AbsoluteBreakpointRemovedEvent;
+				evt.data.AbsoluteAddress() = location.GetAddress().GetLoadAddress(target);
+				post(evt);
+			}
+		}
+	}
 }
 
 
@@ -14,6 +14,13 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <unordered_set>
 #include "../debugadapter.h"
 #include "../debugadaptertype.h"
 #ifdef WIN32
@@ -26,15 +33,124 @@ limitations under the License.
 #endif
 
 namespace BinaryNinjaDebugger {
+	class LldbAdapter;
+
+	// Runs tasks one at a time, in the order they are enqueued, on a thread of its own. The event listener of an
+	// adapter hands every event to it, so the listener never waits for the main thread and gets to the next event right
+	// away. A task must not refer to the adapter, since it can still be running once the adapter is destroyed.
+	class SerialWorker
+	{
+		struct Queue
+		{
+			std::mutex mutex;
+			std::condition_variable condition;
+			std::deque<std::function<void()>> tasks;
+			bool stop = false;
+		};
+		// Shared with the thread, which outlives the worker when a task is running as it is destroyed
+		std::shared_ptr<Queue> m_queue;
+
+		static void Run(std::shared_ptr<Queue> queue);
+
+	public:
+		SerialWorker();
+		// Drops the tasks that have not started yet, and does not wait for the one that is running
+		~SerialWorker();
+		void Enqueue(std::function<void()> task);
+	};
+
+
+	// In multi-target mode (debugger.lldbMultiTarget), all LLDB adapters share one SBDebugger and a single thread that
+	// listens to its events. Each event is dispatched to the adapter that owns the target it comes from, which hands it
+	// to its own worker. Debugging dozens of processes then costs neither an LLDB instance nor a listener each, and a
+	// target whose controller is slow to take an event does not hold up the others.
+	class LldbSession
+	{
+		lldb::SBDebugger m_debugger;
+		// The command interpreter works on the selected target, so the commands of different adapters must not
+		// interleave
+		std::recursive_mutex m_commandMutex;
+
+		std::mutex m_mutex;
+		std::vector<std::pair<lldb::SBTarget, LldbAdapter*>> m_targets;
+		bool m_listenerStarted = false;
+		std::thread::id m_listenerThreadId;
+		// The adapter that is handling an event right now. The lock is not held while it does, since handling an event
+		// talks to LLDB, which may be adding a target of another adapter.
+		LldbAdapter* m_dispatching = nullptr;
+		std::condition_variable m_dispatchDone;
+
+		LldbSession();
+		void EventListener();
+		// Finds the target that sent the event, and the adapter it belongs to
+		bool FindTarget(lldb::SBEvent& event, lldb::SBTarget& target, LldbAdapter*& adapter);
+
+	public:
+		static LldbSession* Get();
+		lldb::SBDebugger GetDebugger() const { return m_debugger; }
+		std::recursive_mutex& GetCommandMutex() { return m_commandMutex; }
+		// Events of the target are dispatched to the adapter until the target exits or detaches, or it is removed
+		void AddTarget(const lldb::SBTarget& target, LldbAdapter* adapter);
+		void RemoveTarget(const lldb::SBTarget& target);
+		// Removes all targets of the adapter, and waits for an event that is being dispatched to it to be handled.
+		// Handling an event only queries LLDB and never waits for the main thread, so this does not wait for long.
+		void RemoveAdapter(LldbAdapter* adapter);
+	};
+
+
 	class LldbAdapter : public DebugAdapter
 	{
 	private:
 		lldb::SBDebugger m_debugger;
 		lldb::SBTarget m_target;
 		lldb::SBProcess m_process;
+		// Whether m_debugger is the one of the LldbSession, rather than a debugger of this adapter alone
+		bool m_multiTarget = false;
+		// Starts listening to the events of the target that is about to be created
+		void StartEventListener();
+		void OnTargetCreated();
+
+		// The listener blocks until there is an event. If the target will never send one that ends the loop, e.g.,
+		// when the launch fails, it is woken up by an event of this broadcaster instead. The event carries the
+		// generation of the listener it is meant for, so an interrupt that arrives late is not taken for the next one.
+		lldb::SBBroadcaster m_interruptBroadcaster;
+		std::atomic<uint64_t> m_listenerGeneration = 0;
+		void InterruptEventListener();
+		// The listener of a single-target adapter. It is joined rather than detached, so it is never left handling an
+		// event of an adapter that is destroyed.
+		std::thread m_listenerThread;
+		void JoinEventListener();
+
+		// Posts the events of the listener to the controller, in the order they are received. The tasks only hold a
+		// copy of the event callback, never the adapter.
+		SerialWorker m_worker;
+		void EnqueueEvent(const DebuggerEvent& event);
+		// Set when the stop filter resumed the target, so the running event that follows is not posted either
+		bool m_resumedByStopFilter = false;
+		static void PostOutput(lldb::SBProcess process, const std::function<void(const DebuggerEvent&)>& post);
+		static void PostBreakpointEvents(lldb::SBBreakpoint breakpoint, lldb::BreakpointEventType type,
+			const std::function<void(const DebuggerEvent&)>& post);
 
 		bool m_targetActive;
 		std::vector<ModuleNameAndOffset> m_pendingBreakpoints {};
+		std::vector<ModuleNameAndOffset> m_pendingOneShotBreakpoints {};
+
+		// IDs of the breakpoints added or removed by AddBreakpoints() and RemoveBreakpoints(), whose LLDB breakpoint
+		// events are not forwarded to the controller. The bulk operations post a single summary message instead.
+		// One-shot breakpoints also stay quiet when LLDB deletes them after they are hit.
+		std::unordered_set<lldb::break_id_t> m_quietBreakpointIds;
+		std::unordered_set<lldb::break_id_t> m_oneShotBreakpointIds;
+		std::mutex m_quietBreakpointMutex;
+		// Number of CreateBreakpoints() calls that are still creating breakpoints. The events of unknown breakpoints
+		// that arrive meanwhile are held back here, and forwarded or dropped once the last of them is done.
+		size_t m_quietBreakpointWriters = 0;
+		std::vector<std::pair<lldb::SBBreakpoint, lldb::BreakpointEventType>> m_deferredBreakpointEvents;
+		// Returns true if the event of the breakpoint must not be forwarded now, either because it is quiet, or
+		// because it is held back until CreateBreakpoints() is done
+		bool ConsumeQuietBreakpoint(lldb::SBBreakpoint bp, lldb::BreakpointEventType type);
+		void ForwardBreakpointEvent(lldb::SBBreakpoint bp, lldb::BreakpointEventType type);
+		void ClearQuietBreakpoints();
+		size_t CreateBreakpoints(const std::vector<ModuleNameAndOffset>& breakpoints, bool oneShot);
 
 		// Since when SBProcess::Kill() and SBProcess::ReadMemory() are called at the same time, LLDB will hang,
 		// we must use this mutex to prevent the quit operation and read memory operation to happen at the same time.
@@ -90,6 +206,22 @@ namespace BinaryNinjaDebugger {
 
 		std::vector<DebugBreakpoint> GetBreakpointList() const override;
 
+		size_t AddBreakpoints(const std::vector<ModuleNameAndOffset>& breakpoints) override;
+
+		size_t RemoveBreakpoints(const std::vector<uint64_t>& addresses) override;
+
+		size_t AddOneShotBreakpoints(const std::vector<ModuleNameAndOffset>& breakpoints) override;
+
+		void OneShotBreakpointHit(uint64_t address) override;
+
+		bool AddWatchpoint(std::uintptr_t address, std::size_t size, DebugWatchpointType type) override;
+
+		bool RemoveWatchpoint(std::uintptr_t address) override;
+
+		bool GetStoppedWatchpoint(std::uintptr_t& address) override;
+
+		bool GetWatchpointInfo(std::uintptr_t address, std::size_t& size, DebugWatchpointType& type) override;
+
 		std::unordered_map<std::string, DebugRegister> ReadAllRegisters() override;
 
 		DebugRegister ReadRegister(const std::string& reg) override;
@@ -126,7 +258,10 @@ namespace BinaryNinjaDebugger {
 
 		bool SupportFeature(DebugAdapterCapacity feature) override;
 
-		void EventListener();
+		void EventListener(uint64_t generation);
+
+		// Handles one event of the target. Returns true once the target has exited or detached.
+		bool HandleEvent(lldb::SBEvent& event);
 
 		void WriteStdin(const std::string& msg) override;
 
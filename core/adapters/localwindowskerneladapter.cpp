@@ -23,8 +23,8 @@ bool LocalWindowsKernelAdapter::ExecuteWithArgsInternal(const std::string& path,
         this->Reset();
         DebuggerEvent event;
         event.type = LaunchFailureEventType;
-        event.data.errorData.error = fmt::format("Failed to initialize DbgEng");
-        event.data.errorData.shortError = fmt::format("Failed to initialize DbgEng");
+        event.data.ErrorData().error = fmt::format("Failed to initialize DbgEng");
+        event.data.ErrorData().shortError = fmt::format("Failed to initialize DbgEng");
         PostDebuggerEvent(event);
         return false;
     }
@@ -34,8 +34,8 @@ bool LocalWindowsKernelAdapter::ExecuteWithArgsInternal(const std::string& path,
         this->Reset();
         DebuggerEvent event;
         event.type = LaunchFailureEventType;
-        event.data.errorData.error = fmt::format("AttachKernel failed: 0x{:x}", result);
-        event.data.errorData.shortError = fmt::format("AttachKernel failed: 0x{:x}", result);
+        event.data.ErrorData().error = fmt::format("AttachKernel failed: 0x{:x}", result);
+        event.data.ErrorData().shortError = fmt::format("AttachKernel failed: 0x{:x}", result);
         PostDebuggerEvent(event);
         return false;
     }
@@ -44,8 +44,8 @@ bool LocalWindowsKernelAdapter::ExecuteWithArgsInternal(const std::string& path,
     if (!Wait()) {
         DebuggerEvent event;
         event.type = LaunchFailureEventType;
-        event.data.errorData.error = fmt::format("WaitForEvent failed");
-        event.data.errorData.shortError = fmt::format("WaitForEvent failed");
+        event.data.ErrorData().error = fmt::format("WaitForEvent failed");
+        event.data.ErrorData().shortError = fmt::format("WaitForEvent failed");
         PostDebuggerEvent(event);
     }
 
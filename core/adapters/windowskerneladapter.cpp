@@ -23,8 +23,8 @@ bool WindowsKernelAdapter::ExecuteWithArgsInternal(const std::string& path, cons
         this->Reset();
         DebuggerEvent event;
         event.type = LaunchFailureEventType;
-        event.data.errorData.error = fmt::format("Failed to initialize DbgEng");
-        event.data.errorData.shortError = fmt::format("Failed to initialize DbgEng");
+        event.data.ErrorData().error = fmt::format("Failed to initialize DbgEng");
+        event.data.ErrorData().shortError = fmt::format("Failed to initialize DbgEng");
         PostDebuggerEvent(event);
         return false;
     }
@@ -33,8 +33,8 @@ bool WindowsKernelAdapter::ExecuteWithArgsInternal(const std::string& path, cons
         this->Reset();
         DebuggerEvent event;
         event.type = LaunchFailureEventType;
-        event.data.errorData.error = fmt::format("Failed to engine option DEBUG_ENGOPT_INITIAL_BREAK");
-        event.data.errorData.shortError = fmt::format("Failed to engine option");
+        event.data.ErrorData().error = fmt::format("Failed to engine option DEBUG_ENGOPT_INITIAL_BREAK");
+        event.data.ErrorData().shortError = fmt::format("Failed to engine option");
         PostDebuggerEvent(event);
         return false;
     }
@@ -45,8 +45,8 @@ bool WindowsKernelAdapter::ExecuteWithArgsInternal(const std::string& path, cons
         this->Reset();
         DebuggerEvent event;
         event.type = LaunchFailureEventType;
-        event.data.errorData.error = fmt::format("AttachKernel failed: 0x{:x}", result);
-        event.data.errorData.shortError = fmt::format("AttachKernel failed: 0x{:x}", result);
+        event.data.ErrorData().error = fmt::format("AttachKernel failed: 0x{:x}", result);
+        event.data.ErrorData().shortError = fmt::format("AttachKernel failed: 0x{:x}", result);
         PostDebuggerEvent(event);
         return false;
     }
@@ -55,8 +55,8 @@ bool WindowsKernelAdapter::ExecuteWithArgsInternal(const std::string& path, cons
     if (!Wait()) {
         DebuggerEvent event;
         event.type = LaunchFailureEventType;
-        event.data.errorData.error = fmt::format("WaitForEvent failed");
-        event.data.errorData.shortError = fmt::format("WaitForEvent failed");
+        event.data.ErrorData().error = fmt::format("WaitForEvent failed");
+        event.data.ErrorData().shortError = fmt::format("WaitForEvent failed");
         PostDebuggerEvent(event);
     }
 
@@ -73,8 +73,8 @@ bool WindowsKernelAdapter::ExecuteWithArgsInternal(const std::string& path, cons
             this->Reset();
             DebuggerEvent event;
             event.type = LaunchFailureEventType;
-            event.data.errorData.error = fmt::format("Failed to resume the target after the system entry point");
-            event.data.errorData.shortError = fmt::format("Failed to resume target");
+            event.data.ErrorData().error = fmt::format("Failed to resume the target after the system entry point");
+            event.data.ErrorData().shortError = fmt::format("Failed to resume target");
             PostDebuggerEvent(event);
             return false;
         }
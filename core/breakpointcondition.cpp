@@ -0,0 +1,460 @@
+/*
+Copyright 2020-2024 Vector 35 Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "breakpointcondition.h"
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+#include "fmt/format.h"
+
+using namespace BinaryNinjaDebugger;
+
+
+// A recursive descent parser with one function per precedence level, lowest first. Errors are reported by throwing
+// std::runtime_error, which Compile() turns into an error string.
+class BreakpointCondition::Parser
+{
+	const std::string& m_text;
+	size_t m_pos = 0;
+	std::vector<Node>& m_nodes;
+
+	void SkipSpaces()
+	{
+		while ((m_pos < m_text.size()) && isspace((unsigned char)m_text[m_pos]))
+			m_pos++;
+	}
+
+	bool Accept(const char* op)
+	{
+		SkipSpaces();
+		size_t length = strlen(op);
+		if (m_text.compare(m_pos, length, op) != 0)
+			return false;
+
+		// Do not take the "<" out of "<<", or the "&" out of "&&"
+		if ((length == 1) && (m_pos + 1 < m_text.size()))
+		{
+			char next = m_text[m_pos + 1];
+			if (((op[0] == '<') || (op[0] == '>')) && ((next == op[0]) || (next == '=')))
+				return false;
+			if (((op[0] == '&') || (op[0] == '|') || (op[0] == '=')) && (next == op[0]))
+				return false;
+			if ((op[0] == '!') && (next == '='))
+				return false;
+		}
+
+		m_pos += length;
+		return true;
+	}
+
+	void Expect(const char* op)
+	{
+		if (!Accept(op))
+			throw std::runtime_error(fmt::format("expected \"{}\" at offset {}", op, m_pos));
+	}
+
+	size_t NewNode(NodeType type, size_t left = 0, size_t right = 0)
+	{
+		Node node;
+		node.type = type;
+		node.left = left;
+		node.right = right;
+		m_nodes.push_back(node);
+		return m_nodes.size() - 1;
+	}
+
+	std::string ParseIdentifier()
+	{
+		size_t start = m_pos;
+		while ((m_pos < m_text.size()) && (isalnum((unsigned char)m_text[m_pos]) || (m_text[m_pos] == '_')))
+			m_pos++;
+		std::string result = m_text.substr(start, m_pos - start);
+		for (auto& c : result)
+			c = (char)tolower((unsigned char)c);
+		return result;
+	}
+
+	size_t ParseMemory(size_t size)
+	{
+		Expect("[");
+		size_t address = ParseLogicalOr();
+		Expect("]");
+		size_t index = NewNode(MemoryNode, address);
+		m_nodes[index].size = size;
+		return index;
+	}
+
+	size_t ParsePrimary()
+	{
+		SkipSpaces();
+		if (m_pos >= m_text.size())
+			throw std::runtime_error("unexpected end of condition");
+
+		if (Accept("("))
+		{
+			size_t result = ParseLogicalOr();
+			Expect(")");
+			return result;
+		}
+
+		if (m_text[m_pos] == '[')
+			return ParseMemory(0);
+
+		if (isdigit((unsigned char)m_text[m_pos]))
+		{
+			// Only decimal and 0x hex, so a leading zero does not make the number octal
+			bool hex = (m_text.compare(m_pos, 2, "0x") == 0) || (m_text.compare(m_pos, 2, "0X") == 0);
+			const char* start = m_text.data() + m_pos + (hex ? 2 : 0);
+			const char* end = m_text.data() + m_text.size();
+			uint64_t value;
+			auto result = std::from_chars(start, end, value, hex ? 16 : 10);
+			if (result.ec != std::errc())
+				throw std::runtime_error(fmt::format("invalid number at offset {}", m_pos));
+			m_pos = result.ptr - m_text.data();
+			size_t index = NewNode(ConstantNode);
+			m_nodes[index].value = value;
+			return index;
+		}
+
+		bool hasPrefix = (m_text[m_pos] == '$');
+		if (hasPrefix)
+			m_pos++;
+
+		size_t start = m_pos;
+		std::string name = ParseIdentifier();
+		if (name.empty())
+			throw std::runtime_error(fmt::format("unexpected character '{}' at offset {}", m_text[start], start));
+
+		if (!hasPrefix)
+		{
+			SkipSpaces();
+			if ((m_pos < m_text.size()) && (m_text[m_pos] == '['))
+			{
+				if (name == "byte")
+					return ParseMemory(1);
+				if (name == "word")
+					return ParseMemory(2);
+				if (name == "dword")
+					return ParseMemory(4);
+				if (name == "qword")
+					return ParseMemory(8);
+				throw std::runtime_error(fmt::format("unknown memory access size \"{}\"", name));
+			}
+		}
+
+		size_t index = NewNode(RegisterNode);
+		m_nodes[index].name = name;
+		return index;
+	}
+
+	size_t ParseUnary()
+	{
+		if (Accept("-"))
+			return NewNode(NegateNode, ParseUnary());
+		if (Accept("~"))
+			return NewNode(NotNode, ParseUnary());
+		if (Accept("!"))
+			return NewNode(LogicalNotNode, ParseUnary());
+		return ParsePrimary();
+	}
+
+	size_t ParseMultiplicative()
+	{
+		size_t left = ParseUnary();
+		while (true)
+		{
+			if (Accept("*"))
+				left = NewNode(MultiplyNode, left, ParseUnary());
+			else if (Accept("/"))
+				left = NewNode(DivideNode, left, ParseUnary());
+			else if (Accept("%"))
+				left = NewNode(ModuloNode, left, ParseUnary());
+			else
+				return left;
+		}
+	}
+
+	size_t ParseAdditive()
+	{
+		size_t left = ParseMultiplicative();
+		while (true)
+		{
+			if (Accept("+"))
+				left = NewNode(AddNode, left, ParseMultiplicative());
+			else if (Accept("-"))
+				left = NewNode(SubtractNode, left, ParseMultiplicative());
+			else
+				return left;
+		}
+	}
+
+	size_t ParseShift()
+	{
+		size_t left = ParseAdditive();
+		while (true)
+		{
+			if (Accept("<<"))
+				left = NewNode(ShiftLeftNode, left, ParseAdditive());
+			else if (Accept(">>"))
+				left = NewNode(ShiftRightNode, left, ParseAdditive());
+			else
+				return left;
+		}
+	}
+
+	size_t ParseRelational()
+	{
+		size_t left = ParseShift();
+		while (true)
+		{
+			if (Accept("<="))
+				left = NewNode(LessEqualNode, left, ParseShift());
+			else if (Accept(">="))
+				left = NewNode(GreaterEqualNode, left, ParseShift());
+			else if (Accept("<"))
+				left = NewNode(LessNode, left, ParseShift());
+			else if (Accept(">"))
+				left = NewNode(GreaterNode, left, ParseShift());
+			else
+				return left;
+		}
+	}
+
+	size_t ParseEquality()
+	{
+		size_t left = ParseRelational();
+		while (true)
+		{
+			if (Accept("=="))
+				left = NewNode(EqualNode, left, ParseRelational());
+			else if (Accept("!="))
+				left = NewNode(NotEqualNode, left, ParseRelational());
+			else
+				return left;
+		}
+	}
+
+	size_t ParseBitAnd()
+	{
+		size_t left = ParseEquality();
+		while (Accept("&"))
+			left = NewNode(AndNode, left, ParseEquality());
+		return left;
+	}
+
+	size_t ParseBitXor()
+	{
+		size_t left = ParseBitAnd();
+		while (Accept("^"))
+			left = NewNode(XorNode, left, ParseBitAnd());
+		return left;
+	}
+
+	size_t ParseBitOr()
+	{
+		size_t left = ParseBitXor();
+		while (Accept("|"))
+			left = NewNode(OrNode, left, ParseBitXor());
+		return left;
+	}
+
+	size_t ParseLogicalAnd()
+	{
+		size_t left = ParseBitOr();
+		while (Accept("&&"))
+			left = NewNode(LogicalAndNode, left, ParseBitOr());
+		return left;
+	}
+
+	size_t ParseLogicalOr()
+	{
+		size_t left = ParseLogicalAnd();
+		while (Accept("||"))
+			left = NewNode(LogicalOrNode, left, ParseLogicalAnd());
+		return left;
+	}
+
+public:
+	Parser(const std::string& text, std::vector<Node>& nodes): m_text(text), m_nodes(nodes) {}
+
+	size_t Parse()
+	{
+		size_t root = ParseLogicalOr();
+		SkipSpaces();
+		if (m_pos != m_text.size())
+			throw std::runtime_error(fmt::format("unexpected character '{}' at offset {}", m_text[m_pos], m_pos));
+		return root;
+	}
+};
+
+
+std::shared_ptr<BreakpointCondition> BreakpointCondition::Compile(const std::string& text, std::string& error)
+{
+	auto result = std::make_shared<BreakpointCondition>();
+	result->m_text = text;
+	try
+	{
+		Parser parser(text, result->m_nodes);
+		result->m_root = parser.Parse();
+	}
+	catch (const std::exception& e)
+	{
+		error = e.what();
+		return nullptr;
+	}
+	return result;
+}
+
+
+bool BreakpointCondition::EvaluateNode(size_t index, const Context& context, uint64_t& value) const
+{
+	const Node& node = m_nodes[index];
+	switch (node.type)
+	{
+	case ConstantNode:
+		value = node.value;
+		return true;
+	case RegisterNode:
+		return context.readRegister && context.readRegister(node.name, value);
+	case MemoryNode:
+	{
+		uint64_t address;
+		if (!EvaluateNode(node.left, context, address))
+			return false;
+		size_t size = node.size ? node.size : context.addressSize;
+		std::vector<uint8_t> data;
+		if (!context.readMemory || !context.readMemory(address, size, data) || (data.size() != size))
+			return false;
+		value = 0;
+		for (size_t i = 0; i < size; i++)
+		{
+			size_t shift = context.littleEndian ? i : (size - 1 - i);
+			value |= (uint64_t)data[i] << (8 * shift);
+		}
+		return true;
+	}
+	case LogicalAndNode:
+	case LogicalOrNode:
+	{
+		uint64_t left;
+		if (!EvaluateNode(node.left, context, left))
+			return false;
+		// Short-circuit, so the right side can rely on the left one, e.g., for a null check before a read
+		if ((node.type == LogicalAndNode) ? (left == 0) : (left != 0))
+		{
+			value = (node.type == LogicalOrNode);
+			return true;
+		}
+		uint64_t right;
+		if (!EvaluateNode(node.right, context, right))
+			return false;
+		value = (right != 0);
+		return true;
+	}
+	default:
+		break;
+	}
+
+	uint64_t left;
+	if (!EvaluateNode(node.left, context, left))
+		return false;
+
+	switch (node.type)
+	{
+	case NegateNode:
+		value = (uint64_t)(-(int64_t)left);
+		return true;
+	case NotNode:
+		value = ~left;
+		return true;
+	case LogicalNotNode:
+		value = (left == 0);
+		return true;
+	default:
+		break;
+	}
+
+	uint64_t right;
+	if (!EvaluateNode(node.right, context, right))
+		return false;
+
+	switch (node.type)
+	{
+	case MultiplyNode:
+		value = left * right;
+		return true;
+	case DivideNode:
+		if (right == 0)
+			return false;
+		value = left / right;
+		return true;
+	case ModuloNode:
+		if (right == 0)
+			return false;
+		value = left % right;
+		return true;
+	case AddNode:
+		value = left + right;
+		return true;
+	case SubtractNode:
+		value = left - right;
+		return true;
+	case ShiftLeftNode:
+		value = (right >= 64) ? 0 : (left << right);
+		return true;
+	case ShiftRightNode:
+		value = (right >= 64) ? 0 : (left >> right);
+		return true;
+	case LessNode:
+		value = (left < right);
+		return true;
+	case LessEqualNode:
+		value = (left <= right);
+		return true;
+	case GreaterNode:
+		value = (left > right);
+		return true;
+	case GreaterEqualNode:
+		value = (left >= right);
+		return true;
+	case EqualNode:
+		value = (left == right);
+		return true;
+	case NotEqualNode:
+		value = (left != right);
+		return true;
+	case AndNode:
+		value = left & right;
+		return true;
+	case XorNode:
+		value = left ^ right;
+		return true;
+	case OrNode:
+		value = left | right;
+		return true;
+	default:
+		return false;
+	}
+}
+
+
+bool BreakpointCondition::Evaluate(const Context& context, uint64_t& value) const
+{
+	if (m_nodes.empty())
+		return false;
+	return EvaluateNode(m_root, context, value);
+}
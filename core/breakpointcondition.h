@@ -0,0 +1,105 @@
+/*
+Copyright 2020-2024 Vector 35 Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace BinaryNinjaDebugger {
+	// The condition of a conditional breakpoint. The text is parsed once, when the condition is set, into a small
+	// expression tree that is then evaluated on every hit without any further parsing.
+	//
+	// The syntax follows C expressions over 64-bit unsigned integers:
+	//   - integer literals, in decimal or with a 0x prefix
+	//   - registers, either bare (rax) or with a $ prefix ($rax), like the expression parser of the debugger view
+	//   - memory reads: [expr] reads a pointer-sized value; byte/word/dword/qword[expr] read 1/2/4/8 bytes
+	//   - unary - ~ !, binary * / % + - << >> < <= > >= == != & ^ | && ||, and parentheses
+	// && and || short-circuit, so "rdi != 0 && [rdi] == 0x41" never reads from a null pointer.
+	class BreakpointCondition
+	{
+	public:
+		// Supplies the target state to Evaluate(). Either function returns false if the value cannot be read;
+		// readMemory must return exactly size bytes.
+		struct Context
+		{
+			std::function<bool(const std::string& name, uint64_t& value)> readRegister;
+			std::function<bool(uint64_t address, size_t size, std::vector<uint8_t>& data)> readMemory;
+			size_t addressSize = 8;
+			bool littleEndian = true;
+		};
+
+	private:
+		enum NodeType
+		{
+			ConstantNode,
+			RegisterNode,
+			MemoryNode,
+			NegateNode,
+			NotNode,
+			LogicalNotNode,
+			MultiplyNode,
+			DivideNode,
+			ModuloNode,
+			AddNode,
+			SubtractNode,
+			ShiftLeftNode,
+			ShiftRightNode,
+			LessNode,
+			LessEqualNode,
+			GreaterNode,
+			GreaterEqualNode,
+			EqualNode,
+			NotEqualNode,
+			AndNode,
+			XorNode,
+			OrNode,
+			LogicalAndNode,
+			LogicalOrNode,
+		};
+
+		struct Node
+		{
+			NodeType type;
+			uint64_t value = 0;
+			// Register name for RegisterNode
+			std::string name;
+			// Read size for MemoryNode; 0 means the address size of the target
+			size_t size = 0;
+			size_t left = 0;
+			size_t right = 0;
+		};
+
+		class Parser;
+
+		std::string m_text;
+		std::vector<Node> m_nodes;
+		size_t m_root = 0;
+
+		bool EvaluateNode(size_t index, const Context& context, uint64_t& value) const;
+
+	public:
+		// Returns nullptr and fills error if the text is not a valid condition
+		static std::shared_ptr<BreakpointCondition> Compile(const std::string& text, std::string& error);
+
+		const std::string& GetText() const { return m_text; }
+		// Returns false if a register or memory read fails, or on a division by zero
+		bool Evaluate(const Context& context, uint64_t& value) const;
+	};
+};  // namespace BinaryNinjaDebugger
@@ -0,0 +1,767 @@
+/*
+Copyright 2020-2024 Vector 35 Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "compiledexpression.h"
+#include <algorithm>
+#include <cstring>
+#include "debuggercontroller.h"
+
+using namespace BinaryNinja;
+using namespace BinaryNinjaDebugger;
+
+// The Debugger Info sidebar compiles a handful of expressions per instruction, so this is only reached when stepping
+// through a lot of code. Starting over is cheaper than tracking which expressions are still in use.
+static constexpr size_t MaxCachedExpressions = 0x10000;
+static constexpr uint64_t SnapshotBlockSize = 0x100;
+
+
+static int64_t MaskToSize(int64_t value, size_t size)
+{
+	if (size >= 8)
+		return value;
+	if (size == 0)
+		return value & 1;
+	return value & ((1LL << (size * 8)) - 1);
+}
+
+
+static int64_t ZeroExtend(int64_t value, size_t sourceSize, size_t destSize)
+{
+	if (destSize <= sourceSize)
+		return MaskToSize(value, destSize);
+	return MaskToSize(value & ((1LL << (sourceSize * 8)) - 1), destSize);
+}
+
+
+static int64_t SignExtend(int64_t value, size_t sourceSize, size_t destSize)
+{
+	if (destSize <= sourceSize)
+		return MaskToSize(value, destSize);
+	if (value & (1LL << ((sourceSize * 8) - 1)))
+		return MaskToSize(value | (~((1LL << (sourceSize * 8)) - 1)), destSize);
+	else
+		return MaskToSize(value & ((1LL << (sourceSize * 8)) - 1), destSize);
+}
+
+
+static inline uint64_t GetActualShift(uint64_t value, size_t instrSize)
+{
+	if (instrSize <= 4)
+		return value & 0b11111;
+	else
+		return value & 0b111111;
+}
+
+
+static inline uint64_t GetSizeMask(size_t size)
+{
+	if (size > 0 && size < 8)
+		return (1ULL << (size * 8)) - 1;
+	return UINT64_MAX;
+}
+
+
+static inline bool IsReadableSize(size_t size)
+{
+	return (size == 1) || (size == 2) || (size == 4) || (size == 8);
+}
+
+
+ExpressionSnapshot::ExpressionSnapshot(DebuggerController* controller) : m_controller(controller) {}
+
+
+void ExpressionSnapshot::Reset()
+{
+	m_registers.assign(m_registerIndices.size(), std::nullopt);
+	m_stackPointer.reset();
+	m_blocks.clear();
+	m_frameBases.clear();
+}
+
+
+uint32_t ExpressionSnapshot::GetRegisterSlot(uint32_t archRegister)
+{
+	auto iter = m_registerSlots.find(archRegister);
+	if (iter != m_registerSlots.end())
+		return iter->second;
+
+	uint32_t slot = (uint32_t)m_registerIndices.size();
+	m_registerIndices.push_back(archRegister);
+	m_registerSlots[archRegister] = slot;
+	m_registers.emplace_back();
+	return slot;
+}
+
+
+bool ExpressionSnapshot::GetRegister(uint32_t slot, uint64_t& value)
+{
+	auto& cached = m_registers[slot];
+	if (!cached.has_value())
+	{
+		uint64_t result;
+		if (!m_controller->GetRegisterValue(m_registerIndices[slot], result))
+			return false;
+		cached = result;
+	}
+	value = cached.value();
+	return true;
+}
+
+
+uint64_t ExpressionSnapshot::GetStackPointer()
+{
+	if (!m_stackPointer.has_value())
+		m_stackPointer = m_controller->GetState()->StackPointer();
+	return m_stackPointer.value();
+}
+
+
+bool ExpressionSnapshot::ReadBlock(uint64_t block, const DataBuffer*& buffer)
+{
+	auto iter = m_blocks.find(block);
+	if (iter == m_blocks.end())
+		iter = m_blocks.emplace(block, m_controller->ReadMemory(block, SnapshotBlockSize)).first;
+
+	buffer = &iter->second;
+	return buffer->GetLength() > 0;
+}
+
+
+bool ExpressionSnapshot::Read(uint64_t address, size_t size, uint64_t& value)
+{
+	uint8_t bytes[8];
+	size_t copied = 0;
+	while (copied < size)
+	{
+		uint64_t current = address + copied;
+		uint64_t block = current & ~(SnapshotBlockSize - 1);
+		const DataBuffer* buffer;
+		if (!ReadBlock(block, buffer))
+			return false;
+
+		size_t offset = current - block;
+		if (offset >= buffer->GetLength())
+			return false;
+		size_t count = std::min(size - copied, buffer->GetLength() - offset);
+		memcpy(bytes + copied, (const uint8_t*)buffer->GetData() + offset, count);
+		copied += count;
+	}
+
+	switch (size)
+	{
+	case 1:
+		value = bytes[0];
+		return true;
+	case 2:
+	{
+		uint16_t result;
+		memcpy(&result, bytes, sizeof(result));
+		value = result;
+		return true;
+	}
+	case 4:
+	{
+		uint32_t result;
+		memcpy(&result, bytes, sizeof(result));
+		value = result;
+		return true;
+	}
+	case 8:
+		memcpy(&value, bytes, sizeof(value));
+		return true;
+	default:
+		return false;
+	}
+}
+
+
+bool ExpressionSnapshot::GetFrameBase(Function* func, uint64_t& base)
+{
+	auto iter = m_frameBases.find(func);
+	if (iter == m_frameBases.end())
+	{
+		std::optional<uint64_t> result;
+		auto arch = m_controller->GetData()->GetDefaultArchitecture();
+		if (arch)
+		{
+			auto stackValue = func->GetRegisterValueAtInstruction(
+				arch, m_controller->LiveToViewAddress(m_controller->GetState()->IP()), arch->GetStackPointerRegister());
+			if (stackValue.state == StackFrameOffset)
+				result = GetStackPointer() - stackValue.value;
+		}
+		iter = m_frameBases.emplace(func, result).first;
+	}
+
+	if (!iter->second.has_value())
+		return false;
+	base = iter->second.value();
+	return true;
+}
+
+
+bool CompiledExpression::Emit(OpCode op, size_t size, uint64_t operand, size_t sourceSize)
+{
+	m_code.push_back({op, size, sourceSize, operand});
+	return true;
+}
+
+
+bool CompiledExpression::CompileRegister(uint32_t reg, size_t size, ExpressionSnapshot& snapshot)
+{
+	if (LLIL_REG_IS_TEMP(reg))
+		return false;
+
+	return Emit(RegisterOp, size, snapshot.GetRegisterSlot(reg));
+}
+
+
+bool CompiledExpression::CompileVariable(const Variable& var, uint64_t address, size_t size,
+	DebuggerController* controller, ExpressionSnapshot& snapshot)
+{
+	if (var.type == RegisterVariableSourceType)
+		return CompileRegister((uint32_t)var.storage, size, snapshot);
+
+	if (var.type != StackVariableSourceType)
+		return false;
+
+	auto funcs = controller->GetData()->GetAnalysisFunctionsContainingAddress(address);
+	if (funcs.empty() || !funcs[0])
+		return false;
+	auto func = funcs[0];
+
+	auto type = func->GetVariableType(var);
+	if (!type)
+		return false;
+
+	auto width = type->GetWidth();
+	if (!IsReadableSize(width))
+		return false;
+
+	m_stackVariables.push_back({func, var.storage, width});
+	return Emit(StackVariableOp, size, m_stackVariables.size() - 1);
+}
+
+
+bool CompiledExpression::CompileNode(
+	const LowLevelILInstruction& instr, DebuggerController* controller, ExpressionSnapshot& snapshot)
+{
+	if (instr.size > 8)
+		return false;
+
+	auto binary = [&](const LowLevelILInstruction& left, const LowLevelILInstruction& right, OpCode op) {
+		return CompileNode(left, controller, snapshot) && CompileNode(right, controller, snapshot)
+			&& Emit(op, instr.size);
+	};
+	auto unary = [&](const LowLevelILInstruction& source, OpCode op) {
+		return CompileNode(source, controller, snapshot) && Emit(op, instr.size, 0, source.size);
+	};
+	uint64_t sizeMask = GetSizeMask(instr.size);
+
+	switch (instr.operation)
+	{
+	case LLIL_CONST:
+		return Emit(ConstantOp, instr.size, instr.GetConstant<LLIL_CONST>() & sizeMask);
+	case LLIL_CONST_PTR:
+		return Emit(ConstantOp, instr.size, instr.GetConstant<LLIL_CONST_PTR>() & sizeMask);
+	case LLIL_FLOAT_CONST:
+		return Emit(ConstantOp, instr.size, instr.GetConstant<LLIL_FLOAT_CONST>() & sizeMask);
+	case LLIL_REG:
+		return CompileRegister(instr.GetSourceRegister<LLIL_REG>(), instr.size, snapshot);
+	case LLIL_ADD:
+		return binary(instr.GetLeftExpr<LLIL_ADD>(), instr.GetRightExpr<LLIL_ADD>(), AddOp);
+	case LLIL_SUB:
+		return binary(instr.GetLeftExpr<LLIL_SUB>(), instr.GetRightExpr<LLIL_SUB>(), SubtractOp);
+	case LLIL_LOAD:
+		return IsReadableSize(instr.size) && unary(instr.GetSourceExpr<LLIL_LOAD>(), LoadOp);
+	case LLIL_STORE:
+		// The value at the destination
+		return IsReadableSize(instr.size) && unary(instr.GetDestExpr<LLIL_STORE>(), LoadOp);
+	case LLIL_LSL:
+		return binary(instr.GetLeftExpr<LLIL_LSL>(), instr.GetRightExpr<LLIL_LSL>(), ShiftLeftOp);
+	case LLIL_LSR:
+		return binary(instr.GetLeftExpr<LLIL_LSR>(), instr.GetRightExpr<LLIL_LSR>(), ShiftRightOp);
+	case LLIL_ASR:
+		return binary(instr.GetLeftExpr<LLIL_ASR>(), instr.GetRightExpr<LLIL_ASR>(), ArithShiftRightOp);
+	case LLIL_XOR:
+		return binary(instr.GetLeftExpr<LLIL_XOR>(), instr.GetRightExpr<LLIL_XOR>(), XorOp);
+	case LLIL_AND:
+		return binary(instr.GetLeftExpr<LLIL_AND>(), instr.GetRightExpr<LLIL_AND>(), AndOp);
+	case LLIL_OR:
+		return binary(instr.GetLeftExpr<LLIL_OR>(), instr.GetRightExpr<LLIL_OR>(), OrOp);
+	case LLIL_NEG:
+		return unary(instr.GetSourceExpr<LLIL_NEG>(), NegateOp);
+	case LLIL_NOT:
+		return unary(instr.GetSourceExpr<LLIL_NOT>(), NotOp);
+	case LLIL_SX:
+		return unary(instr.GetSourceExpr<LLIL_SX>(), SignExtendOp);
+	case LLIL_ZX:
+		return unary(instr.GetSourceExpr<LLIL_ZX>(), ZeroExtendOp);
+	case LLIL_PUSH:
+		// The value being pushed
+		return CompileNode(instr.GetSourceExpr<LLIL_PUSH>(), controller, snapshot);
+	case LLIL_POP:
+	case LLIL_RET:
+		return IsReadableSize(instr.size) && Emit(StackLoadOp, instr.size);
+	case LLIL_CMP_E:
+		return binary(instr.GetLeftExpr<LLIL_CMP_E>(), instr.GetRightExpr<LLIL_CMP_E>(), CompareEqualOp);
+	case LLIL_CMP_NE:
+		return binary(instr.GetLeftExpr<LLIL_CMP_NE>(), instr.GetRightExpr<LLIL_CMP_NE>(), CompareNotEqualOp);
+	case LLIL_CMP_SLT:
+		return binary(instr.GetLeftExpr<LLIL_CMP_SLT>(), instr.GetRightExpr<LLIL_CMP_SLT>(), CompareSignedLessOp);
+	case LLIL_CMP_ULT:
+		return binary(instr.GetLeftExpr<LLIL_CMP_ULT>(), instr.GetRightExpr<LLIL_CMP_ULT>(), CompareUnsignedLessOp);
+	case LLIL_CMP_SLE:
+		return binary(
+			instr.GetLeftExpr<LLIL_CMP_SLE>(), instr.GetRightExpr<LLIL_CMP_SLE>(), CompareSignedLessEqualOp);
+	case LLIL_CMP_ULE:
+		return binary(
+			instr.GetLeftExpr<LLIL_CMP_ULE>(), instr.GetRightExpr<LLIL_CMP_ULE>(), CompareUnsignedLessEqualOp);
+	case LLIL_CMP_SGE:
+		return binary(
+			instr.GetLeftExpr<LLIL_CMP_SGE>(), instr.GetRightExpr<LLIL_CMP_SGE>(), CompareSignedGreaterEqualOp);
+	case LLIL_CMP_UGE:
+		return binary(
+			instr.GetLeftExpr<LLIL_CMP_UGE>(), instr.GetRightExpr<LLIL_CMP_UGE>(), CompareUnsignedGreaterEqualOp);
+	case LLIL_CMP_SGT:
+		return binary(instr.GetLeftExpr<LLIL_CMP_SGT>(), instr.GetRightExpr<LLIL_CMP_SGT>(), CompareSignedGreaterOp);
+	case LLIL_CMP_UGT:
+		return binary(
+			instr.GetLeftExpr<LLIL_CMP_UGT>(), instr.GetRightExpr<LLIL_CMP_UGT>(), CompareUnsignedGreaterOp);
+	default:
+		return false;
+	}
+}
+
+
+bool CompiledExpression::CompileNode(
+	const MediumLevelILInstruction& instr, DebuggerController* controller, ExpressionSnapshot& snapshot)
+{
+	if (instr.size > 8)
+		return false;
+
+	auto binary = [&](const MediumLevelILInstruction& left, const MediumLevelILInstruction& right, OpCode op) {
+		return CompileNode(left, controller, snapshot) && CompileNode(right, controller, snapshot)
+			&& Emit(op, instr.size);
+	};
+	auto unary = [&](const MediumLevelILInstruction& source, OpCode op) {
+		return CompileNode(source, controller, snapshot) && Emit(op, instr.size, 0, source.size);
+	};
+	uint64_t sizeMask = GetSizeMask(instr.size);
+
+	switch (instr.operation)
+	{
+	case MLIL_CONST:
+		return Emit(ConstantOp, instr.size, instr.GetConstant<MLIL_CONST>() & sizeMask);
+	case MLIL_CONST_PTR:
+		return Emit(ConstantOp, instr.size, instr.GetConstant<MLIL_CONST_PTR>() & sizeMask);
+	case MLIL_FLOAT_CONST:
+		return Emit(ConstantOp, instr.size, instr.GetConstant<MLIL_CONST_PTR>() & sizeMask);
+	case MLIL_VAR:
+		return CompileVariable(instr.GetSourceVariable<MLIL_VAR>(), instr.address, instr.size, controller, snapshot);
+	case MLIL_ADD:
+		return binary(instr.GetLeftExpr<MLIL_ADD>(), instr.GetRightExpr<MLIL_ADD>(), AddOp);
+	case MLIL_SUB:
+		return binary(instr.GetLeftExpr<MLIL_SUB>(), instr.GetRightExpr<MLIL_SUB>(), SubtractOp);
+	case MLIL_LOAD:
+		return IsReadableSize(instr.size) && unary(instr.GetSourceExpr<MLIL_LOAD>(), LoadOp);
+	case MLIL_STORE:
+		// The value at the destination
+		return IsReadableSize(instr.size) && unary(instr.GetDestExpr<MLIL_STORE>(), LoadOp);
+	case MLIL_LSL:
+		return binary(instr.GetLeftExpr<MLIL_LSL>(), instr.GetRightExpr<MLIL_LSL>(), ShiftLeftOp);
+	case MLIL_LSR:
+		return binary(instr.GetLeftExpr<MLIL_LSR>(), instr.GetRightExpr<MLIL_LSR>(), ShiftRightOp);
+	case MLIL_ASR:
+		return binary(instr.GetLeftExpr<MLIL_ASR>(), instr.GetRightExpr<MLIL_ASR>(), ArithShiftRightOp);
+	case MLIL_XOR:
+		return binary(instr.GetLeftExpr<MLIL_XOR>(), instr.GetRightExpr<MLIL_XOR>(), XorOp);
+	case MLIL_AND:
+		return binary(instr.GetLeftExpr<MLIL_AND>(), instr.GetRightExpr<MLIL_AND>(), AndOp);
+	case MLIL_OR:
+		return binary(instr.GetLeftExpr<MLIL_OR>(), instr.GetRightExpr<MLIL_OR>(), OrOp);
+	case MLIL_NEG:
+		return unary(instr.GetSourceExpr<MLIL_NEG>(), NegateOp);
+	case MLIL_NOT:
+		return unary(instr.GetSourceExpr<MLIL_NOT>(), NotOp);
+	case MLIL_SX:
+		return unary(instr.GetSourceExpr<MLIL_SX>(), SignExtendOp);
+	case MLIL_ZX:
+		return unary(instr.GetSourceExpr<MLIL_ZX>(), ZeroExtendOp);
+	case MLIL_CMP_E:
+		return binary(instr.GetLeftExpr<MLIL_CMP_E>(), instr.GetRightExpr<MLIL_CMP_E>(), CompareEqualOp);
+	case MLIL_CMP_NE:
+		return binary(instr.GetLeftExpr<MLIL_CMP_NE>(), instr.GetRightExpr<MLIL_CMP_NE>(), CompareNotEqualOp);
+	case MLIL_CMP_SLT:
+		return binary(instr.GetLeftExpr<MLIL_CMP_SLT>(), instr.GetRightExpr<MLIL_CMP_SLT>(), CompareSignedLessOp);
+	case MLIL_CMP_ULT:
+		return binary(instr.GetLeftExpr<MLIL_CMP_ULT>(), instr.GetRightExpr<MLIL_CMP_ULT>(), CompareUnsignedLessOp);
+	case MLIL_CMP_SLE:
+		return binary(
+			instr.GetLeftExpr<MLIL_CMP_SLE>(), instr.GetRightExpr<MLIL_CMP_SLE>(), CompareSignedLessEqualOp);
+	case MLIL_CMP_ULE:
+		return binary(
+			instr.GetLeftExpr<MLIL_CMP_ULE>(), instr.GetRightExpr<MLIL_CMP_ULE>(), CompareUnsignedLessEqualOp);
+	case MLIL_CMP_SGE:
+		return binary(
+			instr.GetLeftExpr<MLIL_CMP_SGE>(), instr.GetRightExpr<MLIL_CMP_SGE>(), CompareSignedGreaterEqualOp);
+	case MLIL_CMP_UGE:
+		return binary(
+			instr.GetLeftExpr<MLIL_CMP_UGE>(), instr.GetRightExpr<MLIL_CMP_UGE>(), CompareUnsignedGreaterEqualOp);
+	case MLIL_CMP_SGT:
+		return binary(instr.GetLeftExpr<MLIL_CMP_SGT>(), instr.GetRightExpr<MLIL_CMP_SGT>(), CompareSignedGreaterOp);
+	case MLIL_CMP_UGT:
+		return binary(
+			instr.GetLeftExpr<MLIL_CMP_UGT>(), instr.GetRightExpr<MLIL_CMP_UGT>(), CompareUnsignedGreaterOp);
+	default:
+		return false;
+	}
+}
+
+
+bool CompiledExpression::CompileNode(
+	const HighLevelILInstruction& instr, DebuggerController* controller, ExpressionSnapshot& snapshot)
+{
+	if (instr.size > 8)
+		return false;
+
+	auto binary = [&](const HighLevelILInstruction& left, const HighLevelILInstruction& right, OpCode op) {
+		return CompileNode(left, controller, snapshot) && CompileNode(right, controller, snapshot)
+			&& Emit(op, instr.size);
+	};
+	auto unary = [&](const HighLevelILInstruction& source, OpCode op) {
+		return CompileNode(source, controller, snapshot) && Emit(op, instr.size, 0, source.size);
+	};
+	uint64_t sizeMask = GetSizeMask(instr.size);
+
+	switch (instr.operation)
+	{
+	case HLIL_CONST:
+		return Emit(ConstantOp, instr.size, instr.GetConstant<HLIL_CONST>() & sizeMask);
+	case HLIL_CONST_PTR:
+		return Emit(ConstantOp, instr.size, instr.GetConstant<HLIL_CONST_PTR>() & sizeMask);
+	case HLIL_FLOAT_CONST:
+		return Emit(ConstantOp, instr.size, instr.GetConstant<HLIL_CONST_PTR>() & sizeMask);
+	case HLIL_VAR:
+		return CompileVariable(instr.GetVariable<HLIL_VAR>(), instr.address, instr.size, controller, snapshot);
+	case HLIL_ADD:
+		return binary(instr.GetLeftExpr<HLIL_ADD>(), instr.GetRightExpr<HLIL_ADD>(), AddOp);
+	case HLIL_SUB:
+		return binary(instr.GetLeftExpr<HLIL_SUB>(), instr.GetRightExpr<HLIL_SUB>(), SubtractOp);
+	case HLIL_LSL:
+		return binary(instr.GetLeftExpr<HLIL_LSL>(), instr.GetRightExpr<HLIL_LSL>(), ShiftLeftOp);
+	case HLIL_LSR:
+		return binary(instr.GetLeftExpr<HLIL_LSR>(), instr.GetRightExpr<HLIL_LSR>(), ShiftRightOp);
+	case HLIL_ASR:
+		return binary(instr.GetLeftExpr<HLIL_ASR>(), instr.GetRightExpr<HLIL_ASR>(), ArithShiftRightOp);
+	case HLIL_XOR:
+		return binary(instr.GetLeftExpr<HLIL_XOR>(), instr.GetRightExpr<HLIL_XOR>(), XorOp);
+	case HLIL_AND:
+		return binary(instr.GetLeftExpr<HLIL_AND>(), instr.GetRightExpr<HLIL_AND>(), AndOp);
+	case HLIL_OR:
+		return binary(instr.GetLeftExpr<HLIL_OR>(), instr.GetRightExpr<HLIL_OR>(), OrOp);
+	case HLIL_NEG:
+		return unary(instr.GetSourceExpr<HLIL_NEG>(), NegateOp);
+	case HLIL_NOT:
+		return unary(instr.GetSourceExpr<HLIL_NOT>(), NotOp);
+	case HLIL_SX:
+		return unary(instr.GetSourceExpr<HLIL_SX>(), SignExtendOp);
+	case HLIL_ZX:
+		return unary(instr.GetSourceExpr<HLIL_ZX>(), ZeroExtendOp);
+	case HLIL_CMP_E:
+		return binary(instr.GetLeftExpr<HLIL_CMP_E>(), instr.GetRightExpr<HLIL_CMP_E>(), CompareEqualOp);
+	case HLIL_CMP_NE:
+		return binary(instr.GetLeftExpr<HLIL_CMP_NE>(), instr.GetRightExpr<HLIL_CMP_NE>(), CompareNotEqualOp);
+	case HLIL_CMP_SLT:
+		return binary(instr.GetLeftExpr<HLIL_CMP_SLT>(), instr.GetRightExpr<HLIL_CMP_SLT>(), CompareSignedLessOp);
+	case HLIL_CMP_ULT:
+		return binary(instr.GetLeftExpr<HLIL_CMP_ULT>(), instr.GetRightExpr<HLIL_CMP_ULT>(), CompareUnsignedLessOp);
+	case HLIL_CMP_SLE:
+		return binary(
+			instr.GetLeftExpr<HLIL_CMP_SLE>(), instr.GetRightExpr<HLIL_CMP_SLE>(), CompareSignedLessEqualOp);
+	case HLIL_CMP_ULE:
+		return binary(
+			instr.GetLeftExpr<HLIL_CMP_ULE>(), instr.GetRightExpr<HLIL_CMP_ULE>(), CompareUnsignedLessEqualOp);
+	case HLIL_CMP_SGE:
+		return binary(
+			instr.GetLeftExpr<HLIL_CMP_SGE>(), instr.GetRightExpr<HLIL_CMP_SGE>(), CompareSignedGreaterEqualOp);
+	case HLIL_CMP_UGE:
+		return binary(
+			instr.GetLeftExpr<HLIL_CMP_UGE>(), instr.GetRightExpr<HLIL_CMP_UGE>(), CompareUnsignedGreaterEqualOp);
+	case HLIL_CMP_SGT:
+		return binary(instr.GetLeftExpr<HLIL_CMP_SGT>(), instr.GetRightExpr<HLIL_CMP_SGT>(), CompareSignedGreaterOp);
+	case HLIL_CMP_UGT:
+		return binary(
+			instr.GetLeftExpr<HLIL_CMP_UGT>(), instr.GetRightExpr<HLIL_CMP_UGT>(), CompareUnsignedGreaterOp);
+	default:
+		return false;
+	}
+}
+
+
+std::shared_ptr<CompiledExpression> CompiledExpression::Compile(
+	const LowLevelILInstruction& instr, DebuggerController* controller, ExpressionSnapshot& snapshot)
+{
+	auto result = std::make_shared<CompiledExpression>();
+	if (!result->CompileNode(instr, controller, snapshot))
+		return nullptr;
+	return result;
+}
+
+
+std::shared_ptr<CompiledExpression> CompiledExpression::Compile(
+	const MediumLevelILInstruction& instr, DebuggerController* controller, ExpressionSnapshot& snapshot)
+{
+	auto result = std::make_shared<CompiledExpression>();
+	if (!result->CompileNode(instr, controller, snapshot))
+		return nullptr;
+	return result;
+}
+
+
+std::shared_ptr<CompiledExpression> CompiledExpression::Compile(
+	const HighLevelILInstruction& instr, DebuggerController* controller, ExpressionSnapshot& snapshot)
+{
+	auto result = std::make_shared<CompiledExpression>();
+	if (!result->CompileNode(instr, controller, snapshot))
+		return nullptr;
+	return result;
+}
+
+
+bool CompiledExpression::Evaluate(ExpressionSnapshot& snapshot, uint64_t& value) const
+{
+	std::vector<uint64_t> stack;
+	stack.reserve(m_code.size());
+	for (const auto& instr : m_code)
+	{
+		uint64_t sizeMask = GetSizeMask(instr.size);
+		switch (instr.op)
+		{
+		case ConstantOp:
+			stack.push_back(instr.operand);
+			continue;
+		case RegisterOp:
+		{
+			uint64_t result;
+			if (!snapshot.GetRegister((uint32_t)instr.operand, result))
+				return false;
+			stack.push_back(result & sizeMask);
+			continue;
+		}
+		case StackVariableOp:
+		{
+			const auto& var = m_stackVariables[instr.operand];
+			uint64_t base, result;
+			if (!snapshot.GetFrameBase(var.func, base) || !snapshot.Read(base + var.offset, var.width, result))
+				return false;
+			stack.push_back(result & sizeMask);
+			continue;
+		}
+		case StackLoadOp:
+		{
+			uint64_t result;
+			if (!snapshot.Read(snapshot.GetStackPointer(), instr.size, result))
+				return false;
+			stack.push_back(result & sizeMask);
+			continue;
+		}
+		default:
+			break;
+		}
+
+		// Unary operations
+		uint64_t right = stack.back();
+		stack.pop_back();
+		uint64_t result = 0;
+		switch (instr.op)
+		{
+		case LoadOp:
+			if (!snapshot.Read(right, instr.size, result))
+				return false;
+			stack.push_back(result & sizeMask);
+			continue;
+		case NegateOp:
+			stack.push_back((-right) & sizeMask);
+			continue;
+		case NotOp:
+			stack.push_back((~right) & sizeMask);
+			continue;
+		case SignExtendOp:
+			stack.push_back(SignExtend(right, instr.sourceSize, instr.size));
+			continue;
+		case ZeroExtendOp:
+			stack.push_back(ZeroExtend(right, instr.sourceSize, instr.size));
+			continue;
+		default:
+			break;
+		}
+
+		// Binary operations
+		uint64_t left = stack.back();
+		stack.pop_back();
+		switch (instr.op)
+		{
+		case AddOp:
+			result = (left + right) & sizeMask;
+			break;
+		case SubtractOp:
+			result = (left - right) & sizeMask;
+			break;
+		case ShiftLeftOp:
+			result = (left << GetActualShift(right, instr.size)) & sizeMask;
+			break;
+		case ShiftRightOp:
+			result = (left >> GetActualShift(right, instr.size)) & sizeMask;
+			break;
+		case ArithShiftRightOp:
+			if (left & (1ULL << ((instr.size * 8) - 1)))
+				left |= ~sizeMask;
+			else
+				left &= sizeMask;
+			result = (uint64_t)(((int64_t)left) >> GetActualShift(right, instr.size)) & sizeMask;
+			break;
+		case XorOp:
+			result = (left ^ right) & sizeMask;
+			break;
+		case AndOp:
+			result = (left & right) & sizeMask;
+			break;
+		case OrOp:
+			result = (left | right) & sizeMask;
+			break;
+		case CompareEqualOp:
+			result = left == right;
+			break;
+		case CompareNotEqualOp:
+			result = left != right;
+			break;
+		case CompareSignedLessOp:
+			result = SignExtend(left, instr.size, 8) < SignExtend(right, instr.size, 8);
+			break;
+		case CompareUnsignedLessOp:
+			result = left < right;
+			break;
+		case CompareSignedLessEqualOp:
+			result = SignExtend(left, instr.size, 8) <= SignExtend(right, instr.size, 8);
+			break;
+		case CompareUnsignedLessEqualOp:
+			result = left <= right;
+			break;
+		case CompareSignedGreaterEqualOp:
+			result = SignExtend(left, instr.size, 8) >= SignExtend(right, instr.size, 8);
+			break;
+		case CompareUnsignedGreaterEqualOp:
+			result = left >= right;
+			break;
+		case CompareSignedGreaterOp:
+			result = SignExtend(left, instr.size, 8) > SignExtend(right, instr.size, 8);
+			break;
+		case CompareUnsignedGreaterOp:
+			result = left > right;
+			break;
+		default:
+			return false;
+		}
+		stack.push_back(result);
+	}
+
+	if (stack.size() != 1)
+		return false;
+	value = stack.back();
+	return true;
+}
+
+
+ExpressionCache::ExpressionCache(DebuggerController* controller) : m_controller(controller), m_snapshot(controller)
+{}
+
+
+void ExpressionCache::UpdateSnapshot()
+{
+	uint64_t generation = m_controller->GetState()->GetCacheGeneration();
+	if (m_snapshotValid && (generation == m_snapshotGeneration))
+		return;
+
+	m_snapshot.Reset();
+	m_snapshotGeneration = generation;
+	m_snapshotValid = true;
+}
+
+
+template <typename Instruction, typename ILFunction>
+bool ExpressionCache::Evaluate(
+	const Instruction& instr, BNFunctionGraphType level, ILFunction* func, uint64_t& value)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	UpdateSnapshot();
+
+	ExpressionKey key {func->GetObject(), level, instr.exprIndex};
+	auto iter = m_expressions.find(key);
+	if (iter == m_expressions.end())
+	{
+		if (m_expressions.size() >= MaxCachedExpressions)
+			m_expressions.clear();
+
+		CachedExpression cached;
+		cached.owner = std::make_shared<Ref<ILFunction>>(func);
+		cached.expression = CompiledExpression::Compile(instr, m_controller, m_snapshot);
+		iter = m_expressions.emplace(key, std::move(cached)).first;
+	}
+
+	if (!iter->second.expression)
+		return false;
+	return iter->second.expression->Evaluate(m_snapshot, value);
+}
+
+
+bool ExpressionCache::Evaluate(const LowLevelILInstruction& instr, uint64_t& value)
+{
+	return Evaluate<LowLevelILInstruction, LowLevelILFunction>(instr, LowLevelILFunctionGraph, instr.function, value);
+}
+
+
+bool ExpressionCache::Evaluate(const MediumLevelILInstruction& instr, uint64_t& value)
+{
+	return Evaluate<MediumLevelILInstruction, MediumLevelILFunction>(
+		instr, MediumLevelILFunctionGraph, instr.function, value);
+}
+
+
+bool ExpressionCache::Evaluate(const HighLevelILInstruction& instr, uint64_t& value)
+{
+	return Evaluate<HighLevelILInstruction, HighLevelILFunction>(
+		instr, HighLevelILFunctionGraph, instr.function, value);
+}
+
+
+bool ExpressionCache::EvaluateOnce(const LowLevelILInstruction& instr, uint64_t& value)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	UpdateSnapshot();
+
+	auto expression = CompiledExpression::Compile(instr, m_controller, m_snapshot);
+	if (!expression)
+		return false;
+	return expression->Evaluate(m_snapshot, value);
+}
+
+
+void ExpressionCache::Clear()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_expressions.clear();
+	m_snapshotValid = false;
+}
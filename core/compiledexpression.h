@@ -0,0 +1,189 @@
+/*
+Copyright 2020-2024 Vector 35 Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <tuple>
+#include <unordered_map>
+#include "binaryninjaapi.h"
+#include "lowlevelilinstruction.h"
+#include "mediumlevelilinstruction.h"
+#include "highlevelilinstruction.h"
+
+namespace BinaryNinjaDebugger {
+	class DebuggerController;
+
+	// The state of the stopped target that compiled expressions are evaluated against. Every register is read at most
+	// once, and memory is read in 0x100-byte blocks that are fetched at most once, no matter how many expressions, or
+	// operands of one expression, refer to them. It must be reset whenever the target state changes.
+	class ExpressionSnapshot
+	{
+		DebuggerController* m_controller;
+
+		// Register slots outlive Reset(), since the compiled expressions refer to them
+		std::vector<uint32_t> m_registerIndices;
+		std::unordered_map<uint32_t, uint32_t> m_registerSlots;
+
+		std::vector<std::optional<uint64_t>> m_registers;
+		std::optional<uint64_t> m_stackPointer;
+		std::unordered_map<uint64_t, BinaryNinja::DataBuffer> m_blocks;
+		std::unordered_map<BinaryNinja::Function*, std::optional<uint64_t>> m_frameBases;
+
+		bool ReadBlock(uint64_t block, const BinaryNinja::DataBuffer*& buffer);
+
+	public:
+		ExpressionSnapshot(DebuggerController* controller);
+
+		void Reset();
+
+		// The slot of a register of the architecture, by its index
+		uint32_t GetRegisterSlot(uint32_t archRegister);
+		// Returns false if the adapter does not report the register
+		bool GetRegister(uint32_t slot, uint64_t& value);
+		uint64_t GetStackPointer();
+		// Reads an integer of size bytes, which must be 1, 2, 4 or 8
+		bool Read(uint64_t address, size_t size, uint64_t& value);
+		// The stack pointer at the entry of the function, at the current instruction pointer
+		bool GetFrameBase(BinaryNinja::Function* func, uint64_t& base);
+	};
+
+
+	// An LLIL, MLIL or HLIL expression compiled into a postfix program. Registers are resolved to snapshot slots and
+	// stack variables to their offset and width at compile time, so evaluating it neither walks the IL nor looks up any
+	// names. An expression that the compiler does not support, e.g., one that uses a temporary register, fails to
+	// compile, just as it would fail to evaluate.
+	class CompiledExpression
+	{
+		enum OpCode
+		{
+			ConstantOp,
+			RegisterOp,
+			StackVariableOp,
+			LoadOp,
+			// Reads from the stack pointer, for LLIL_POP and LLIL_RET
+			StackLoadOp,
+			AddOp,
+			SubtractOp,
+			ShiftLeftOp,
+			ShiftRightOp,
+			ArithShiftRightOp,
+			XorOp,
+			AndOp,
+			OrOp,
+			NegateOp,
+			NotOp,
+			SignExtendOp,
+			ZeroExtendOp,
+			CompareEqualOp,
+			CompareNotEqualOp,
+			CompareSignedLessOp,
+			CompareUnsignedLessOp,
+			CompareSignedLessEqualOp,
+			CompareUnsignedLessEqualOp,
+			CompareSignedGreaterEqualOp,
+			CompareUnsignedGreaterEqualOp,
+			CompareSignedGreaterOp,
+			CompareUnsignedGreaterOp,
+		};
+
+		struct Instruction
+		{
+			OpCode op;
+			size_t size;
+			// The size of the operand, for SignExtendOp and ZeroExtendOp
+			size_t sourceSize;
+			// The constant, the register slot, or the index into m_stackVariables
+			uint64_t operand;
+		};
+
+		struct StackVariable
+		{
+			BinaryNinja::Ref<BinaryNinja::Function> func;
+			int64_t offset;
+			size_t width;
+		};
+
+		std::vector<Instruction> m_code;
+		std::vector<StackVariable> m_stackVariables;
+
+		bool Emit(OpCode op, size_t size, uint64_t operand = 0, size_t sourceSize = 0);
+		bool CompileVariable(const BinaryNinja::Variable& var, uint64_t address, size_t size,
+			DebuggerController* controller, ExpressionSnapshot& snapshot);
+		bool CompileRegister(uint32_t reg, size_t size, ExpressionSnapshot& snapshot);
+		bool CompileNode(const BinaryNinja::LowLevelILInstruction& instr, DebuggerController* controller,
+			ExpressionSnapshot& snapshot);
+		bool CompileNode(const BinaryNinja::MediumLevelILInstruction& instr, DebuggerController* controller,
+			ExpressionSnapshot& snapshot);
+		bool CompileNode(const BinaryNinja::HighLevelILInstruction& instr, DebuggerController* controller,
+			ExpressionSnapshot& snapshot);
+
+	public:
+		// Returns nullptr if the expression is not supported
+		static std::shared_ptr<CompiledExpression> Compile(const BinaryNinja::LowLevelILInstruction& instr,
+			DebuggerController* controller, ExpressionSnapshot& snapshot);
+		static std::shared_ptr<CompiledExpression> Compile(const BinaryNinja::MediumLevelILInstruction& instr,
+			DebuggerController* controller, ExpressionSnapshot& snapshot);
+		static std::shared_ptr<CompiledExpression> Compile(const BinaryNinja::HighLevelILInstruction& instr,
+			DebuggerController* controller, ExpressionSnapshot& snapshot);
+
+		// Returns false if a register or memory read fails
+		bool Evaluate(ExpressionSnapshot& snapshot, uint64_t& value) const;
+	};
+
+
+	// The compiled expressions of a controller, keyed by IL function, IL level and expression index, and the snapshot
+	// they are evaluated against. The Debugger Info sidebar evaluates the same expressions at every stop, so they are
+	// only compiled the first time.
+	class ExpressionCache
+	{
+		typedef std::tuple<const void*, BNFunctionGraphType, size_t> ExpressionKey;
+
+		struct CachedExpression
+		{
+			// Holds a reference to the IL function, so that its address is not reused by another one while it is in
+			// the cache
+			std::shared_ptr<void> owner;
+			// nullptr if the expression is not supported
+			std::shared_ptr<CompiledExpression> expression;
+		};
+
+		std::mutex m_mutex;
+		DebuggerController* m_controller;
+		std::map<ExpressionKey, CachedExpression> m_expressions;
+		ExpressionSnapshot m_snapshot;
+		uint64_t m_snapshotGeneration = 0;
+		bool m_snapshotValid = false;
+
+		void UpdateSnapshot();
+		template <typename Instruction, typename ILFunction>
+		bool Evaluate(const Instruction& instr, BNFunctionGraphType level, ILFunction* func, uint64_t& value);
+
+	public:
+		ExpressionCache(DebuggerController* controller);
+
+		bool Evaluate(const BinaryNinja::LowLevelILInstruction& instr, uint64_t& value);
+		bool Evaluate(const BinaryNinja::MediumLevelILInstruction& instr, uint64_t& value);
+		bool Evaluate(const BinaryNinja::HighLevelILInstruction& instr, uint64_t& value);
+		// Evaluates without caching the compiled expression, for IL that is lifted on the fly and thrown away
+		bool EvaluateOnce(const BinaryNinja::LowLevelILInstruction& instr, uint64_t& value);
+
+		void Clear();
+	};
+};  // namespace BinaryNinjaDebugger
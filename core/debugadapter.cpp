@@ -122,6 +122,66 @@ bool DebugAdapter::StepReturnReverse()
 }
 
 
+size_t DebugAdapter::AddBreakpoints(const std::vector<ModuleNameAndOffset>& breakpoints)
+{
+	size_t count = 0;
+	for (const auto& breakpoint : breakpoints)
+	{
+		AddBreakpoint(breakpoint);
+		count++;
+	}
+	return count;
+}
+
+
+size_t DebugAdapter::RemoveBreakpoints(const std::vector<uint64_t>& addresses)
+{
+	size_t count = 0;
+	for (uint64_t address : addresses)
+	{
+		if (RemoveBreakpoint(DebugBreakpoint(address)))
+			count++;
+	}
+	return count;
+}
+
+
+size_t DebugAdapter::AddOneShotBreakpoints(const std::vector<ModuleNameAndOffset>& breakpoints)
+{
+	return AddBreakpoints(breakpoints);
+}
+
+
+void DebugAdapter::OneShotBreakpointHit(uint64_t address)
+{
+	RemoveBreakpoint(DebugBreakpoint(address));
+}
+
+
+bool DebugAdapter::AddWatchpoint(std::uintptr_t address, std::size_t size, DebugWatchpointType type)
+{
+	return false;
+}
+
+
+bool DebugAdapter::RemoveWatchpoint(std::uintptr_t address)
+{
+	return false;
+}
+
+
+bool DebugAdapter::GetStoppedWatchpoint(std::uintptr_t& address)
+{
+	return false;
+}
+
+
+bool DebugAdapter::GetWatchpointInfo(std::uintptr_t address, std::size_t& size, DebugWatchpointType& type)
+{
+	return false;
+}
+
+
 uint64_t DebugAdapter::GetStackPointer()
 {
 	return 0;
@@ -55,6 +55,10 @@ namespace BinaryNinjaDebugger {
 		DebugAdapterSupportModules,
 		DebugAdapterSupportThreads,
 		DebugAdapterSupportTTD,
+		DebugAdapterSupportStepReturn,
+		// The adapter asks the stop filter about every breakpoint and watchpoint stop, and resumes the target itself
+		// when it is told to, without reporting the stop
+		DebugAdapterSupportStopFilter,
 	};
 
 
@@ -76,6 +80,11 @@ namespace BinaryNinjaDebugger {
 	{
 		std::uint32_t m_pid {};
 		std::string m_processName {};
+		// These are left empty, or 0, when the platform does not report them
+		std::uint32_t m_parentPid {};
+		std::string m_user {};
+		std::string m_arch {};
+		std::string m_commandLine {};
 
 		DebugProcess() {}
 
@@ -129,6 +138,8 @@ namespace BinaryNinjaDebugger {
 		bool operator!() const { return !this->m_address && !this->m_id && !this->m_is_active; }
 	};
 
+	typedef BNDebugWatchpointType DebugWatchpointType;
+
 	struct DebugRegister
 	{
 		std::string m_name {};
@@ -190,13 +201,17 @@ namespace BinaryNinjaDebugger {
 	{
 		IMPLEMENT_DEBUGGER_API_OBJECT(BNDebugAdapter);
 
-	private:
+	protected:
 		// Function to call when the DebugAdapter wants to notify the front-end of certain events
 		// TODO: we should not use a vector here; only the DebuggerController should register one here;
 		// Other components should register their callbacks to the controller, who is responsible for notify them.
+		// Adapters that post events from a thread of their own may copy it, since it does not refer to the adapter.
 		std::function<void(const DebuggerEvent& event)> m_eventCallback;
+		// Returns true if a stop at a breakpoint or a watchpoint is handled by the controller, e.g., a tracepoint, and
+		// the target should be resumed right away. It is called on the thread that receives the stop, before it is
+		// reported. See DebugAdapterSupportStopFilter.
+		std::function<bool(DebugStopReason reason)> m_stopFilter;
 
-	protected:
 		uint64_t m_entryPoint;
 		bool m_hasEntryFunction;
 		uint64_t m_start;
@@ -215,6 +230,8 @@ namespace BinaryNinjaDebugger {
 			m_eventCallback = function;
 		}
 
+		virtual void SetStopFilter(std::function<bool(DebugStopReason reason)> function) { m_stopFilter = function; }
+
 		[[nodiscard]] virtual bool Execute(const std::string& path, const LaunchConfigurations& configs = {}) = 0;
 
 		[[nodiscard]] virtual bool ExecuteWithArgs(const std::string& path, const std::string& args,
@@ -260,6 +277,31 @@ namespace BinaryNinjaDebugger {
 
 		virtual std::vector<DebugBreakpoint> GetBreakpointList() const = 0;
 
+		// Bulk versions of AddBreakpoint() and RemoveBreakpoint(), used when a large number of breakpoints is applied
+		// at once, e.g., on launch. Adapters can override them to avoid per-breakpoint overhead and events. Both return
+		// the number of breakpoints that succeeded.
+		virtual size_t AddBreakpoints(const std::vector<ModuleNameAndOffset>& breakpoints);
+
+		virtual size_t RemoveBreakpoints(const std::vector<uint64_t>& addresses);
+
+		// One-shot breakpoints only need to be hit once, e.g., for coverage. Adapters that can delete a breakpoint by
+		// themselves when it is hit, without reporting it as removed, override both functions. By default, they are
+		// regular breakpoints, and OneShotBreakpointHit() deletes the one at the address.
+		virtual size_t AddOneShotBreakpoints(const std::vector<ModuleNameAndOffset>& breakpoints);
+
+		virtual void OneShotBreakpointHit(uint64_t address);
+
+		// Hardware watchpoints on size bytes at the address. Adapters that do not support them fail every call.
+		virtual bool AddWatchpoint(std::uintptr_t address, std::size_t size, DebugWatchpointType type);
+
+		virtual bool RemoveWatchpoint(std::uintptr_t address);
+
+		// The address of the watchpoint that triggered the current stop, if the stop reason is Watchpoint
+		virtual bool GetStoppedWatchpoint(std::uintptr_t& address);
+
+		// The size and type of the watchpoint at the address, e.g., one that was added from the backend console
+		virtual bool GetWatchpointInfo(std::uintptr_t address, std::size_t& size, DebugWatchpointType& type);
+
 		virtual std::unordered_map<std::string, DebugRegister> ReadAllRegisters() = 0;
 
 		virtual DebugRegister ReadRegister(const std::string& reg) = 0;
@@ -22,6 +22,8 @@ limitations under the License.
 	#include "adapters/windowskerneladapter.h"
 	#include "adapters/localwindowskerneladapter.h"
 	#include "adapters/windowsdumpfile.h"
+#else
+	#include "adapters/elfcorefile.h"
 #endif
 
 using namespace BinaryNinja;
@@ -39,6 +41,8 @@ void InitDebugAdapterTypes()
 	InitWindowsKernelAdapterType();
 	InitLocalWindowsKernelAdapterType();
 	InitWindowsDumpFileAdapterType();
+#else
+	InitElfCoreFileAdapterType();
 #endif
 
 	// Disable these adapters because they are not tested, and will get replaced later
@@ -169,6 +173,98 @@ static void RegisterSettings()
 			"description" : "When enabled, this holds the analysis for the binary view during debugging to increase performance."
 			})");
 
+	settings->RegisterSetting("debugger.tracepointBufferSize",
+		R"({
+			"title" : "Tracepoint Buffer Size",
+			"type" : "number",
+			"default" : 65536,
+			"minValue" : 1,
+			"maxValue" : 16777216,
+			"description" : "The number of tracepoint hits kept until they are retrieved. When the buffer is full, the oldest hits are dropped.",
+			"ignore" : ["SettingsProjectScope", "SettingsResourceScope"]
+			})");
+
+	settings->RegisterSetting("debugger.watchpointBufferSize",
+		R"({
+			"title" : "Watchpoint Hit Buffer Size",
+			"type" : "number",
+			"default" : 65536,
+			"minValue" : 1,
+			"maxValue" : 16777216,
+			"description" : "The number of hits of recording watchpoints kept until they are retrieved. When the buffer is full, the oldest hits are dropped.",
+			"ignore" : ["SettingsProjectScope", "SettingsResourceScope"]
+			})");
+
+	settings->RegisterSetting("debugger.lldbMultiTarget",
+		R"({
+			"title" : "LLDB Multi-Target Mode",
+			"type" : "boolean",
+			"default" : false,
+			"description" : "When enabled, all targets debugged with the LLDB adapter share a single LLDB instance and a single event listener thread, which scales to debugging dozens of processes at once, e.g., the workers of a server. The targets also share the selected LLDB platform. Only affects the targets debugged afterwards.",
+			"ignore" : ["SettingsProjectScope", "SettingsResourceScope"]
+			})");
+
+	settings->RegisterSetting("debugger.followForkMode",
+		R"({
+			"title" : "Follow Fork Mode",
+			"type" : "string",
+			"default" : "parent",
+			"enum" : ["parent", "child"],
+			"enumDescriptions" : [
+				"Keep debugging the parent process when the target forks. The child process is detached and keeps running.",
+				"Debug the child process when the target forks. The parent process is detached and keeps running."],
+			"description" : "Which process the LLDB adapter keeps debugging when the target forks. To debug the other one as well, attach to it from another view of its binary, preferably in multi-target mode.",
+			"ignore" : ["SettingsProjectScope", "SettingsResourceScope"]
+			})");
+
+	settings->RegisterSetting("debugger.recordExecution",
+		R"({
+			"title" : "Record Execution for Reverse Debugging",
+			"type" : "boolean",
+			"default" : false,
+			"description" : "When enabled, adapters without time travel debugging record the forward execution of the target into an execution journal, so the target can be stepped and run backwards within the recorded history. Recorded operations execute one instruction at a time, so resuming the target is much slower.",
+			"ignore" : ["SettingsProjectScope", "SettingsResourceScope"]
+			})");
+
+	settings->RegisterSetting("debugger.executionJournalSize",
+		R"({
+			"title" : "Execution Journal Size",
+			"type" : "number",
+			"default" : 256,
+			"minValue" : 1,
+			"maxValue" : 65536,
+			"description" : "The maximum size of the execution journal, in MB. When it is full, the recorded history is discarded and the recording starts over.",
+			"ignore" : ["SettingsProjectScope", "SettingsResourceScope"]
+			})");
+
+	settings->RegisterSetting("debugger.analyzeLoadedModules",
+		R"({
+			"title" : "Analyze Loaded Modules",
+			"type" : "boolean",
+			"default" : false,
+			"description" : "When enabled, the loaded modules other than the input file, e.g., shared libraries, are analyzed in the background once the target stops after loading them. Their functions are then used to name stack frames and to annotate register and stack values. The results are saved in the user directory and reused for the same module file in later sessions. Only affects the binaries opened afterwards.",
+			"ignore" : ["SettingsProjectScope", "SettingsResourceScope"]
+			})");
+
+	settings->RegisterSetting("debugger.moduleAnalysisThreads",
+		R"({
+			"title" : "Module Analysis Threads",
+			"type" : "number",
+			"default" : 2,
+			"minValue" : 1,
+			"maxValue" : 16,
+			"description" : "The number of loaded modules that are analyzed at the same time when debugger.analyzeLoadedModules is enabled.",
+			"ignore" : ["SettingsProjectScope", "SettingsResourceScope"]
+			})");
+
+	settings->RegisterSetting("debugger.translateImageBase",
+		R"({
+			"title" : "Translate Addresses Instead of Rebasing",
+			"type" : "boolean",
+			"default" : false,
+			"description" : "When the target loads the input file at a different base than the one in the view, keep the view at its original base and translate the addresses between the view and the target, instead of rebasing the view. Rebasing reanalyzes the whole binary, which can take minutes for a large one. Addresses reported by the debugger, e.g., register values and stack traces, are still those of the target, and are translated when they are looked up in the view.",
+			"ignore" : ["SettingsProjectScope", "SettingsResourceScope"]
+			})");
 }
 
 extern "C"
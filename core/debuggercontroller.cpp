@@ -15,6 +15,7 @@ limitations under the License.
 */
 
 #include "debuggercontroller.h"
+#include <algorithm>
 #include <thread>
 #include "lowlevelilinstruction.h"
 #include "mediumlevelilinstruction.h"
@@ -31,10 +32,14 @@ DebuggerController::DebuggerController(BinaryViewRef data)
 	m_data = data;
 	m_data->RegisterNotification(this);
 	m_viewStart = m_data->GetStart();
+	m_viewEnd = GetFileSegmentsEnd(m_data);
 
 	m_state = new DebuggerState(data, this);
+	m_expressions = new ExpressionCache(this);
 	m_adapter = nullptr;
 	m_shouldAnnotateStackVariable = Settings::Instance()->Get<bool>("debugger.stackVariableAnnotations");
+	if (Settings::Instance()->Get<bool>("debugger.analyzeLoadedModules"))
+		m_moduleAnalysis = new ModuleAnalysis(Settings::Instance()->Get<uint64_t>("debugger.moduleAnalysisThreads"));
 	RegisterEventCallback([this](const DebuggerEvent& event) { EventHandler(event); }, "Debugger Core");
 }
 
@@ -44,6 +49,18 @@ DebuggerController::~DebuggerController()
 	m_data->UnregisterNotification(this);
 	m_file = nullptr;
 
+	if (m_expressions)
+	{
+		delete m_expressions;
+		m_expressions = nullptr;
+	}
+
+	if (m_moduleAnalysis)
+	{
+		delete m_moduleAnalysis;
+		m_moduleAnalysis = nullptr;
+	}
+
 	if (m_state)
 	{
 		delete m_state;
@@ -57,7 +74,7 @@ void DebuggerController::AddBreakpoint(uint64_t address)
 	m_state->AddBreakpoint(address);
 	DebuggerEvent event;
 	event.type = AbsoluteBreakpointAddedEvent;
-	event.data.absoluteAddress = address;
+	event.data.AbsoluteAddress() = address;
 	PostDebuggerEvent(event);
 }
 
@@ -67,7 +84,7 @@ void DebuggerController::AddBreakpoint(const ModuleNameAndOffset& address)
 	m_state->AddBreakpoint(address);
 	DebuggerEvent event;
 	event.type = RelativeBreakpointAddedEvent;
-	event.data.relativeAddress = address;
+	event.data.RelativeAddress() = address;
 	PostDebuggerEvent(event);
 }
 
@@ -77,7 +94,7 @@ void DebuggerController::DeleteBreakpoint(uint64_t address)
 	m_state->DeleteBreakpoint(address);
 	DebuggerEvent event;
 	event.type = AbsoluteBreakpointRemovedEvent;
-	event.data.absoluteAddress = address;
+	event.data.AbsoluteAddress() = address;
 	PostDebuggerEvent(event);
 }
 
@@ -87,11 +104,195 @@ void DebuggerController::DeleteBreakpoint(const ModuleNameAndOffset& address)
 	m_state->DeleteBreakpoint(address);
 	DebuggerEvent event;
 	event.type = RelativeBreakpointRemovedEvent;
-	event.data.relativeAddress = address;
+	event.data.RelativeAddress() = address;
+	PostDebuggerEvent(event);
+}
+
+
+size_t DebuggerController::AddBreakpoints(const std::vector<uint64_t>& addresses)
+{
+	// Like AddBreakpoint(uint64_t), absolute addresses can only be converted once the adapter is created
+	if (!m_state->GetAdapter())
+		return 0;
+
+	std::vector<ModuleNameAndOffset> relative;
+	relative.reserve(addresses.size());
+	for (uint64_t address : addresses)
+		relative.push_back(m_state->GetModules()->AbsoluteAddressToRelative(address));
+	return AddBreakpoints(relative);
+}
+
+
+size_t DebuggerController::AddBreakpoints(const std::vector<ModuleNameAndOffset>& addresses)
+{
+	size_t count = m_state->GetBreakpoints()->AddOffsets(addresses);
+	DebuggerEvent event;
+	event.type = BreakpointsChangedEvent;
+	event.data.MessageData().message = fmt::format("Added {} breakpoint(s)", count);
+	PostDebuggerEvent(event);
+	return count;
+}
+
+
+size_t DebuggerController::DeleteBreakpoints(const std::vector<uint64_t>& addresses)
+{
+	if (!m_state->GetAdapter())
+		return 0;
+
+	std::vector<ModuleNameAndOffset> relative;
+	relative.reserve(addresses.size());
+	for (uint64_t address : addresses)
+		relative.push_back(m_state->GetModules()->AbsoluteAddressToRelative(address));
+	return DeleteBreakpoints(relative);
+}
+
+
+size_t DebuggerController::DeleteBreakpoints(const std::vector<ModuleNameAndOffset>& addresses)
+{
+	size_t count = m_state->GetBreakpoints()->RemoveOffsets(addresses);
+	DebuggerEvent event;
+	event.type = BreakpointsChangedEvent;
+	event.data.MessageData().message = fmt::format("Removed {} breakpoint(s)", count);
+	PostDebuggerEvent(event);
+	return count;
+}
+
+
+bool DebuggerController::SetBreakpointCondition(uint64_t address, const std::string& condition)
+{
+	return m_state->GetBreakpoints()->SetConditionAbsolute(address, condition);
+}
+
+
+bool DebuggerController::SetBreakpointCondition(const ModuleNameAndOffset& address, const std::string& condition)
+{
+	return m_state->GetBreakpoints()->SetConditionOffset(address, condition);
+}
+
+
+bool DebuggerController::AddTracepoint(uint64_t address, const std::string& captures)
+{
+	// Validate first, so an invalid tracepoint does not leave a stopping breakpoint behind
+	std::string error;
+	std::vector<TraceCapture> parsed;
+	if (!ParseTraceCaptures(captures, parsed, error))
+	{
+		LogWarn("Invalid tracepoint captures \"%s\": %s", captures.c_str(), error.c_str());
+		return false;
+	}
+
+	if (!m_state->GetBreakpoints()->ContainsAbsolute(address))
+		AddBreakpoint(address);
+	return m_state->GetBreakpoints()->SetTracepointAbsolute(address, true, captures);
+}
+
+
+bool DebuggerController::AddTracepoint(const ModuleNameAndOffset& address, const std::string& captures)
+{
+	std::string error;
+	std::vector<TraceCapture> parsed;
+	if (!ParseTraceCaptures(captures, parsed, error))
+	{
+		LogWarn("Invalid tracepoint captures \"%s\": %s", captures.c_str(), error.c_str());
+		return false;
+	}
+
+	if (!m_state->GetBreakpoints()->ContainsOffset(address))
+		AddBreakpoint(address);
+	return m_state->GetBreakpoints()->SetTracepointOffset(address, true, captures);
+}
+
+
+std::vector<TraceRecord> DebuggerController::DrainTraceRecords(size_t maxCount)
+{
+	return m_state->GetBreakpoints()->GetTraceBuffer()->Drain(maxCount);
+}
+
+
+uint64_t DebuggerController::GetDroppedTraceRecordCount()
+{
+	return m_state->GetBreakpoints()->GetTraceBuffer()->GetDroppedCount();
+}
+
+
+size_t DebuggerController::AddCoverage(const std::vector<uint64_t>& functions)
+{
+	size_t count = m_state->GetCoverage()->AddFunctions(functions);
+	if (count > 0)
+	{
+		DebuggerEvent event;
+		event.type = CoverageChangedEvent;
+		event.data.MessageData().message = fmt::format("Added {} block(s) to the coverage", count);
+		PostDebuggerEvent(event);
+	}
+	return count;
+}
+
+
+void DebuggerController::ClearCoverage()
+{
+	m_state->GetCoverage()->Clear();
+	DebuggerEvent event;
+	event.type = CoverageChangedEvent;
+	event.data.MessageData().message = "Cleared the coverage";
 	PostDebuggerEvent(event);
 }
 
 
+size_t DebuggerController::GetCoverageBlockCount()
+{
+	return m_state->GetCoverage()->GetBlockCount();
+}
+
+
+size_t DebuggerController::GetCoverageHitCount()
+{
+	return m_state->GetCoverage()->GetHitCount();
+}
+
+
+std::vector<uint64_t> DebuggerController::GetCoverageHits(size_t start)
+{
+	std::vector<uint64_t> hits = m_state->GetCoverage()->GetHits(start);
+	uint64_t viewStart = GetViewFileSegmentsStart();
+	for (auto& hit : hits)
+		hit += viewStart;
+	return hits;
+}
+
+
+// The adapter reports the watchpoints it adds or removes, including the ones from the backend console, and the event
+// handler keeps the list in sync. So these do not post any event themselves.
+bool DebuggerController::AddWatchpoint(uint64_t address, size_t size, DebugWatchpointType type, bool record)
+{
+	return m_state->GetWatchpoints()->Add(address, size, type, record);
+}
+
+
+bool DebuggerController::DeleteWatchpoint(uint64_t address)
+{
+	return m_state->GetWatchpoints()->Remove(address);
+}
+
+
+std::vector<WatchpointInfo> DebuggerController::GetWatchpoints()
+{
+	return m_state->GetWatchpoints()->GetWatchpointList();
+}
+
+
+std::vector<WatchpointHitRecord> DebuggerController::DrainWatchpointHits(size_t maxCount)
+{
+	return m_state->GetWatchpoints()->GetHitBuffer()->Drain(maxCount);
+}
+
+
+uint64_t DebuggerController::GetDroppedWatchpointHitCount()
+{
+	return m_state->GetWatchpoints()->GetHitBuffer()->GetDroppedCount();
+}
+
+
 bool DebuggerController::SetIP(uint64_t address)
 {
 	std::string ipRegisterName;
@@ -131,8 +332,8 @@ DebugStopReason DebuggerController::LaunchAndWaitInternal()
 	{
 		DebuggerEvent event;
 		event.type = LaunchFailureEventType;
-		event.data.errorData.shortError = "Safe mode enabled";
-		event.data.errorData.error =
+		event.data.ErrorData().shortError = "Safe mode enabled";
+		event.data.ErrorData().error =
 			fmt::format("Cannot launch the target because the debugger is in safe mode.");
 		PostDebuggerEvent(event);
 		return InternalError;
@@ -154,7 +355,13 @@ DebugStopReason DebuggerController::LaunchAndWaitInternal()
 	if (!CreateDebuggerBinaryView())
 		return InternalError;
 
-	return ExecuteAdapterAndWait(DebugAdapterLaunch);
+	// Without a stop at the entry point, the target runs straight into the breakpoints, so treat them like Go does.
+	// Otherwise, the first stop is the one at the entry point, which must surface.
+	auto reason = ExecuteAdapterAndWait(DebugAdapterLaunch);
+	if (m_userRequestedBreak || Settings::Instance()->Get<bool>("debugger.stopAtEntryPoint")
+		|| m_adapter->SupportFeature(DebugAdapterSupportStopFilter) || !IsStopHandledByCore(reason))
+		return reason;
+	return GoAndWaitInternal();
 }
 
 
@@ -309,6 +516,7 @@ bool DebuggerController::CreateDebugAdapter()
 
 	// Forward the DebuggerEvent from the adapters to the controller
 	m_adapter->SetEventCallback([this](const DebuggerEvent& event) { PostDebuggerEvent(event); });
+	m_adapter->SetStopFilter([this](DebugStopReason reason) { return FilterAdapterStop(reason); });
 	return true;
 }
 
@@ -402,7 +610,7 @@ DebugStopReason DebuggerController::StepIntoIL(BNFunctionGraphType il)
 			if (!ExpectSingleStep(reason))
 				return reason;
 
-			uint64_t newRemoteRip = m_state->IP();
+			uint64_t newRemoteRip = LiveToViewAddress(m_state->IP());
 			std::vector<FunctionRef> functions = GetData()->GetAnalysisFunctionsContainingAddress(newRemoteRip);
 			if (functions.empty())
 				return SingleStep;
@@ -432,7 +640,7 @@ DebugStopReason DebuggerController::StepIntoIL(BNFunctionGraphType il)
 			if (!ExpectSingleStep(reason))
 				return reason;
 
-			uint64_t newRemoteRip = m_state->IP();
+			uint64_t newRemoteRip = LiveToViewAddress(m_state->IP());
 			std::vector<FunctionRef> functions = GetData()->GetAnalysisFunctionsContainingAddress(newRemoteRip);
 			if (functions.empty())
 				return SingleStep;
@@ -463,7 +671,7 @@ DebugStopReason DebuggerController::StepIntoIL(BNFunctionGraphType il)
 			if (!ExpectSingleStep(reason))
 				return reason;
 
-			uint64_t newRemoteRip = m_state->IP();
+			uint64_t newRemoteRip = LiveToViewAddress(m_state->IP());
 			std::vector<FunctionRef> functions = GetData()->GetAnalysisFunctionsContainingAddress(newRemoteRip);
 			if (functions.empty())
 				return SingleStep;
@@ -507,7 +715,7 @@ DebugStopReason DebuggerController::StepIntoReverseIL(BNFunctionGraphType il)
 			if (!ExpectSingleStep(reason))
 				return reason;
 
-			uint64_t newRemoteRip = m_state->IP();
+			uint64_t newRemoteRip = LiveToViewAddress(m_state->IP());
 			std::vector<FunctionRef> functions = GetData()->GetAnalysisFunctionsContainingAddress(newRemoteRip);
 			if (functions.empty())
 				return SingleStep;
@@ -537,7 +745,7 @@ DebugStopReason DebuggerController::StepIntoReverseIL(BNFunctionGraphType il)
 			if (!ExpectSingleStep(reason))
 				return reason;
 
-			uint64_t newRemoteRip = m_state->IP();
+			uint64_t newRemoteRip = LiveToViewAddress(m_state->IP());
 			std::vector<FunctionRef> functions = GetData()->GetAnalysisFunctionsContainingAddress(newRemoteRip);
 			if (functions.empty())
 				return SingleStep;
@@ -568,7 +776,7 @@ DebugStopReason DebuggerController::StepIntoReverseIL(BNFunctionGraphType il)
 			if (!ExpectSingleStep(reason))
 				return reason;
 
-			uint64_t newRemoteRip = m_state->IP();
+			uint64_t newRemoteRip = LiveToViewAddress(m_state->IP());
 			std::vector<FunctionRef> functions = GetData()->GetAnalysisFunctionsContainingAddress(newRemoteRip);
 			if (functions.empty())
 				return SingleStep;
@@ -598,6 +806,10 @@ DebugStopReason DebuggerController::StepIntoReverseIL(BNFunctionGraphType il)
 DebugStopReason DebuggerController::StepIntoReverseAndWaitInternal()
 {
 	m_userRequestedBreak = false;
+	DebugStopReason reason;
+	if (ExecuteJournalAndWait(DebugAdapterStepIntoReverse, reason))
+		return reason;
+
 	// TODO: check if StepInto() succeeds
 	return ExecuteAdapterAndWait(DebugAdapterStepIntoReverse);
 }
@@ -665,7 +877,7 @@ DebugStopReason DebuggerController::StepOverIL(BNFunctionGraphType il)
 			if (!ExpectSingleStep(reason))
 				return reason;
 
-			uint64_t newRemoteRip = m_state->IP();
+			uint64_t newRemoteRip = LiveToViewAddress(m_state->IP());
 			std::vector<FunctionRef> functions = GetData()->GetAnalysisFunctionsContainingAddress(newRemoteRip);
 			if (functions.empty())
 				return SingleStep;
@@ -694,7 +906,7 @@ DebugStopReason DebuggerController::StepOverIL(BNFunctionGraphType il)
 			DebugStopReason reason = StepOverAndWaitInternal();
 			if (!ExpectSingleStep(reason))
 				return reason;
-			uint64_t newRemoteRip = m_state->IP();
+			uint64_t newRemoteRip = LiveToViewAddress(m_state->IP());
 			std::vector<FunctionRef> functions = GetData()->GetAnalysisFunctionsContainingAddress(newRemoteRip);
 			if (functions.empty())
 				return SingleStep;
@@ -725,7 +937,7 @@ DebugStopReason DebuggerController::StepOverIL(BNFunctionGraphType il)
 			if (!ExpectSingleStep(reason))
 				return reason;
 
-			uint64_t newRemoteRip = m_state->IP();
+			uint64_t newRemoteRip = LiveToViewAddress(m_state->IP());
 			std::vector<FunctionRef> functions = GetData()->GetAnalysisFunctionsContainingAddress(newRemoteRip);
 			if (functions.empty())
 				return SingleStep;
@@ -768,7 +980,7 @@ DebugStopReason DebuggerController::StepOverReverseIL(BNFunctionGraphType il)
 			if (!ExpectSingleStep(reason))
 				return reason;
 
-			uint64_t newRemoteRip = m_state->IP();
+			uint64_t newRemoteRip = LiveToViewAddress(m_state->IP());
 			std::vector<FunctionRef> functions = GetData()->GetAnalysisFunctionsContainingAddress(newRemoteRip);
 			if (functions.empty())
 				return SingleStep;
@@ -797,7 +1009,7 @@ DebugStopReason DebuggerController::StepOverReverseIL(BNFunctionGraphType il)
 			DebugStopReason reason = StepOverReverseAndWaitInternal();
 			if (!ExpectSingleStep(reason))
 				return reason;
-			uint64_t newRemoteRip = m_state->IP();
+			uint64_t newRemoteRip = LiveToViewAddress(m_state->IP());
 			std::vector<FunctionRef> functions = GetData()->GetAnalysisFunctionsContainingAddress(newRemoteRip);
 			if (functions.empty())
 				return SingleStep;
@@ -828,7 +1040,7 @@ DebugStopReason DebuggerController::StepOverReverseIL(BNFunctionGraphType il)
 			if (!ExpectSingleStep(reason))
 				return reason;
 
-			uint64_t newRemoteRip = m_state->IP();
+			uint64_t newRemoteRip = LiveToViewAddress(m_state->IP());
 			std::vector<FunctionRef> functions = GetData()->GetAnalysisFunctionsContainingAddress(newRemoteRip);
 			if (functions.empty())
 				return SingleStep;
@@ -905,38 +1117,95 @@ DebugStopReason DebuggerController::StepOverReverseAndWait(BNFunctionGraphType i
 }
 
 
-DebugStopReason DebuggerController::EmulateStepReturnAndWait()
+bool DebuggerController::GetFunctionReturns(uint64_t remoteAddress, std::vector<uint64_t>& remoteAddresses)
 {
-	uint64_t address = m_state->IP();
+	uint64_t address = LiveToViewAddress(remoteAddress);
 	std::vector<FunctionRef> functions = GetData()->GetAnalysisFunctionsContainingAddress(address);
 	if (functions.empty())
-		return InternalError;
+		return false;
 
-	std::vector<uint64_t> returnAddresses;
 	FunctionRef function = functions[0];
-	MediumLevelILFunctionRef mlilFunc = function->GetMediumLevelIL();
-	for (size_t i = 0; i < mlilFunc->GetInstructionCount(); i++)
+	auto iter = m_functionReturns.find(function->GetStart());
+	if (iter == m_functionReturns.end())
+	{
+		std::vector<uint64_t> returnAddresses;
+		MediumLevelILFunctionRef mlilFunc = function->GetMediumLevelIL();
+		if (!mlilFunc)
+			return false;
+		for (size_t i = 0; i < mlilFunc->GetInstructionCount(); i++)
+		{
+			MediumLevelILInstruction instruction = mlilFunc->GetInstruction(i);
+			if ((instruction.operation == MLIL_RET) || (instruction.operation == MLIL_TAILCALL))
+				returnAddresses.push_back(instruction.address);
+		}
+		iter = m_functionReturns.emplace(function->GetStart(), std::move(returnAddresses)).first;
+	}
+
+	remoteAddresses.clear();
+	for (uint64_t returnAddress : iter->second)
+		remoteAddresses.push_back(ViewToLiveAddress(returnAddress));
+	return !remoteAddresses.empty();
+}
+
+
+DebugStopReason DebuggerController::EmulateStepReturnAndWait()
+{
+	auto thread = m_state->GetThreads()->GetActiveThread();
+	std::vector<DebugFrame> frames = m_state->GetThreads()->GetFramesOfThread(thread.m_tid);
+	if ((frames.size() < 2) || (frames[1].m_pc == 0))
+	{
+		// Without a caller frame, e.g., when the unwinder gives up, run to the return instructions of the function
+		std::vector<uint64_t> returnAddresses;
+		if (!GetFunctionReturns(m_state->IP(), returnAddresses))
+			return InternalError;
+		return RunToAndWaitInternal(returnAddresses);
+	}
+
+	// The return address of a recursive call can be the same one, so only stop once the stack is back at the caller
+	// frame. The breakpoint is not thread specific either, so a hit by another thread is ignored as well.
+	uint64_t returnAddress = frames[1].m_pc;
+	// A nested call returns with the stack pointer of the current frame, so the stop must be strictly above it, even
+	// when the unwinder does not report the stack pointer of the caller
+	uint64_t stackPointer = m_adapter->GetStackPointer();
+	uint64_t callerStackPointer = (frames[1].m_sp > stackPointer) ? frames[1].m_sp : stackPointer + 1;
+	bool userBreakpoint = m_state->GetBreakpoints()->ContainsAbsolute(returnAddress);
+	if (!userBreakpoint)
+		m_adapter->AddBreakpoint(returnAddress);
+
+	// The register cache is only refreshed once the stop surfaces, so the checks read from the adapter directly
+	DebugStopReason reason;
+	while (true)
 	{
-		MediumLevelILInstruction instruction = mlilFunc->GetInstruction(i);
-		if ((instruction.operation == MLIL_RET) || (instruction.operation == MLIL_TAILCALL))
-			returnAddresses.push_back(instruction.address);
+		reason = GoAndWaitInternal();
+		if (m_userRequestedBreak || (reason != Breakpoint) || (m_adapter->GetInstructionOffset() != returnAddress))
+			break;
+		if (userBreakpoint)
+			break;
+		if ((m_adapter->GetActiveThreadId() == thread.m_tid) && (m_adapter->GetStackPointer() >= callerStackPointer))
+			break;
 	}
 
-	return RunToAndWaitInternal(returnAddresses);
+	if (!userBreakpoint)
+		m_adapter->RemoveBreakpoint(returnAddress);
+
+	return reason;
 }
 
 
 DebugStopReason DebuggerController::StepReturnAndWaitInternal()
 {
 	m_userRequestedBreak = false;
+	DebugStopReason reason;
+	if (ExecuteJournalAndWait(DebugAdapterStepReturn, reason))
+		return reason;
 
-	if (true /* StepReturnAvailable() */)
+	if (m_adapter->SupportFeature(DebugAdapterSupportStepReturn))
 	{
 		return ExecuteAdapterAndWait(DebugAdapterStepReturn);
 	}
 	else
 	{
-		// Emulate a step over
+		// Emulate a step return
 		return EmulateStepReturnAndWait();
 	}
 }
@@ -945,6 +1214,9 @@ DebugStopReason DebuggerController::StepReturnAndWaitInternal()
 DebugStopReason DebuggerController::StepReturnReverseAndWaitInternal()
 {
 	m_userRequestedBreak = false;
+	DebugStopReason reason;
+	if (ExecuteJournalAndWait(DebugAdapterStepReturnReverse, reason))
+		return reason;
 
 	if (true /* StepReturnReverseAvailable() */)
 	{
@@ -1007,6 +1279,13 @@ DebugStopReason DebuggerController::RunToAndWaitInternal(const std::vector<uint6
 {
 	m_userRequestedBreak = false;
 
+	DebugStopReason journalReason;
+	if (ExecuteJournalAndWait(DebugAdapterGo, journalReason, remoteAddresses))
+	{
+		NotifyStopped(journalReason);
+		return journalReason;
+	}
+
 	for (uint64_t remoteAddress : remoteAddresses)
 	{
 		if (!m_state->GetBreakpoints()->ContainsAbsolute(remoteAddress))
@@ -1089,13 +1368,25 @@ void DebuggerController::DetectLoadedModule()
 	if (m_inputFileLoaded || (!m_state->GetRemoteBase(remoteBase)))
 		return;
 
+	if ((remoteBase != GetViewFileSegmentsStart()) && Settings::Instance()->Get<bool>("debugger.translateImageBase"))
+	{
+		// Rebasing reanalyzes the whole binary. Leave the view where it is and read the image from where the target
+		// loaded it instead.
+		m_liveImageBase = remoteBase;
+		m_imageTranslated = true;
+		m_inputFileLoaded = true;
+		LogInfo("%s", fmt::format("Input file loaded at 0x{:x}, translating addresses instead of rebasing the view",
+			remoteBase).c_str());
+		return;
+	}
+
 	if (BinaryNinja::IsUIEnabled())
 	{
 		// When the UI is enabled, let the debugger UI do the work. It can show a progress bar if the operation takes
 		// a while.
 		DebuggerEvent event;
 		event.type = ModuleLoadedEvent;
-		event.data.absoluteAddress = remoteBase;
+		event.data.AbsoluteAddress() = remoteBase;
 		PostDebuggerEvent(event);
 	}
 	else
@@ -1117,6 +1408,55 @@ void DebuggerController::DetectLoadedModule()
 }
 
 
+uint64_t DebuggerController::GetFileSegmentsEnd(BinaryView* view)
+{
+	uint64_t end = 0;
+	for (const auto& segment : view->GetSegments())
+		end = std::max(end, segment->GetEnd());
+	// A view without segments, e.g., a raw one, is all file
+	if (end == 0)
+		end = view->GetEnd();
+	return end;
+}
+
+
+uint64_t DebuggerController::ViewToLiveAddress(uint64_t address) const
+{
+	if (!m_imageTranslated || (address < m_viewStart) || (address >= m_viewEnd))
+		return address;
+	return address - m_viewStart + m_liveImageBase;
+}
+
+
+uint64_t DebuggerController::LiveToViewAddress(uint64_t address) const
+{
+	if (!m_imageTranslated || (address < m_liveImageBase) || (address - m_liveImageBase >= m_viewEnd - m_viewStart))
+		return address;
+	return address - m_liveImageBase + m_viewStart;
+}
+
+
+uint64_t DebuggerController::ViewToLiveRange(uint64_t address, size_t& length) const
+{
+	if (!m_imageTranslated)
+		return address;
+
+	if (address < m_viewStart)
+	{
+		if (length > m_viewStart - address)
+			length = m_viewStart - address;
+		return address;
+	}
+
+	if (address >= m_viewEnd)
+		return address;
+
+	if (length > m_viewEnd - address)
+		length = m_viewEnd - address;
+	return address - m_viewStart + m_liveImageBase;
+}
+
+
 DebugThread DebuggerController::GetActiveThread() const
 {
 	return m_state->GetThreads()->GetActiveThread();
@@ -1314,13 +1654,122 @@ DebugStopReason DebuggerController::PauseAndWait()
 
 DebugStopReason DebuggerController::GoAndWaitInternal()
 {
+	if (!m_adapter)
+		return InternalError;
+
 	m_userRequestedBreak = false;
-	return ExecuteAdapterAndWait(DebugAdapterGo);
+	DebugStopReason journalReason;
+	if (ExecuteJournalAndWait(DebugAdapterGo, journalReason))
+		return journalReason;
+
+	// A breakpoint whose condition does not hold, a tracepoint, a recording watchpoint, or the first hit of a covered
+	// block is resumed right away. An adapter with a stop filter does so itself and never reports the stop. Otherwise,
+	// it is resumed right here, which costs a round trip to the adapter, but neither a cache refresh nor one through
+	// the event callbacks.
+	bool adapterFilters = m_adapter->SupportFeature(DebugAdapterSupportStopFilter);
+	while (true)
+	{
+		auto reason = ExecuteAdapterAndWait(DebugAdapterGo);
+		if (m_userRequestedBreak || adapterFilters || !IsStopHandledByCore(reason))
+			return reason;
+	}
+}
+
+
+bool DebuggerController::IsStopHandledByCore(DebugStopReason reason)
+{
+	if (reason == Breakpoint)
+		return HandleCoverageHit() || !ShouldStopAtBreakpoint();
+	if (reason == Watchpoint)
+		return !ShouldStopAtWatchpoint();
+	return false;
+}
+
+
+bool DebuggerController::FilterAdapterStop(DebugStopReason reason)
+{
+	if (!m_filterAdapterStops || m_userRequestedBreak)
+		return false;
+	return IsStopHandledByCore(reason);
+}
+
+
+bool DebuggerController::ShouldStopAtBreakpoint()
+{
+	auto breakpoints = m_state->GetBreakpoints();
+	if (!m_adapter || !breakpoints->HasConditions())
+		return true;
+
+	// The register and memory caches are only refreshed once a stop surfaces, so the condition reads from the adapter
+	// directly. The registers are fetched at most once, when the condition first refers to one.
+	std::optional<std::unordered_map<std::string, DebugRegister>> registers;
+	auto arch = m_state->GetRemoteArchitecture();
+
+	BreakpointCondition::Context context;
+	context.addressSize = arch ? arch->GetAddressSize() : 8;
+	context.littleEndian = !arch || (arch->GetEndianness() == LittleEndian);
+	context.readRegister = [&](const std::string& name, uint64_t& value) {
+		if (!registers.has_value())
+			registers = m_adapter->ReadAllRegisters();
+		auto iter = registers->find(name);
+		if (iter == registers->end())
+			return false;
+		value = iter->second.m_value;
+		return true;
+	};
+	context.readMemory = [&](uint64_t address, size_t size, std::vector<uint8_t>& data) {
+		DataBuffer buffer = m_adapter->ReadMemory(address, size);
+		if (buffer.GetLength() != size)
+			return false;
+		auto bytes = (const uint8_t*)buffer.GetData();
+		data.assign(bytes, bytes + size);
+		return true;
+	};
+
+	return breakpoints->ShouldStopAt(
+		m_adapter->GetInstructionOffset(), context, [&]() { return m_adapter->GetActiveThreadId(); });
+}
+
+
+// Records the hit if the target stopped at the start of a covered block. Returns true if nothing but the breakpoint of
+// that block stopped the target, i.e., there is no user breakpoint at the same address, so it can be resumed.
+bool DebuggerController::HandleCoverageHit()
+{
+	auto coverage = m_state->GetCoverage();
+	if (!m_adapter || coverage->IsEmpty())
+		return false;
+
+	uint64_t address = m_adapter->GetInstructionOffset();
+	bool firstHit = false;
+	if (!coverage->RecordHit(address, firstHit))
+		return false;
+
+	// Adapters without one-shot breakpoints delete every breakpoint at the address, so keep the user's one
+	bool userBreakpoint = m_state->GetBreakpoints()->ContainsAbsolute(address);
+	if (firstHit && !userBreakpoint)
+		m_adapter->OneShotBreakpointHit(address);
+	return !userBreakpoint;
 }
 
+
+bool DebuggerController::ShouldStopAtWatchpoint()
+{
+	std::uintptr_t address = 0;
+	if (!m_adapter || !m_adapter->GetStoppedWatchpoint(address))
+		return true;
+
+	return m_state->GetWatchpoints()->ShouldStopAt(
+		address, m_adapter->GetInstructionOffset(), m_adapter->GetActiveThreadId());
+}
+
+
 DebugStopReason DebuggerController::GoReverseAndWaitInternal()
 {
 	m_userRequestedBreak = false;
+	DebugStopReason reason;
+	if (ExecuteJournalAndWait(DebugAdapterGoReverse, reason))
+		return reason;
+
 	return ExecuteAdapterAndWait(DebugAdapterGoReverse);
 }
 
@@ -1328,6 +1777,10 @@ DebugStopReason DebuggerController::GoReverseAndWaitInternal()
 DebugStopReason DebuggerController::StepIntoAndWaitInternal()
 {
 	m_userRequestedBreak = false;
+	DebugStopReason reason;
+	if (ExecuteJournalAndWait(DebugAdapterStepInto, reason))
+		return reason;
+
 	// TODO: check if StepInto() succeeds
 	return ExecuteAdapterAndWait(DebugAdapterStepInto);
 }
@@ -1378,6 +1831,9 @@ DebugStopReason DebuggerController::EmulateStepOverAndWait()
 DebugStopReason DebuggerController::StepOverAndWaitInternal()
 {
 	m_userRequestedBreak = false;
+	DebugStopReason reason;
+	if (ExecuteJournalAndWait(DebugAdapterStepOver, reason))
+		return reason;
 
 	if (true /* StepOverAvailable() */)
 	{
@@ -1393,6 +1849,9 @@ DebugStopReason DebuggerController::StepOverAndWaitInternal()
 DebugStopReason DebuggerController::StepOverReverseAndWaitInternal()
 {
 	m_userRequestedBreak = false;
+	DebugStopReason reason;
+	if (ExecuteJournalAndWait(DebugAdapterStepOverReverse, reason))
+		return reason;
 
 	if (true /* StepOverAvailable() */)
 	{
@@ -1406,133 +1865,392 @@ DebugStopReason DebuggerController::StepOverReverseAndWaitInternal()
 }
 
 
-void DebuggerController::LaunchOrConnect()
+bool DebuggerController::IsRecordingExecution()
 {
-	std::string adapter = m_state->GetAdapterType();
-	auto adapterType = DebugAdapterType::GetByName(adapter);
-	if (!adapterType)
-		return;
+	if (!m_adapter || m_adapter->SupportFeature(DebugAdapterSupportTTD))
+		return false;
 
-	if (adapterType->CanExecute(GetData()))
-		Launch();
-	else if (adapterType->CanConnect(GetData()))
-		Connect();
+	return Settings::Instance()->Get<bool>("debugger.recordExecution");
 }
 
 
-// Can't use a vector here as initialization order is not guaranteed.
-DbgRef<DebuggerController>* DebuggerController::g_debuggerControllers = nullptr;
-size_t DebuggerController::g_controllerCount = 0;
+static bool IsReverseOperation(DebugAdapterOperation operation)
+{
+	return (operation == DebugAdapterGoReverse) || (operation == DebugAdapterStepIntoReverse)
+		|| (operation == DebugAdapterStepOverReverse) || (operation == DebugAdapterStepReturnReverse);
+}
 
 
-DbgRef<DebuggerController> DebuggerController::GetController(BinaryViewRef data)
+bool DebuggerController::ExecuteJournalAndWait(
+	DebugAdapterOperation operation, DebugStopReason& reason, const std::vector<uint64_t>& stopAddresses)
 {
-	for (size_t i = 0; i < g_controllerCount; i++)
+	// Adapters with time travel debugging go backwards on their own
+	if (!m_adapter || m_adapter->SupportFeature(DebugAdapterSupportTTD))
+		return false;
+
+	ExecutionJournal* journal = m_state->GetJournal();
+	if (IsReverseOperation(operation) || journal->IsReplaying())
 	{
-		DebuggerController* controller = g_debuggerControllers[i];
-		if (!controller)
-			continue;
-		if (controller->m_file.operator==(data->GetFile()))
-			return controller;
+		reason = ReplayAndWait(operation, stopAddresses);
+		return true;
 	}
 
-	auto controller = new DebuggerController(data);
-	g_debuggerControllers = (DbgRef<DebuggerController>*)realloc(g_debuggerControllers,
-							sizeof(DbgRef<DebuggerController>) * (g_controllerCount + 1));
+	if (IsRecordingExecution())
+	{
+		reason = RecordAndWait(operation, stopAddresses);
+		return true;
+	}
 
-	// We must call the DbgRef ctor on the newly allocated space explicitly. If we do a
-	// g_debuggerControllers[g_controllerCount] = controller;
-	// The `=` operator on the next line will cause a call to `DbgRef<T>& operator=(T* obj)` on an uninitialized DbgRef
-	// object, leading to a crash when `DbgRef::m_obj` is de-referenced.
-	// In fact, this is how std::vector does things inside `push_back`.
-	new (&g_debuggerControllers[g_controllerCount]) DbgRef<DebuggerController>(controller);
-	g_controllerCount++;
-	return controller;
+	// The target runs without being recorded, so the recorded history no longer leads up to its state
+	if (journal->GetStepCount() > 0)
+		journal->Clear();
+	return false;
 }
 
 
-void DebuggerController::DeleteController(BinaryViewRef data)
+void DebuggerController::GetInstructionWrites(
+	uint64_t address, uint64_t stackPointer, std::vector<JournalMemoryWrite>& writes, uint32_t& flags)
 {
-	for (size_t i = 0; i < g_controllerCount; i++)
-	{
-		DbgRef<DebuggerController> controller = g_debuggerControllers[i];
-		if (!controller)
-			continue;
+	ArchitectureRef remoteArch = m_state->GetRemoteArchitecture();
+	if (!remoteArch)
+		return;
 
-		if (controller->GetData() == data)
-		{
-			g_debuggerControllers[i] = nullptr;
-		}
+	DataBuffer buffer = m_adapter->ReadMemory(address, remoteArch->GetMaxInstructionLength());
+	if (buffer.GetLength() == 0)
+		return;
+
+	Ref<LowLevelILFunction> ilFunc = new LowLevelILFunction(remoteArch, nullptr);
+	ilFunc->SetCurrentAddress(remoteArch, address);
+	remoteArch->GetInstructionLowLevelIL((const uint8_t*)buffer.GetData(), address, buffer.GetLength(), *ilFunc);
+
+	std::vector<std::pair<uint64_t, size_t>> ranges;
+	bool hasStore = false;
+	uint64_t newStackPointer = stackPointer;
+	size_t addressSize = remoteArch->GetAddressSize();
+	uint32_t stackPointerRegister = remoteArch->GetStackPointerRegister();
+	for (size_t i = 0; i < ilFunc->GetInstructionCount(); i++)
+	{
+		(*ilFunc)[i].VisitExprs([&](const LowLevelILInstruction& expr) {
+			uint64_t value = 0;
+			switch (expr.operation)
+			{
+			case LLIL_STORE:
+				hasStore = true;
+				if (m_expressions->EvaluateOnce(expr.GetDestExpr<LLIL_STORE>(), value))
+					ranges.emplace_back(value, expr.size);
+				break;
+			case LLIL_PUSH:
+				ranges.emplace_back(stackPointer - expr.size, expr.size);
+				break;
+			case LLIL_CALL:
+				// The return address, on the architectures that push it. Recording bytes that are not written is
+				// harmless, since putting them back restores the same value.
+				ranges.emplace_back(stackPointer - addressSize, addressSize);
+				flags |= JournalCallStep;
+				break;
+			case LLIL_RET:
+				flags |= JournalReturnStep;
+				break;
+			case LLIL_SET_REG:
+				if ((expr.GetDestRegister<LLIL_SET_REG>() == stackPointerRegister)
+					&& m_expressions->EvaluateOnce(expr.GetSourceExpr<LLIL_SET_REG>(), value))
+					newStackPointer = value;
+				break;
+			default:
+				break;
+			}
+			return true;
+		});
 	}
-}
 
+	// The address of a store after a stack pointer update in the same instruction, e.g., stp x29, x30, [sp, #-0x10]!
+	// on arm64, is computed from the old stack pointer above. Record everything between the two instead.
+	if (hasStore && (newStackPointer < stackPointer) && (stackPointer - newStackPointer <= 0x10000))
+		ranges.emplace_back(newStackPointer, stackPointer - newStackPointer);
 
-bool DebuggerController::ControllerExists(BinaryViewRef data)
-{
-	for (size_t i = 0; i < g_controllerCount; i++)
+	for (const auto& [start, size] : ranges)
 	{
-		DbgRef<DebuggerController> controller = g_debuggerControllers[i];
-		if (!controller)
+		if (size == 0)
 			continue;
-		if (controller->GetData() == data)
-			return true;
+		DataBuffer before = m_adapter->ReadMemory(start, size);
+		if (before.GetLength() != size)
+			continue;
+		JournalMemoryWrite write;
+		write.address = start;
+		auto bytes = (const uint8_t*)before.GetData();
+		write.before.assign(bytes, bytes + size);
+		writes.push_back(std::move(write));
 	}
-
-	return false;
 }
 
 
-DbgRef<DebuggerController> DebuggerController::GetController(FileMetadataRef file)
+DebugStopReason DebuggerController::RecordStepAndWait(uint32_t& flags)
 {
-	for (size_t i = 0; i < g_controllerCount; i++)
-	{
-		DebuggerController* controller = g_debuggerControllers[i];
-		if (!controller)
-			continue;
-		if (controller->GetFile() == file)
-			return controller;
-	}
+	ExecutionJournal* journal = m_state->GetJournal();
+	if (journal->GetStepCount() == 0)
+		journal->SetCapacity(Settings::Instance()->Get<uint64_t>("debugger.executionJournalSize") * 1024 * 1024);
 
-	// You cannot create a controller from a file -- you must use a binary view for it
-	return nullptr;
-}
+	// The register cache is only refreshed once a stop surfaces, but the addresses of the stores are computed from it
+	m_state->GetRegisters()->MarkDirty();
 
+	uint64_t ip = m_adapter->GetInstructionOffset();
+	uint64_t sp = m_adapter->GetStackPointer();
+	auto before = m_adapter->ReadAllRegisters();
+	std::vector<JournalMemoryWrite> writes;
+	flags = 0;
+	GetInstructionWrites(ip, sp, writes, flags);
 
-bool DebuggerController::ControllerExists(FileMetadataRef file)
+	auto reason = ExecuteAdapterAndWait(DebugAdapterStepInto);
+	if ((reason == ProcessExited) || (reason == InternalError))
+		return reason;
+
+	auto after = m_adapter->ReadAllRegisters();
+	if (!journal->AppendStep(
+			before, ip, sp, flags, writes, after, m_adapter->GetInstructionOffset(), m_adapter->GetStackPointer()))
+	{
+		LogWarn("The execution journal is full after %zu steps, discarding the recorded history",
+			journal->GetStepCount());
+		journal->Clear();
+	}
+	return reason;
+}
+
+
+DebugStopReason DebuggerController::RecordAndWait(
+	DebugAdapterOperation operation, const std::vector<uint64_t>& stopAddresses)
 {
-	for (size_t i = 0; i < g_controllerCount; i++)
+	// Only the active thread is stepped and journaled, so the other threads must not run and change the memory behind
+	// the back of the journal. The threads frozen by the user stay frozen afterwards. Threads created while recording
+	// are not suspended.
+	std::vector<uint32_t> suspended;
+	uint32_t activeThread = m_adapter->GetActiveThread().m_tid;
+	for (const DebugThread& thread : m_state->GetThreads()->GetAllThreads())
 	{
-		DbgRef<DebuggerController> controller = g_debuggerControllers[i];
-		if (!controller)
-			continue;
-		if (controller->GetFile() == file)
-			return true;
+		if ((thread.m_tid != activeThread) && !thread.m_isFrozen && m_adapter->SuspendThread(thread.m_tid))
+			suspended.push_back(thread.m_tid);
 	}
 
-	return false;
+	auto record = [&]() {
+		// The call depth relative to the start, for stepping over calls and out of the current function
+		int depth = 0;
+		while (true)
+		{
+			uint32_t flags = 0;
+			auto reason = RecordStepAndWait(flags);
+			if (!ExpectSingleStep(reason) || (operation == DebugAdapterStepInto) || m_userRequestedBreak)
+				return reason;
+
+			if (flags & JournalCallStep)
+				depth++;
+			if (flags & JournalReturnStep)
+				depth--;
+			if ((operation == DebugAdapterStepOver) && (depth <= 0))
+				return SingleStep;
+			if ((operation == DebugAdapterStepReturn) && (depth < 0))
+				return SingleStep;
+
+			uint64_t ip = m_adapter->GetInstructionOffset();
+			if (std::find(stopAddresses.begin(), stopAddresses.end(), ip) != stopAddresses.end())
+				return Breakpoint;
+			if (m_state->GetBreakpoints()->ContainsAbsolute(ip) && ShouldStopAtBreakpoint())
+				return Breakpoint;
+		}
+	};
+
+	DebugStopReason reason = record();
+	if ((reason != ProcessExited) && (reason != InternalError))
+	{
+		for (uint32_t tid : suspended)
+			m_adapter->ResumeThread(tid);
+	}
+	return reason;
 }
 
 
-void DebuggerController::DeleteController(FileMetadataRef file)
+DebugStopReason DebuggerController::ReplayAndWait(
+	DebugAdapterOperation operation, const std::vector<uint64_t>& stopAddresses)
 {
-	for (size_t i = 0; i < g_controllerCount; i++)
+	ExecutionJournal* journal = m_state->GetJournal();
+	bool reverse = IsReverseOperation(operation);
+	size_t count = journal->GetStepCount();
+	size_t start = journal->GetPosition();
+	size_t position = start;
+	DebugStopReason reason = SingleStep;
+
+	// Like RecordAndWait(), except that breakpoint conditions are not evaluated while replaying
+	int depth = 0;
+	while (reverse ? (position > 0) : (position < count))
 	{
-		DbgRef<DebuggerController> controller = g_debuggerControllers[i];
-		if (!controller)
-			continue;
+		uint32_t flags = journal->GetFlags(reverse ? position - 1 : position);
+		position = reverse ? position - 1 : position + 1;
+		if (flags & JournalCallStep)
+			depth += reverse ? -1 : 1;
+		if (flags & JournalReturnStep)
+			depth += reverse ? 1 : -1;
+
+		if ((operation == DebugAdapterStepInto) || (operation == DebugAdapterStepIntoReverse))
+			break;
+		if (((operation == DebugAdapterStepOver) || (operation == DebugAdapterStepOverReverse)) && (depth <= 0))
+			break;
+		if (((operation == DebugAdapterStepReturn) || (operation == DebugAdapterStepReturnReverse)) && (depth < 0))
+			break;
 
-		if (controller->GetFile() == file)
+		uint64_t ip = journal->GetIP(position);
+		if ((std::find(stopAddresses.begin(), stopAddresses.end(), ip) != stopAddresses.end())
+			|| m_state->GetBreakpoints()->ContainsAbsolute(ip))
 		{
-			g_debuggerControllers[i] = nullptr;
+			reason = Breakpoint;
+			break;
 		}
 	}
+
+	if (position == start)
+	{
+		if (count == 0)
+			LogWarn("There is no recorded execution to replay. Enable debugger.recordExecution before running the "
+					"target to step and run it backwards.");
+		else
+			LogWarn("Reached the beginning of the execution journal");
+		return InvalidStatusOrOperation;
+	}
+
+	if (position == count)
+		LogInfo("Reached the end of the execution journal, back at the live state of the target");
+
+	journal->SetPosition(position);
+	m_state->MarkDirty();
+	return reason;
+}
+
+
+void DebuggerController::LaunchOrConnect()
+{
+	std::string adapter = m_state->GetAdapterType();
+	auto adapterType = DebugAdapterType::GetByName(adapter);
+	if (!adapterType)
+		return;
+
+	if (adapterType->CanExecute(GetData()))
+		Launch();
+	else if (adapterType->CanConnect(GetData()))
+		Connect();
+}
+
+
+// These are function-local statics, since the initialization order of globals across translation units is not
+// guaranteed. They are allocated once and intentionally never freed, so no controller is destructed during static
+// destruction at exit, when the rest of the core may already be gone.
+DebuggerController::ControllerMap& DebuggerController::GetControllerMap()
+{
+	static ControllerMap* controllers = new ControllerMap();
+	return *controllers;
+}
+
+
+std::shared_mutex& DebuggerController::GetControllerMapMutex()
+{
+	static std::shared_mutex* mutex = new std::shared_mutex();
+	return *mutex;
+}
+
+
+DbgRef<DebuggerController> DebuggerController::GetController(BinaryViewRef data)
+{
+	if (!data)
+		return nullptr;
+
+	FileMetadataRef file = data->GetFile();
+	if (auto controller = GetController(file))
+		return controller;
+
+	std::unique_lock<std::shared_mutex> lock(GetControllerMapMutex());
+	// Another thread may have created the controller between the two locks
+	auto& slot = GetControllerMap()[file->GetObject()];
+	if (!slot)
+		slot = new DebuggerController(data);
+	return slot;
+}
+
+
+void DebuggerController::DeleteController(BinaryViewRef data)
+{
+	if (!data)
+		return;
+
+	DbgRef<DebuggerController> controller;
+	{
+		std::unique_lock<std::shared_mutex> lock(GetControllerMapMutex());
+		auto& controllers = GetControllerMap();
+		auto iter = controllers.find(data->GetFile()->GetObject());
+		if ((iter == controllers.end()) || (iter->second->GetData() != data))
+			return;
+		// Keep the last reference until the lock is released, so the destructor never runs while it is held
+		controller = iter->second;
+		controllers.erase(iter);
+	}
+}
+
+
+bool DebuggerController::ControllerExists(BinaryViewRef data)
+{
+	if (!data)
+		return false;
+
+	std::shared_lock<std::shared_mutex> lock(GetControllerMapMutex());
+	auto& controllers = GetControllerMap();
+	auto iter = controllers.find(data->GetFile()->GetObject());
+	return (iter != controllers.end()) && (iter->second->GetData() == data);
+}
+
+
+DbgRef<DebuggerController> DebuggerController::GetController(FileMetadataRef file)
+{
+	if (!file)
+		return nullptr;
+
+	// You cannot create a controller from a file -- you must use a binary view for it
+	std::shared_lock<std::shared_mutex> lock(GetControllerMapMutex());
+	auto& controllers = GetControllerMap();
+	auto iter = controllers.find(file->GetObject());
+	if (iter == controllers.end())
+		return nullptr;
+	return iter->second;
+}
+
+
+bool DebuggerController::ControllerExists(FileMetadataRef file)
+{
+	if (!file)
+		return false;
+
+	std::shared_lock<std::shared_mutex> lock(GetControllerMapMutex());
+	auto& controllers = GetControllerMap();
+	return controllers.find(file->GetObject()) != controllers.end();
+}
+
+
+void DebuggerController::DeleteController(FileMetadataRef file)
+{
+	if (!file)
+		return;
+
+	DbgRef<DebuggerController> controller;
+	{
+		std::unique_lock<std::shared_mutex> lock(GetControllerMapMutex());
+		auto& controllers = GetControllerMap();
+		auto iter = controllers.find(file->GetObject());
+		if (iter == controllers.end())
+			return;
+		controller = iter->second;
+		controllers.erase(iter);
+	}
 }
 
 
 void DebuggerController::Destroy()
 {
 	// Contrary to the name, DebuggerController::Destroy() actually only removes the object from the global debugger
-	// controller array (g_debuggerControllers). This enabling its ref count to go down to zero and eventually get freed.
+	// controller registry (GetControllerMap()). This enabling its ref count to go down to zero and eventually get freed.
 	// The actual cleanup happens in DebuggerController::~DebuggerController().
 	// TODO: I should change the function name later
 	DebuggerController::DeleteController(m_file);
@@ -1553,13 +2271,19 @@ void DebuggerController::EventHandler(const DebuggerEvent& event)
 		break;
 	}
 	case TargetExitedEventType:
-		m_exitCode = event.data.exitData.exitCode;
+		m_exitCode = event.data.ExitData().exitCode;
 		m_state->MarkDirty();
 	case QuitDebuggingEventType:
 	case DetachedEventType:
 	case LaunchFailureEventType:
 	{
 		m_inputFileLoaded = false;
+		m_state->GetJournal()->Clear();
+		m_state->GetRegisters()->ResetRegisterMap();
+		m_imageTranslated = false;
+		m_expressions->Clear();
+		m_functionReturns.clear();
+		m_state->GetWatchpoints()->Clear();
 		m_initialBreakpointSeen = false;
 		RemoveDebuggerMemoryRegion();
 		if (m_oldAnalysisState != HoldState)
@@ -1588,6 +2312,7 @@ void DebuggerController::EventHandler(const DebuggerEvent& event)
 		m_currentIP = m_state->IP();
 
 		DetectLoadedModule();
+		AnalyzeLoadedModules();
 		UpdateStackVariables();
 		AddRegisterValuesToExpressionParser();
 		break;
@@ -1609,7 +2334,24 @@ void DebuggerController::EventHandler(const DebuggerEvent& event)
 	}
 	case ErrorEventType:
 	{
-		LogError("%s", event.data.errorData.error.c_str());
+		LogError("%s", event.data.ErrorData().error.c_str());
+		break;
+	}
+	case WatchpointAddedEvent:
+	{
+		// The watchpoint may have been added from the backend console. One added by AddWatchpoint() is already known.
+		uint64_t address = event.data.AbsoluteAddress();
+		size_t size = 0;
+		DebugWatchpointType type = WriteWatchpoint;
+		if (!m_state->GetWatchpoints()->Contains(address) && m_adapter
+			&& m_adapter->GetWatchpointInfo(address, size, type))
+			m_state->GetWatchpoints()->Track(address, size, type);
+		break;
+	}
+	case WatchpointRemovedEvent:
+	{
+		// The watchpoint may have been deleted from the backend console
+		m_state->GetWatchpoints()->Forget(event.data.AbsoluteAddress());
 		break;
 	}
 	default:
@@ -1667,7 +2409,7 @@ void DebuggerController::PostDebuggerEvent(const DebuggerEvent& event)
 		if ((eventToSend.type == TargetStoppedEventType) && !m_initialBreakpointSeen)
 		{
 			m_initialBreakpointSeen = true;
-			eventToSend.data.targetStoppedData.reason = InitialBreakpoint;
+			eventToSend.data.TargetStoppedData().reason = InitialBreakpoint;
 		}
 
 		for (const DebuggerEventCallback& cb : eventCallbacks)
@@ -1687,7 +2429,7 @@ void DebuggerController::PostDebuggerEvent(const DebuggerEvent& event)
 			if (!m_initialBreakpointSeen)
 			{
 				m_initialBreakpointSeen = true;
-				stopEvent.data.targetStoppedData.reason = InitialBreakpoint;
+				stopEvent.data.TargetStoppedData().reason = InitialBreakpoint;
 			}
 			for (const DebuggerEventCallback& cb : eventCallbacks)
 			{
@@ -1716,10 +2458,14 @@ void DebuggerController::CleanUpDisabledEvent()
 
 void DebuggerController::NotifyStopped(DebugStopReason reason, void* data)
 {
+	// E.g., a step that ends at the breakpoint of a covered block
+	if (reason == Breakpoint)
+		HandleCoverageHit();
+
 	DebuggerEvent event;
 	event.type = TargetStoppedEventType;
-	event.data.targetStoppedData.reason = reason;
-	event.data.targetStoppedData.data = data;
+	event.data.TargetStoppedData().reason = reason;
+	event.data.TargetStoppedData().data = data;
 	PostDebuggerEvent(event);
 }
 
@@ -1728,9 +2474,9 @@ void DebuggerController::NotifyError(const std::string& error, const std::string
 {
 	DebuggerEvent event;
 	event.type = ErrorEventType;
-	event.data.errorData.error = error;
-	event.data.errorData.shortError = shortError;
-	event.data.errorData.data = data;
+	event.data.ErrorData().error = error;
+	event.data.ErrorData().shortError = shortError;
+	event.data.ErrorData().data = data;
 	PostDebuggerEvent(event);
 }
 
@@ -1760,6 +2506,39 @@ DataBuffer DebuggerController::ReadMemory(std::uintptr_t address, std::size_t si
 }
 
 
+size_t DebuggerController::ReadMemory(std::uintptr_t address, void* dest, std::size_t size)
+{
+	if (!GetData())
+		return 0;
+
+	if (!m_state->IsConnected())
+		return 0;
+
+	DebuggerMemory* memory = m_state->GetMemory();
+	if (!memory)
+		return 0;
+
+	return memory->ReadMemory(address, dest, size);
+}
+
+
+size_t DebuggerController::ReadMemoryRanges(
+	const std::vector<std::pair<uint64_t, size_t>>& ranges, void* dest, std::vector<size_t>& bytesRead)
+{
+	bytesRead.assign(ranges.size(), 0);
+	size_t total = 0;
+	size_t offset = 0;
+	for (size_t i = 0; i < ranges.size(); i++)
+	{
+		const auto& [address, size] = ranges[i];
+		bytesRead[i] = ReadMemory(address, (uint8_t*)dest + offset, size);
+		total += bytesRead[i];
+		offset += size;
+	}
+	return total;
+}
+
+
 bool DebuggerController::WriteMemory(std::uintptr_t address, const DataBuffer& buffer)
 {
 	if (!GetData())
@@ -1792,7 +2571,18 @@ std::vector<DebugProcess> DebuggerController::GetProcessList()
 			return {};
 	}
 
-	return m_adapter->GetProcessList();
+	return GetAdapterProcessList();
+}
+
+
+std::vector<DebugProcess> DebuggerController::GetAdapterProcessList()
+{
+	std::unique_lock<std::mutex> lock(m_processListMutex);
+	DebugAdapter* adapter = m_adapter;
+	if (!adapter)
+		return {};
+
+	return adapter->GetProcessList();
 }
 
 
@@ -1802,9 +2592,9 @@ std::vector<DebugThread> DebuggerController::GetAllThreads()
 }
 
 
-std::vector<DebugRegister> DebuggerController::GetAllRegisters()
+std::vector<DebugRegister> DebuggerController::GetAllRegisters(bool computeHints)
 {
-	return m_state->GetRegisters()->GetAllRegisters();
+	return m_state->GetRegisters()->GetAllRegisters(computeHints);
 }
 
 
@@ -1814,6 +2604,12 @@ uint64_t DebuggerController::GetRegisterValue(const std::string& name)
 }
 
 
+bool DebuggerController::GetRegisterValue(uint32_t archRegister, uint64_t& value)
+{
+	return m_state->GetRegisters()->GetRegisterValue(archRegister, value);
+}
+
+
 bool DebuggerController::SetRegisterValue(const std::string& name, uint64_t value)
 {
 	return m_state->GetRegisters()->SetRegisterValue(name, value);
@@ -1931,6 +2727,8 @@ void DebuggerController::DefineVariablesRecursive(uint64_t address, Confidence<R
 		}
 		if (readOk)
 		{
+			// The pointer holds an address of the target, and the child is defined in the view
+			targetAddress = LiveToViewAddress(targetAddress);
 			// Define a data variable for the child
 			ProcessOneVariable(targetAddress, type->GetChildType(), "");
 			// Recurse into the child
@@ -1992,7 +2790,7 @@ void DebuggerController::UpdateStackVariables()
 			const DebugFrame& frame = frames[i];
 			const DebugFrame& prevFrame = frames[i + 1];
 			// If there is no function at a stacktrace function start, add one
-			auto functions = GetData()->GetAnalysisFunctionsForAddress(frame.m_functionStart);
+			auto functions = GetData()->GetAnalysisFunctionsForAddress(LiveToViewAddress(frame.m_functionStart));
 			if (functions.empty())
 				continue;
 
@@ -2054,7 +2852,8 @@ void DebuggerController::UpdateStackVariables()
 
 void DebuggerController::AddRegisterValuesToExpressionParser()
 {
-	auto regs = GetAllRegisters();
+	// Only the values are needed here, and this runs on every stop, so do not pay for the hints
+	auto regs = GetAllRegisters(false);
 	std::vector<std::string> names;
 	names.reserve(regs.size());
 	std::vector<uint64_t> values;
@@ -2176,6 +2975,8 @@ std::string DebuggerController::GetStopReasonString(DebugStopReason reason)
 		return "UserRequestedBreak";
 	case OperationNotSupported:
 		return "OperationNotSupported";
+	case Watchpoint:
+		return "Watchpoint";
 	default:
 		return "";
 	}
@@ -2199,6 +3000,15 @@ DebugStopReason DebuggerController::ExecuteAdapterAndWait(const DebugAdapterOper
 		&& !m_adapterMutex.try_lock())
 		throw std::runtime_error("Cannot obtain mutex for debug adapter");
 
+	// Pausing, quitting and detaching happen while another operation waits, whose stops are filtered or not
+	bool ownsAdapter = (operation != DebugAdapterPause) && (operation != DebugAdapterQuit)
+		&& (operation != DebugAdapterDetach);
+	if (ownsAdapter)
+	{
+		m_filterAdapterStops = (operation == DebugAdapterGo)
+			|| ((operation == DebugAdapterLaunch) && !Settings::Instance()->Get<bool>("debugger.stopAtEntryPoint"));
+	}
+
 	Semaphore sem;
 	DebugStopReason reason = UnknownReason;
 	size_t callback = RegisterEventCallback(
@@ -2206,7 +3016,7 @@ DebugStopReason DebuggerController::ExecuteAdapterAndWait(const DebugAdapterOper
 			switch (event.type)
 			{
 			case AdapterStoppedEventType:
-				reason = event.data.targetStoppedData.reason;
+				reason = event.data.TargetStoppedData().reason;
 				sem.Release();
 				break;
 			// It is a little awkward to add two cases for these events, but we must take them into account,
@@ -2296,8 +3106,11 @@ DebugStopReason DebuggerController::ExecuteAdapterAndWait(const DebugAdapterOper
 		reason = InternalError;
 
 	RemoveEventCallback(callback);
-	if ((operation != DebugAdapterPause) && (operation != DebugAdapterQuit) && (operation != DebugAdapterDetach))
+	if (ownsAdapter)
+	{
+		m_filterAdapterStops = false;
 		m_adapterMutex.unlock();
+	}
 	return reason;
 }
 
@@ -2484,6 +3297,10 @@ std::string DebuggerController::GetAddressInformation(uint64_t address)
 	if (!result.empty())
 		return result;
 
+	// The address is one of the target, and the analysis below is looked up at its address in the view
+	uint64_t liveAddress = address;
+	address = LiveToViewAddress(address);
+
 	// Check pointer to strings
 	auto buffer = GetData()->ReadBuffer(address, GetData()->GetAddressSize());
 	if (buffer.GetLength() == GetData()->GetAddressSize())
@@ -2525,6 +3342,16 @@ std::string DebuggerController::GetAddressInformation(uint64_t address)
 		return sym->GetShortName();
 	}
 
+	// Look for functions in the other modules
+	uint64_t functionStart;
+	std::string functionName;
+	if (GetModuleFunction(liveAddress, functionStart, functionName))
+	{
+		if (liveAddress == functionStart)
+			return functionName;
+		return fmt::format("{} + 0x{:x}", functionName, liveAddress - functionStart);
+	}
+
 	//	Look for data variables
 	DataVariable var;
 	if (GetData()->GetDataVariableAtAddress(address, var))
@@ -2544,7 +3371,7 @@ std::string DebuggerController::GetAddressInformation(uint64_t address)
 	}
 
 	// Check if the address itself is a printable string, e.g., 0x61626364 ==> "abcd"
-	result = CheckForLiteralString(address);
+	result = CheckForLiteralString(liveAddress);
 	if (!result.empty())
 		return result;
 
@@ -2552,6 +3379,40 @@ std::string DebuggerController::GetAddressInformation(uint64_t address)
 }
 
 
+void DebuggerController::AnalyzeLoadedModules()
+{
+	if (!m_moduleAnalysis)
+		return;
+
+	// The list is refreshed on every stop anyway, and only looked at again once it changed, e.g., a library was loaded
+	uint64_t version = m_state->GetModules()->GetVersion();
+	if (version == m_analyzedModulesVersion)
+		return;
+	m_analyzedModulesVersion = version;
+
+	std::vector<DebugModule> modules;
+	for (const DebugModule& module : m_state->GetModules()->GetAllModules())
+	{
+		if (!module.IsSameBaseModule(m_state->GetInputFile()))
+			modules.push_back(module);
+	}
+	m_moduleAnalysis->Queue(modules);
+}
+
+
+bool DebuggerController::GetModuleFunction(uint64_t address, uint64_t& functionStart, std::string& name)
+{
+	if (!m_moduleAnalysis || !m_state->IsConnected())
+		return false;
+
+	DebugModule module = m_state->GetModules()->GetModuleForAddress(address);
+	if (module.m_name.empty() || module.IsSameBaseModule(m_state->GetInputFile()))
+		return false;
+
+	return m_moduleAnalysis->Lookup(module, address, functionStart, name);
+}
+
+
 bool DebuggerController::IsFirstLaunch()
 {
 	return m_firstLaunch;
@@ -2566,6 +3427,13 @@ bool DebuggerController::IsTTD()
 }
 
 
+bool DebuggerController::IsReverseExecutionSupported()
+{
+	// Without native support, the target goes backwards by replaying the execution journal
+	return IsTTD() || IsRecordingExecution();
+}
+
+
 bool DebuggerController::RemoveDebuggerMemoryRegion()
 {
 	GetData()->SetFunctionAnalysisUpdateDisabled(true);
@@ -2584,873 +3452,99 @@ bool DebuggerController::ReAddDebuggerMemoryRegion()
 }
 
 
-
-// TODO: these 3 functions should be moved to the BinaryNinjaAPI namespace for wider audiences
-static int64_t MaskToSize(int64_t value, size_t size)
+bool DebuggerController::ComputeExprValueAPI(const BinaryNinja::LowLevelILInstruction &instr, uint64_t& value)
 {
-	if (size >= 8)
-		return value;
-	if (size == 0)
-		return value & 1;
-	return value & ((1LL << (size * 8)) - 1);
+	// We only want to do this check once before the evaluation
+	if (!m_state->IsConnected() || m_state->IsRunning())
+		return false;
+
+	return ComputeExprValue(instr, value);
 }
 
 
-static int64_t ZeroExtend(int64_t value, size_t sourceSize, size_t destSize)
+bool DebuggerController::ComputeExprValue(const LowLevelILInstruction &instr, uint64_t& value)
 {
-	if (destSize <= sourceSize)
-		return MaskToSize(value, destSize);
-	return MaskToSize(value & ((1LL << (sourceSize * 8)) - 1), destSize);
+	return m_expressions->Evaluate(instr, value);
 }
 
 
-static int64_t SignExtend(int64_t value, size_t sourceSize, size_t destSize)
+bool DebuggerController::ComputeExprValueAPI(const BinaryNinja::MediumLevelILInstruction &instr, uint64_t& value)
 {
-	if (destSize <= sourceSize)
-		return MaskToSize(value, destSize);
-	if (value & (1LL << ((sourceSize * 8) - 1)))
-		return MaskToSize(value | (~((1LL << (sourceSize * 8)) - 1)), destSize);
-	else
-		return MaskToSize(value & ((1LL << (sourceSize * 8)) - 1), destSize);
+	// We only want to do this check once before the evaluation
+	if (!m_state->IsConnected() || m_state->IsRunning())
+		return false;
+
+	return ComputeExprValue(instr, value);
 }
 
 
-static inline uint64_t GetActualShift(uint64_t value, size_t instrSize)
+bool DebuggerController::ComputeExprValue(const MediumLevelILInstruction &instr, uint64_t& value)
 {
-	if (instrSize <= 4)
-		return value & 0b11111;
-	else
-		return value & 0b111111;
+	return m_expressions->Evaluate(instr, value);
 }
 
 
-bool DebuggerController::ComputeExprValueAPI(const BinaryNinja::LowLevelILInstruction &instr, uint64_t& value)
+bool DebuggerController::GetVariableValueAPI(const Variable& var, uint64_t address, size_t size, uint64_t& value)
 {
 	// We only want to do this check once before the recursion
 	if (!m_state->IsConnected() || m_state->IsRunning())
 		return false;
 
-	return ComputeExprValue(instr, value);
+	return GetVariableValue(var, address, size, value);
 }
 
 
-bool DebuggerController::ComputeExprValue(const LowLevelILInstruction &instr, uint64_t& value)
+bool DebuggerController::GetVariableValue(const Variable& var, uint64_t address, size_t size, uint64_t &value)
 {
-	if (instr.size > 8)
-		return false;
-
-	uint64_t left, right;
-
 	int64_t sizeMask = -1;
-	if (instr.size > 0 && instr.size < 8)
-		sizeMask = (1LL << (instr.size * 8)) - 1;
+	if (size > 0 && size < 8)
+		sizeMask = (1LL << (size * 8)) - 1;
 
-	switch (instr.operation)
-	{
-	case LLIL_CONST:
-		value = instr.GetConstant<LLIL_CONST>() & sizeMask;
-		return true;
-	case LLIL_CONST_PTR:
-		value = instr.GetConstant<LLIL_CONST_PTR>() & sizeMask;
-		return true;
-	case LLIL_FLOAT_CONST:
-		value = instr.GetConstant<LLIL_FLOAT_CONST>() & sizeMask;
-		return true;
-	case LLIL_REG:
+	if (var.type == RegisterVariableSourceType)
 	{
-		auto reg = instr.GetSourceRegister<LLIL_REG>();
+		auto reg = var.storage;
 		if (LLIL_REG_IS_TEMP(reg))
 			return false;
 
-		auto name = GetData()->GetDefaultArchitecture()->GetRegisterName(reg);
-		// TODO: what if the name reported by the adapter is different from that in the architecture?
-		// GetRegisterValue should return if the value can be retrieved
-
-		// Cheat for arm64
-		if (name == "x29") name = "fp";
+		if (!GetRegisterValue((uint32_t)reg, value))
+			return false;
 
-		value = GetRegisterValue(name) & sizeMask;
+		value &= sizeMask;
 		return true;
 	}
-	case LLIL_ADD:
-		if (!ComputeExprValue(instr.GetLeftExpr<LLIL_ADD>(), left))
+	else if (var.type == StackVariableSourceType)
+	{
+		auto stack = m_state->StackPointer();
+		auto ip = LiveToViewAddress(m_state->IP());
+		auto funcs = GetData()->GetAnalysisFunctionsContainingAddress(address);
+		if (funcs.empty())
 			return false;
-		if (!ComputeExprValue(instr.GetRightExpr<LLIL_ADD>(), right))
+		auto func = funcs[0];
+		if (!func)
 			return false;
-		value = left + right;
-		value &= sizeMask;
-		return true;
-	case LLIL_SUB:
-		if (!ComputeExprValue(instr.GetLeftExpr<LLIL_SUB>(), left))
+		auto arch = GetData()->GetDefaultArchitecture();
+		if (!arch)
 			return false;
-		if (!ComputeExprValue(instr.GetRightExpr<LLIL_SUB>(), right))
+		auto stackReg = arch->GetStackPointerRegister();
+		auto stackValue = func->GetRegisterValueAtInstruction(arch, ip, stackReg);
+		if (stackValue.state != StackFrameOffset)
 			return false;
-		value = left - right;
-		value &= sizeMask;
-		return true;
-	case LLIL_LOAD:
-	{
-		if (!ComputeExprValue(instr.GetSourceExpr<LLIL_LOAD>(), left))
+		auto stackAtFuncEntry = stack - stackValue.value;
+		auto addrOfVar = stackAtFuncEntry + var.storage;
+
+		auto type = func->GetVariableType(var);
+		if (!type)
+			return false;
+
+		auto width = type->GetWidth();
+		if (width > 8)
 			return false;
-		auto buffer = ReadMemory(left, instr.size);
-		if (buffer.GetLength() != instr.size)
+
+		auto buffer = ReadMemory(addrOfVar, width);
+		if (buffer.GetLength() != width)
 			return false;
 
-		switch (instr.size)
-		{
-		case 1:
-			value = *reinterpret_cast<uint8_t*>(buffer.GetData());
-			value &= sizeMask;
-			return true;
-		case 2:
-			value = *reinterpret_cast<uint16_t*>(buffer.GetData());
-			value &= sizeMask;
-			return true;
-		case 4:
-			value = *reinterpret_cast<uint32_t*>(buffer.GetData());
-			value &= sizeMask;
-			return true;
-		case 8:
-			value = *reinterpret_cast<uint64_t*>(buffer.GetData());
-			value &= sizeMask;
-			return true;
-		default:
-			return false;
-		}
-	}
-	case LLIL_STORE:
-	{
-		if (!ComputeExprValue(instr.GetDestExpr<LLIL_STORE>(), left))
-			return false;
-		auto buffer = ReadMemory(left, instr.size);
-		if (buffer.GetLength() != instr.size)
-			return false;
-
-		switch (instr.size)
-		{
-		case 1:
-			value = *reinterpret_cast<uint8_t*>(buffer.GetData());
-			value &= sizeMask;
-			return true;
-		case 2:
-			value = *reinterpret_cast<uint16_t*>(buffer.GetData());
-			value &= sizeMask;
-			return true;
-		case 4:
-			value = *reinterpret_cast<uint32_t*>(buffer.GetData());
-			value &= sizeMask;
-			return true;
-		case 8:
-			value = *reinterpret_cast<uint64_t*>(buffer.GetData());
-			value &= sizeMask;
-			return true;
-		default:
-			return false;
-		}
-	}
-	case LLIL_LSL:
-	{
-		if (!ComputeExprValue(instr.GetLeftExpr<LLIL_LSL>(), left))
-			return false;
-		if (!ComputeExprValue(instr.GetRightExpr<LLIL_LSL>(), right))
-			return false;
-		value = left << GetActualShift(right, instr.size);
-		value &= sizeMask;
-		return true;
-	}
-	case LLIL_LSR:
-	{
-		if (!ComputeExprValue(instr.GetLeftExpr<LLIL_LSR>(), left))
-			return false;
-		if (!ComputeExprValue(instr.GetRightExpr<LLIL_LSR>(), right))
-			return false;
-		value = left >> GetActualShift(right, instr.size);
-		value &= sizeMask;
-		return true;
-	}
-	case LLIL_ASR:
-	{
-		if (!ComputeExprValue(instr.GetLeftExpr<LLIL_ASR>(), left))
-			return false;
-		if (!ComputeExprValue(instr.GetRightExpr<LLIL_ASR>(), right))
-			return false;
-		if (left & (1LL << ((instr.size * 8) - 1)))
-			left |= ~sizeMask;
-		else
-			left &= sizeMask;
-		value = ((int64_t)left) >> GetActualShift(right, instr.size);
-		value &= sizeMask;
-		return true;
-	}
-	case LLIL_XOR:
-	{
-		if (!ComputeExprValue(instr.GetLeftExpr<LLIL_XOR>(), left))
-			return false;
-		if (!ComputeExprValue(instr.GetRightExpr<LLIL_XOR>(), right))
-			return false;
-		value = left ^ right;
-		value &= sizeMask;
-		return true;
-	}
-	case LLIL_AND:
-	{
-		if (!ComputeExprValue(instr.GetLeftExpr<LLIL_AND>(), left))
-			return false;
-		if (!ComputeExprValue(instr.GetRightExpr<LLIL_AND>(), right))
-			return false;
-		value = left & right;
-		value &= sizeMask;
-		return true;
-	}
-	case LLIL_OR:
-	{
-		if (!ComputeExprValue(instr.GetLeftExpr<LLIL_OR>(), left))
-			return false;
-		if (!ComputeExprValue(instr.GetRightExpr<LLIL_OR>(), right))
-			return false;
-		value = left | right;
-		value &= sizeMask;
-		return true;
-	}
-	case LLIL_NEG:
-	{
-		if (!ComputeExprValue(instr.GetSourceExpr<LLIL_NEG>(), left))
-			return false;
-		value = -left;
-		value &= sizeMask;
-		return true;
-	}
-	case LLIL_NOT:
-	{
-		if (!ComputeExprValue(instr.GetSourceExpr<LLIL_NOT>(), left))
-			return false;
-		value = ~left;
-		value &= sizeMask;
-		return true;
-	}
-	case LLIL_SX:
-	{
-		if (!ComputeExprValue(instr.GetSourceExpr<LLIL_SX>(), left))
-			return false;
-		value = SignExtend(left, instr.GetSourceExpr<LLIL_SX>().size, instr.size);
-		return true;
-	}
-	case LLIL_ZX:
-	{
-		if (!ComputeExprValue(instr.GetSourceExpr<LLIL_ZX>(), left))
-			return false;
-		value = ZeroExtend(left, instr.GetSourceExpr<LLIL_ZX>().size, instr.size);
-		return true;
-	}
-	case LLIL_PUSH:
-	{
-		if (!ComputeExprValue(instr.GetSourceExpr<LLIL_PUSH>(), left))
-			return false;
-		value &= sizeMask;
-		return true;
-	}
-	case LLIL_POP:
-	case LLIL_RET:
-	{
-		auto stackPointer = GetState()->StackPointer();
-		auto buffer = ReadMemory(stackPointer, instr.size);
-		if (buffer.GetLength() != instr.size)
-			return false;
-
-		switch (instr.size)
-		{
-		case 1:
-			value = *reinterpret_cast<uint8_t*>(buffer.GetData());
-			value &= sizeMask;
-			return true;
-		case 2:
-			value = *reinterpret_cast<uint16_t*>(buffer.GetData());
-			value &= sizeMask;
-			return true;
-		case 4:
-			value = *reinterpret_cast<uint32_t*>(buffer.GetData());
-			value &= sizeMask;
-			return true;
-		case 8:
-			value = *reinterpret_cast<uint64_t*>(buffer.GetData());
-			value &= sizeMask;
-			return true;
-		default:
-			return false;
-		}
-	}
-	case LLIL_CMP_E:
-		if (!ComputeExprValue(instr.GetLeftExpr<LLIL_CMP_E>(), left))
-			return false;
-		if (!ComputeExprValue(instr.GetRightExpr<LLIL_CMP_E>(), right))
-			return false;
-		value = GetValueFromComparison(instr.operation, left, right, instr.size);
-		return true;
-
-	case LLIL_CMP_NE:
-		if (!ComputeExprValue(instr.GetLeftExpr<LLIL_CMP_NE>(), left))
-			return false;
-		if (!ComputeExprValue(instr.GetRightExpr<LLIL_CMP_NE>(), right))
-			return false;
-		value = GetValueFromComparison(instr.operation, left, right, instr.size);
-		return true;
-
-	case LLIL_CMP_SLT:
-		if (!ComputeExprValue(instr.GetLeftExpr<LLIL_CMP_SLT>(), left))
-			return false;
-		if (!ComputeExprValue(instr.GetRightExpr<LLIL_CMP_SLT>(), right))
-			return false;
-		value = GetValueFromComparison(instr.operation, left, right, instr.size);
-		return true;
-
-	case LLIL_CMP_ULT:
-		if (!ComputeExprValue(instr.GetLeftExpr<LLIL_CMP_ULT>(), left))
-			return false;
-		if (!ComputeExprValue(instr.GetRightExpr<LLIL_CMP_ULT>(), right))
-			return false;
-		value = GetValueFromComparison(instr.operation, left, right, instr.size);
-		return true;
-
-	case LLIL_CMP_SLE:
-		if (!ComputeExprValue(instr.GetLeftExpr<LLIL_CMP_SLE>(), left))
-			return false;
-		if (!ComputeExprValue(instr.GetRightExpr<LLIL_CMP_SLE>(), right))
-			return false;
-		value = GetValueFromComparison(instr.operation, left, right, instr.size);
-		return true;
-
-	case LLIL_CMP_ULE:
-		if (!ComputeExprValue(instr.GetLeftExpr<LLIL_CMP_ULE>(), left))
-			return false;
-		if (!ComputeExprValue(instr.GetRightExpr<LLIL_CMP_ULE>(), right))
-			return false;
-		value = GetValueFromComparison(instr.operation, left, right, instr.size);
-		return true;
-
-	case LLIL_CMP_SGE:
-		if (!ComputeExprValue(instr.GetLeftExpr<LLIL_CMP_SGE>(), left))
-			return false;
-		if (!ComputeExprValue(instr.GetRightExpr<LLIL_CMP_SGE>(), right))
-			return false;
-		value = GetValueFromComparison(instr.operation, left, right, instr.size);
-		return true;
-
-	case LLIL_CMP_UGE:
-		if (!ComputeExprValue(instr.GetLeftExpr<LLIL_CMP_UGE>(), left))
-			return false;
-		if (!ComputeExprValue(instr.GetRightExpr<LLIL_CMP_UGE>(), right))
-			return false;
-		value = GetValueFromComparison(instr.operation, left, right, instr.size);
-		return true;
-
-	case LLIL_CMP_SGT:
-		if (!ComputeExprValue(instr.GetLeftExpr<LLIL_CMP_SGT>(), left))
-			return false;
-		if (!ComputeExprValue(instr.GetRightExpr<LLIL_CMP_SGT>(), right))
-			return false;
-		value = GetValueFromComparison(instr.operation, left, right, instr.size);
-		return true;
-
-	case LLIL_CMP_UGT:
-		if (!ComputeExprValue(instr.GetLeftExpr<LLIL_CMP_UGT>(), left))
-			return false;
-		if (!ComputeExprValue(instr.GetRightExpr<LLIL_CMP_UGT>(), right))
-			return false;
-		value = GetValueFromComparison(instr.operation, left, right, instr.size);
-		return true;
-
-	default:
-		break;
-	}
-	return false;
-}
-
-
-uint64_t DebuggerController::GetValueFromComparison(const BNLowLevelILOperation op, uint64_t left, uint64_t right,
-	size_t size)
-{
-	switch (op)
-	{
-		case LLIL_CMP_E:
-			return left == right;
-			break;
-		case LLIL_CMP_NE:
-			return left != right;
-			break;
-		case LLIL_CMP_SLT:
-			return SignExtend(left, size, 8) < SignExtend(right, size, 8);
-			break;
-		case LLIL_CMP_ULT:
-			return (uint64_t)(left) < (uint64_t)(right);
-			break;
-		case LLIL_CMP_SLE:
-			return SignExtend(left, size, 8) <= SignExtend(right, size, 8);
-			break;
-		case LLIL_CMP_ULE:
-			return (uint64_t)(left) <= (uint64_t)(right);
-			break;
-		case LLIL_CMP_SGE:
-			return SignExtend(left, size, 8) >= SignExtend(right, size, 8);
-			break;
-		case LLIL_CMP_UGE:
-			return (uint64_t)(left) >= (uint64_t)(right);
-			break;
-		case LLIL_CMP_SGT:
-			return SignExtend(left, size, 8) > SignExtend(right, size, 8);
-			break;
-		case LLIL_CMP_UGT:
-			return (uint64_t)(left) > (uint64_t)(right);
-			break;
-		default:
-			break;
-	}
-	return -1;
-}
-
-
-uint64_t DebuggerController::GetValueFromComparison(const BNMediumLevelILOperation op, uint64_t left, uint64_t right,
-	size_t size)
-{
-	switch (op)
-	{
-		case MLIL_CMP_E:
-			return left == right;
-			break;
-		case MLIL_CMP_NE:
-			return left != right;
-			break;
-		case MLIL_CMP_SLT:
-			return SignExtend(left, size, 8) < SignExtend(right, size, 8);
-			break;
-		case MLIL_CMP_ULT:
-			return (uint64_t)(left) < (uint64_t)(right);
-			break;
-		case MLIL_CMP_SLE:
-			return SignExtend(left, size, 8) <= SignExtend(right, size, 8);
-			break;
-		case MLIL_CMP_ULE:
-			return (uint64_t)(left) <= (uint64_t)(right);
-			break;
-		case MLIL_CMP_SGE:
-			return SignExtend(left, size, 8) >= SignExtend(right, size, 8);
-			break;
-		case MLIL_CMP_UGE:
-			return (uint64_t)(left) >= (uint64_t)(right);
-			break;
-		case MLIL_CMP_SGT:
-			return SignExtend(left, size, 8) > SignExtend(right, size, 8);
-			break;
-		case MLIL_CMP_UGT:
-			return (uint64_t)(left) > (uint64_t)(right);
-			break;
-		default:
-			break;
-	}
-	return -1;
-}
-
-
-uint64_t DebuggerController::GetValueFromComparison(const BNHighLevelILOperation op, uint64_t left, uint64_t right,
-	size_t size)
-{
-	switch (op)
-	{
-		case HLIL_CMP_E:
-			return left == right;
-			break;
-		case HLIL_CMP_NE:
-			return left != right;
-			break;
-		case HLIL_CMP_SLT:
-			return SignExtend(left, size, 8) < SignExtend(right, size, 8);
-			break;
-		case HLIL_CMP_ULT:
-			return (uint64_t)(left) < (uint64_t)(right);
-			break;
-		case HLIL_CMP_SLE:
-			return SignExtend(left, size, 8) <= SignExtend(right, size, 8);
-			break;
-		case HLIL_CMP_ULE:
-			return (uint64_t)(left) <= (uint64_t)(right);
-			break;
-		case HLIL_CMP_SGE:
-			return SignExtend(left, size, 8) >= SignExtend(right, size, 8);
-			break;
-		case HLIL_CMP_UGE:
-			return (uint64_t)(left) >= (uint64_t)(right);
-			break;
-		case HLIL_CMP_SGT:
-			return SignExtend(left, size, 8) > SignExtend(right, size, 8);
-			break;
-		case HLIL_CMP_UGT:
-			return (uint64_t)(left) > (uint64_t)(right);
-			break;
-		default:
-			break;
-	}
-	return -1;
-}
-
-
-bool DebuggerController::ComputeExprValueAPI(const BinaryNinja::MediumLevelILInstruction &instr, uint64_t& value)
-{
-	// We only want to do this check once before the recursion
-	if (!m_state->IsConnected() || m_state->IsRunning())
-		return false;
-
-	return ComputeExprValue(instr, value);
-}
-
-
-bool DebuggerController::ComputeExprValue(const MediumLevelILInstruction &instr, uint64_t& value)
-{
-	if (instr.size > 8)
-		return false;
-
-	uint64_t left, right;
-
-	int64_t sizeMask = -1;
-	if (instr.size > 0 && instr.size < 8)
-		sizeMask = (1LL << (instr.size * 8)) - 1;
-
-	switch (instr.operation)
-	{
-	case MLIL_CONST:
-		value = instr.GetConstant<MLIL_CONST>() & sizeMask;
-		return true;
-	case MLIL_CONST_PTR:
-		value = instr.GetConstant<MLIL_CONST_PTR>() & sizeMask;
-		return true;
-	case MLIL_FLOAT_CONST:
-		value = instr.GetConstant<MLIL_CONST_PTR>() & sizeMask;
-		return true;
-	case MLIL_VAR:
-	{
-		const auto var = instr.GetSourceVariable<MLIL_VAR>();
-		return GetVariableValue(var, instr.address, instr.size, value);
-		break;
-	}
-	case MLIL_ADD:
-		if (!ComputeExprValue(instr.GetLeftExpr<MLIL_ADD>(), left))
-			return false;
-		if (!ComputeExprValue(instr.GetRightExpr<MLIL_ADD>(), right))
-			return false;
-		value = left + right;
-		value &= sizeMask;
-		return true;
-	case MLIL_SUB:
-		if (!ComputeExprValue(instr.GetLeftExpr<MLIL_SUB>(), left))
-			return false;
-		if (!ComputeExprValue(instr.GetRightExpr<MLIL_SUB>(), right))
-			return false;
-		value = left - right;
-		value &= sizeMask;
-		return true;
-	case MLIL_LOAD:
-	{
-		if (!ComputeExprValue(instr.GetSourceExpr<MLIL_LOAD>(), left))
-			return false;
-		auto buffer = ReadMemory(left, instr.size);
-		if (buffer.GetLength() != instr.size)
-			return false;
-
-		switch (instr.size)
-		{
-		case 1:
-			value = *reinterpret_cast<uint8_t*>(buffer.GetData());
-			value &= sizeMask;
-			return true;
-		case 2:
-			value = *reinterpret_cast<uint16_t*>(buffer.GetData());
-			value &= sizeMask;
-			return true;
-		case 4:
-			value = *reinterpret_cast<uint32_t*>(buffer.GetData());
-			value &= sizeMask;
-			return true;
-		case 8:
-			value = *reinterpret_cast<uint64_t*>(buffer.GetData());
-			value &= sizeMask;
-			return true;
-		default:
-			return false;
-		}
-	}
-	case MLIL_STORE:
-	{
-		if (!ComputeExprValue(instr.GetDestExpr<MLIL_STORE>(), left))
-			return false;
-		auto buffer = ReadMemory(left, instr.size);
-		if (buffer.GetLength() != instr.size)
-			return false;
-
-		switch (instr.size)
-		{
-		case 1:
-			value = *reinterpret_cast<uint8_t*>(buffer.GetData());
-			value &= sizeMask;
-			return true;
-		case 2:
-			value = *reinterpret_cast<uint16_t*>(buffer.GetData());
-			value &= sizeMask;
-			return true;
-		case 4:
-			value = *reinterpret_cast<uint32_t*>(buffer.GetData());
-			value &= sizeMask;
-			return true;
-		case 8:
-			value = *reinterpret_cast<uint64_t*>(buffer.GetData());
-			value &= sizeMask;
-			return true;
-		default:
-			return false;
-		}
-	}
-	case MLIL_LSL:
-	{
-		if (!ComputeExprValue(instr.GetLeftExpr<MLIL_LSL>(), left))
-			return false;
-		if (!ComputeExprValue(instr.GetRightExpr<MLIL_LSL>(), right))
-			return false;
-		value = left << GetActualShift(right, instr.size);
-		value &= sizeMask;
-		return true;
-	}
-	case MLIL_LSR:
-	{
-		if (!ComputeExprValue(instr.GetLeftExpr<MLIL_LSR>(), left))
-			return false;
-		if (!ComputeExprValue(instr.GetRightExpr<MLIL_LSR>(), right))
-			return false;
-		value = left >> GetActualShift(right, instr.size);
-		value &= sizeMask;
-		return true;
-	}
-	case MLIL_ASR:
-	{
-		if (!ComputeExprValue(instr.GetLeftExpr<MLIL_ASR>(), left))
-			return false;
-		if (!ComputeExprValue(instr.GetRightExpr<MLIL_ASR>(), right))
-			return false;
-		if (left & (1LL << ((instr.size * 8) - 1)))
-			left |= ~sizeMask;
-		else
-			left &= sizeMask;
-		value = ((int64_t)left) >> GetActualShift(right, instr.size);
-		value &= sizeMask;
-		return true;
-	}
-	case MLIL_XOR:
-	{
-		if (!ComputeExprValue(instr.GetLeftExpr<MLIL_XOR>(), left))
-			return false;
-		if (!ComputeExprValue(instr.GetRightExpr<MLIL_XOR>(), right))
-			return false;
-		value = left ^ right;
-		value &= sizeMask;
-		return true;
-	}
-	case MLIL_AND:
-	{
-		if (!ComputeExprValue(instr.GetLeftExpr<MLIL_AND>(), left))
-			return false;
-		if (!ComputeExprValue(instr.GetRightExpr<MLIL_AND>(), right))
-			return false;
-		value = left & right;
-		value &= sizeMask;
-		return true;
-	}
-	case MLIL_OR:
-	{
-		if (!ComputeExprValue(instr.GetLeftExpr<MLIL_OR>(), left))
-			return false;
-		if (!ComputeExprValue(instr.GetRightExpr<MLIL_OR>(), right))
-			return false;
-		value = left | right;
-		value &= sizeMask;
-		return true;
-	}
-	case MLIL_NEG:
-	{
-		if (!ComputeExprValue(instr.GetSourceExpr<MLIL_NEG>(), left))
-			return false;
-		value = -left;
-		value &= sizeMask;
-		return true;
-	}
-	case MLIL_NOT:
-	{
-		if (!ComputeExprValue(instr.GetSourceExpr<MLIL_NOT>(), left))
-			return false;
-		value = ~left;
-		value &= sizeMask;
-		return true;
-	}
-	case MLIL_SX:
-	{
-		if (!ComputeExprValue(instr.GetSourceExpr<MLIL_SX>(), left))
-			return false;
-		value = SignExtend(left, instr.GetSourceExpr<MLIL_SX>().size, instr.size);
-		return true;
-	}
-	case MLIL_ZX:
-	{
-		if (!ComputeExprValue(instr.GetSourceExpr<MLIL_ZX>(), left))
-			return false;
-		value = ZeroExtend(left, instr.GetSourceExpr<MLIL_ZX>().size, instr.size);
-		return true;
-	}
-	case MLIL_CMP_E:
-		if (!ComputeExprValue(instr.GetLeftExpr<MLIL_CMP_E>(), left))
-			return false;
-		if (!ComputeExprValue(instr.GetRightExpr<MLIL_CMP_E>(), right))
-			return false;
-		value = GetValueFromComparison(instr.operation, left, right, instr.size);
-		return true;
-
-	case MLIL_CMP_NE:
-		if (!ComputeExprValue(instr.GetLeftExpr<MLIL_CMP_NE>(), left))
-			return false;
-		if (!ComputeExprValue(instr.GetRightExpr<MLIL_CMP_NE>(), right))
-			return false;
-		value = GetValueFromComparison(instr.operation, left, right, instr.size);
-		return true;
-
-	case MLIL_CMP_SLT:
-		if (!ComputeExprValue(instr.GetLeftExpr<MLIL_CMP_SLT>(), left))
-			return false;
-		if (!ComputeExprValue(instr.GetRightExpr<MLIL_CMP_SLT>(), right))
-			return false;
-		value = GetValueFromComparison(instr.operation, left, right, instr.size);
-		return true;
-
-	case MLIL_CMP_ULT:
-		if (!ComputeExprValue(instr.GetLeftExpr<MLIL_CMP_ULT>(), left))
-			return false;
-		if (!ComputeExprValue(instr.GetRightExpr<MLIL_CMP_ULT>(), right))
-			return false;
-		value = GetValueFromComparison(instr.operation, left, right, instr.size);
-		return true;
-
-	case MLIL_CMP_SLE:
-		if (!ComputeExprValue(instr.GetLeftExpr<MLIL_CMP_SLE>(), left))
-			return false;
-		if (!ComputeExprValue(instr.GetRightExpr<MLIL_CMP_SLE>(), right))
-			return false;
-		value = GetValueFromComparison(instr.operation, left, right, instr.size);
-		return true;
-
-	case MLIL_CMP_ULE:
-		if (!ComputeExprValue(instr.GetLeftExpr<MLIL_CMP_ULE>(), left))
-			return false;
-		if (!ComputeExprValue(instr.GetRightExpr<MLIL_CMP_ULE>(), right))
-			return false;
-		value = GetValueFromComparison(instr.operation, left, right, instr.size);
-		return true;
-
-	case MLIL_CMP_SGE:
-		if (!ComputeExprValue(instr.GetLeftExpr<MLIL_CMP_SGE>(), left))
-			return false;
-		if (!ComputeExprValue(instr.GetRightExpr<MLIL_CMP_SGE>(), right))
-			return false;
-		value = GetValueFromComparison(instr.operation, left, right, instr.size);
-		return true;
-
-	case MLIL_CMP_UGE:
-		if (!ComputeExprValue(instr.GetLeftExpr<MLIL_CMP_UGE>(), left))
-			return false;
-		if (!ComputeExprValue(instr.GetRightExpr<MLIL_CMP_UGE>(), right))
-			return false;
-		value = GetValueFromComparison(instr.operation, left, right, instr.size);
-		return true;
-
-	case MLIL_CMP_SGT:
-		if (!ComputeExprValue(instr.GetLeftExpr<MLIL_CMP_SGT>(), left))
-			return false;
-		if (!ComputeExprValue(instr.GetRightExpr<MLIL_CMP_SGT>(), right))
-			return false;
-		value = GetValueFromComparison(instr.operation, left, right, instr.size);
-		return true;
-
-	case MLIL_CMP_UGT:
-		if (!ComputeExprValue(instr.GetLeftExpr<MLIL_CMP_UGT>(), left))
-			return false;
-		if (!ComputeExprValue(instr.GetRightExpr<MLIL_CMP_UGT>(), right))
-			return false;
-		value = GetValueFromComparison(instr.operation, left, right, instr.size);
-		return true;
-
-	default:
-		return false;
-	}
-}
-
-
-bool DebuggerController::GetVariableValueAPI(const Variable& var, uint64_t address, size_t size, uint64_t& value)
-{
-	// We only want to do this check once before the recursion
-	if (!m_state->IsConnected() || m_state->IsRunning())
-		return false;
-
-	return GetVariableValue(var, address, size, value);
-}
-
-
-bool DebuggerController::GetVariableValue(const Variable& var, uint64_t address, size_t size, uint64_t &value)
-{
-	int64_t sizeMask = -1;
-	if (size > 0 && size < 8)
-		sizeMask = (1LL << (size * 8)) - 1;
-
-	if (var.type == RegisterVariableSourceType)
-	{
-		auto reg = var.storage;
-		if (LLIL_REG_IS_TEMP(reg))
-			return false;
-
-		auto name = GetData()->GetDefaultArchitecture()->GetRegisterName(reg);
-		// TODO: what if the name reported by the adapter is different from that in the architecture?
-		// GetRegisterValue should return if the value can be retrieved
-
-		// Cheat for arm64
-		if (name == "x29") name = "fp";
-
-		value = GetRegisterValue(name) & sizeMask;
-		return true;
-	}
-	else if (var.type == StackVariableSourceType)
-	{
-		auto stack = m_state->StackPointer();
-		auto ip = m_state->IP();
-		auto funcs = GetData()->GetAnalysisFunctionsContainingAddress(address);
-		if (funcs.empty())
-			return false;
-		auto func = funcs[0];
-		if (!func)
-			return false;
-		auto arch = GetData()->GetDefaultArchitecture();
-		if (!arch)
-			return false;
-		auto stackReg = arch->GetStackPointerRegister();
-		auto stackValue = func->GetRegisterValueAtInstruction(arch, ip, stackReg);
-		if (stackValue.state != StackFrameOffset)
-			return false;
-		auto stackAtFuncEntry = stack - stackValue.value;
-		auto addrOfVar = stackAtFuncEntry + var.storage;
-
-		auto type = func->GetVariableType(var);
-		if (!type)
-			return false;
-
-		auto width = type->GetWidth();
-		if (width > 8)
-			return false;
-
-		auto buffer = ReadMemory(addrOfVar, width);
-		if (buffer.GetLength() != width)
-			return false;
-
-		switch (width)
+		switch (width)
 		{
 		case 1:
 			value = *reinterpret_cast<uint8_t*>(buffer.GetData());
@@ -3479,7 +3573,7 @@ bool DebuggerController::GetVariableValue(const Variable& var, uint64_t address,
 
 bool DebuggerController::ComputeExprValueAPI(const BinaryNinja::HighLevelILInstruction &instr, uint64_t& value)
 {
-	// We only want to do this check once before the recursion
+	// We only want to do this check once before the evaluation
 	if (!m_state->IsConnected() || m_state->IsRunning())
 		return false;
 
@@ -3489,223 +3583,5 @@ bool DebuggerController::ComputeExprValueAPI(const BinaryNinja::HighLevelILInstr
 
 bool DebuggerController::ComputeExprValue(const HighLevelILInstruction &instr, uint64_t& value)
 {
-	if (instr.size > 8)
-		return false;
-
-	uint64_t left, right;
-
-	int64_t sizeMask = -1;
-	if (instr.size > 0 && instr.size < 8)
-		sizeMask = (1LL << (instr.size * 8)) - 1;
-
-	switch (instr.operation)
-	{
-	case HLIL_CONST:
-		value = instr.GetConstant<HLIL_CONST>() & sizeMask;
-		return true;
-	case HLIL_CONST_PTR:
-		value = instr.GetConstant<HLIL_CONST_PTR>() & sizeMask;
-		return true;
-	case HLIL_FLOAT_CONST:
-		value = instr.GetConstant<HLIL_CONST_PTR>() & sizeMask;
-		return true;
-	case HLIL_VAR:
-	{
-		const auto var = instr.GetVariable<HLIL_VAR>();
-		return GetVariableValue(var, instr.address, instr.size, value);
-		break;
-	}
-	case HLIL_ADD:
-		if (!ComputeExprValue(instr.GetLeftExpr<HLIL_ADD>(), left))
-			return false;
-		if (!ComputeExprValue(instr.GetRightExpr<HLIL_ADD>(), right))
-			return false;
-		value = left + right;
-		value &= sizeMask;
-		return true;
-	case HLIL_SUB:
-		if (!ComputeExprValue(instr.GetLeftExpr<HLIL_SUB>(), left))
-			return false;
-		if (!ComputeExprValue(instr.GetRightExpr<HLIL_SUB>(), right))
-			return false;
-		value = left - right;
-		value &= sizeMask;
-		return true;
-	case HLIL_LSL:
-	{
-		if (!ComputeExprValue(instr.GetLeftExpr<HLIL_LSL>(), left))
-			return false;
-		if (!ComputeExprValue(instr.GetRightExpr<HLIL_LSL>(), right))
-			return false;
-		value = left << GetActualShift(right, instr.size);
-		value &= sizeMask;
-		return true;
-	}
-	case HLIL_LSR:
-	{
-		if (!ComputeExprValue(instr.GetLeftExpr<HLIL_LSR>(), left))
-			return false;
-		if (!ComputeExprValue(instr.GetRightExpr<HLIL_LSR>(), right))
-			return false;
-		value = left >> GetActualShift(right, instr.size);
-		value &= sizeMask;
-		return true;
-	}
-	case HLIL_ASR:
-	{
-		if (!ComputeExprValue(instr.GetLeftExpr<HLIL_ASR>(), left))
-			return false;
-		if (!ComputeExprValue(instr.GetRightExpr<HLIL_ASR>(), right))
-			return false;
-		if (left & (1LL << ((instr.size * 8) - 1)))
-			left |= ~sizeMask;
-		else
-			left &= sizeMask;
-		value = ((int64_t)left) >> GetActualShift(right, instr.size);
-		value &= sizeMask;
-		return true;
-	}
-	case HLIL_XOR:
-	{
-		if (!ComputeExprValue(instr.GetLeftExpr<HLIL_XOR>(), left))
-			return false;
-		if (!ComputeExprValue(instr.GetRightExpr<HLIL_XOR>(), right))
-			return false;
-		value = left ^ right;
-		value &= sizeMask;
-		return true;
-	}
-	case HLIL_AND:
-	{
-		if (!ComputeExprValue(instr.GetLeftExpr<HLIL_AND>(), left))
-			return false;
-		if (!ComputeExprValue(instr.GetRightExpr<HLIL_AND>(), right))
-			return false;
-		value = left & right;
-		value &= sizeMask;
-		return true;
-	}
-	case HLIL_OR:
-	{
-		if (!ComputeExprValue(instr.GetLeftExpr<HLIL_OR>(), left))
-			return false;
-		if (!ComputeExprValue(instr.GetRightExpr<HLIL_OR>(), right))
-			return false;
-		value = left | right;
-		value &= sizeMask;
-		return true;
-	}
-	case HLIL_NEG:
-	{
-		if (!ComputeExprValue(instr.GetSourceExpr<HLIL_NEG>(), left))
-			return false;
-		value = -left;
-		value &= sizeMask;
-		return true;
-	}
-	case HLIL_NOT:
-	{
-		if (!ComputeExprValue(instr.GetSourceExpr<HLIL_NOT>(), left))
-			return false;
-		value = ~left;
-		value &= sizeMask;
-		return true;
-	}
-	case HLIL_SX:
-	{
-		if (!ComputeExprValue(instr.GetSourceExpr<HLIL_SX>(), left))
-			return false;
-		value = SignExtend(left, instr.GetSourceExpr<HLIL_SX>().size, instr.size);
-		return true;
-	}
-	case HLIL_ZX:
-	{
-		if (!ComputeExprValue(instr.GetSourceExpr<HLIL_ZX>(), left))
-			return false;
-		value = ZeroExtend(left, instr.GetSourceExpr<HLIL_ZX>().size, instr.size);
-		return true;
-	}
-	case HLIL_CMP_E:
-		if (!ComputeExprValue(instr.GetLeftExpr<HLIL_CMP_E>(), left))
-			return false;
-		if (!ComputeExprValue(instr.GetRightExpr<HLIL_CMP_E>(), right))
-			return false;
-		value = GetValueFromComparison(instr.operation, left, right, instr.size);
-		return true;
-
-	case HLIL_CMP_NE:
-		if (!ComputeExprValue(instr.GetLeftExpr<HLIL_CMP_NE>(), left))
-			return false;
-		if (!ComputeExprValue(instr.GetRightExpr<HLIL_CMP_NE>(), right))
-			return false;
-		value = GetValueFromComparison(instr.operation, left, right, instr.size);
-		return true;
-
-	case HLIL_CMP_SLT:
-		if (!ComputeExprValue(instr.GetLeftExpr<HLIL_CMP_SLT>(), left))
-			return false;
-		if (!ComputeExprValue(instr.GetRightExpr<HLIL_CMP_SLT>(), right))
-			return false;
-		value = GetValueFromComparison(instr.operation, left, right, instr.size);
-		return true;
-
-	case HLIL_CMP_ULT:
-		if (!ComputeExprValue(instr.GetLeftExpr<HLIL_CMP_ULT>(), left))
-			return false;
-		if (!ComputeExprValue(instr.GetRightExpr<HLIL_CMP_ULT>(), right))
-			return false;
-		value = GetValueFromComparison(instr.operation, left, right, instr.size);
-		return true;
-
-	case HLIL_CMP_SLE:
-		if (!ComputeExprValue(instr.GetLeftExpr<HLIL_CMP_SLE>(), left))
-			return false;
-		if (!ComputeExprValue(instr.GetRightExpr<HLIL_CMP_SLE>(), right))
-			return false;
-		value = GetValueFromComparison(instr.operation, left, right, instr.size);
-		return true;
-
-	case HLIL_CMP_ULE:
-		if (!ComputeExprValue(instr.GetLeftExpr<HLIL_CMP_ULE>(), left))
-			return false;
-		if (!ComputeExprValue(instr.GetRightExpr<HLIL_CMP_ULE>(), right))
-			return false;
-		value = GetValueFromComparison(instr.operation, left, right, instr.size);
-		return true;
-
-	case HLIL_CMP_SGE:
-		if (!ComputeExprValue(instr.GetLeftExpr<HLIL_CMP_SGE>(), left))
-			return false;
-		if (!ComputeExprValue(instr.GetRightExpr<HLIL_CMP_SGE>(), right))
-			return false;
-		value = GetValueFromComparison(instr.operation, left, right, instr.size);
-		return true;
-
-	case HLIL_CMP_UGE:
-		if (!ComputeExprValue(instr.GetLeftExpr<HLIL_CMP_UGE>(), left))
-			return false;
-		if (!ComputeExprValue(instr.GetRightExpr<HLIL_CMP_UGE>(), right))
-			return false;
-		value = GetValueFromComparison(instr.operation, left, right, instr.size);
-		return true;
-
-	case HLIL_CMP_SGT:
-		if (!ComputeExprValue(instr.GetLeftExpr<HLIL_CMP_SGT>(), left))
-			return false;
-		if (!ComputeExprValue(instr.GetRightExpr<HLIL_CMP_SGT>(), right))
-			return false;
-		value = GetValueFromComparison(instr.operation, left, right, instr.size);
-		return true;
-
-	case HLIL_CMP_UGT:
-		if (!ComputeExprValue(instr.GetLeftExpr<HLIL_CMP_UGT>(), left))
-			return false;
-		if (!ComputeExprValue(instr.GetRightExpr<HLIL_CMP_UGT>(), right))
-			return false;
-		value = GetValueFromComparison(instr.operation, left, right, instr.size);
-		return true;
-
-	default:
-		return false;
-	}
+	return m_expressions->Evaluate(instr, value);
 }
@@ -18,11 +18,16 @@ limitations under the License.
 #include "binaryninjaapi.h"
 #include "debuggerstate.h"
 #include "debuggerevent.h"
+#include <atomic>
 #include <queue>
 #include <list>
+#include <shared_mutex>
+#include <unordered_map>
 #include "ffi_global.h"
 #include "refcountobject.h"
 #include "debuggerfileaccessor.h"
+#include "compiledexpression.h"
+#include "moduleanalysis.h"
 
 DECLARE_DEBUGGER_API_OBJECT(BNDebuggerController, DebuggerController);
 
@@ -62,6 +67,11 @@ namespace BinaryNinjaDebugger {
 	private:
 		DebugAdapter* m_adapter;
 		DebuggerState* m_state;
+		ExpressionCache* m_expressions;
+		// nullptr unless debugger.analyzeLoadedModules is enabled
+		ModuleAnalysis* m_moduleAnalysis = nullptr;
+		// The version of the module list whose modules were last queued for analysis
+		uint64_t m_analyzedModulesVersion = 0;
 		FileMetadataRef m_file;
 		BinaryViewRef m_data;
 		DebuggerFileAccessor* m_accessor;
@@ -69,10 +79,20 @@ namespace BinaryNinjaDebugger {
 		// this does not change even if we add the debugger memory region. In the future, this should be provided by
 		// the binary view -- we will no longer need to track it ourselves
 		uint64_t m_viewStart;
-
-		//	inline static std::vector<DbgRef<DebuggerController>> g_debuggerControllers;
-		static DbgRef<DebuggerController>* g_debuggerControllers;
-		static size_t g_controllerCount;
+		// The end of the file segments in m_data, which the debugger memory region does not extend either
+		uint64_t m_viewEnd;
+		static uint64_t GetFileSegmentsEnd(BinaryView* view);
+		// Whether the input view was left at its original base when the target loaded it elsewhere, and where the
+		// target loaded it. See debugger.translateImageBase.
+		std::atomic<bool> m_imageTranslated = false;
+		uint64_t m_liveImageBase = 0;
+
+		// Controllers keyed by the core object of their FileMetadata. Lookups happen from the UI action callbacks, the
+		// FFI, the adapter threads and the scripting threads, so they take a shared lock and only creating or deleting a
+		// controller takes the exclusive one.
+		typedef std::unordered_map<BNFileMetadata*, DbgRef<DebuggerController>> ControllerMap;
+		static ControllerMap& GetControllerMap();
+		static std::shared_mutex& GetControllerMapMutex();
 
 		std::atomic<size_t> m_callbackIndex = 0;
 		std::list<DebuggerEventCallback> m_eventCallbacks;
@@ -84,6 +104,8 @@ namespace BinaryNinjaDebugger {
 		// same time
 		std::mutex m_adapterMutex;
 		std::recursive_mutex m_targetControlMutex;
+		// Serializes the process lists read from worker threads, e.g., by the attach dialog
+		std::mutex m_processListMutex;
 
 		uint64_t m_lastIP = 0;
 		uint64_t m_currentIP = 0;
@@ -92,7 +114,8 @@ namespace BinaryNinjaDebugger {
 		// status before returning the value
 		uint32_t m_exitCode = 0;
 
-		bool m_userRequestedBreak = false;
+		// Written by the UI thread, and read by the adapter listener thread through the stop filter
+		std::atomic<bool> m_userRequestedBreak = false;
 
 		bool m_lastAdapterStopEventConsumed = true;
 
@@ -102,6 +125,10 @@ namespace BinaryNinjaDebugger {
 		bool m_firstLaunch = true;
 		bool m_shouldAnnotateStackVariable = false;
 
+		// The return instructions of the functions that step return had to fall back to scanning, keyed by the start
+		// of the function in the view
+		std::unordered_map<uint64_t, std::vector<uint64_t>> m_functionReturns;
+
 		void EventHandler(const DebuggerEvent& event);
 		void UpdateStackVariables();
 		void AddRegisterValuesToExpressionParser();
@@ -127,11 +154,25 @@ namespace BinaryNinjaDebugger {
 		DebugStopReason EmulateStepOverAndWait();
 		DebugStopReason StepOverAndWaitInternal();
 		DebugStopReason StepOverReverseAndWaitInternal();
+		bool GetFunctionReturns(uint64_t remoteAddress, std::vector<uint64_t>& remoteAddresses);
 		DebugStopReason EmulateStepReturnAndWait();
 		DebugStopReason StepReturnAndWaitInternal();
 		DebugStopReason StepReturnReverseAndWaitInternal();
 		DebugStopReason RunToAndWaitInternal(const std::vector<uint64_t> &remoteAddresses);
 
+		// Without native time travel debugging, reverse operations replay the execution journal. Forward operations
+		// replay it too until they reach its end, and are recorded into it one instruction at a time when
+		// debugger.recordExecution is enabled. Returns false if the adapter should carry out the operation instead.
+		bool ExecuteJournalAndWait(DebugAdapterOperation operation, DebugStopReason& reason,
+			const std::vector<uint64_t>& stopAddresses = {});
+		bool IsRecordingExecution();
+		// Finds the memory the instruction at the address is about to write, from its LLIL, and reads the current bytes
+		void GetInstructionWrites(
+			uint64_t address, uint64_t stackPointer, std::vector<JournalMemoryWrite>& writes, uint32_t& flags);
+		DebugStopReason RecordStepAndWait(uint32_t& flags);
+		DebugStopReason RecordAndWait(DebugAdapterOperation operation, const std::vector<uint64_t>& stopAddresses);
+		DebugStopReason ReplayAndWait(DebugAdapterOperation operation, const std::vector<uint64_t>& stopAddresses);
+
 		// Whether we can resume the execution of the target, including stepping.
 		bool CanResumeTarget();
 
@@ -145,6 +186,19 @@ namespace BinaryNinjaDebugger {
 		void DefineVariablesRecursive(uint64_t address, Confidence<Ref<Type>> type);
 
 		void ApplyBreakpoints();
+		// Decides whether an adapter stop at a breakpoint should surface, by evaluating the condition of the breakpoint
+		// at the current instruction pointer, if any. Tracepoints are recorded here.
+		bool ShouldStopAtBreakpoint();
+		bool HandleCoverageHit();
+		// Likewise for a stop at a watchpoint, which only does not surface for a recording watchpoint
+		bool ShouldStopAtWatchpoint();
+		// Whether a stop of the running target is handled by the checks above, and the target should be resumed
+		bool IsStopHandledByCore(DebugStopReason reason);
+		// The stop filter of the adapter, which runs these checks on the thread of the adapter, before the stop is
+		// reported. It only handles the stops while the target runs, i.e., Go, and a launch that does not stop at the
+		// entry point. A step must stop at a breakpoint, since the adapter cannot resume the step.
+		std::atomic<bool> m_filterAdapterStops = false;
+		bool FilterAdapterStop(DebugStopReason reason);
 
 		std::string m_lastAdapterName;
 		std::string m_lastCommand;
@@ -154,6 +208,8 @@ namespace BinaryNinjaDebugger {
 		BNAnalysisState m_oldAnalysisState = IdleState;
 
 		void DetectLoadedModule();
+		// Queues the loaded modules other than the input file for the background analysis, when the list changed
+		void AnalyzeLoadedModules();
 
 	public:
 		DebuggerController(BinaryViewRef data);
@@ -176,15 +232,50 @@ namespace BinaryNinjaDebugger {
 		void AddBreakpoint(const ModuleNameAndOffset& address);
 		void DeleteBreakpoint(uint64_t address);
 		void DeleteBreakpoint(const ModuleNameAndOffset& address);
+		// Add or remove many breakpoints at once and post a single BreakpointsChangedEvent, rather than one event per
+		// breakpoint. Return the number of breakpoints added or removed.
+		size_t AddBreakpoints(const std::vector<uint64_t>& addresses);
+		size_t AddBreakpoints(const std::vector<ModuleNameAndOffset>& addresses);
+		size_t DeleteBreakpoints(const std::vector<uint64_t>& addresses);
+		size_t DeleteBreakpoints(const std::vector<ModuleNameAndOffset>& addresses);
 		DebugBreakpoint GetAllBreakpoints();
+		bool SetBreakpointCondition(uint64_t address, const std::string& condition);
+		bool SetBreakpointCondition(const ModuleNameAndOffset& address, const std::string& condition);
+		// Adds a breakpoint at the address if there is none, and makes it record the captures instead of stopping
+		bool AddTracepoint(uint64_t address, const std::string& captures);
+		bool AddTracepoint(const ModuleNameAndOffset& address, const std::string& captures);
+		std::vector<TraceRecord> DrainTraceRecords(size_t maxCount = 0);
+		uint64_t GetDroppedTraceRecordCount();
+
+		// watchpoints
+		bool AddWatchpoint(uint64_t address, size_t size, DebugWatchpointType type, bool record = false);
+		bool DeleteWatchpoint(uint64_t address);
+		std::vector<WatchpointInfo> GetWatchpoints();
+		std::vector<WatchpointHitRecord> DrainWatchpointHits(size_t maxCount = 0);
+		uint64_t GetDroppedWatchpointHitCount();
+
+		// coverage
+		// Adds the basic blocks of the functions at the given addresses, or of all functions if the list is empty, and
+		// returns the number of new blocks
+		size_t AddCoverage(const std::vector<uint64_t>& functions);
+		void ClearCoverage();
+		size_t GetCoverageBlockCount();
+		size_t GetCoverageHitCount();
+		// Addresses in the input view of the blocks hit so far, in the order they were hit, starting at the given
+		// position
+		std::vector<uint64_t> GetCoverageHits(size_t start = 0);
 
 		// registers
 		uint64_t GetRegisterValue(const std::string& name);
+		bool GetRegisterValue(uint32_t archRegister, uint64_t& value);
 		bool SetRegisterValue(const std::string& name, uint64_t value);
-		std::vector<DebugRegister> GetAllRegisters();
+		std::vector<DebugRegister> GetAllRegisters(bool computeHints = true);
 
 		// processes
 		std::vector<DebugProcess> GetProcessList();
+		// Like GetProcessList(), but never creates the adapter, so it can be called off the main thread. The list is
+		// empty until the adapter is created, e.g., by ActivateDebugAdapter().
+		std::vector<DebugProcess> GetAdapterProcessList();
 
 		// threads
 		DebugThread GetActiveThread() const;
@@ -212,6 +303,12 @@ namespace BinaryNinjaDebugger {
 
 		// memory
 		DataBuffer ReadMemory(std::uintptr_t address, std::size_t size);
+		// Copies the memory into dest, up to the first byte that cannot be read. Returns the number of bytes copied.
+		size_t ReadMemory(std::uintptr_t address, void* dest, std::size_t size);
+		// Reads every range into dest, one after another. bytesRead receives the number of bytes read from each range,
+		// and the total is returned.
+		size_t ReadMemoryRanges(const std::vector<std::pair<uint64_t, size_t>>& ranges, void* dest,
+			std::vector<size_t>& bytesRead);
 		bool WriteMemory(std::uintptr_t address, const DataBuffer& buffer);
 
 		// debugger events
@@ -300,13 +397,20 @@ namespace BinaryNinjaDebugger {
 
 		// Dereference an address and check for printable strings, functions, symbols, etc
 		std::string GetAddressInformation(uint64_t address);
+		// Finds the function containing the address in a loaded module other than the input file, from the
+		// background analysis of the module. See debugger.analyzeLoadedModules.
+		bool GetModuleFunction(uint64_t address, uint64_t& functionStart, std::string& name);
 
 		bool IsFirstLaunch();
+		// Whether the adapter does time travel debugging, e.g., it replays a TTD trace
 		bool IsTTD();
+		// Whether the target can step and run backwards, natively or from the execution journal
+		bool IsReverseExecutionSupported();
 
 		void OnRebased(BinaryView* oldView, BinaryView* newView) override {
 			m_data = newView;
 			m_viewStart = newView->GetStart();
+			m_viewEnd = GetFileSegmentsEnd(newView);
 			// UnregisterNotification() is not designed to be called from one of the callbacks, so we cannot call it
 			// here. Also, there is no need to do so -- the oldView is about to be deleted
 			// oldView->UnregisterNotification(this);
@@ -318,17 +422,23 @@ namespace BinaryNinjaDebugger {
 
 		uint64_t GetViewFileSegmentsStart() { return m_viewStart; }
 
+		// Addresses in the input view and in the target only differ when the view is translated rather than rebased.
+		// Addresses outside the input file are the same in both.
+		bool IsImageTranslated() const { return m_imageTranslated; }
+		uint64_t ViewToLiveAddress(uint64_t address) const;
+		uint64_t LiveToViewAddress(uint64_t address) const;
+		// Translates the start of a range of the input view, and shortens the range so that it does not cross the
+		// boundary of the input file, past which the rest translates differently
+		uint64_t ViewToLiveRange(uint64_t address, size_t& length) const;
+
 		bool ComputeExprValueAPI(const LowLevelILInstruction& instr, uint64_t& value);
 		bool ComputeExprValue(const LowLevelILInstruction& instr, uint64_t& value);
-		uint64_t GetValueFromComparison(const BNLowLevelILOperation op, uint64_t left, uint64_t right, size_t size);
 
 		bool ComputeExprValueAPI(const MediumLevelILInstruction& instr, uint64_t& value);
 		bool ComputeExprValue(const MediumLevelILInstruction& instr, uint64_t& value);
-		uint64_t GetValueFromComparison(const BNMediumLevelILOperation op, uint64_t left, uint64_t right, size_t size);
 
 		bool ComputeExprValueAPI(const HighLevelILInstruction& instr, uint64_t& value);
 		bool ComputeExprValue(const HighLevelILInstruction& instr, uint64_t& value);
-		uint64_t GetValueFromComparison(const BNHighLevelILOperation op, uint64_t left, uint64_t right, size_t size);
 
 		bool GetVariableValueAPI(const Variable& var, uint64_t address, size_t size, uint64_t& value);
 		bool GetVariableValue(const Variable& var, uint64_t address, size_t size, uint64_t& value);
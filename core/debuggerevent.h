@@ -17,6 +17,7 @@ limitations under the License.
 #pragma once
 #include "cstddef"
 #include <string>
+#include <variant>
 #include "debuggercommon.h"
 #include "../api/ffi.h"
 
@@ -54,15 +55,57 @@ namespace BinaryNinjaDebugger {
 	};
 
 
-	// This should really be a union, but gcc complains...
-	struct DebuggerEventData
+	// The payload of an event. Each event carries at most one kind of data, so this is a tagged variant rather than a
+	// struct of every possible payload; a plain event like ResumeEventType holds nothing and costs nothing to copy.
+	// The strings are owned by the event, and the FFI layer hands out borrowed pointers into them.
+	//
+	// The accessors are named after the fields of the old struct. The non-const ones switch the payload to the
+	// requested kind (value-initialized) if it holds something else, so that event construction reads as before. The
+	// const ones never modify the event and return an empty payload if a different kind is held.
+	class DebuggerEventData
 	{
-		TargetStoppedEventData targetStoppedData;
-		ErrorEventData errorData;
-		uint64_t absoluteAddress;
-		ModuleNameAndOffset relativeAddress;
-		TargetExitedEventData exitData;
-		StdoutMessageEventData messageData;
+		std::variant<std::monostate, TargetStoppedEventData, ErrorEventData, uint64_t, ModuleNameAndOffset,
+			TargetExitedEventData, StdoutMessageEventData>
+			m_payload;
+
+		template <typename T>
+		T& Activate()
+		{
+			if (!std::holds_alternative<T>(m_payload))
+				m_payload.template emplace<T>();
+			return std::get<T>(m_payload);
+		}
+
+		template <typename T>
+		const T& Get() const
+		{
+			static const T empty {};
+			auto result = std::get_if<T>(&m_payload);
+			return result ? *result : empty;
+		}
+
+	public:
+		template <typename T>
+		const T* GetIf() const { return std::get_if<T>(&m_payload); }
+		bool IsEmpty() const { return std::holds_alternative<std::monostate>(m_payload); }
+
+		TargetStoppedEventData& TargetStoppedData() { return Activate<TargetStoppedEventData>(); }
+		const TargetStoppedEventData& TargetStoppedData() const { return Get<TargetStoppedEventData>(); }
+
+		ErrorEventData& ErrorData() { return Activate<ErrorEventData>(); }
+		const ErrorEventData& ErrorData() const { return Get<ErrorEventData>(); }
+
+		uint64_t& AbsoluteAddress() { return Activate<uint64_t>(); }
+		uint64_t AbsoluteAddress() const { return Get<uint64_t>(); }
+
+		ModuleNameAndOffset& RelativeAddress() { return Activate<ModuleNameAndOffset>(); }
+		const ModuleNameAndOffset& RelativeAddress() const { return Get<ModuleNameAndOffset>(); }
+
+		TargetExitedEventData& ExitData() { return Activate<TargetExitedEventData>(); }
+		const TargetExitedEventData& ExitData() const { return Get<TargetExitedEventData>(); }
+
+		StdoutMessageEventData& MessageData() { return Activate<StdoutMessageEventData>(); }
+		const StdoutMessageEventData& MessageData() const { return Get<StdoutMessageEventData>(); }
 	};
 
 
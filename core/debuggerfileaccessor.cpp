@@ -53,22 +53,44 @@ uint64_t DebuggerFileAccessor::GetLength() const
 
 size_t DebuggerFileAccessor::Read(void *dest, uint64_t offset, size_t len)
 {
-	DataBuffer buffer = m_controller->ReadMemory(offset, len);
-	memcpy(dest, buffer.GetData(), buffer.GetLength());
+	if (!m_controller->IsImageTranslated())
+	{
+		DataBuffer buffer = m_controller->ReadMemory(offset, len);
+		memcpy(dest, buffer.GetData(), buffer.GetLength());
+		return buffer.GetLength();
+	}
 
-	return buffer.GetLength();
+	// The input file is read from where the target loaded it, and a read that crosses its boundary is split there
+	size_t done = 0;
+	while (done < len)
+	{
+		size_t chunk = len - done;
+		uint64_t address = m_controller->ViewToLiveRange(offset + done, chunk);
+		DataBuffer buffer = m_controller->ReadMemory(address, chunk);
+		memcpy((uint8_t*)dest + done, buffer.GetData(), buffer.GetLength());
+		done += buffer.GetLength();
+		if (buffer.GetLength() != chunk)
+			break;
+	}
+	return done;
 }
 
 
 size_t DebuggerFileAccessor::Write(uint64_t offset, const void *src, size_t len)
 {
-	if (m_controller->WriteMemory(offset, DataBuffer(src, len)))
+	size_t done = 0;
+	while (done < len)
 	{
-		m_controller->GetData()->NotifyDataWritten(offset, len);
-		return len;
+		size_t chunk = len - done;
+		uint64_t address = m_controller->ViewToLiveRange(offset + done, chunk);
+		if (!m_controller->WriteMemory(address, DataBuffer((const uint8_t*)src + done, chunk)))
+			break;
+		done += chunk;
 	}
 
-	return 0;
+	if (done > 0)
+		m_controller->GetData()->NotifyDataWritten(offset, done);
+	return done;
 }
 
 
@@ -14,10 +14,16 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
+#include <algorithm>
 #include <chrono>
+#include <iterator>
 #include <thread>
 #include <utility>
 #include <filesystem>
+#include <cinttypes>
+#include <cstring>
+#include <set>
+#include <unordered_set>
 #include "lowlevelilinstruction.h"
 #include "mediumlevelilinstruction.h"
 #include "highlevelilinstruction.h"
@@ -40,6 +46,8 @@ void DebuggerRegisters::MarkDirty()
 {
 	m_dirty = true;
 	m_registerCache.clear();
+	m_registerValues.clear();
+	m_state->InvalidateCacheGeneration();
 }
 
 
@@ -52,7 +60,19 @@ void DebuggerRegisters::Update()
 	if (!m_state->IsConnected())
 		return;
 
-	m_registerCache = adapter->ReadAllRegisters();
+	ExecutionJournal* journal = m_state->GetJournal();
+	if (journal->IsReplaying())
+		m_registerCache = journal->GetRegisters(journal->GetPosition());
+	else
+		m_registerCache = adapter->ReadAllRegisters();
+
+	// The map is built from the first register read of the session. It only needs to be rebuilt if the adapter
+	// starts reporting a different set of registers.
+	if (!m_registerMap.Fill(m_registerCache, m_registerValues))
+	{
+		m_registerMap.Build(m_state->GetRemoteArchitecture(), m_registerCache);
+		m_registerMap.Fill(m_registerCache, m_registerValues);
+	}
 	m_dirty = false;
 }
 
@@ -72,6 +92,15 @@ uint64_t DebuggerRegisters::GetRegisterValue(const std::string& name)
 }
 
 
+bool DebuggerRegisters::GetRegisterValue(uint32_t archRegister, uint64_t& value)
+{
+	if (IsDirty())
+		Update();
+
+	return m_registerMap.GetValue(archRegister, m_registerValues, value);
+}
+
+
 bool DebuggerRegisters::SetRegisterValue(const std::string& name, uint64_t value)
 {
 	DebugAdapter* adapter = m_state->GetAdapter();
@@ -82,6 +111,9 @@ bool DebuggerRegisters::SetRegisterValue(const std::string& name, uint64_t value
 	if (iter == m_registerCache.end())
 		return false;
 
+	if (!m_state->CanModifyTarget())
+		return false;
+
 	bool ok = adapter->WriteRegister(name, value);
 	if (!ok)
 		return false;
@@ -95,7 +127,7 @@ bool DebuggerRegisters::SetRegisterValue(const std::string& name, uint64_t value
 }
 
 
-std::vector<DebugRegister> DebuggerRegisters::GetAllRegisters()
+std::vector<DebugRegister> DebuggerRegisters::GetAllRegisters(bool computeHints)
 {
 	if (IsDirty())
 		Update();
@@ -108,6 +140,9 @@ std::vector<DebugRegister> DebuggerRegisters::GetAllRegisters()
 		return lhs.m_registerIndex < rhs.m_registerIndex;
 	});
 
+	if (!computeHints)
+		return result;
+
 	// TODO: maybe we should not hold a m_state at all; instead we just hold a m_controller
 	auto controller = m_state->GetController();
 	if (!controller->GetState()->IsConnected())
@@ -154,24 +189,27 @@ void DebuggerThreads::SymbolizeFrames(std::vector<DebugFrame>& frames)
 	if (!m_state || !m_state->GetController())
 		return;
 
-	auto data = m_state->GetController()->GetData();
+	DebuggerController* controller = m_state->GetController();
+	auto data = controller->GetData();
 	if (!data)
 		return;
 
 	for (DebugFrame& frame: frames)
 	{
-		// Try to find a better symbol than the one provided by the debugger backend
-		auto funcs = data->GetAnalysisFunctionsContainingAddress(frame.m_pc);
+		// Try to find a better symbol than the one provided by the debugger backend. The frames keep the addresses of
+		// the target, which differ from the ones in the view when it is translated rather than rebased.
+		auto funcs = data->GetAnalysisFunctionsContainingAddress(controller->LiveToViewAddress(frame.m_pc));
 		if (!funcs.empty())
 		{
 			auto func = funcs[0];
 			if (!func)
 				continue;
 
-			if (func->GetStart() != frame.m_functionStart)
+			uint64_t functionStart = controller->ViewToLiveAddress(func->GetStart());
+			if (functionStart != frame.m_functionStart)
 			{
 				// Found a better function start from the analysis, use it
-				frame.m_functionStart = func->GetStart();
+				frame.m_functionStart = functionStart;
 				auto symbol = func->GetSymbol();
 				if (symbol)
 					frame.m_functionName = symbol->GetShortName();
@@ -201,6 +239,18 @@ void DebuggerThreads::SymbolizeFrames(std::vector<DebugFrame>& frames)
 			}
 			continue;
 		}
+
+		// The input view knows nothing about the other modules, but they may have been analyzed in the background.
+		// Prefer the symbol of the backend, unless it is further away, e.g., it is the nearest exported function
+		// before a static one.
+		uint64_t functionStart;
+		std::string functionName;
+		if (m_state->GetController()->GetModuleFunction(frame.m_pc, functionStart, functionName)
+			&& (frame.m_functionName.empty() || (functionStart > frame.m_functionStart)))
+		{
+			frame.m_functionStart = functionStart;
+			frame.m_functionName = functionName;
+		}
 	}
 }
 
@@ -355,6 +405,7 @@ DebuggerModules::DebuggerModules(DebuggerState* state) : m_state(state)
 void DebuggerModules::MarkDirty()
 {
 	m_dirty = true;
+	m_versionStale = true;
 	m_modules.clear();
 }
 
@@ -370,6 +421,31 @@ void DebuggerModules::Update()
 
 	m_modules = adapter->GetModuleList();
 	m_dirty = false;
+	m_versionStale = true;
+}
+
+
+uint64_t DebuggerModules::GetVersion()
+{
+	if (IsDirty())
+		Update();
+
+	// Only compare the lists when they may have changed, since this is called once per breakpoint that is resolved
+	if (!m_versionStale)
+		return m_version;
+
+	m_versionStale = false;
+	auto sameModule = [](const DebugModule& a, const DebugModule& b) {
+		return (a.m_name == b.m_name) && (a.m_address == b.m_address);
+	};
+	bool same = std::equal(
+		m_modules.begin(), m_modules.end(), m_versionedModules.begin(), m_versionedModules.end(), sameModule);
+	if (!same)
+	{
+		m_versionedModules = m_modules;
+		m_version++;
+	}
+	return m_version;
 }
 
 
@@ -448,6 +524,11 @@ ModuleNameAndOffset DebuggerModules::AbsoluteAddressToRelative(uint64_t absolute
 	}
 	else
 	{
+		// The input file may be missing from the module list, but its translated range is still known
+		DebuggerController* controller = m_state->GetController();
+		uint64_t viewAddress = controller->LiveToViewAddress(absoluteAddress);
+		if (viewAddress != absoluteAddress)
+			return ModuleNameAndOffset(m_state->GetInputFile(), viewAddress - controller->GetViewFileSegmentsStart());
 		relativeAddress = absoluteAddress;
 	}
 
@@ -472,7 +553,9 @@ uint64_t DebuggerModules::RelativeAddressToAbsolute(const ModuleNameAndOffset& r
 		if (DebugModule::IsSameBaseModule(m_state->GetController()->GetData()->GetFile()->GetOriginalFilename(),
 										  relativeAddress.module))
 		{
-			return m_state->GetController()->GetViewFileSegmentsStart() + relativeAddress.offset;
+			// Where the target loaded the input file, if the view is translated rather than rebased
+			DebuggerController* controller = m_state->GetController();
+			return controller->ViewToLiveAddress(controller->GetViewFileSegmentsStart() + relativeAddress.offset);
 		}
 	}
 
@@ -490,7 +573,8 @@ std::vector<DebugModule> DebuggerModules::GetAllModules()
 
 
 DebuggerBreakpoints::DebuggerBreakpoints(DebuggerState* state, std::vector<ModuleNameAndOffset> initial) :
-	m_state(state), m_breakpoints(std::move(initial))
+	m_state(state), m_breakpoints(std::move(initial)),
+	m_traceBuffer(Settings::Instance()->Get<uint64_t>("debugger.tracepointBufferSize"))
 {}
 
 
@@ -507,10 +591,13 @@ bool DebuggerBreakpoints::AddAbsolute(uint64_t remoteAddress)
 		result = true;
 	}
 
+	std::unique_lock<std::recursive_mutex> lock(m_mutex);
 	if (!ContainsAbsolute(remoteAddress))
 	{
 		ModuleNameAndOffset info = m_state->GetModules()->AbsoluteAddressToRelative(remoteAddress);
 		m_breakpoints.push_back(info);
+		RecordChange(info, true);
+		lock.unlock();
 		SerializeMetadata();
 	}
 
@@ -520,9 +607,12 @@ bool DebuggerBreakpoints::AddAbsolute(uint64_t remoteAddress)
 
 bool DebuggerBreakpoints::AddOffset(const ModuleNameAndOffset& address)
 {
+	std::unique_lock<std::recursive_mutex> lock(m_mutex);
 	if (!ContainsOffset(address))
 	{
 		m_breakpoints.push_back(address);
+		RecordChange(address, true);
+		lock.unlock();
 		SerializeMetadata();
 
 		// If the adapter is already created, we ask it to add the breakpoint.
@@ -543,14 +633,20 @@ bool DebuggerBreakpoints::RemoveAbsolute(uint64_t remoteAddress)
 	if (!m_state->GetAdapter())
 		return false;
 
+	std::unique_lock<std::recursive_mutex> lock(m_mutex);
 	ModuleNameAndOffset info = m_state->GetModules()->AbsoluteAddressToRelative(remoteAddress);
 	if (ContainsOffset(info))
 	{
 		auto iter = std::find(m_breakpoints.begin(), m_breakpoints.end(), info);
 		if (iter != m_breakpoints.end())
 		{
+			std::unique_lock<std::mutex> conditionLock(m_conditionMutex);
+			m_conditions.erase(*iter);
+			conditionLock.unlock();
+			RecordChange(*iter, false);
 			m_breakpoints.erase(iter);
 		}
+		lock.unlock();
 		SerializeMetadata();
 		m_state->GetAdapter()->RemoveBreakpoint(remoteAddress);
 		return true;
@@ -561,16 +657,24 @@ bool DebuggerBreakpoints::RemoveAbsolute(uint64_t remoteAddress)
 
 bool DebuggerBreakpoints::RemoveOffset(const ModuleNameAndOffset& address)
 {
+	std::unique_lock<std::recursive_mutex> lock(m_mutex);
 	if (ContainsOffset(address))
 	{
 		if (auto iter = std::find(m_breakpoints.begin(), m_breakpoints.end(), address); iter != m_breakpoints.end())
+		{
+			std::unique_lock<std::mutex> conditionLock(m_conditionMutex);
+			m_conditions.erase(*iter);
+			conditionLock.unlock();
+			RecordChange(*iter, false);
 			m_breakpoints.erase(iter);
+		}
+		uint64_t remoteAddress = ResolveAddress(address);
+		lock.unlock();
 
 		SerializeMetadata();
 
 		if (m_state->GetAdapter() && m_state->IsConnected())
 		{
-			uint64_t remoteAddress = m_state->GetModules()->RelativeAddressToAbsolute(address);
 			m_state->GetAdapter()->RemoveBreakpoint(remoteAddress);
 			return true;
 		}
@@ -580,15 +684,220 @@ bool DebuggerBreakpoints::RemoveOffset(const ModuleNameAndOffset& address)
 }
 
 
+void DebuggerBreakpoints::RecordChange(const ModuleNameAndOffset& address, bool added)
+{
+	// Enough for the bursts of changes between two updates of a client. A client that falls further behind than this
+	// gets the whole list again, which costs about the same as applying this many changes.
+	static constexpr size_t MaxBreakpointChanges = 0x10000;
+
+	m_version++;
+	m_changes.push_back({m_version, added, address});
+	if (m_changes.size() > MaxBreakpointChanges)
+	{
+		m_resetVersion = m_changes.front().version;
+		m_changes.pop_front();
+	}
+
+	// Another breakpoint may resolve to the same address, so a removal rebuilds the index rather than erasing from it
+	if (!added)
+		m_absoluteAddressesValid = false;
+	else if (m_absoluteAddressesValid)
+		m_absoluteAddresses.emplace(ResolveAddress(address), address);
+}
+
+
+void DebuggerBreakpoints::Reset()
+{
+	m_version++;
+	m_resetVersion = m_version;
+	m_changes.clear();
+	m_absoluteAddressesValid = false;
+}
+
+
+void DebuggerBreakpoints::ValidateModuleBases()
+{
+	uint64_t moduleVersion = m_state->GetModules()->GetVersion();
+	uint64_t viewStart = m_state->GetController()->GetViewFileSegmentsStart();
+	if (m_moduleBasesValid && (moduleVersion == m_moduleBasesVersion) && (viewStart == m_moduleBasesViewStart))
+		return;
+
+	m_moduleBases.clear();
+	m_moduleBasesVersion = moduleVersion;
+	m_moduleBasesViewStart = viewStart;
+	m_moduleBasesValid = true;
+	// The absolute addresses that clients have seen may no longer be right
+	Reset();
+}
+
+
+void DebuggerBreakpoints::ValidateAbsoluteAddresses()
+{
+	ValidateModuleBases();
+	if (m_absoluteAddressesValid)
+		return;
+
+	m_absoluteAddresses.clear();
+	m_absoluteAddresses.reserve(m_breakpoints.size());
+	for (const ModuleNameAndOffset& breakpoint : m_breakpoints)
+		m_absoluteAddresses.emplace(ResolveAddress(breakpoint), breakpoint);
+	m_absoluteAddressesValid = true;
+}
+
+
+uint64_t DebuggerBreakpoints::ResolveAddress(const ModuleNameAndOffset& address)
+{
+	std::unique_lock<std::recursive_mutex> lock(m_mutex);
+	ValidateModuleBases();
+	auto iter = m_moduleBases.find(address.module);
+	if (iter == m_moduleBases.end())
+	{
+		uint64_t base = m_state->GetModules()->RelativeAddressToAbsolute(ModuleNameAndOffset(address.module, 0));
+		iter = m_moduleBases.emplace(address.module, base).first;
+	}
+	return iter->second + address.offset;
+}
+
+
+std::vector<ModuleNameAndOffset> DebuggerBreakpoints::GetBreakpointList() const
+{
+	std::unique_lock<std::recursive_mutex> lock(m_mutex);
+	return m_breakpoints;
+}
+
+
+uint64_t DebuggerBreakpoints::GetVersion() const
+{
+	std::unique_lock<std::recursive_mutex> lock(m_mutex);
+	return m_version;
+}
+
+
+bool DebuggerBreakpoints::GetChangesSince(
+	uint64_t version, std::vector<BreakpointChange>& changes, uint64_t& currentVersion)
+{
+	std::unique_lock<std::recursive_mutex> lock(m_mutex);
+	changes.clear();
+	ValidateModuleBases();
+	currentVersion = m_version;
+	if ((version < m_resetVersion) || (version > m_version))
+		return false;
+
+	auto iter = std::upper_bound(m_changes.begin(), m_changes.end(), version,
+		[](uint64_t version, const BreakpointChange& change) { return version < change.version; });
+	changes.assign(iter, m_changes.end());
+	// Resolved under the lock, so a rebase cannot slip in between the version and the addresses. A removed breakpoint
+	// resolves to where it was, since the addresses have not changed since the version.
+	for (BreakpointChange& change : changes)
+		change.absoluteAddress = ResolveAddress(change.address);
+	return true;
+}
+
+
+size_t DebuggerBreakpoints::AddOffsets(const std::vector<ModuleNameAndOffset>& addresses)
+{
+	// Same as AddOffset() on each of the addresses, but with a single metadata update and a single call to the adapter,
+	// and without the linear search of ContainsOffset() for every one of them
+	std::unique_lock<std::recursive_mutex> lock(m_mutex);
+	bool hasAdapter = m_state->GetAdapter() != nullptr;
+	std::set<ModuleNameAndOffset> existing(m_breakpoints.begin(), m_breakpoints.end());
+	std::unordered_set<uint64_t> existingAbsolute;
+	if (hasAdapter)
+	{
+		for (const ModuleNameAndOffset& breakpoint : m_breakpoints)
+			existingAbsolute.insert(ResolveAddress(breakpoint));
+	}
+
+	std::vector<ModuleNameAndOffset> added;
+	for (const ModuleNameAndOffset& address : addresses)
+	{
+		if (!existing.insert(address).second)
+			continue;
+		if (hasAdapter && !existingAbsolute.insert(ResolveAddress(address)).second)
+			continue;
+		added.push_back(address);
+	}
+
+	if (added.empty())
+		return 0;
+
+	m_breakpoints.insert(m_breakpoints.end(), added.begin(), added.end());
+	for (const ModuleNameAndOffset& address : added)
+		RecordChange(address, true);
+	lock.unlock();
+	SerializeMetadata();
+
+	if (hasAdapter && m_state->IsConnected())
+		m_state->GetAdapter()->AddBreakpoints(added);
+	return added.size();
+}
+
+
+size_t DebuggerBreakpoints::RemoveOffsets(const std::vector<ModuleNameAndOffset>& addresses)
+{
+	// Like ContainsOffset(), compare the absolute addresses when the adapter is created
+	std::unique_lock<std::recursive_mutex> lock(m_mutex);
+	bool hasAdapter = m_state->GetAdapter() != nullptr;
+	std::set<ModuleNameAndOffset> toRemove(addresses.begin(), addresses.end());
+	std::unordered_set<uint64_t> toRemoveAbsolute;
+	if (hasAdapter)
+	{
+		for (const ModuleNameAndOffset& address : toRemove)
+			toRemoveAbsolute.insert(ResolveAddress(address));
+	}
+
+	std::vector<ModuleNameAndOffset> remaining;
+	std::vector<uint64_t> removedAbsolute;
+	std::unique_lock<std::mutex> conditionLock(m_conditionMutex);
+	for (const ModuleNameAndOffset& breakpoint : m_breakpoints)
+	{
+		bool remove;
+		if (hasAdapter)
+		{
+			uint64_t absolute = ResolveAddress(breakpoint);
+			remove = toRemoveAbsolute.find(absolute) != toRemoveAbsolute.end();
+			if (remove)
+				removedAbsolute.push_back(absolute);
+		}
+		else
+		{
+			remove = toRemove.find(breakpoint) != toRemove.end();
+		}
+
+		if (remove)
+		{
+			m_conditions.erase(breakpoint);
+			RecordChange(breakpoint, false);
+		}
+		else
+			remaining.push_back(breakpoint);
+	}
+	conditionLock.unlock();
+
+	size_t count = m_breakpoints.size() - remaining.size();
+	if (count == 0)
+		return 0;
+
+	m_breakpoints = std::move(remaining);
+	lock.unlock();
+	SerializeMetadata();
+
+	if (hasAdapter && m_state->IsConnected())
+		m_state->GetAdapter()->RemoveBreakpoints(removedAbsolute);
+	return count;
+}
+
+
 bool DebuggerBreakpoints::ContainsOffset(const ModuleNameAndOffset& address)
 {
+	std::unique_lock<std::recursive_mutex> lock(m_mutex);
 	// If there is no backend, then only check if the breakpoint is in the list
 	// This is useful when we deal with the breakpoint before the target is launched
 	if (!m_state->GetAdapter())
 		return std::find(m_breakpoints.begin(), m_breakpoints.end(), address) != m_breakpoints.end();
 
 	// When the backend is live, convert the relative address to absolute address and check its existence
-	uint64_t absolute = m_state->GetModules()->RelativeAddressToAbsolute(address);
+	uint64_t absolute = ResolveAddress(address);
 	return ContainsAbsolute(absolute);
 }
 
@@ -598,17 +907,11 @@ bool DebuggerBreakpoints::ContainsAbsolute(uint64_t address)
 	if (!m_state->GetAdapter())
 		return false;
 
-	// We need to convert every ModuleAndOffset to absolute address and compare with the input address
-	// Because every ModuleAndOffset can be converted to an absolute address, but there is no guarantee that it works
-	// backward
-	// Well, that is because lldb does not report the size of the loaded libraries, so it is currently screwed up
-	for (const ModuleNameAndOffset& breakpoint : m_breakpoints)
-	{
-		uint64_t absolute = m_state->GetModules()->RelativeAddressToAbsolute(breakpoint);
-		if (absolute == address)
-			return true;
-	}
-	return false;
+	// Every ModuleAndOffset can be converted to an absolute address, but there is no guarantee that it works backward,
+	// because lldb does not report the size of the loaded libraries. So look the address up among the resolved ones.
+	std::unique_lock<std::recursive_mutex> lock(m_mutex);
+	ValidateAbsoluteAddresses();
+	return m_absoluteAddresses.find(address) != m_absoluteAddresses.end();
 }
 
 
@@ -616,11 +919,22 @@ void DebuggerBreakpoints::SerializeMetadata()
 {
 	// TODO: who should free these Metadata objects?
 	std::vector<Ref<Metadata>> breakpoints;
-	for (const ModuleNameAndOffset& bp : m_breakpoints)
+	for (const ModuleNameAndOffset& bp : GetBreakpointList())
 	{
 		std::map<std::string, Ref<Metadata>> info;
 		info["module"] = new Metadata(bp.module);
 		info["offset"] = new Metadata(bp.offset);
+
+		std::unique_lock<std::mutex> lock(m_conditionMutex);
+		if (auto iter = m_conditions.find(bp); iter != m_conditions.end())
+		{
+			if (iter->second.condition)
+				info["condition"] = new Metadata(iter->second.condition->GetText());
+			if (iter->second.isTracepoint)
+				info["trace"] = new Metadata(iter->second.traceText);
+		}
+		lock.unlock();
+
 		breakpoints.push_back(new Metadata(info));
 	}
 	m_state->GetController()->GetData()->StoreMetadata("debugger.breakpoints", new Metadata(breakpoints));
@@ -635,6 +949,7 @@ void DebuggerBreakpoints::UnserializedMetadata()
 
 	vector<Ref<Metadata>> array = metadata->GetArray();
 	std::vector<ModuleNameAndOffset> newBreakpoints;
+	std::map<ModuleNameAndOffset, BreakpointConditionInfo> newConditions;
 
 	for (auto& element : array)
 	{
@@ -654,9 +969,43 @@ void DebuggerBreakpoints::UnserializedMetadata()
 
 		address.offset = info["offset"]->GetUnsignedInteger();
 		newBreakpoints.push_back(address);
+
+		if (info["condition"] && info["condition"]->IsString())
+		{
+			std::string error;
+			auto condition = BreakpointCondition::Compile(info["condition"]->GetString(), error);
+			if (condition)
+				newConditions[address].condition = condition;
+			else
+				LogWarn("Failed to restore the condition of the breakpoint at %s + 0x%" PRIx64 ": %s",
+					address.module.c_str(), address.offset, error.c_str());
+		}
+
+		if (info["trace"] && info["trace"]->IsString())
+		{
+			std::string error;
+			std::vector<TraceCapture> captures;
+			std::string text = info["trace"]->GetString();
+			if (ParseTraceCaptures(text, captures, error))
+			{
+				auto& conditionInfo = newConditions[address];
+				conditionInfo.isTracepoint = true;
+				conditionInfo.traceText = text;
+				conditionInfo.captures = std::make_shared<const std::vector<TraceCapture>>(std::move(captures));
+			}
+			else
+			{
+				LogWarn("Failed to restore the tracepoint at %s + 0x%" PRIx64 ": %s", address.module.c_str(),
+					address.offset, error.c_str());
+			}
+		}
 	}
 
+	std::unique_lock<std::recursive_mutex> lock(m_mutex);
 	m_breakpoints = newBreakpoints;
+	Reset();
+	std::unique_lock<std::mutex> conditionLock(m_conditionMutex);
+	m_conditions = newConditions;
 }
 
 
@@ -665,8 +1014,546 @@ void DebuggerBreakpoints::Apply()
 	if (!m_state->GetAdapter())
 		return;
 
-	for (const ModuleNameAndOffset& address : m_breakpoints)
-		m_state->GetAdapter()->AddBreakpoint(address);
+	m_state->GetAdapter()->AddBreakpoints(GetBreakpointList());
+}
+
+
+bool DebuggerBreakpoints::SetConditionAbsolute(uint64_t remoteAddress, const std::string& condition)
+{
+	if (!m_state->GetAdapter())
+		return false;
+
+	ModuleNameAndOffset info = m_state->GetModules()->AbsoluteAddressToRelative(remoteAddress);
+	return SetConditionOffset(info, condition);
+}
+
+
+bool DebuggerBreakpoints::SetConditionOffset(const ModuleNameAndOffset& address, const std::string& condition)
+{
+	// Key the condition by the stored breakpoint, since the caller may only have given the base name of the module
+	std::unique_lock<std::recursive_mutex> breakpointLock(m_mutex);
+	auto iter = std::find(m_breakpoints.begin(), m_breakpoints.end(), address);
+	if (iter == m_breakpoints.end())
+		return false;
+	ModuleNameAndOffset key = *iter;
+	breakpointLock.unlock();
+
+	std::shared_ptr<BreakpointCondition> compiled;
+	if (!condition.empty())
+	{
+		std::string error;
+		compiled = BreakpointCondition::Compile(condition, error);
+		if (!compiled)
+		{
+			LogWarn("Invalid breakpoint condition \"%s\": %s", condition.c_str(), error.c_str());
+			return false;
+		}
+	}
+
+	std::unique_lock<std::mutex> lock(m_conditionMutex);
+	auto& info = m_conditions[key];
+	info.condition = compiled;
+	info.hitCount = 0;
+	info.skipCount = 0;
+	EraseConditionInfoIfUnused(key);
+	lock.unlock();
+
+	SerializeMetadata();
+	return true;
+}
+
+
+bool DebuggerBreakpoints::SetTracepointAbsolute(uint64_t remoteAddress, bool isTracepoint, const std::string& captures)
+{
+	if (!m_state->GetAdapter())
+		return false;
+
+	ModuleNameAndOffset info = m_state->GetModules()->AbsoluteAddressToRelative(remoteAddress);
+	return SetTracepointOffset(info, isTracepoint, captures);
+}
+
+
+bool DebuggerBreakpoints::SetTracepointOffset(
+	const ModuleNameAndOffset& address, bool isTracepoint, const std::string& captures)
+{
+	std::unique_lock<std::recursive_mutex> breakpointLock(m_mutex);
+	auto iter = std::find(m_breakpoints.begin(), m_breakpoints.end(), address);
+	if (iter == m_breakpoints.end())
+		return false;
+	ModuleNameAndOffset key = *iter;
+	breakpointLock.unlock();
+
+	std::vector<TraceCapture> parsed;
+	if (isTracepoint)
+	{
+		std::string error;
+		if (!ParseTraceCaptures(captures, parsed, error))
+		{
+			LogWarn("Invalid tracepoint captures \"%s\": %s", captures.c_str(), error.c_str());
+			return false;
+		}
+	}
+
+	std::unique_lock<std::mutex> lock(m_conditionMutex);
+	auto& info = m_conditions[key];
+	info.isTracepoint = isTracepoint;
+	info.traceText = isTracepoint ? captures : "";
+	info.captures =
+		isTracepoint ? std::make_shared<const std::vector<TraceCapture>>(std::move(parsed)) : nullptr;
+	info.hitCount = 0;
+	info.skipCount = 0;
+	EraseConditionInfoIfUnused(key);
+	lock.unlock();
+
+	SerializeMetadata();
+	return true;
+}
+
+
+void DebuggerBreakpoints::EraseConditionInfoIfUnused(const ModuleNameAndOffset& address)
+{
+	// A plain breakpoint has no entry, which keeps HasConditions() a cheap test on the common path
+	if (auto iter = m_conditions.find(address); iter != m_conditions.end())
+	{
+		if (!iter->second.condition && !iter->second.isTracepoint)
+			m_conditions.erase(iter);
+	}
+}
+
+
+BreakpointConditionInfo DebuggerBreakpoints::GetConditionInfo(const ModuleNameAndOffset& address)
+{
+	std::unique_lock<std::mutex> lock(m_conditionMutex);
+	if (auto iter = m_conditions.find(address); iter != m_conditions.end())
+		return iter->second;
+	return {};
+}
+
+
+bool DebuggerBreakpoints::HasConditions()
+{
+	std::unique_lock<std::mutex> lock(m_conditionMutex);
+	return !m_conditions.empty();
+}
+
+
+bool DebuggerBreakpoints::ShouldStopAt(uint64_t remoteAddress, const BreakpointCondition::Context& context,
+	const std::function<std::uint32_t()>& getThreadId)
+{
+	std::unique_lock<std::recursive_mutex> breakpointLock(m_mutex);
+	ValidateAbsoluteAddresses();
+	auto breakpoint = m_absoluteAddresses.find(remoteAddress);
+	if (breakpoint == m_absoluteAddresses.end())
+		return true;
+	auto key = breakpoint->second;
+	breakpointLock.unlock();
+
+	std::unique_lock<std::mutex> lock(m_conditionMutex);
+	auto iter = m_conditions.find(key);
+	if (iter == m_conditions.end())
+		return true;
+
+	auto condition = iter->second.condition;
+	auto captures = iter->second.captures;
+	// Evaluating reads from the target, so do not hold the lock meanwhile
+	lock.unlock();
+
+	bool hit = true;
+	if (condition)
+	{
+		uint64_t value = 0;
+		bool evaluated = condition->Evaluate(context, value);
+		if (!evaluated)
+			LogWarn("Failed to evaluate the breakpoint condition \"%s\" at 0x%" PRIx64 ", stopping",
+				condition->GetText().c_str(), remoteAddress);
+		hit = !evaluated || (value != 0);
+	}
+
+	bool stop = hit;
+	if (hit && captures)
+	{
+		TraceRecord record;
+		record.address = remoteAddress;
+		record.threadId = getThreadId();
+		auto now = std::chrono::steady_clock::now().time_since_epoch();
+		record.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+		record.values.resize(captures->size());
+		for (size_t i = 0; i < captures->size(); i++)
+		{
+			const auto& capture = (*captures)[i];
+			auto& value = record.values[i];
+			value.valid = capture.expression->Evaluate(context, value.value);
+			if (value.valid && capture.size)
+				value.valid = context.readMemory(value.value, capture.size, value.data) &&
+					(value.data.size() == capture.size);
+		}
+		m_traceBuffer.Push(std::move(record));
+		stop = false;
+	}
+
+	lock.lock();
+	// The breakpoint may have been changed or removed in the meantime; only count against the one evaluated
+	iter = m_conditions.find(key);
+	if ((iter != m_conditions.end()) && (iter->second.condition == condition) && (iter->second.captures == captures))
+	{
+		if (hit)
+			iter->second.hitCount++;
+		else
+			iter->second.skipCount++;
+	}
+	return stop;
+}
+
+
+DebuggerWatchpoints::DebuggerWatchpoints(DebuggerState* state) :
+	m_state(state), m_hits(Settings::Instance()->Get<uint64_t>("debugger.watchpointBufferSize"))
+{}
+
+
+bool DebuggerWatchpoints::ReadValue(uint64_t address, size_t size, uint64_t& value)
+{
+	// The memory cache is only refreshed once a stop surfaces, so read from the adapter directly
+	DataBuffer buffer = m_state->GetAdapter()->ReadMemory(address, size);
+	if (buffer.GetLength() != size)
+		return false;
+
+	auto arch = m_state->GetRemoteArchitecture();
+	bool littleEndian = !arch || (arch->GetEndianness() == LittleEndian);
+	auto bytes = (const uint8_t*)buffer.GetData();
+	value = 0;
+	for (size_t i = 0; i < size; i++)
+		value |= (uint64_t)bytes[i] << (8 * (littleEndian ? i : (size - 1 - i)));
+	return true;
+}
+
+
+bool DebuggerWatchpoints::Add(uint64_t address, size_t size, DebugWatchpointType type, bool record)
+{
+	if (!m_state->GetAdapter() || !m_state->IsConnected())
+		return false;
+
+	if ((size != 1) && (size != 2) && (size != 4) && (size != 8))
+	{
+		LogWarn("Invalid watchpoint size %zu, it must be 1, 2, 4 or 8", size);
+		return false;
+	}
+
+	WatchpointInfo info;
+	info.address = address;
+	info.size = size;
+	info.type = type;
+	info.record = record;
+	ReadValue(address, size, info.lastValue);
+
+	// In the list before the adapter reports the watchpoint, so the event does not track it a second time
+	std::unique_lock<std::mutex> lock(m_mutex);
+	if (std::any_of(m_watchpoints.begin(), m_watchpoints.end(),
+			[&](const WatchpointInfo& existing) { return existing.address == address; }))
+		return false;
+	m_watchpoints.push_back(info);
+	lock.unlock();
+
+	if (!m_state->GetAdapter()->AddWatchpoint(address, size, type))
+	{
+		Forget(address);
+		return false;
+	}
+	return true;
+}
+
+
+bool DebuggerWatchpoints::Remove(uint64_t address)
+{
+	if (!Contains(address))
+		return false;
+
+	Forget(address);
+	if (m_state->GetAdapter() && m_state->IsConnected())
+		m_state->GetAdapter()->RemoveWatchpoint(address);
+	return true;
+}
+
+
+void DebuggerWatchpoints::Track(uint64_t address, size_t size, DebugWatchpointType type)
+{
+	WatchpointInfo info;
+	info.address = address;
+	info.size = size;
+	info.type = type;
+	if (m_state->GetAdapter())
+		ReadValue(address, size, info.lastValue);
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	if (std::none_of(m_watchpoints.begin(), m_watchpoints.end(),
+			[&](const WatchpointInfo& existing) { return existing.address == address; }))
+		m_watchpoints.push_back(info);
+}
+
+
+void DebuggerWatchpoints::Forget(uint64_t address)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_watchpoints.erase(std::remove_if(m_watchpoints.begin(), m_watchpoints.end(),
+							[&](const WatchpointInfo& info) { return info.address == address; }),
+		m_watchpoints.end());
+}
+
+
+bool DebuggerWatchpoints::Contains(uint64_t address)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	return std::any_of(m_watchpoints.begin(), m_watchpoints.end(),
+		[&](const WatchpointInfo& info) { return info.address == address; });
+}
+
+
+void DebuggerWatchpoints::Clear()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_watchpoints.clear();
+}
+
+
+std::vector<WatchpointInfo> DebuggerWatchpoints::GetWatchpointList()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	return m_watchpoints;
+}
+
+
+bool DebuggerWatchpoints::ShouldStopAt(uint64_t address, uint64_t pc, std::uint32_t threadId)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	auto iter = std::find_if(m_watchpoints.begin(), m_watchpoints.end(),
+		[&](const WatchpointInfo& info) { return info.address == address; });
+	// E.g., a watchpoint set from the backend console
+	if (iter == m_watchpoints.end())
+		return true;
+
+	size_t size = iter->size;
+	lock.unlock();
+
+	// Hardware watchpoints trigger after the access, so the memory already holds the new value
+	uint64_t newValue = 0;
+	bool valid = ReadValue(address, size, newValue);
+
+	lock.lock();
+	iter = std::find_if(m_watchpoints.begin(), m_watchpoints.end(),
+		[&](const WatchpointInfo& info) { return info.address == address; });
+	if (iter == m_watchpoints.end())
+		return true;
+
+	iter->hitCount++;
+	uint64_t oldValue = iter->lastValue;
+	if (valid)
+		iter->lastValue = newValue;
+	if (!iter->record)
+		return true;
+	lock.unlock();
+
+	WatchpointHitRecord record;
+	record.address = address;
+	record.pc = pc;
+	record.threadId = threadId;
+	auto now = std::chrono::steady_clock::now().time_since_epoch();
+	record.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+	record.oldValue = oldValue;
+	record.newValue = valid ? newValue : oldValue;
+	m_hits.Push(std::move(record));
+	return false;
+}
+
+
+DebuggerCoverage::DebuggerCoverage(DebuggerState* state) : m_state(state) {}
+
+
+size_t DebuggerCoverage::AddFunctions(const std::vector<uint64_t>& functions)
+{
+	Ref<BinaryView> data = m_state->GetController()->GetData();
+	uint64_t viewStart = m_state->GetController()->GetViewFileSegmentsStart();
+
+	std::vector<Ref<Function>> funcs;
+	if (functions.empty())
+	{
+		funcs = data->GetAnalysisFunctionList();
+	}
+	else
+	{
+		for (uint64_t address : functions)
+		{
+			for (const auto& func : data->GetAnalysisFunctionsForAddress(address))
+				funcs.push_back(func);
+		}
+	}
+
+	std::vector<uint64_t> offsets;
+	for (const auto& func : funcs)
+	{
+		for (const auto& block : func->GetBasicBlocks())
+			offsets.push_back(block->GetStart() - viewStart);
+	}
+	std::sort(offsets.begin(), offsets.end());
+	offsets.erase(std::unique(offsets.begin(), offsets.end()), offsets.end());
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	std::vector<uint64_t> added;
+	std::set_difference(offsets.begin(), offsets.end(), m_blocks.begin(), m_blocks.end(), std::back_inserter(added));
+	if (added.empty())
+		return 0;
+
+	std::vector<uint64_t> merged;
+	merged.reserve(m_blocks.size() + added.size());
+	std::merge(m_blocks.begin(), m_blocks.end(), added.begin(), added.end(), std::back_inserter(merged));
+	m_blocks = std::move(merged);
+
+	// The indices of the blocks changed, so the bitmap is rebuilt from the list of hits
+	m_hitBits.assign((m_blocks.size() + 63) / 64, 0);
+	for (uint64_t offset : m_hits)
+	{
+		size_t index = std::lower_bound(m_blocks.begin(), m_blocks.end(), offset) - m_blocks.begin();
+		m_hitBits[index / 64] |= (uint64_t)1 << (index % 64);
+	}
+	lock.unlock();
+
+	// Otherwise, they are planted along with the breakpoints when the target is launched
+	if (m_state->IsConnected())
+		Plant(added);
+	return added.size();
+}
+
+
+void DebuggerCoverage::Plant(const std::vector<uint64_t>& offsets)
+{
+	DebugAdapter* adapter = m_state->GetAdapter();
+	if (!adapter || offsets.empty())
+		return;
+
+	std::string module = m_state->GetInputFile();
+	std::vector<ModuleNameAndOffset> breakpoints;
+	breakpoints.reserve(offsets.size());
+	for (uint64_t offset : offsets)
+		breakpoints.emplace_back(module, offset);
+	adapter->AddOneShotBreakpoints(breakpoints);
+}
+
+
+void DebuggerCoverage::Apply()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	// The target may be loaded at a different address this time
+	m_remoteBase.reset();
+	std::vector<uint64_t> remaining;
+	for (size_t i = 0; i < m_blocks.size(); i++)
+	{
+		if (!IsHit(i))
+			remaining.push_back(m_blocks[i]);
+	}
+	lock.unlock();
+
+	Plant(remaining);
+}
+
+
+bool DebuggerCoverage::RecordHit(uint64_t remoteAddress, bool& firstHit)
+{
+	firstHit = false;
+	std::unique_lock<std::mutex> lock(m_mutex);
+	if (m_blocks.empty())
+		return false;
+
+	if (!m_remoteBase.has_value())
+	{
+		ModuleNameAndOffset base(m_state->GetInputFile(), 0);
+		m_remoteBase = m_state->GetModules()->RelativeAddressToAbsolute(base);
+	}
+
+	uint64_t offset = remoteAddress - *m_remoteBase;
+	auto iter = std::lower_bound(m_blocks.begin(), m_blocks.end(), offset);
+	if ((iter == m_blocks.end()) || (*iter != offset))
+		return false;
+
+	size_t index = iter - m_blocks.begin();
+	if (!IsHit(index))
+	{
+		m_hitBits[index / 64] |= (uint64_t)1 << (index % 64);
+		m_hits.push_back(offset);
+		firstHit = true;
+	}
+	return true;
+}
+
+
+void DebuggerCoverage::Clear()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	std::vector<uint64_t> remaining;
+	for (size_t i = 0; i < m_blocks.size(); i++)
+	{
+		if (!IsHit(i))
+			remaining.push_back(m_blocks[i]);
+	}
+	m_blocks.clear();
+	m_hitBits.clear();
+	m_hits.clear();
+	m_remoteBase.reset();
+	lock.unlock();
+
+	DebugAdapter* adapter = m_state->GetAdapter();
+	if (!adapter || !m_state->IsConnected() || remaining.empty())
+		return;
+
+	// Remove the breakpoints of the blocks that were never hit, but not the user breakpoints at the same addresses
+	DebuggerBreakpoints* breakpoints = m_state->GetBreakpoints();
+	std::unordered_set<uint64_t> userBreakpoints;
+	for (const ModuleNameAndOffset& breakpoint : breakpoints->GetBreakpointList())
+		userBreakpoints.insert(breakpoints->ResolveAddress(breakpoint));
+
+	uint64_t base = breakpoints->ResolveAddress(ModuleNameAndOffset(m_state->GetInputFile(), 0));
+	std::vector<uint64_t> addresses;
+	addresses.reserve(remaining.size());
+	for (uint64_t offset : remaining)
+	{
+		if (userBreakpoints.find(base + offset) == userBreakpoints.end())
+			addresses.push_back(base + offset);
+	}
+	adapter->RemoveBreakpoints(addresses);
+}
+
+
+bool DebuggerCoverage::IsEmpty()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	return m_blocks.empty();
+}
+
+
+size_t DebuggerCoverage::GetBlockCount()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	return m_blocks.size();
+}
+
+
+size_t DebuggerCoverage::GetHitCount()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	return m_hits.size();
+}
+
+
+std::vector<uint64_t> DebuggerCoverage::GetHits(size_t start)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	if (start >= m_hits.size())
+		return {};
+	return std::vector<uint64_t>(m_hits.begin() + start, m_hits.end());
+}
+
+
+std::vector<uint64_t> DebuggerCoverage::GetBlocks()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	return m_blocks;
 }
 
 
@@ -676,6 +1563,7 @@ DebuggerMemory::DebuggerMemory(DebuggerState* state) : m_state(state) {}
 void DebuggerMemory::MarkDirty()
 {
 	std::unique_lock<std::recursive_mutex> memoryLock(m_memoryMutex);
+	m_state->InvalidateCacheGeneration();
 	for (auto& it: m_valueCache)
 	{
 		if (it.second.status == UpToDateStatus)
@@ -686,7 +1574,57 @@ void DebuggerMemory::MarkDirty()
 }
 
 
-DataBuffer DebuggerMemory::ReadBlock(uint64_t block)
+bool DebuggerMemory::ShouldReadBlock(uint64_t block)
+{
+	auto iter = m_valueCache.find(block);
+	if (iter == m_valueCache.end())
+		return true;
+	return (iter->second.status == DefaultStatus) || (iter->second.status == OutOfDateStatus);
+}
+
+
+// Reads every run of consecutive blocks that are not cached with a single adapter call, rather than one call per block.
+// A run that cannot be read in full is left to GetBlock(), which reads it block by block and records the ones that fail.
+void DebuggerMemory::ReadBlocks(uint64_t start, uint64_t end)
+{
+	// Large reads are split, so a scan of a huge region does not hold a copy of all of it at once
+	static constexpr uint64_t MaxBlocksPerRead = 0x1000;
+
+	if (!m_state->IsConnected() || m_state->IsRunning())
+		return;
+
+	uint64_t block = start;
+	while (block < end)
+	{
+		if (!ShouldReadBlock(block))
+		{
+			block += 0x100;
+			continue;
+		}
+
+		uint64_t runStart = block;
+		while ((block < end) && ((block - runStart) < MaxBlocksPerRead * 0x100) && ShouldReadBlock(block))
+			block += 0x100;
+
+		size_t runLength = block - runStart;
+		if (runLength == 0x100)
+			continue;
+
+		DataBuffer buffer = m_state->GetAdapter()->ReadMemory(runStart, runLength);
+		if (buffer.GetLength() != runLength)
+			continue;
+
+		ExecutionJournal* journal = m_state->GetJournal();
+		if (journal->IsReplaying())
+			journal->RestoreMemory(journal->GetPosition(), runStart, (uint8_t*)buffer.GetData(), runLength);
+
+		for (size_t offset = 0; offset < runLength; offset += 0x100)
+			m_valueCache[runStart + offset] = {buffer.GetSlice(offset, 0x100), UpToDateStatus};
+	}
+}
+
+
+const DataBuffer* DebuggerMemory::GetBlock(uint64_t block)
 {
 	auto iter = m_valueCache.find(block);
 	if (iter != m_valueCache.end())
@@ -694,13 +1632,13 @@ DataBuffer DebuggerMemory::ReadBlock(uint64_t block)
 		switch (iter->second.status)
 		{
 		case FailedToReadStatus:
-			return {};
+			return nullptr;
 		case OutOfDateStatus:
 		{
 			if (m_state->IsConnected() && m_state->IsRunning())
 			{
 				// The cache is old but the target is running, return old value
-				return iter->second.value;
+				return &iter->second.value;
 			}
 			// Break out and try to read the new value
 			break;
@@ -708,7 +1646,7 @@ DataBuffer DebuggerMemory::ReadBlock(uint64_t block)
 		case UpToDateStatus:
 		{
 			// Cache is up-to-date, return the value
-			return iter->second.value;
+			return &iter->second.value;
 		}
 		case DefaultStatus:
 			// There is no useful information about the status, break out and try to read it
@@ -723,23 +1661,46 @@ DataBuffer DebuggerMemory::ReadBlock(uint64_t block)
 		DataBuffer buffer = m_state->GetAdapter()->ReadMemory(block, 0x100);
 		if (buffer.GetLength() > 0)
 		{
+			// While replaying, this is the memory at the current position of the execution journal
+			ExecutionJournal* journal = m_state->GetJournal();
+			if (journal->IsReplaying())
+				journal->RestoreMemory(journal->GetPosition(), block, (uint8_t*)buffer.GetData(), buffer.GetLength());
+
 			// Successfully updated
-			m_valueCache[block] = {buffer, UpToDateStatus};
-			return buffer;
+			auto& entry = m_valueCache[block];
+			entry = {buffer, UpToDateStatus};
+			return &entry.value;
 		}
 	}
 
 	// Update failed
 	m_valueCache[block] = {{}, FailedToReadStatus};
-	return {};
+	return nullptr;
 }
 
 
-DataBuffer DebuggerMemory::ReadMemory(uint64_t offset, size_t len)
+DataBuffer DebuggerMemory::ReadBlock(uint64_t block)
 {
 	std::unique_lock<std::recursive_mutex> memoryLock(m_memoryMutex);
 
-	DataBuffer result;
+	const DataBuffer* cached = GetBlock(block);
+	if (!cached)
+		return {};
+	return *cached;
+}
+
+
+DataBuffer DebuggerMemory::ReadMemory(uint64_t offset, size_t len)
+{
+	DataBuffer result(len);
+	result.SetSize(ReadMemory(offset, result.GetData(), len));
+	return result;
+}
+
+
+size_t DebuggerMemory::ReadMemory(uint64_t offset, void* dest, size_t len)
+{
+	std::unique_lock<std::recursive_mutex> memoryLock(m_memoryMutex);
 
 	// ProcessView implements read caching in a manner inspired by CPU cache:
 	// Reads are aligned on 256-byte boundaries and 256 bytes long
@@ -748,27 +1709,29 @@ DataBuffer DebuggerMemory::ReadMemory(uint64_t offset, size_t len)
 	size_t cacheStart = offset & (~0xffLL);
 	// Cache read end: round up addr+length to nearest 256 byte boundary
 	size_t cacheEnd = (offset + len + 0xFF) & (~0xffLL);
-	// List of 256-byte block addresses to read into the cache to fully cover this region
+	ReadBlocks(cacheStart, cacheEnd);
+
+	// The blocks are copied straight out of the cache, without building a DataBuffer for every one of them
+	size_t copied = 0;
 	for (uint64_t block = cacheStart; block < cacheEnd; block += 0x100)
 	{
-		auto cached = ReadBlock(block);
-		if (cached.GetLength() == 0)
-			return result;
-
-		if (offset + len < block + cached.GetLength())
-		{
-			// Last block
-			cached = cached.GetSlice(0, offset + len - block);
-		}
-		// Note a block can be both the fist and the last block, so we should not put an else here
-		if (offset > block)
-		{
-			// First block
-			cached = cached.GetSlice(offset - block, cached.GetLength() - (offset - block));
-		}
-		result.Append(cached);
+		const DataBuffer* cached = GetBlock(block);
+		if (!cached || (cached->GetLength() == 0))
+			return copied;
+
+		// Note a block can be both the fist and the last block
+		uint64_t start = std::max<uint64_t>(offset, block);
+		uint64_t end = std::min<uint64_t>(offset + len, block + cached->GetLength());
+		if (end <= start)
+			return copied;
+
+		memcpy((uint8_t*)dest + (start - offset), (const uint8_t*)cached->GetData() + (start - block), end - start);
+		copied += end - start;
+		// A short block means the memory after it could not be read
+		if (block + cached->GetLength() < std::min<uint64_t>(offset + len, block + 0x100))
+			return copied;
 	}
-	return result;
+	return copied;
 }
 
 
@@ -780,6 +1743,9 @@ bool DebuggerMemory::WriteMemory(std::uintptr_t address, const DataBuffer& buffe
 	if (!adapter)
 		return false;
 
+	if (!m_state->CanModifyTarget())
+		return false;
+
 	if (!adapter->WriteMemory(address, buffer))
 		return false;
 
@@ -799,7 +1765,11 @@ DebuggerState::DebuggerState(BinaryViewRef data, DebuggerController* controller)
 	m_threads = new DebuggerThreads(this);
 	m_breakpoints = new DebuggerBreakpoints(this);
 	m_breakpoints->UnserializedMetadata();
+	m_watchpoints = new DebuggerWatchpoints(this);
+	m_coverage = new DebuggerCoverage(this);
 	m_memory = new DebuggerMemory(this);
+	m_journal = new ExecutionJournal(
+		Settings::Instance()->Get<uint64_t>("debugger.executionJournalSize") * 1024 * 1024);
 
 	// TODO: A better way to deal with this is to have the adapters return a fitness score, and then we pick the highest
 	// one from the list. Similar to what we do for the views.
@@ -892,7 +1862,10 @@ DebuggerState::~DebuggerState()
 	delete m_registers;
 	delete m_threads;
 	delete m_breakpoints;
+	delete m_watchpoints;
+	delete m_coverage;
 	delete m_memory;
+	delete m_journal;
 }
 
 
@@ -925,6 +1898,9 @@ uint64_t DebuggerState::IP()
 	if (!IsConnected())
 		return 0;
 
+	if (m_journal->IsReplaying())
+		return m_journal->GetIP(m_journal->GetPosition());
+
 	return m_adapter->GetInstructionOffset();
 }
 
@@ -935,10 +1911,32 @@ uint64_t DebuggerState::StackPointer()
 	if (!IsConnected())
 		return 0;
 
+	if (m_journal->IsReplaying())
+		return m_journal->GetSP(m_journal->GetPosition());
+
 	return m_adapter->GetStackPointer();
 }
 
 
+bool DebuggerState::CanModifyTarget()
+{
+	if (m_journal->IsReplaying())
+	{
+		LogWarn("Cannot modify the target while replaying the execution journal. Step or run forward to the end of "
+				"the journal first.");
+		return false;
+	}
+
+	// The recorded history does not know about the change, so it cannot be replayed past it
+	if (m_journal->GetStepCount() > 0)
+	{
+		LogDebug("The target is modified, discarding the execution journal");
+		m_journal->Clear();
+	}
+	return true;
+}
+
+
 bool DebuggerState::SetActiveThread(const DebugThread& thread)
 {
 	if (!m_threads)
@@ -985,6 +1983,7 @@ bool DebuggerState::GetRemoteBase(uint64_t& address)
 void DebuggerState::ApplyBreakpoints()
 {
 	m_breakpoints->Apply();
+	m_coverage->Apply();
 }
 
 
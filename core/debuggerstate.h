@@ -20,9 +20,16 @@ limitations under the License.
 #include "ui/uitypes.h"
 #include "debugadaptertype.h"
 #include "debuggercommon.h"
+#include "breakpointcondition.h"
+#include "tracepoint.h"
+#include "executionjournal.h"
+#include "registermap.h"
 #include "semaphore.h"
 #include "ffi_global.h"
 #include "refcountobject.h"
+#include <atomic>
+#include <deque>
+#include <unordered_map>
 
 DECLARE_DEBUGGER_API_OBJECT(BNDebuggerState, DebuggerState);
 
@@ -37,17 +44,27 @@ namespace BinaryNinjaDebugger {
 	private:
 		DebuggerState* m_state;
 		std::unordered_map<std::string, DebugRegister> m_registerCache;
+		// The same values as m_registerCache, indexed by the slots of m_registerMap
+		std::vector<std::optional<uint64_t>> m_registerValues;
+		RegisterMap m_registerMap;
 		bool m_dirty;
 
 	public:
 		DebuggerRegisters(DebuggerState* state);
 		// DebugRegister operator[](std::string name);
 		uint64_t GetRegisterValue(const std::string& name);
+		// Looks up a register of the architecture by its index, without going through its name. Returns false if the
+		// adapter does not report the register.
+		bool GetRegisterValue(uint32_t archRegister, uint64_t& value);
 		bool SetRegisterValue(const std::string& name, uint64_t value);
+		// Discards the register map, which is rebuilt at the next update. Call this when the session ends.
+		void ResetRegisterMap() { m_registerMap.Clear(); }
 		void MarkDirty();
 		bool IsDirty() const { return m_dirty; }
 		void Update();
-		std::vector<DebugRegister> GetAllRegisters();
+		// Computing the hints reads target memory for every distinct register value, so callers that only need the
+		// values (or that compute hints on their own schedule) should pass computeHints = false
+		std::vector<DebugRegister> GetAllRegisters(bool computeHints = true);
 	};
 
 
@@ -57,12 +74,18 @@ namespace BinaryNinjaDebugger {
 		DebuggerState* m_state;
 		std::vector<DebugModule> m_modules;
 		bool m_dirty;
+		// The modules are marked dirty on every stop, but they rarely change. The version is only bumped when the list
+		// is actually different from the one it was last computed for, so callers can cache what they derive from it.
+		std::vector<DebugModule> m_versionedModules;
+		uint64_t m_version = 0;
+		bool m_versionStale = true;
 
 	public:
 		DebuggerModules(DebuggerState* state);
 		void MarkDirty();
 		void Update();
 		bool IsDirty() const { return m_dirty; }
+		uint64_t GetVersion();
 
 		std::vector<DebugModule> GetAllModules();
 		// TODO: These conversion functions are not very robust for lookup failures. They need to be improved for it.
@@ -74,24 +97,211 @@ namespace BinaryNinjaDebugger {
 	};
 
 
+	// The condition and tracing configuration of a breakpoint, and its counters. A hit is a stop that satisfied the
+	// condition, or whose condition could not be evaluated; a skip is a stop that was resumed because the condition
+	// did not hold. A tracepoint records every hit into the trace buffer and resumes the target instead of stopping.
+	struct BreakpointConditionInfo
+	{
+		std::shared_ptr<BreakpointCondition> condition;
+		bool isTracepoint = false;
+		std::string traceText;
+		std::shared_ptr<const std::vector<TraceCapture>> captures;
+		uint64_t hitCount = 0;
+		uint64_t skipCount = 0;
+	};
+
+
+	struct BreakpointChange
+	{
+		// The breakpoint version right after the change
+		uint64_t version = 0;
+		bool added = false;
+		ModuleNameAndOffset address;
+		// Filled in by GetChangesSince(), from the same module bases as the version it returns
+		uint64_t absoluteAddress = 0;
+	};
+
+
 	class DebuggerBreakpoints
 	{
 	private:
 		DebuggerState* m_state;
+		// Guards the breakpoint list, the change log and the module bases below. The breakpoints are changed from the
+		// UI and the API, and looked up from the thread that waits for the adapter. It is not held while the breakpoints
+		// are sent to the adapter or the metadata is stored. Taken before m_conditionMutex.
+		mutable std::recursive_mutex m_mutex;
 		std::vector<ModuleNameAndOffset> m_breakpoints;
 
+		// Bumped on every change to m_breakpoints. The most recent changes are kept, so a client that has already seen
+		// a version only needs to apply what happened since then, e.g., the breakpoints widget.
+		uint64_t m_version = 0;
+		std::deque<BreakpointChange> m_changes;
+		// Changes at or before this version are no longer available, e.g., because the log was trimmed, the list was
+		// reloaded, or the absolute addresses of all breakpoints changed. A client older than it must start over.
+		uint64_t m_resetVersion = 0;
+
+		// The absolute address of every module that a breakpoint refers to, so resolving a breakpoint does not scan the
+		// module list. Valid as long as the module list and the start of the view do not change.
+		std::unordered_map<std::string, uint64_t> m_moduleBases;
+		uint64_t m_moduleBasesVersion = 0;
+		uint64_t m_moduleBasesViewStart = 0;
+		bool m_moduleBasesValid = false;
+
+		// The breakpoints by their absolute address, so a hit is looked up without resolving every breakpoint. Built
+		// with ResolveAddress() on first use, and dropped along with the module bases or when a breakpoint is removed.
+		std::unordered_map<uint64_t, ModuleNameAndOffset> m_absoluteAddresses;
+		bool m_absoluteAddressesValid = false;
+
+		void EraseConditionInfoIfUnused(const ModuleNameAndOffset& address);
+		// These must be called with m_mutex held
+		void RecordChange(const ModuleNameAndOffset& address, bool added);
+		void Reset();
+		void ValidateModuleBases();
+		void ValidateAbsoluteAddresses();
+		// Keyed by the entries of m_breakpoints. Conditions are evaluated on the thread that waits for the adapter,
+		// so this is guarded separately.
+		std::map<ModuleNameAndOffset, BreakpointConditionInfo> m_conditions;
+		std::mutex m_conditionMutex;
+		TraceBuffer<TraceRecord> m_traceBuffer;
+
 	public:
 		DebuggerBreakpoints(DebuggerState* state, std::vector<ModuleNameAndOffset> initial = {});
 		bool AddAbsolute(uint64_t remoteAddress);
 		bool AddOffset(const ModuleNameAndOffset& address);
 		bool RemoveAbsolute(uint64_t remoteAddress);
 		bool RemoveOffset(const ModuleNameAndOffset& address);
+		// Add or remove many breakpoints at once, e.g., to restore a saved set of coverage breakpoints. Both return
+		// the number of breakpoints actually added or removed.
+		size_t AddOffsets(const std::vector<ModuleNameAndOffset>& addresses);
+		size_t RemoveOffsets(const std::vector<ModuleNameAndOffset>& addresses);
 		bool ContainsAbsolute(uint64_t address);
 		bool ContainsOffset(const ModuleNameAndOffset& address);
 		void Apply();
 		void SerializeMetadata();
 		void UnserializedMetadata();
-		std::vector<ModuleNameAndOffset> GetBreakpointList() const { return m_breakpoints; }
+		std::vector<ModuleNameAndOffset> GetBreakpointList() const;
+		// Same as DebuggerModules::RelativeAddressToAbsolute(), but cached until the modules change
+		uint64_t ResolveAddress(const ModuleNameAndOffset& address);
+		uint64_t GetVersion() const;
+		// Returns false if the changes since the version are not all available, in which case the client must get the
+		// whole list again. Also returns false if the absolute address of any breakpoint has changed since then.
+		// currentVersion receives the version the changes bring the client to.
+		bool GetChangesSince(uint64_t version, std::vector<BreakpointChange>& changes, uint64_t& currentVersion);
+
+		// An empty condition turns the breakpoint back into an unconditional one. Returns false if there is no
+		// breakpoint at the address, or if the condition does not compile.
+		bool SetConditionAbsolute(uint64_t remoteAddress, const std::string& condition);
+		bool SetConditionOffset(const ModuleNameAndOffset& address, const std::string& condition);
+		// Turns the breakpoint into a tracepoint recording the given captures (see ParseTraceCaptures), or back into
+		// a regular breakpoint. Returns false if there is no breakpoint at the address, or if a capture is invalid.
+		bool SetTracepointAbsolute(uint64_t remoteAddress, bool isTracepoint, const std::string& captures);
+		bool SetTracepointOffset(const ModuleNameAndOffset& address, bool isTracepoint, const std::string& captures);
+		BreakpointConditionInfo GetConditionInfo(const ModuleNameAndOffset& address);
+		bool HasConditions();
+		// Evaluates the condition of the breakpoint at the address, if it has one, and updates its counters. A
+		// tracepoint whose condition holds is recorded into the trace buffer, and false is returned for it.
+		// The controller only calls it when the target stops while running, i.e., Go, run to and launch. A step
+		// that hits a breakpoint always stops there, since the adapter cannot resume the step.
+		bool ShouldStopAt(uint64_t remoteAddress, const BreakpointCondition::Context& context,
+			const std::function<std::uint32_t()>& getThreadId);
+		TraceBuffer<TraceRecord>* GetTraceBuffer() { return &m_traceBuffer; }
+	};
+
+
+	struct WatchpointInfo
+	{
+		uint64_t address = 0;
+		size_t size = 0;
+		DebugWatchpointType type = WriteWatchpoint;
+		// Record the hits and resume the target, rather than stopping it
+		bool record = false;
+		uint64_t hitCount = 0;
+		// The value at the previous hit, or when the watchpoint was added, which is the old value of the next hit
+		uint64_t lastValue = 0;
+	};
+
+
+	struct WatchpointHitRecord
+	{
+		uint64_t address = 0;
+		// The instruction pointer when the target stopped. On x86, this is after the instruction that made the access.
+		uint64_t pc = 0;
+		std::uint32_t threadId = 0;
+		// Nanoseconds of a monotonic clock, like TraceRecord::timestamp
+		uint64_t timestamp = 0;
+		uint64_t oldValue = 0;
+		uint64_t newValue = 0;
+	};
+
+
+	// Hardware watchpoints only live as long as the process, so unlike breakpoints they use absolute addresses and are
+	// not saved into the metadata.
+	class DebuggerWatchpoints
+	{
+	private:
+		DebuggerState* m_state;
+		std::vector<WatchpointInfo> m_watchpoints;
+		std::mutex m_mutex;
+		TraceBuffer<WatchpointHitRecord> m_hits;
+
+		bool ReadValue(uint64_t address, size_t size, uint64_t& value);
+
+	public:
+		DebuggerWatchpoints(DebuggerState* state);
+		bool Add(uint64_t address, size_t size, DebugWatchpointType type, bool record);
+		bool Remove(uint64_t address);
+		// Adds or drops the watchpoint without touching the adapter, e.g., when it is added or removed from the console
+		void Track(uint64_t address, size_t size, DebugWatchpointType type);
+		void Forget(uint64_t address);
+		bool Contains(uint64_t address);
+		void Clear();
+		std::vector<WatchpointInfo> GetWatchpointList();
+		// Updates the counter and the last value of the watchpoint at the address, which the target just stopped at.
+		// A recording watchpoint also records the hit, and false is returned for it.
+		bool ShouldStopAt(uint64_t address, uint64_t pc, std::uint32_t threadId);
+		TraceBuffer<WatchpointHitRecord>* GetHitBuffer() { return &m_hits; }
+	};
+
+
+	// Basic block coverage of the input binary. Every block start gets a one-shot breakpoint, which is removed on its
+	// first hit, and the hit is recorded into a bitmap without stopping the target. The blocks are stored as offsets
+	// relative to the start of the input view, so they survive rebasing and relaunching. Hits accumulate until the
+	// coverage is cleared, and the blocks not hit yet are planted again when the target is relaunched.
+	class DebuggerCoverage
+	{
+	private:
+		DebuggerState* m_state;
+		std::mutex m_mutex;
+		// Sorted and unique
+		std::vector<uint64_t> m_blocks;
+		// One bit per entry of m_blocks
+		std::vector<uint64_t> m_hitBits;
+		// Offsets of the hit blocks, in the order they were hit
+		std::vector<uint64_t> m_hits;
+		// Remote address of the input binary, resolved on the first hit after the breakpoints are planted
+		std::optional<uint64_t> m_remoteBase;
+
+		bool IsHit(size_t index) const { return (m_hitBits[index / 64] >> (index % 64)) & 1; }
+		void Plant(const std::vector<uint64_t>& offsets);
+
+	public:
+		DebuggerCoverage(DebuggerState* state);
+		// Adds the blocks of the functions at the given addresses of the input view, or of all functions if the list
+		// is empty. Returns the number of new blocks.
+		size_t AddFunctions(const std::vector<uint64_t>& functions);
+		// Plants the breakpoints of all blocks not hit yet, e.g., when the adapter is created
+		void Apply();
+		// Records a hit if the address is the start of a covered block. Returns false if it is not one, and sets
+		// firstHit if the block was not hit before.
+		bool RecordHit(uint64_t remoteAddress, bool& firstHit);
+		void Clear();
+		bool IsEmpty();
+		size_t GetBlockCount();
+		size_t GetHitCount();
+		// Offsets of the blocks hit so far, in the order they were hit, starting at the given position. Callers that
+		// poll the coverage pass the number of hits they have already seen.
+		std::vector<uint64_t> GetHits(size_t start = 0);
+		std::vector<uint64_t> GetBlocks();
 	};
 
 
@@ -139,12 +349,19 @@ namespace BinaryNinjaDebugger {
 		std::map<uint64_t, MemoryBytesCache> m_valueCache;
 		std::recursive_mutex m_memoryMutex;
 
+		bool ShouldReadBlock(uint64_t block);
+		void ReadBlocks(uint64_t start, uint64_t end);
+		// The cached content of the block, which stays valid while m_memoryMutex is held, or nullptr if it cannot be read
+		const DataBuffer* GetBlock(uint64_t block);
+
 	public:
 		DebuggerMemory(DebuggerState* state);
 
 		void MarkDirty();
 		DataBuffer ReadBlock(uint64_t block);
 		DataBuffer ReadMemory(uint64_t offset, size_t len);
+		// Copies the memory into dest, up to the first byte that cannot be read. Returns the number of bytes copied.
+		size_t ReadMemory(uint64_t offset, void* dest, size_t len);
 		bool WriteMemory(std::uintptr_t address, const DataBuffer& buffer);
 	};
 
@@ -168,7 +385,10 @@ namespace BinaryNinjaDebugger {
 		DebuggerRegisters* m_registers;
 		DebuggerThreads* m_threads;
 		DebuggerBreakpoints* m_breakpoints;
+		DebuggerWatchpoints* m_watchpoints;
+		DebuggerCoverage* m_coverage;
 		DebuggerMemory* m_memory;
+		ExecutionJournal* m_journal;
 
 		std::string m_executablePath;
 		std::string m_inputFile;
@@ -185,6 +405,8 @@ namespace BinaryNinjaDebugger {
 
 		bool m_connectedToDebugServer = false;
 
+		std::atomic<uint64_t> m_cacheGeneration = 0;
+
 	public:
 		DebuggerState(Ref<BinaryView> data, DebuggerController* controller);
 		~DebuggerState();
@@ -194,9 +416,12 @@ namespace BinaryNinjaDebugger {
 
 		DebuggerModules* GetModules() const { return m_modules; }
 		DebuggerBreakpoints* GetBreakpoints() const { return m_breakpoints; }
+		DebuggerWatchpoints* GetWatchpoints() const { return m_watchpoints; }
+		DebuggerCoverage* GetCoverage() const { return m_coverage; }
 		DebuggerRegisters* GetRegisters() const { return m_registers; }
 		DebuggerThreads* GetThreads() const { return m_threads; }
 		DebuggerMemory* GetMemory() const { return m_memory; }
+		ExecutionJournal* GetJournal() const { return m_journal; }
 		// This is no longer a remote architecture, because we do not really read the remote arch
 		Ref<Architecture> GetRemoteArchitecture() const;
 
@@ -231,6 +456,14 @@ namespace BinaryNinjaDebugger {
 
 		uint64_t IP();
 		uint64_t StackPointer();
+		// Whether registers and memory can be written. They cannot while the execution journal is replaying, and the
+		// journal is discarded when they are written at the live state.
+		bool CanModifyTarget();
+
+		// Bumped whenever the cached registers or memory are discarded, so that anything derived from them, e.g., the
+		// snapshot that compiled expressions are evaluated against, knows it is out of date
+		uint64_t GetCacheGeneration() const { return m_cacheGeneration; }
+		void InvalidateCacheGeneration() { m_cacheGeneration++; }
 
 		bool IsConnected() const { return m_connectionStatus == DebugAdapterConnectedStatus; }
 		bool IsConnecting() const { return m_connectionStatus == DebugAdapterConnectingStatus; }
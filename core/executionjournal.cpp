@@ -0,0 +1,337 @@
+/*
+Copyright 2020-2024 Vector 35 Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "executionjournal.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace BinaryNinjaDebugger;
+
+static constexpr uint64_t JournalBlockSize = 0x100;
+
+
+static size_t AlignSize(size_t size)
+{
+	return (size + 7) & ~(size_t)7;
+}
+
+
+ExecutionJournal::ExecutionJournal(size_t capacity) : m_capacity(capacity) {}
+
+
+void ExecutionJournal::Clear()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_data.clear();
+	m_data.shrink_to_fit();
+	m_steps.clear();
+	m_checkpoints.clear();
+	m_blockWriters.clear();
+	m_layout.clear();
+	m_registerIndices.clear();
+	m_endRegisters.clear();
+	m_endIP = 0;
+	m_endSP = 0;
+	m_position = 0;
+}
+
+
+void ExecutionJournal::SetCapacity(size_t capacity)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_capacity = capacity;
+}
+
+
+size_t ExecutionJournal::GetStepCount()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	return m_steps.size();
+}
+
+
+size_t ExecutionJournal::GetSize()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	return m_data.size();
+}
+
+
+size_t ExecutionJournal::GetPosition()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	return m_position;
+}
+
+
+void ExecutionJournal::SetPosition(size_t position)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_position = std::min(position, m_steps.size());
+}
+
+
+bool ExecutionJournal::IsReplaying()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	return m_position < m_steps.size();
+}
+
+
+uint32_t ExecutionJournal::GetRegisterIndex(const DebugRegister& reg)
+{
+	auto iter = m_registerIndices.find(reg.m_name);
+	if (iter != m_registerIndices.end())
+		return iter->second;
+
+	uint32_t index = (uint32_t)m_layout.size();
+	m_layout.push_back(reg);
+	m_registerIndices[reg.m_name] = index;
+	m_endRegisters.resize(m_layout.size(), 0);
+	return index;
+}
+
+
+void ExecutionJournal::AppendRecord(RecordKind kind, uint32_t flags, uint64_t ip, uint64_t sp,
+	const std::vector<RegisterEntry>& registers, const std::vector<JournalMemoryWrite>& writes)
+{
+	RecordHeader header;
+	header.kind = kind;
+	header.flags = flags;
+	header.registerCount = (uint32_t)registers.size();
+	header.memoryCount = (uint32_t)writes.size();
+	header.ip = ip;
+	header.sp = sp;
+
+	size_t offset = m_data.size();
+	size_t size = sizeof(RecordHeader) + registers.size() * sizeof(RegisterEntry);
+	for (const auto& write : writes)
+		size += sizeof(MemoryEntry) + AlignSize(write.before.size());
+	m_data.resize(offset + size, 0);
+
+	uint8_t* cursor = m_data.data() + offset;
+	memcpy(cursor, &header, sizeof(header));
+	cursor += sizeof(header);
+	if (!registers.empty())
+	{
+		memcpy(cursor, registers.data(), registers.size() * sizeof(RegisterEntry));
+		cursor += registers.size() * sizeof(RegisterEntry);
+	}
+	for (const auto& write : writes)
+	{
+		MemoryEntry entry {write.address, write.before.size()};
+		memcpy(cursor, &entry, sizeof(entry));
+		cursor += sizeof(entry);
+		if (!write.before.empty())
+			memcpy(cursor, write.before.data(), write.before.size());
+		cursor += AlignSize(write.before.size());
+	}
+
+	if (kind == CheckpointRecord)
+	{
+		m_checkpoints.emplace_back(m_steps.size(), offset);
+		return;
+	}
+
+	uint32_t step = (uint32_t)m_steps.size();
+	m_steps.push_back(offset);
+	for (const auto& write : writes)
+	{
+		if (write.before.empty())
+			continue;
+		uint64_t first = write.address & ~(JournalBlockSize - 1);
+		uint64_t last = (write.address + write.before.size() - 1) & ~(JournalBlockSize - 1);
+		for (uint64_t block = first; block <= last; block += JournalBlockSize)
+		{
+			auto& writers = m_blockWriters[block];
+			if (writers.empty() || (writers.back() != step))
+				writers.push_back(step);
+			if (block == last)
+				break;
+		}
+	}
+}
+
+
+const ExecutionJournal::RecordHeader* ExecutionJournal::GetRecord(uint64_t offset) const
+{
+	return (const RecordHeader*)(m_data.data() + offset);
+}
+
+
+bool ExecutionJournal::AppendStep(const std::unordered_map<std::string, DebugRegister>& before, uint64_t ip,
+	uint64_t sp, uint32_t flags, const std::vector<JournalMemoryWrite>& writes,
+	const std::unordered_map<std::string, DebugRegister>& after, uint64_t newIP, uint64_t newSP)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	if (m_position != m_steps.size())
+		return false;
+
+	size_t size = sizeof(RecordHeader) * 2 + (before.size() + after.size()) * sizeof(RegisterEntry);
+	for (const auto& write : writes)
+		size += sizeof(MemoryEntry) + AlignSize(write.before.size());
+	if (m_data.size() + size > m_capacity)
+		return false;
+
+	// A checkpoint at the first step, every CheckpointInterval steps, and whenever the registers no longer match the
+	// end of the journal, e.g., when a new register shows up
+	bool checkpoint = m_steps.empty() || ((m_steps.size() % CheckpointInterval) == 0);
+	for (const auto& [name, reg] : before)
+	{
+		auto iter = m_registerIndices.find(name);
+		if ((iter == m_registerIndices.end()) || (m_endRegisters[iter->second] != reg.m_value))
+			checkpoint = true;
+	}
+
+	if (checkpoint)
+	{
+		std::vector<RegisterEntry> registers;
+		registers.reserve(before.size());
+		for (const auto& [name, reg] : before)
+		{
+			uint32_t index = GetRegisterIndex(reg);
+			registers.push_back({index, 0, reg.m_value});
+			m_endRegisters[index] = reg.m_value;
+		}
+		AppendRecord(CheckpointRecord, 0, ip, sp, registers, {});
+	}
+
+	std::vector<RegisterEntry> changed;
+	for (const auto& [name, reg] : after)
+	{
+		uint32_t index = GetRegisterIndex(reg);
+		if (m_endRegisters[index] == reg.m_value)
+			continue;
+		changed.push_back({index, 0, reg.m_value});
+		m_endRegisters[index] = reg.m_value;
+	}
+	AppendRecord(StepRecord, flags, ip, sp, changed, writes);
+
+	m_endIP = newIP;
+	m_endSP = newSP;
+	m_position = m_steps.size();
+	return true;
+}
+
+
+uint64_t ExecutionJournal::GetIP(size_t position)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	if (position >= m_steps.size())
+		return m_endIP;
+	return GetRecord(m_steps[position])->ip;
+}
+
+
+uint64_t ExecutionJournal::GetSP(size_t position)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	if (position >= m_steps.size())
+		return m_endSP;
+	return GetRecord(m_steps[position])->sp;
+}
+
+
+uint32_t ExecutionJournal::GetFlags(size_t position)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	if (position >= m_steps.size())
+		return 0;
+	return GetRecord(m_steps[position])->flags;
+}
+
+
+std::unordered_map<std::string, DebugRegister> ExecutionJournal::GetRegisters(size_t position)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	std::vector<uint64_t> values;
+	if ((position >= m_steps.size()) || m_checkpoints.empty())
+	{
+		values = m_endRegisters;
+	}
+	else
+	{
+		// The last checkpoint at or before the position. There is always one at position 0.
+		auto checkpoint = std::upper_bound(m_checkpoints.begin(), m_checkpoints.end(), position,
+			[](size_t value, const std::pair<size_t, uint64_t>& item) { return value < item.first; });
+		checkpoint--;
+
+		values.resize(m_layout.size(), 0);
+		auto apply = [&](uint64_t offset) {
+			auto header = GetRecord(offset);
+			auto entries = (const RegisterEntry*)(header + 1);
+			for (uint32_t i = 0; i < header->registerCount; i++)
+				values[entries[i].index] = entries[i].value;
+		};
+
+		apply(checkpoint->second);
+		for (size_t step = checkpoint->first; step < position; step++)
+			apply(m_steps[step]);
+	}
+
+	std::unordered_map<std::string, DebugRegister> result;
+	for (size_t i = 0; i < m_layout.size(); i++)
+	{
+		DebugRegister reg = m_layout[i];
+		reg.m_value = values[i];
+		reg.m_hint.clear();
+		result[reg.m_name] = reg;
+	}
+	return result;
+}
+
+
+void ExecutionJournal::RestoreMemory(size_t position, uint64_t address, uint8_t* data, size_t length)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	if ((length == 0) || (position >= m_steps.size()))
+		return;
+
+	uint64_t end = address + length;
+	uint64_t first = address & ~(JournalBlockSize - 1);
+	for (uint64_t block = first; block < end; block += JournalBlockSize)
+	{
+		auto writers = m_blockWriters.find(block);
+		if (writers == m_blockWriters.end())
+			continue;
+
+		uint64_t rangeStart = std::max(address, block);
+		uint64_t rangeEnd = std::min(end, block + JournalBlockSize);
+
+		// From the newest step back to the position, so the bytes of the oldest step that wrote them win
+		for (auto step = writers->second.rbegin(); step != writers->second.rend(); step++)
+		{
+			if (*step < position)
+				break;
+
+			auto header = GetRecord(m_steps[*step]);
+			auto cursor = (const uint8_t*)(header + 1) + header->registerCount * sizeof(RegisterEntry);
+			for (uint32_t i = 0; i < header->memoryCount; i++)
+			{
+				auto entry = (const MemoryEntry*)cursor;
+				auto bytes = cursor + sizeof(MemoryEntry);
+				cursor = bytes + AlignSize(entry->length);
+
+				uint64_t overlapStart = std::max(rangeStart, entry->address);
+				uint64_t overlapEnd = std::min(rangeEnd, entry->address + entry->length);
+				if (overlapStart >= overlapEnd)
+					continue;
+				memcpy(data + (overlapStart - address), bytes + (overlapStart - entry->address),
+					overlapEnd - overlapStart);
+			}
+		}
+	}
+}
@@ -0,0 +1,146 @@
+/*
+Copyright 2020-2024 Vector 35 Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "debugadapter.h"
+
+namespace BinaryNinjaDebugger {
+	enum JournalStepFlag : uint32_t
+	{
+		JournalCallStep = 1,
+		JournalReturnStep = 2,
+	};
+
+
+	// The bytes an instruction is about to overwrite, read right before it executes
+	struct JournalMemoryWrite
+	{
+		uint64_t address = 0;
+		std::vector<uint8_t> before;
+	};
+
+
+	// A software recording of the forward execution of the target, one instruction at a time, which lets the debugger
+	// step and run backwards on adapters without native time travel debugging.
+	//
+	// A position is the state before a step, so position i is the state before step i, and position GetStepCount() is
+	// the live state of the target. Every step appends one record with the registers that the step changed (their new
+	// values) and the memory it overwrote (the old bytes). Every CheckpointInterval steps, a checkpoint with the values
+	// of all registers is appended as well, so the registers at any position are rebuilt from the nearest checkpoint
+	// before it. The memory at a position is the live memory with the old bytes of every later step put back.
+	//
+	// The records are appended to one flat buffer and never modified. They only hold fixed-size, 8-byte aligned fields
+	// and refer to each other by offset. The journal is kept in memory, though: the register layout, the step offsets
+	// and the checkpoints live outside the buffer, so it cannot be saved to a file or memory-mapped yet.
+	class ExecutionJournal
+	{
+		enum RecordKind : uint32_t
+		{
+			StepRecord,
+			CheckpointRecord,
+		};
+
+		// Every record starts with a header, followed by registerCount RegisterEntry and memoryCount MemoryEntry. The
+		// bytes of a MemoryEntry follow it, padded to 8 bytes.
+		struct RecordHeader
+		{
+			uint32_t kind;
+			uint32_t flags;
+			uint32_t registerCount;
+			uint32_t memoryCount;
+			uint64_t ip;
+			uint64_t sp;
+		};
+
+		struct RegisterEntry
+		{
+			uint32_t index;
+			uint32_t reserved;
+			uint64_t value;
+		};
+
+		struct MemoryEntry
+		{
+			uint64_t address;
+			uint64_t length;
+		};
+
+		std::mutex m_mutex;
+		size_t m_capacity;
+		std::vector<uint8_t> m_data;
+		// Offset of the record of every step
+		std::vector<uint64_t> m_steps;
+		// Position and offset of every checkpoint, sorted by position
+		std::vector<std::pair<size_t, uint64_t>> m_checkpoints;
+		// The steps that wrote to every 0x100-byte block, in order. This only speeds up reading memory at a position,
+		// and can be rebuilt from the records.
+		std::unordered_map<uint64_t, std::vector<uint32_t>> m_blockWriters;
+
+		// The registers seen so far. The values in the records are indexed into this list.
+		std::vector<DebugRegister> m_layout;
+		std::unordered_map<std::string, uint32_t> m_registerIndices;
+
+		// The state at the end of the journal, i.e., the live state of the target
+		std::vector<uint64_t> m_endRegisters;
+		uint64_t m_endIP = 0;
+		uint64_t m_endSP = 0;
+
+		size_t m_position = 0;
+
+		uint32_t GetRegisterIndex(const DebugRegister& reg);
+		void AppendRecord(RecordKind kind, uint32_t flags, uint64_t ip, uint64_t sp,
+			const std::vector<RegisterEntry>& registers, const std::vector<JournalMemoryWrite>& writes);
+		const RecordHeader* GetRecord(uint64_t offset) const;
+
+	public:
+		static constexpr size_t CheckpointInterval = 256;
+
+		ExecutionJournal(size_t capacity);
+
+		void Clear();
+		void SetCapacity(size_t capacity);
+
+		size_t GetStepCount();
+		size_t GetSize();
+		size_t GetPosition();
+		void SetPosition(size_t position);
+		// Whether the debugger shows a recorded state rather than the live one
+		bool IsReplaying();
+
+		// Appends a step that took the target from the registers in before to the registers in after, and overwrote
+		// the memory in writes. Steps can only be appended at the end of the journal, and the position moves to the
+		// end. Returns false if the journal is full, in which case nothing is appended.
+		bool AppendStep(const std::unordered_map<std::string, DebugRegister>& before, uint64_t ip, uint64_t sp,
+			uint32_t flags, const std::vector<JournalMemoryWrite>& writes,
+			const std::unordered_map<std::string, DebugRegister>& after, uint64_t newIP, uint64_t newSP);
+
+		uint64_t GetIP(size_t position);
+		uint64_t GetSP(size_t position);
+		// JournalStepFlag of the step that leaves the position
+		uint32_t GetFlags(size_t position);
+
+		std::unordered_map<std::string, DebugRegister> GetRegisters(size_t position);
+		// Puts the bytes that were in memory at the position back into data, which holds length bytes of live memory
+		// starting at address
+		void RestoreMemory(size_t position, uint64_t address, uint8_t* data, size_t length);
+	};
+};  // namespace BinaryNinjaDebugger
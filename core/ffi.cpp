@@ -171,6 +171,27 @@ BNDataBuffer* BNDebuggerReadMemory(BNDebuggerController* controller, uint64_t ad
 }
 
 
+size_t BNDebuggerReadMemoryInto(BNDebuggerController* controller, uint64_t address, uint8_t* dest, size_t size)
+{
+	return controller->object->ReadMemory(address, dest, size);
+}
+
+
+size_t BNDebuggerReadMemoryRanges(BNDebuggerController* controller, const uint64_t* addresses, const size_t* sizes,
+	size_t count, uint8_t* dest, size_t* bytesRead)
+{
+	std::vector<std::pair<uint64_t, size_t>> ranges;
+	ranges.reserve(count);
+	for (size_t i = 0; i < count; i++)
+		ranges.emplace_back(addresses[i], sizes[i]);
+
+	std::vector<size_t> read;
+	size_t total = controller->object->ReadMemoryRanges(ranges, dest, read);
+	std::copy(read.begin(), read.end(), bytesRead);
+	return total;
+}
+
+
 bool BNDebuggerWriteMemory(BNDebuggerController* controller, uint64_t address, BNDataBuffer* buffer)
 {
 	// Hacky way of getting a BinaryNinj::DataBuffer out of a BNDataBuffer, without causing a segfault
@@ -180,10 +201,8 @@ bool BNDebuggerWriteMemory(BNDebuggerController* controller, uint64_t address, B
 }
 
 
-BNDebugProcess* BNDebuggerGetProcessList(BNDebuggerController* controller, size_t* size)
+static BNDebugProcess* AllocProcessList(const std::vector<DebugProcess>& processes, size_t* size)
 {
-	std::vector<DebugProcess> processes = controller->object->GetProcessList();
-
 	*size = processes.size();
 	BNDebugProcess* results = new BNDebugProcess[processes.size()];
 
@@ -191,17 +210,36 @@ BNDebugProcess* BNDebuggerGetProcessList(BNDebuggerController* controller, size_
 	{
 		results[i].m_pid = processes[i].m_pid;
 		results[i].m_processName = BNDebuggerAllocString(processes[i].m_processName.c_str());
+		results[i].m_parentPid = processes[i].m_parentPid;
+		results[i].m_user = BNDebuggerAllocString(processes[i].m_user.c_str());
+		results[i].m_arch = BNDebuggerAllocString(processes[i].m_arch.c_str());
+		results[i].m_commandLine = BNDebuggerAllocString(processes[i].m_commandLine.c_str());
 	}
 
 	return results;
 }
 
 
+BNDebugProcess* BNDebuggerGetProcessList(BNDebuggerController* controller, size_t* size)
+{
+	return AllocProcessList(controller->object->GetProcessList(), size);
+}
+
+
+BNDebugProcess* BNDebuggerGetAdapterProcessList(BNDebuggerController* controller, size_t* size)
+{
+	return AllocProcessList(controller->object->GetAdapterProcessList(), size);
+}
+
+
 void BNDebuggerFreeProcessList(BNDebugProcess* processes, size_t count)
 {
 	for (size_t i = 0; i < count; i++)
 	{
 		BNDebuggerFreeString(processes[i].m_processName);
+		BNDebuggerFreeString(processes[i].m_user);
+		BNDebuggerFreeString(processes[i].m_arch);
+		BNDebuggerFreeString(processes[i].m_commandLine);
 	}
 
 	delete[] processes;
@@ -329,10 +367,8 @@ void BNDebuggerFreeModules(BNDebugModule* modules, size_t count)
 }
 
 
-BNDebugRegister* BNDebuggerGetRegisters(BNDebuggerController* controller, size_t* size)
+static BNDebugRegister* ConvertRegisters(const std::vector<DebugRegister>& registers, size_t* size)
 {
-	std::vector<DebugRegister> registers = controller->object->GetAllRegisters();
-
 	*size = registers.size();
 	BNDebugRegister* results = new BNDebugRegister[registers.size()];
 
@@ -349,6 +385,18 @@ BNDebugRegister* BNDebuggerGetRegisters(BNDebuggerController* controller, size_t
 }
 
 
+BNDebugRegister* BNDebuggerGetRegisters(BNDebuggerController* controller, size_t* size)
+{
+	return ConvertRegisters(controller->object->GetAllRegisters(), size);
+}
+
+
+BNDebugRegister* BNDebuggerGetRegistersWithoutHints(BNDebuggerController* controller, size_t* size)
+{
+	return ConvertRegisters(controller->object->GetAllRegisters(false), size);
+}
+
+
 void BNDebuggerFreeRegisters(BNDebugRegister* registers, size_t count)
 {
 	for (size_t i = 0; i < count; i++)
@@ -775,12 +823,20 @@ BNDebugBreakpoint* BNDebuggerGetBreakpoints(BNDebuggerController* controller, si
 	BNDebugBreakpoint* result = new BNDebugBreakpoint[breakpoints.size()];
 	for (size_t i = 0; i < breakpoints.size(); i++)
 	{
-		uint64_t remoteAddress = state->GetModules()->RelativeAddressToAbsolute(breakpoints[i]);
+		uint64_t remoteAddress = state->GetBreakpoints()->ResolveAddress(breakpoints[i]);
 		bool enabled = false;
 		result[i].module = BNDebuggerAllocString(breakpoints[i].module.c_str());
 		result[i].offset = breakpoints[i].offset;
 		result[i].address = remoteAddress;
 		result[i].enabled = enabled;
+
+		auto conditionInfo = state->GetBreakpoints()->GetConditionInfo(breakpoints[i]);
+		result[i].condition =
+			BNDebuggerAllocString(conditionInfo.condition ? conditionInfo.condition->GetText().c_str() : "");
+		result[i].hitCount = conditionInfo.hitCount;
+		result[i].skipCount = conditionInfo.skipCount;
+		result[i].isTracepoint = conditionInfo.isTracepoint;
+		result[i].traceCaptures = BNDebuggerAllocString(conditionInfo.traceText.c_str());
 	}
 	return result;
 }
@@ -791,11 +847,47 @@ void BNDebuggerFreeBreakpoints(BNDebugBreakpoint* breakpoints, size_t count)
 	for (size_t i = 0; i < count; i++)
 	{
 		BNDebuggerFreeString(breakpoints[i].module);
+		BNDebuggerFreeString(breakpoints[i].condition);
+		BNDebuggerFreeString(breakpoints[i].traceCaptures);
 	}
 	delete[] breakpoints;
 }
 
 
+uint64_t BNDebuggerGetBreakpointVersion(BNDebuggerController* controller)
+{
+	return controller->object->GetState()->GetBreakpoints()->GetVersion();
+}
+
+
+BNDebugBreakpointChange* BNDebuggerGetBreakpointChanges(
+	BNDebuggerController* controller, uint64_t version, uint64_t* newVersion, bool* complete, size_t* count)
+{
+	DebuggerBreakpoints* breakpoints = controller->object->GetState()->GetBreakpoints();
+	std::vector<BreakpointChange> changes;
+	*complete = breakpoints->GetChangesSince(version, changes, *newVersion);
+	*count = changes.size();
+
+	BNDebugBreakpointChange* result = new BNDebugBreakpointChange[changes.size()];
+	for (size_t i = 0; i < changes.size(); i++)
+	{
+		result[i].module = BNDebuggerAllocString(changes[i].address.module.c_str());
+		result[i].offset = changes[i].address.offset;
+		result[i].address = changes[i].absoluteAddress;
+		result[i].added = changes[i].added;
+	}
+	return result;
+}
+
+
+void BNDebuggerFreeBreakpointChanges(BNDebugBreakpointChange* changes, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+		BNDebuggerFreeString(changes[i].module);
+	delete[] changes;
+}
+
+
 void BNDebuggerDeleteAbsoluteBreakpoint(BNDebuggerController* controller, uint64_t address)
 {
 	controller->object->DeleteBreakpoint(address);
@@ -820,6 +912,43 @@ void BNDebuggerAddRelativeBreakpoint(BNDebuggerController* controller, const cha
 }
 
 
+static std::vector<ModuleNameAndOffset> MakeRelativeAddresses(
+	const char** modules, const uint64_t* offsets, size_t count)
+{
+	std::vector<ModuleNameAndOffset> result;
+	result.reserve(count);
+	for (size_t i = 0; i < count; i++)
+		result.emplace_back(modules[i], offsets[i]);
+	return result;
+}
+
+
+size_t BNDebuggerAddAbsoluteBreakpoints(BNDebuggerController* controller, const uint64_t* addresses, size_t count)
+{
+	return controller->object->AddBreakpoints(std::vector<uint64_t>(addresses, addresses + count));
+}
+
+
+size_t BNDebuggerAddRelativeBreakpoints(
+	BNDebuggerController* controller, const char** modules, const uint64_t* offsets, size_t count)
+{
+	return controller->object->AddBreakpoints(MakeRelativeAddresses(modules, offsets, count));
+}
+
+
+size_t BNDebuggerDeleteAbsoluteBreakpoints(BNDebuggerController* controller, const uint64_t* addresses, size_t count)
+{
+	return controller->object->DeleteBreakpoints(std::vector<uint64_t>(addresses, addresses + count));
+}
+
+
+size_t BNDebuggerDeleteRelativeBreakpoints(
+	BNDebuggerController* controller, const char** modules, const uint64_t* offsets, size_t count)
+{
+	return controller->object->DeleteBreakpoints(MakeRelativeAddresses(modules, offsets, count));
+}
+
+
 uint64_t BNDebuggerGetIP(BNDebuggerController* controller)
 {
 	return controller->object->GetCurrentIP();
@@ -866,6 +995,200 @@ bool BNDebuggerContainsRelativeBreakpoint(BNDebuggerController* controller, cons
 }
 
 
+bool BNDebuggerSetAbsoluteBreakpointCondition(BNDebuggerController* controller, uint64_t address, const char* condition)
+{
+	return controller->object->SetBreakpointCondition(address, condition);
+}
+
+
+bool BNDebuggerSetRelativeBreakpointCondition(
+	BNDebuggerController* controller, const char* module, uint64_t offset, const char* condition)
+{
+	return controller->object->SetBreakpointCondition(ModuleNameAndOffset(module, offset), condition);
+}
+
+
+bool BNDebuggerAddAbsoluteTracepoint(BNDebuggerController* controller, uint64_t address, const char* captures)
+{
+	return controller->object->AddTracepoint(address, captures);
+}
+
+
+bool BNDebuggerAddRelativeTracepoint(
+	BNDebuggerController* controller, const char* module, uint64_t offset, const char* captures)
+{
+	return controller->object->AddTracepoint(ModuleNameAndOffset(module, offset), captures);
+}
+
+
+BNDebuggerTraceRecord* BNDebuggerDrainTraceRecords(BNDebuggerController* controller, size_t maxCount, size_t* count)
+{
+	std::vector<TraceRecord> records = controller->object->DrainTraceRecords(maxCount);
+	*count = records.size();
+	if (records.empty())
+		return nullptr;
+
+	// A tracepoint can fire many thousands of times between two drains, so rather than one allocation per record
+	// and per snippet, everything goes into one block: the records, then all the values, then all the snippet bytes
+	size_t valueCount = 0;
+	size_t dataSize = 0;
+	for (const auto& record : records)
+	{
+		valueCount += record.values.size();
+		for (const auto& value : record.values)
+			dataSize += value.data.size();
+	}
+
+	size_t recordBytes = sizeof(BNDebuggerTraceRecord) * records.size();
+	size_t valueBytes = sizeof(BNDebuggerTraceValue) * valueCount;
+	char* block = new char[recordBytes + valueBytes + dataSize];
+	auto result = (BNDebuggerTraceRecord*)block;
+	auto values = (BNDebuggerTraceValue*)(block + recordBytes);
+	auto data = (uint8_t*)(block + recordBytes + valueBytes);
+
+	for (size_t i = 0; i < records.size(); i++)
+	{
+		result[i].address = records[i].address;
+		result[i].threadId = records[i].threadId;
+		result[i].timestamp = records[i].timestamp;
+		result[i].values = values;
+		result[i].valueCount = records[i].values.size();
+		for (const auto& value : records[i].values)
+		{
+			values->valid = value.valid;
+			values->value = value.value;
+			values->dataSize = value.data.size();
+			values->data = value.data.empty() ? nullptr : data;
+			if (!value.data.empty())
+				memcpy(data, value.data.data(), value.data.size());
+			data += value.data.size();
+			values++;
+		}
+	}
+	return result;
+}
+
+
+void BNDebuggerFreeTraceRecords(BNDebuggerTraceRecord* records)
+{
+	delete[] (char*)records;
+}
+
+
+uint64_t BNDebuggerGetDroppedTraceRecordCount(BNDebuggerController* controller)
+{
+	return controller->object->GetDroppedTraceRecordCount();
+}
+
+
+bool BNDebuggerAddWatchpoint(
+	BNDebuggerController* controller, uint64_t address, size_t size, BNDebugWatchpointType type, bool record)
+{
+	return controller->object->AddWatchpoint(address, size, type, record);
+}
+
+
+bool BNDebuggerDeleteWatchpoint(BNDebuggerController* controller, uint64_t address)
+{
+	return controller->object->DeleteWatchpoint(address);
+}
+
+
+BNDebugWatchpoint* BNDebuggerGetWatchpoints(BNDebuggerController* controller, size_t* count)
+{
+	std::vector<WatchpointInfo> watchpoints = controller->object->GetWatchpoints();
+	*count = watchpoints.size();
+
+	BNDebugWatchpoint* result = new BNDebugWatchpoint[watchpoints.size()];
+	for (size_t i = 0; i < watchpoints.size(); i++)
+	{
+		result[i].address = watchpoints[i].address;
+		result[i].size = watchpoints[i].size;
+		result[i].type = watchpoints[i].type;
+		result[i].record = watchpoints[i].record;
+		result[i].hitCount = watchpoints[i].hitCount;
+	}
+	return result;
+}
+
+
+void BNDebuggerFreeWatchpoints(BNDebugWatchpoint* watchpoints)
+{
+	delete[] watchpoints;
+}
+
+
+BNDebugWatchpointHit* BNDebuggerDrainWatchpointHits(BNDebuggerController* controller, size_t maxCount, size_t* count)
+{
+	std::vector<WatchpointHitRecord> hits = controller->object->DrainWatchpointHits(maxCount);
+	*count = hits.size();
+
+	BNDebugWatchpointHit* result = new BNDebugWatchpointHit[hits.size()];
+	for (size_t i = 0; i < hits.size(); i++)
+	{
+		result[i].address = hits[i].address;
+		result[i].pc = hits[i].pc;
+		result[i].threadId = hits[i].threadId;
+		result[i].timestamp = hits[i].timestamp;
+		result[i].oldValue = hits[i].oldValue;
+		result[i].newValue = hits[i].newValue;
+	}
+	return result;
+}
+
+
+void BNDebuggerFreeWatchpointHits(BNDebugWatchpointHit* hits)
+{
+	delete[] hits;
+}
+
+
+uint64_t BNDebuggerGetDroppedWatchpointHitCount(BNDebuggerController* controller)
+{
+	return controller->object->GetDroppedWatchpointHitCount();
+}
+
+
+size_t BNDebuggerAddCoverage(BNDebuggerController* controller, const uint64_t* functions, size_t count)
+{
+	return controller->object->AddCoverage(std::vector<uint64_t>(functions, functions + count));
+}
+
+
+void BNDebuggerClearCoverage(BNDebuggerController* controller)
+{
+	controller->object->ClearCoverage();
+}
+
+
+size_t BNDebuggerGetCoverageBlockCount(BNDebuggerController* controller)
+{
+	return controller->object->GetCoverageBlockCount();
+}
+
+
+size_t BNDebuggerGetCoverageHitCount(BNDebuggerController* controller)
+{
+	return controller->object->GetCoverageHitCount();
+}
+
+
+uint64_t* BNDebuggerGetCoverageHits(BNDebuggerController* controller, size_t start, size_t* count)
+{
+	std::vector<uint64_t> hits = controller->object->GetCoverageHits(start);
+	*count = hits.size();
+	uint64_t* result = new uint64_t[hits.size()];
+	std::copy(hits.begin(), hits.end(), result);
+	return result;
+}
+
+
+void BNDebuggerFreeCoverageHits(uint64_t* hits)
+{
+	delete[] hits;
+}
+
+
 uint64_t BNDebuggerRelativeAddressToAbsolute(BNDebuggerController* controller, const char* module, uint64_t offset)
 {
 	DebuggerState* state = controller->object->GetState();
@@ -907,39 +1230,61 @@ bool BNDebuggerIsSameBaseModule(const char* module1, const char* module2)
 }
 
 
-size_t BNDebuggerRegisterEventCallback(
-	BNDebuggerController* controller, void (*callback)(void* ctx, BNDebuggerEvent* event), const char* name, void* ctx)
+// Fills a borrow-only view of the event for the C API. The strings point into the event itself, so they are only valid
+// for the duration of the callback; the receiver must copy whatever it wants to keep and must not free them. Nothing is
+// allocated here, neither per event nor per subscriber. String fields that the event does not carry point to an empty
+// string rather than being null, which is what existing consumers expect.
+static void FillEventView(const DebuggerEvent& event, BNDebuggerEvent& view)
 {
-	return controller->object->RegisterEventCallback(
-		[=](const DebuggerEvent& event) {
-			BNDebuggerEvent* evt = new BNDebuggerEvent;
-
-			evt->type = event.type;
-			evt->data.targetStoppedData.reason = event.data.targetStoppedData.reason;
-			evt->data.targetStoppedData.exitCode = event.data.targetStoppedData.exitCode;
-			evt->data.targetStoppedData.lastActiveThread = event.data.targetStoppedData.lastActiveThread;
-			evt->data.targetStoppedData.data = event.data.targetStoppedData.data;
-
-			evt->data.errorData.error = BNDebuggerAllocString(event.data.errorData.error.c_str());
-			evt->data.errorData.shortError = BNDebuggerAllocString(event.data.errorData.shortError.c_str());
-			evt->data.errorData.data = event.data.errorData.data;
-
-			evt->data.exitData.exitCode = event.data.exitData.exitCode;
-
-			evt->data.relativeAddress.module = BNDebuggerAllocString(event.data.relativeAddress.module.c_str());
-			evt->data.relativeAddress.offset = event.data.relativeAddress.offset;
+	static char emptyString[] = "";
 
-			evt->data.absoluteAddress = event.data.absoluteAddress;
+	view.type = event.type;
+	view.data.errorData.error = emptyString;
+	view.data.errorData.shortError = emptyString;
+	view.data.relativeAddress.module = emptyString;
+	view.data.messageData.message = emptyString;
 
-			evt->data.messageData.message = BNDebuggerAllocString(event.data.messageData.message.c_str());
+	if (auto stopped = event.data.GetIf<TargetStoppedEventData>())
+	{
+		view.data.targetStoppedData.reason = stopped->reason;
+		view.data.targetStoppedData.exitCode = stopped->exitCode;
+		view.data.targetStoppedData.lastActiveThread = stopped->lastActiveThread;
+		view.data.targetStoppedData.data = stopped->data;
+	}
+	else if (auto error = event.data.GetIf<ErrorEventData>())
+	{
+		view.data.errorData.error = const_cast<char*>(error->error.c_str());
+		view.data.errorData.shortError = const_cast<char*>(error->shortError.c_str());
+		view.data.errorData.data = error->data;
+	}
+	else if (auto address = event.data.GetIf<uint64_t>())
+	{
+		view.data.absoluteAddress = *address;
+	}
+	else if (auto relative = event.data.GetIf<ModuleNameAndOffset>())
+	{
+		view.data.relativeAddress.module = const_cast<char*>(relative->module.c_str());
+		view.data.relativeAddress.offset = relative->offset;
+	}
+	else if (auto exited = event.data.GetIf<TargetExitedEventData>())
+	{
+		view.data.exitData.exitCode = exited->exitCode;
+	}
+	else if (auto message = event.data.GetIf<StdoutMessageEventData>())
+	{
+		view.data.messageData.message = const_cast<char*>(message->message.c_str());
+	}
+}
 
-			callback(ctx, evt);
 
-			BNDebuggerFreeString(evt->data.errorData.error);
-			BNDebuggerFreeString(evt->data.errorData.shortError);
-			BNDebuggerFreeString(evt->data.relativeAddress.module);
-			BNDebuggerFreeString(evt->data.messageData.message);
-			delete evt;
+size_t BNDebuggerRegisterEventCallback(
+	BNDebuggerController* controller, void (*callback)(void* ctx, BNDebuggerEvent* event), const char* name, void* ctx)
+{
+	return controller->object->RegisterEventCallback(
+		[=](const DebuggerEvent& event) {
+			BNDebuggerEvent view {};
+			FillEventView(event, view);
+			callback(ctx, &view);
 		},
 		name);
 }
@@ -1024,27 +1369,75 @@ bool BNDebuggerIsTTD(BNDebuggerController* controller)
 }
 
 
+bool BNDebuggerIsReverseExecutionSupported(BNDebuggerController* controller)
+{
+	return controller->object->IsReverseExecutionSupported();
+}
+
+
 void BNDebuggerPostDebuggerEvent(BNDebuggerController* controller, BNDebuggerEvent* event)
 {
+	// The C struct carries every kind of payload, so the event type decides which one is meaningful
 	DebuggerEvent evt;
 	evt.type = event->type;
-	evt.data.targetStoppedData.reason = event->data.targetStoppedData.reason;
-	evt.data.targetStoppedData.exitCode = event->data.targetStoppedData.exitCode;
-	evt.data.targetStoppedData.lastActiveThread = event->data.targetStoppedData.lastActiveThread;
-	evt.data.targetStoppedData.data = event->data.targetStoppedData.data;
-
-	evt.data.errorData.error = event->data.errorData.error;
-	evt.data.errorData.shortError = event->data.errorData.shortError;
-	evt.data.errorData.data = event->data.errorData.data;
-
-	evt.data.exitData.exitCode = event->data.exitData.exitCode;
-
-	evt.data.relativeAddress.module = event->data.relativeAddress.module;
-	evt.data.relativeAddress.offset = event->data.relativeAddress.offset;
-
-	evt.data.absoluteAddress = event->data.absoluteAddress;
-
-	evt.data.messageData.message = event->data.messageData.message;
+	switch (event->type)
+	{
+	case TargetStoppedEventType:
+	case AdapterStoppedEventType:
+	{
+		auto& stopped = evt.data.TargetStoppedData();
+		stopped.reason = event->data.targetStoppedData.reason;
+		stopped.exitCode = event->data.targetStoppedData.exitCode;
+		stopped.lastActiveThread = event->data.targetStoppedData.lastActiveThread;
+		stopped.data = event->data.targetStoppedData.data;
+		break;
+	}
+	case ErrorEventType:
+	case LaunchFailureEventType:
+	case InternalErrorEventType:
+	case InvalidOperationEventType:
+	{
+		auto& error = evt.data.ErrorData();
+		if (event->data.errorData.error)
+			error.error = event->data.errorData.error;
+		if (event->data.errorData.shortError)
+			error.shortError = event->data.errorData.shortError;
+		error.data = event->data.errorData.data;
+		break;
+	}
+	case AbsoluteBreakpointAddedEvent:
+	case AbsoluteBreakpointRemovedEvent:
+	case ModuleLoadedEvent:
+	case WatchpointAddedEvent:
+	case WatchpointRemovedEvent:
+		evt.data.AbsoluteAddress() = event->data.absoluteAddress;
+		break;
+	case RelativeBreakpointAddedEvent:
+	case RelativeBreakpointRemovedEvent:
+	{
+		auto& relative = evt.data.RelativeAddress();
+		if (event->data.relativeAddress.module)
+			relative.module = event->data.relativeAddress.module;
+		relative.offset = event->data.relativeAddress.offset;
+		break;
+	}
+	case TargetExitedEventType:
+	case AdapterTargetExitedEventType:
+		evt.data.ExitData().exitCode = event->data.exitData.exitCode;
+		break;
+	case StdoutMessageEventType:
+	case BackendMessageEventType:
+	case BreakpointsChangedEvent:
+	case CoverageChangedEvent:
+	{
+		auto& message = evt.data.MessageData();
+		if (event->data.messageData.message)
+			message.message = event->data.messageData.message;
+		break;
+	}
+	default:
+		break;
+	}
 
 	controller->object->PostDebuggerEvent(evt);
 }
@@ -1068,6 +1461,24 @@ uint64_t BNDebuggerGetViewFileSegmentsStart(BNDebuggerController* controller)
 }
 
 
+bool BNDebuggerIsImageTranslated(BNDebuggerController* controller)
+{
+	return controller->object->IsImageTranslated();
+}
+
+
+uint64_t BNDebuggerViewToLiveAddress(BNDebuggerController* controller, uint64_t address)
+{
+	return controller->object->ViewToLiveAddress(address);
+}
+
+
+uint64_t BNDebuggerLiveToViewAddress(BNDebuggerController* controller, uint64_t address)
+{
+	return controller->object->LiveToViewAddress(address);
+}
+
+
 bool BNDebuggerComputeLLILExprValue(BNDebuggerController* controller, BNLowLevelILFunction* function, size_t expr,
 	uint64_t& value)
 {
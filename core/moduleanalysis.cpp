@@ -0,0 +1,303 @@
+/*
+Copyright 2020-2024 Vector 35 Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "moduleanalysis.h"
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include "fmt/format.h"
+
+using namespace BinaryNinja;
+using namespace BinaryNinjaDebugger;
+
+// Bump this whenever the format of the cache files changes, so the old ones are not read
+static constexpr uint32_t ModuleCacheVersion = 1;
+
+
+ModuleAnalysis::ModuleAnalysis(size_t threadCount) : m_threadCount(std::max<size_t>(threadCount, 1)) {}
+
+
+ModuleAnalysis::~ModuleAnalysis()
+{
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_stop = true;
+		for (auto& view : m_analyzing)
+			view->AbortAnalysis();
+	}
+	m_condition.notify_all();
+
+	for (auto& thread : m_threads)
+	{
+		if (thread.joinable())
+			thread.join();
+	}
+}
+
+
+void ModuleAnalysis::QueueLocked(const std::string& path)
+{
+	m_modules[path] = ModuleEntry();
+	m_queue.push_back(path);
+	// The workers are only started once they have something to do, so there is no cost unless it is used
+	if (m_threads.size() < m_threadCount)
+		m_threads.emplace_back([this]() { Run(); });
+	m_condition.notify_one();
+}
+
+
+void ModuleAnalysis::Queue(const std::vector<DebugModule>& modules)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	for (const auto& module : modules)
+	{
+		if (module.m_name.empty())
+			continue;
+		auto iter = m_modules.find(module.m_name);
+		if ((iter == m_modules.end()) || (iter->second.status == ModuleFailed))
+			QueueLocked(module.m_name);
+	}
+}
+
+
+bool ModuleAnalysis::Lookup(const DebugModule& module, uint64_t address, uint64_t& functionStart, std::string& name)
+{
+	if (module.m_name.empty() || (address < module.m_address))
+		return false;
+
+	std::shared_ptr<const ModuleTable> table;
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		auto iter = m_modules.find(module.m_name);
+		if (iter == m_modules.end())
+		{
+			QueueLocked(module.m_name);
+			return false;
+		}
+		table = iter->second.table;
+	}
+
+	if (!table)
+		return false;
+
+	uint64_t offset = address - module.m_address;
+	if (offset >= table->size)
+		return false;
+
+	// The last function that starts at or before the offset
+	auto iter = std::upper_bound(table->functions.begin(), table->functions.end(), offset,
+		[](uint64_t value, const ModuleFunction& func) { return value < func.start; });
+	if (iter == table->functions.begin())
+		return false;
+	iter--;
+	if (offset >= iter->end)
+		return false;
+
+	functionStart = module.m_address + iter->start;
+	name = iter->name;
+	return true;
+}
+
+
+void ModuleAnalysis::Run()
+{
+	while (true)
+	{
+		std::string path;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_condition.wait(lock, [this]() { return m_stop || !m_queue.empty(); });
+			if (m_stop)
+				return;
+			path = m_queue.front();
+			m_queue.pop_front();
+		}
+
+		auto table = Analyze(path);
+
+		std::unique_lock<std::mutex> lock(m_mutex);
+		ModuleEntry& entry = m_modules[path];
+		entry.status = table ? ModuleAnalyzed : ModuleFailed;
+		entry.table = table;
+	}
+}
+
+
+std::shared_ptr<const ModuleAnalysis::ModuleTable> ModuleAnalysis::Analyze(const std::string& path)
+{
+	// The module may not exist on this machine, e.g., when debugging remotely
+	std::error_code error;
+	if (!std::filesystem::is_regular_file(path, error))
+		return nullptr;
+
+	std::string hash;
+	if (!HashFile(path, hash))
+		return nullptr;
+
+	auto table = std::make_shared<ModuleTable>();
+	std::string cachePath = GetCachePath(hash);
+	if (LoadCache(cachePath, *table))
+	{
+		LogDebug("Loaded the analysis of %s from %s", path.c_str(), cachePath.c_str());
+		return table;
+	}
+	// The cache may have been read in part
+	*table = ModuleTable();
+
+	Ref<BinaryView> view = BinaryNinja::Load(path, false);
+	if (!view)
+	{
+		LogWarn("Failed to load %s for analysis", path.c_str());
+		return nullptr;
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		if (m_stop)
+		{
+			view->GetFile()->Close();
+			return nullptr;
+		}
+		m_analyzing.push_back(view);
+	}
+
+	LogInfo("Analyzing %s in the background", path.c_str());
+	view->UpdateAnalysisAndWait();
+
+	bool aborted;
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_analyzing.erase(std::find(m_analyzing.begin(), m_analyzing.end(), view));
+		aborted = m_stop;
+	}
+
+	if (!aborted)
+	{
+		uint64_t base = view->GetStart();
+		table->size = view->GetEnd() - base;
+		for (const auto& func : view->GetAnalysisFunctionList())
+		{
+			ModuleFunction entry;
+			entry.start = func->GetStart() - base;
+			entry.end = func->GetHighestAddress() + 1 - base;
+			auto symbol = func->GetSymbol();
+			if (symbol)
+				entry.name = symbol->GetShortName();
+			else
+				entry.name = fmt::format("sub_{:x}", func->GetStart());
+			table->functions.push_back(std::move(entry));
+		}
+		std::sort(table->functions.begin(), table->functions.end(),
+			[](const ModuleFunction& lhs, const ModuleFunction& rhs) { return lhs.start < rhs.start; });
+	}
+
+	view->GetFile()->Close();
+	if (aborted)
+		return nullptr;
+
+	SaveCache(cachePath, path, *table);
+	return table;
+}
+
+
+bool ModuleAnalysis::HashFile(const std::string& path, std::string& hash)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file)
+		return false;
+
+	// 64-bit FNV-1a, plus the size. This only needs to tell different builds of a library apart.
+	uint64_t value = 0xcbf29ce484222325;
+	uint64_t size = 0;
+	std::vector<char> buffer(0x10000);
+	while (file)
+	{
+		file.read(buffer.data(), buffer.size());
+		std::streamsize count = file.gcount();
+		for (std::streamsize i = 0; i < count; i++)
+		{
+			value ^= (uint8_t)buffer[i];
+			value *= 0x100000001b3;
+		}
+		size += count;
+	}
+
+	hash = fmt::format("{:x}-{:016x}", size, value);
+	return true;
+}
+
+
+std::string ModuleAnalysis::GetCachePath(const std::string& hash)
+{
+	auto directory = std::filesystem::path(BinaryNinja::GetUserDirectory()) / "debugger" / "modules";
+	return (directory / (hash + ".txt")).string();
+}
+
+
+bool ModuleAnalysis::LoadCache(const std::string& path, ModuleTable& table)
+{
+	std::ifstream file(path);
+	if (!file)
+		return false;
+
+	// The first line is the version and the size of the module, and the second one the path it was analyzed from
+	std::string line;
+	uint32_t version = 0;
+	if (!std::getline(file, line) || (sscanf(line.c_str(), "%u %" SCNx64, &version, &table.size) != 2)
+		|| (version != ModuleCacheVersion))
+		return false;
+	if (!std::getline(file, line))
+		return false;
+
+	// Every other line is a function: start, end and name
+	while (std::getline(file, line))
+	{
+		std::istringstream stream(line);
+		ModuleFunction func;
+		if (!(stream >> std::hex >> func.start >> func.end))
+			return false;
+		stream.get();
+		std::getline(stream, func.name);
+		table.functions.push_back(std::move(func));
+	}
+	return true;
+}
+
+
+void ModuleAnalysis::SaveCache(const std::string& path, const std::string& modulePath, const ModuleTable& table)
+{
+	std::error_code error;
+	std::filesystem::create_directories(std::filesystem::path(path).parent_path(), error);
+
+	// Write to a temporary file first, so a session that reads the cache never sees a partial one
+	std::string temporary = path + ".tmp";
+	{
+		std::ofstream file(temporary, std::ios::trunc);
+		if (!file)
+		{
+			LogWarn("Failed to write the analysis cache %s", path.c_str());
+			return;
+		}
+
+		file << fmt::format("{} {:x}\n{}\n", ModuleCacheVersion, table.size, modulePath);
+		for (const auto& func : table.functions)
+			file << fmt::format("{:x} {:x} {}\n", func.start, func.end, func.name);
+	}
+	std::filesystem::rename(temporary, path, error);
+}
@@ -0,0 +1,100 @@
+/*
+Copyright 2020-2024 Vector 35 Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "binaryninjaapi.h"
+#include "debugadapter.h"
+
+namespace BinaryNinjaDebugger {
+	// A function found by analyzing a module, as offsets from the start of the module
+	struct ModuleFunction
+	{
+		uint64_t start;
+		uint64_t end;
+		std::string name;
+	};
+
+
+	// Function boundaries and names of the loaded modules other than the input file, e.g., libc, which the input view
+	// knows nothing about. The modules are queued when the debugger sees them loaded, or at the latest the first time
+	// an address in them is looked up, and are analyzed on background threads, so the lookup fails until the analysis
+	// is done. The results are saved into the user directory, keyed by a hash of the module file, so a module is only
+	// analyzed once across sessions.
+	class ModuleAnalysis
+	{
+		struct ModuleTable
+		{
+			uint64_t size = 0;
+			// Sorted by start
+			std::vector<ModuleFunction> functions;
+		};
+
+		enum ModuleStatus
+		{
+			ModuleQueued,
+			ModuleAnalyzed,
+			// The module could not be analyzed, e.g., it does not exist on this machine. It is queued again the next
+			// time the loaded modules are queued, but not by a lookup, which happens far more often.
+			ModuleFailed
+		};
+
+		struct ModuleEntry
+		{
+			ModuleStatus status = ModuleQueued;
+			std::shared_ptr<const ModuleTable> table;
+		};
+
+		std::mutex m_mutex;
+		std::condition_variable m_condition;
+		size_t m_threadCount;
+		std::vector<std::thread> m_threads;
+		bool m_stop = false;
+		// Paths of the modules waiting to be analyzed
+		std::deque<std::string> m_queue;
+		// Every module that was requested, by path
+		std::unordered_map<std::string, ModuleEntry> m_modules;
+		// The views being analyzed, so their analysis can be aborted when the debugger goes away
+		std::vector<BinaryNinja::Ref<BinaryNinja::BinaryView>> m_analyzing;
+
+		// Must be called with the mutex held
+		void QueueLocked(const std::string& path);
+		void Run();
+		std::shared_ptr<const ModuleTable> Analyze(const std::string& path);
+		static bool HashFile(const std::string& path, std::string& hash);
+		static std::string GetCachePath(const std::string& hash);
+		static bool LoadCache(const std::string& path, ModuleTable& table);
+		static void SaveCache(const std::string& path, const std::string& modulePath, const ModuleTable& table);
+
+	public:
+		ModuleAnalysis(size_t threadCount);
+		~ModuleAnalysis();
+
+		// Queues the modules that have not been analyzed yet, and the ones whose analysis failed
+		void Queue(const std::vector<DebugModule>& modules);
+		// Finds the function of the module that contains the address. The module is queued for analysis if it has not
+		// been yet.
+		bool Lookup(const DebugModule& module, uint64_t address, uint64_t& functionStart, std::string& name);
+	};
+};  // namespace BinaryNinjaDebugger
@@ -0,0 +1,164 @@
+/*
+Copyright 2020-2024 Vector 35 Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "registermap.h"
+#include <algorithm>
+
+using namespace BinaryNinja;
+using namespace BinaryNinjaDebugger;
+
+// Names that the architecture and the adapters use for the same register
+static const std::vector<std::pair<std::string, std::string>> RegisterAliases = {
+	{"x29", "fp"},
+	{"x30", "lr"},
+	{"fp", "x29"},
+	{"lr", "x30"},
+};
+
+// Neither the adapter nor the architecture register indices are expected to go beyond this. Registers that do are
+// left out of the map.
+static constexpr size_t MaxRegisterIndex = 0x10000;
+
+
+uint32_t RegisterMap::FindSlot(const std::unordered_map<std::string, uint32_t>& slots, const std::string& name) const
+{
+	auto iter = slots.find(name);
+	if (iter != slots.end())
+		return iter->second;
+
+	for (const auto& [archName, adapterName] : RegisterAliases)
+	{
+		if (archName != name)
+			continue;
+		iter = slots.find(adapterName);
+		if (iter != slots.end())
+			return iter->second;
+	}
+	return InvalidSlot;
+}
+
+
+void RegisterMap::Build(Ref<Architecture> arch, const std::unordered_map<std::string, DebugRegister>& registers)
+{
+	Clear();
+
+	std::vector<const DebugRegister*> ordered;
+	ordered.reserve(registers.size());
+	for (const auto& [name, reg] : registers)
+		ordered.push_back(&reg);
+	std::sort(ordered.begin(), ordered.end(), [](const DebugRegister* lhs, const DebugRegister* rhs) {
+		return lhs->m_registerIndex < rhs->m_registerIndex;
+	});
+
+	std::unordered_map<std::string, uint32_t> slots;
+	for (const auto reg : ordered)
+	{
+		uint32_t slot = (uint32_t)m_names.size();
+		m_names.push_back(reg->m_name);
+		m_widths.push_back(reg->m_width);
+		slots[reg->m_name] = slot;
+
+		if (reg->m_registerIndex < MaxRegisterIndex)
+		{
+			if (m_slotsByAdapterIndex.size() <= reg->m_registerIndex)
+				m_slotsByAdapterIndex.resize(reg->m_registerIndex + 1, InvalidSlot);
+			m_slotsByAdapterIndex[reg->m_registerIndex] = slot;
+		}
+	}
+
+	if (arch)
+	{
+		for (auto archRegister : arch->GetAllRegisters())
+		{
+			if (archRegister >= MaxRegisterIndex)
+				continue;
+			if (m_archRegisters.size() <= archRegister)
+				m_archRegisters.resize(archRegister + 1);
+
+			ArchRegister& entry = m_archRegisters[archRegister];
+			entry.slot = FindSlot(slots, arch->GetRegisterName(archRegister));
+			if (entry.slot != InvalidSlot)
+				continue;
+
+			BNRegisterInfo info = arch->GetRegisterInfo(archRegister);
+			if (info.fullWidthRegister == archRegister)
+				continue;
+
+			entry.slot = FindSlot(slots, arch->GetRegisterName(info.fullWidthRegister));
+			if (entry.slot == InvalidSlot)
+				continue;
+
+			entry.shift = (uint8_t)(info.offset * 8);
+			if (info.size < 8)
+				entry.mask = (1ULL << (info.size * 8)) - 1;
+		}
+	}
+
+	m_valid = true;
+}
+
+
+void RegisterMap::Clear()
+{
+	m_valid = false;
+	m_names.clear();
+	m_widths.clear();
+	m_slotsByAdapterIndex.clear();
+	m_archRegisters.clear();
+}
+
+
+uint32_t RegisterMap::GetSlot(uint32_t archRegister) const
+{
+	if (archRegister >= m_archRegisters.size())
+		return InvalidSlot;
+	return m_archRegisters[archRegister].slot;
+}
+
+
+bool RegisterMap::Fill(
+	const std::unordered_map<std::string, DebugRegister>& registers, std::vector<std::optional<uint64_t>>& values) const
+{
+	if (!m_valid)
+		return false;
+
+	values.assign(m_names.size(), std::nullopt);
+	for (const auto& [name, reg] : registers)
+	{
+		if (reg.m_registerIndex >= m_slotsByAdapterIndex.size())
+			return false;
+		uint32_t slot = m_slotsByAdapterIndex[reg.m_registerIndex];
+		if ((slot == InvalidSlot) || (m_names[slot] != name))
+			return false;
+		values[slot] = reg.m_value;
+	}
+	return true;
+}
+
+
+bool RegisterMap::GetValue(
+	uint32_t archRegister, const std::vector<std::optional<uint64_t>>& values, uint64_t& value) const
+{
+	if (archRegister >= m_archRegisters.size())
+		return false;
+
+	const ArchRegister& entry = m_archRegisters[archRegister];
+	if ((entry.slot == InvalidSlot) || (entry.slot >= values.size()) || !values[entry.slot].has_value())
+		return false;
+
+	value = (values[entry.slot].value() >> entry.shift) & entry.mask;
+	return true;
+}
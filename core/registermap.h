@@ -0,0 +1,77 @@
+/*
+Copyright 2020-2024 Vector 35 Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "binaryninjaapi.h"
+#include "debugadapter.h"
+
+namespace BinaryNinjaDebugger {
+	// Maps the registers of the architecture, by index, to the registers that the adapter reports, by slot. It is
+	// built once per session from the first full register read, so the registers can be looked up by index afterwards
+	// instead of by name.
+	//
+	// An architecture register resolves to the adapter register of the same name, or of a known alias, e.g., x29 is
+	// reported as fp by LLDB. A sub-register that the adapter does not report on its own, e.g., eax on x86_64, resolves
+	// to the bits of its full width register.
+	class RegisterMap
+	{
+		struct ArchRegister
+		{
+			uint32_t slot = InvalidSlot;
+			uint8_t shift = 0;
+			uint64_t mask = UINT64_MAX;
+		};
+
+		bool m_valid = false;
+		// Name and width of every slot, in the order the adapter enumerates them
+		std::vector<std::string> m_names;
+		std::vector<size_t> m_widths;
+		// The slot of every adapter index. The adapters number their registers densely, so this stays small.
+		std::vector<uint32_t> m_slotsByAdapterIndex;
+		std::vector<ArchRegister> m_archRegisters;
+
+		uint32_t FindSlot(const std::unordered_map<std::string, uint32_t>& slots, const std::string& name) const;
+
+	public:
+		static constexpr uint32_t InvalidSlot = UINT32_MAX;
+
+		void Build(BinaryNinja::Ref<BinaryNinja::Architecture> arch,
+			const std::unordered_map<std::string, DebugRegister>& registers);
+		void Clear();
+		bool IsValid() const { return m_valid; }
+
+		size_t GetSlotCount() const { return m_names.size(); }
+		const std::string& GetSlotName(uint32_t slot) const { return m_names[slot]; }
+		size_t GetSlotWidth(uint32_t slot) const { return m_widths[slot]; }
+		// The adapter register that holds the architecture register, or InvalidSlot. For a sub-register, this is the
+		// slot of its full width register.
+		uint32_t GetSlot(uint32_t archRegister) const;
+
+		// Stores the value of every register into values, indexed by slot. Returns false if the registers do not
+		// match the ones the map was built from, in which case it must be rebuilt.
+		bool Fill(const std::unordered_map<std::string, DebugRegister>& registers,
+			std::vector<std::optional<uint64_t>>& values) const;
+		// The value of an architecture register, given the values stored by Fill()
+		bool GetValue(
+			uint32_t archRegister, const std::vector<std::optional<uint64_t>>& values, uint64_t& value) const;
+	};
+};  // namespace BinaryNinjaDebugger
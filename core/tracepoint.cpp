@@ -0,0 +1,96 @@
+/*
+Copyright 2020-2024 Vector 35 Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "tracepoint.h"
+#include <cctype>
+#include <charconv>
+#include "fmt/format.h"
+
+using namespace BinaryNinjaDebugger;
+
+// Snippets are meant for a few lines of a buffer or a structure, not for dumping memory on every hit
+static constexpr size_t MaxTraceSnippetSize = 0x1000;
+
+
+static std::string Trim(const std::string& text)
+{
+	size_t start = 0;
+	while ((start < text.size()) && isspace((unsigned char)text[start]))
+		start++;
+	size_t end = text.size();
+	while ((end > start) && isspace((unsigned char)text[end - 1]))
+		end--;
+	return text.substr(start, end - start);
+}
+
+
+bool BinaryNinjaDebugger::ParseTraceCaptures(
+	const std::string& text, std::vector<TraceCapture>& captures, std::string& error)
+{
+	captures.clear();
+	size_t start = 0;
+	while (start <= text.size())
+	{
+		size_t end = text.find(',', start);
+		if (end == std::string::npos)
+			end = text.size();
+
+		std::string item = Trim(text.substr(start, end - start));
+		start = end + 1;
+		if (item.empty())
+		{
+			// Allow "" and a trailing comma, but not an empty item in the middle
+			if (start > text.size())
+				break;
+			error = "empty capture";
+			return false;
+		}
+
+		TraceCapture capture;
+		auto colon = item.rfind(':');
+		if (colon != std::string::npos)
+		{
+			std::string sizeText = Trim(item.substr(colon + 1));
+			// Decimal or 0x hex, like the literals of the condition syntax
+			bool hex = (sizeText.compare(0, 2, "0x") == 0) || (sizeText.compare(0, 2, "0X") == 0);
+			const char* start = sizeText.data() + (hex ? 2 : 0);
+			const char* end = sizeText.data() + sizeText.size();
+			auto result = std::from_chars(start, end, capture.size, hex ? 16 : 10);
+			if ((result.ec != std::errc()) || (result.ptr != end))
+			{
+				error = fmt::format("invalid snippet size \"{}\"", sizeText);
+				return false;
+			}
+			if ((capture.size == 0) || (capture.size > MaxTraceSnippetSize))
+			{
+				error = fmt::format("snippet size must be between 1 and {:#x}", MaxTraceSnippetSize);
+				return false;
+			}
+			item = Trim(item.substr(0, colon));
+		}
+
+		std::string expressionError;
+		capture.expression = BreakpointCondition::Compile(item, expressionError);
+		if (!capture.expression)
+		{
+			error = fmt::format("\"{}\": {}", item, expressionError);
+			return false;
+		}
+		captures.push_back(capture);
+	}
+	return true;
+}
+
@@ -0,0 +1,147 @@
+/*
+Copyright 2020-2024 Vector 35 Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <mutex>
+#include "breakpointcondition.h"
+
+namespace BinaryNinjaDebugger {
+	// One value a tracepoint records on every hit. Without a size, this is the value of the expression, e.g., "rdi"
+	// or "[rsp+8]". With a size, written as "expr:size", it is a snippet of that many bytes read at the address the
+	// expression evaluates to, e.g., "rsi:32".
+	struct TraceCapture
+	{
+		std::shared_ptr<BreakpointCondition> expression;
+		size_t size = 0;
+	};
+
+
+	// Parses a comma-separated list of captures, e.g., "rdi, [rsp+8], rsi:32". Returns false and fills error if any of
+	// them is invalid.
+	bool ParseTraceCaptures(const std::string& text, std::vector<TraceCapture>& captures, std::string& error);
+
+
+	struct TraceValue
+	{
+		// False if a register or memory read failed
+		bool valid = false;
+		uint64_t value = 0;
+		// The snippet, for captures with a size
+		std::vector<uint8_t> data;
+	};
+
+
+	struct TraceRecord
+	{
+		uint64_t address = 0;
+		std::uint32_t threadId = 0;
+		// Nanoseconds of a monotonic clock, only meaningful relative to each other
+		uint64_t timestamp = 0;
+		// One per capture, in the order of the tracepoint
+		std::vector<TraceValue> values;
+	};
+
+
+	// A bounded ring buffer of records, e.g., tracepoint or watchpoint hits. When it is full, the oldest record is
+	// overwritten and counted as dropped, so a tracepoint that fires faster than the records are drained never makes
+	// the core grow without bound.
+	template <typename Record>
+	class TraceBuffer
+	{
+		std::mutex m_mutex;
+		std::vector<Record> m_records;
+		size_t m_capacity;
+		// Index of the oldest record
+		size_t m_head = 0;
+		size_t m_count = 0;
+		uint64_t m_dropped = 0;
+
+	public:
+		TraceBuffer(size_t capacity): m_capacity(std::max<size_t>(capacity, 1)) {}
+
+		void Push(Record&& record)
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			if (m_records.size() < m_capacity)
+			{
+				// Not wrapped around yet, so the records are stored in order from m_head to the end of the vector
+				m_records.push_back(std::move(record));
+				m_count++;
+				return;
+			}
+
+			size_t tail = (m_head + m_count) % m_capacity;
+			m_records[tail] = std::move(record);
+			if (m_count == m_capacity)
+			{
+				m_head = (m_head + 1) % m_capacity;
+				m_dropped++;
+			}
+			else
+			{
+				m_count++;
+			}
+		}
+
+		// Removes and returns up to maxCount of the oldest records; all of them if maxCount is 0
+		std::vector<Record> Drain(size_t maxCount = 0)
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			size_t count = ((maxCount == 0) || (maxCount > m_count)) ? m_count : maxCount;
+			std::vector<Record> result;
+			result.reserve(count);
+			for (size_t i = 0; i < count; i++)
+				result.push_back(std::move(m_records[(m_head + i) % m_records.size()]));
+
+			m_count -= count;
+			if (m_count == 0)
+			{
+				// Start over at index 0, which keeps Push() simple while the buffer has not wrapped yet. clear() keeps
+				// the allocation of the vector itself.
+				m_records.clear();
+				m_head = 0;
+			}
+			else
+			{
+				m_head = (m_head + count) % m_records.size();
+			}
+			return result;
+		}
+
+		size_t GetCount()
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			return m_count;
+		}
+
+		uint64_t GetDroppedCount()
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			return m_dropped;
+		}
+
+		void Clear()
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_records.clear();
+			m_head = 0;
+			m_count = 0;
+			m_dropped = 0;
+		}
+	};
+};  // namespace BinaryNinjaDebugger
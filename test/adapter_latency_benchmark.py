@@ -0,0 +1,78 @@
+#!/usr/bin/env python3
+#
+# Measures how long it takes from launching the target to its first stop, from quitting the target until the debugger
+# reports it is gone, and from resuming the target until it exits. The adapter listener used to poll for events once a
+# second, which showed up in these numbers. This is a benchmark, not a unit test, and it is not run by debugger_test.py.
+#
+# Usage: python3 adapter_latency_benchmark.py [binary] [iterations]
+# By default, it uses the helloworld test binary and 10 iterations.
+
+import statistics
+import sys
+import time
+
+from binaryninja import load, Settings
+try:
+    from debugger import DebuggerController, DebugStopReason
+except:
+    from binaryninja.debugger import DebuggerController, DebugStopReason
+
+from debugger_test import name_to_fpath
+
+
+def timed(func):
+    start = time.perf_counter()
+    result = func()
+    return result, time.perf_counter() - start
+
+
+def report(name, samples):
+    if not samples:
+        print(f'{name:>24}: no samples')
+        return
+    samples_ms = [sample * 1000 for sample in samples]
+    print(f'{name:>24}: min {min(samples_ms):8.1f}ms, median {statistics.median(samples_ms):8.1f}ms, '
+          f'max {max(samples_ms):8.1f}ms ({len(samples_ms)} runs)')
+
+
+def bench(bv, iterations):
+    dbg = DebuggerController(bv)
+    launch_times = []
+    quit_times = []
+    exit_times = []
+    for _ in range(iterations):
+        reason, launch_time = timed(dbg.launch_and_wait)
+        if reason in [DebugStopReason.ProcessExited, DebugStopReason.InternalError]:
+            print(f'failed to launch the target: {reason}')
+            return
+        launch_times.append(launch_time)
+        _, quit_time = timed(dbg.quit_and_wait)
+        quit_times.append(quit_time)
+
+        dbg.launch_and_wait()
+        reason, exit_time = timed(dbg.go_and_wait)
+        if reason == DebugStopReason.ProcessExited:
+            exit_times.append(exit_time)
+        else:
+            dbg.quit_and_wait()
+
+    report('launch to first stop', launch_times)
+    report('quit', quit_times)
+    report('go to exit', exit_times)
+
+
+def main():
+    fpath = name_to_fpath('helloworld')
+    iterations = 10
+    if len(sys.argv) > 1:
+        fpath = sys.argv[1]
+    if len(sys.argv) > 2:
+        iterations = int(sys.argv[2], 0)
+
+    bv = load(fpath)
+    print(f'multi-target mode: {Settings().get_bool("debugger.lldbMultiTarget")}')
+    bench(bv, iterations)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,112 @@
+#!/usr/bin/env python3
+#
+# Times adding, applying and removing a large number of breakpoints, e.g., to restore a saved set of coverage
+# breakpoints. This is a benchmark, not a unit test, and it is not run by debugger_test.py.
+#
+# Usage: python3 breakpoint_benchmark.py [binary] [count ...]
+# By default, it uses the helloworld test binary and 1000, 10000 and 100000 breakpoints. The breakpoints are placed on
+# consecutive bytes of the executable segments, so the counts are capped to the size of those segments.
+
+import sys
+import time
+
+from binaryninja import load
+try:
+    from debugger import DebuggerController, DebugStopReason, ModuleNameAndOffset
+except:
+    from binaryninja.debugger import DebuggerController, DebugStopReason, ModuleNameAndOffset
+
+from debugger_test import name_to_fpath
+
+
+def executable_offsets(bv, count):
+    offsets = []
+    for segment in bv.segments:
+        if not segment.executable:
+            continue
+        for address in range(segment.start, segment.end):
+            offsets.append(address - bv.start)
+            if len(offsets) == count:
+                return offsets
+    return offsets
+
+
+def clear_breakpoints(dbg):
+    dbg.delete_breakpoints([ModuleNameAndOffset(bp.module, bp.offset) for bp in dbg.breakpoints])
+
+
+def timed(func):
+    start = time.perf_counter()
+    result = func()
+    return result, time.perf_counter() - start
+
+
+def bench(bv, count):
+    module = bv.file.original_filename
+    breakpoints = [ModuleNameAndOffset(module, offset) for offset in executable_offsets(bv, count)]
+    if len(breakpoints) < count:
+        print(f'note: only {len(breakpoints)} executable bytes, using that many breakpoints')
+
+    dbg = DebuggerController(bv)
+    clear_breakpoints(dbg)
+
+    # Without a target, this only updates the breakpoint list and the metadata of the view
+    added, add_time = timed(lambda: dbg.add_breakpoints(breakpoints))
+
+    # The breakpoints are applied to the target while launching
+    reason, launch_time = timed(dbg.launch_and_wait)
+    if reason in [DebugStopReason.ProcessExited, DebugStopReason.InternalError]:
+        print(f'failed to launch the target: {reason}')
+        return
+
+    removed, delete_time = timed(lambda: dbg.delete_breakpoints(breakpoints))
+    dbg.quit_and_wait()
+
+    print(f'{len(breakpoints):>8} breakpoints: add {add_time:8.3f}s ({added}), launch and apply {launch_time:8.3f}s, '
+          f'delete while running {delete_time:8.3f}s ({removed})')
+
+
+def bench_launch(bv):
+    # Baseline for the launch time, without any breakpoints
+    dbg = DebuggerController(bv)
+    clear_breakpoints(dbg)
+    _, launch_time = timed(dbg.launch_and_wait)
+    dbg.quit_and_wait()
+    print(f'{0:>8} breakpoints: launch {launch_time:8.3f}s')
+
+
+def bench_one_by_one(bv, count):
+    # For comparison, the same breakpoints added one at a time while the target is running
+    module = bv.file.original_filename
+    breakpoints = [ModuleNameAndOffset(module, offset) for offset in executable_offsets(bv, count)]
+    dbg = DebuggerController(bv)
+    clear_breakpoints(dbg)
+    dbg.launch_and_wait()
+
+    def add_all():
+        for breakpoint in breakpoints:
+            dbg.add_breakpoint(breakpoint)
+
+    _, add_time = timed(add_all)
+    dbg.delete_breakpoints(breakpoints)
+    dbg.quit_and_wait()
+    print(f'{len(breakpoints):>8} breakpoints: add one by one while running {add_time:8.3f}s')
+
+
+def main():
+    fpath = name_to_fpath('helloworld')
+    counts = [1000, 10000, 100000]
+    if len(sys.argv) > 1:
+        fpath = sys.argv[1]
+    if len(sys.argv) > 2:
+        counts = [int(count, 0) for count in sys.argv[2:]]
+
+    bv = load(fpath)
+    bench_launch(bv)
+    for count in counts:
+        bench(bv, count)
+    bench_one_by_one(bv, min(counts))
+
+
+if __name__ == '__main__':
+    main()
@@ -10,11 +10,11 @@ import threading
 import subprocess
 import unittest
 
-from binaryninja import load
+from binaryninja import load, Settings
 try:
-    from debugger import DebuggerController, DebugStopReason
+    from debugger import DebuggerController, DebugStopReason, DebugWatchpointType
 except:
-    from binaryninja.debugger import DebuggerController, DebugStopReason
+    from binaryninja.debugger import DebuggerController, DebugStopReason, DebugWatchpointType
 
 # 'helloworld' -> '{BN_SOURCE_ROOT}\public\debugger\test\binaries\Windows-x64\helloworld.exe' (windows)
 # 'helloworld' -> '{BN_SOURCE_ROOT}/public/debugger/test/binaries/Darwin/arm64/helloworld' (linux, macOS)
@@ -192,6 +192,235 @@ class DebuggerAPI(unittest.TestCase):
         self.assertEqual(dbg.ip, entry)
         dbg.quit_and_wait()
 
+    def first_argument(self):
+        # The expression of the first int argument at the start of a function, in the breakpoint condition syntax
+        if self.arch == 'x86':
+            return 'dword[esp+4]'
+        if self.arch == 'x86_64':
+            return '(rcx & 0xffffffff)' if platform.system() == 'Windows' else '(rdi & 0xffffffff)'
+        return '(x0 & 0xffffffff)'
+
+    def test_breakpoint_condition(self):
+        fpath = name_to_fpath('helloworld_recursion', self.arch)
+        bv = load(fpath)
+        dbg = DebuggerController(bv)
+        # fib(6) calls fib(5) right away, so the first hit is skipped and the second one stops
+        dbg.cmd_line = '6'
+        self.assertNotIn(dbg.launch_and_wait(), [DebugStopReason.ProcessExited, DebugStopReason.InternalError])
+
+        fib = dbg.data.get_functions_by_name('fib')[0].start
+        dbg.add_breakpoint(fib)
+        self.assertFalse(dbg.set_breakpoint_condition(fib, '(('))
+        self.assertFalse(dbg.set_breakpoint_condition(fib + 1, '1'))
+        self.assertTrue(dbg.set_breakpoint_condition(fib, f'{self.first_argument()} == 5'))
+
+        reason = sleep_and_go(dbg)
+        self.assertEqual(reason, DebugStopReason.Breakpoint)
+        self.assertEqual(dbg.ip, fib)
+        bp = [bp for bp in dbg.breakpoints if bp.address == fib][0]
+        self.assertEqual(bp.hit_count, 1)
+        self.assertEqual(bp.skip_count, 1)
+
+        # An unconditional breakpoint stops at the next call, i.e., fib(4)
+        self.assertTrue(dbg.set_breakpoint_condition(fib, ''))
+        reason = sleep_and_go(dbg)
+        self.assertEqual(reason, DebugStopReason.Breakpoint)
+        self.assertEqual(dbg.ip, fib)
+        dbg.quit_and_wait()
+
+    def test_step_return(self):
+        fpath = name_to_fpath('helloworld_recursion', self.arch)
+        bv = load(fpath)
+        dbg = DebuggerController(bv)
+        dbg.cmd_line = '6'
+        self.assertNotIn(dbg.launch_and_wait(), [DebugStopReason.ProcessExited, DebugStopReason.InternalError])
+
+        fib = dbg.data.get_functions_by_name('fib')[0].start
+        dbg.add_breakpoint(fib)
+        self.assertTrue(dbg.set_breakpoint_condition(fib, f'{self.first_argument()} == 3'))
+        reason = sleep_and_go(dbg)
+        self.assertEqual(reason, DebugStopReason.Breakpoint)
+        self.assertEqual(dbg.ip, fib)
+        dbg.delete_breakpoint(fib)
+
+        # fib(3) calls fib(2), which returns to the same call site in fib(3). Stepping out must skip that return and
+        # stop in the caller of fib(3).
+        frames = dbg.frames_of_thread(dbg.active_thread.tid)
+        return_address = frames[1].pc
+        sp = dbg.stack_pointer
+        time.sleep(0.1)
+        self.assertNotIn(dbg.step_return_and_wait(), [DebugStopReason.ProcessExited, DebugStopReason.InternalError])
+        self.assertEqual(dbg.ip, return_address)
+        self.assertGreater(dbg.stack_pointer, sp)
+
+        # The next fib(3) is called by fib(5) at the second call site. Stop it mid-body at that call site, after its
+        # own fib(2) call returned. The fib(1) call made there returns to the same address with the same stack
+        # pointer, so the step out must go past it.
+        dbg.add_breakpoint(fib)
+        self.assertTrue(dbg.set_breakpoint_condition(fib, f'{self.first_argument()} == 3'))
+        reason = sleep_and_go(dbg)
+        self.assertEqual(reason, DebugStopReason.Breakpoint)
+        self.assertEqual(dbg.ip, fib)
+        dbg.delete_breakpoint(fib)
+
+        frames = dbg.frames_of_thread(dbg.active_thread.tid)
+        return_address = frames[1].pc
+        depth = len(frames)
+        sp = dbg.stack_pointer
+        fib_function = dbg.data.get_functions_at(fib)[0]
+        call_site = [ref.address for ref in fib_function.call_sites
+                     if ref.address + dbg.data.get_instruction_length(ref.address) == return_address][0]
+        dbg.add_breakpoint(call_site)
+        while True:
+            reason = sleep_and_go(dbg)
+            self.assertEqual(reason, DebugStopReason.Breakpoint)
+            if len(dbg.frames_of_thread(dbg.active_thread.tid)) == depth:
+                break
+        dbg.delete_breakpoint(call_site)
+
+        time.sleep(0.1)
+        self.assertNotIn(dbg.step_return_and_wait(), [DebugStopReason.ProcessExited, DebugStopReason.InternalError])
+        self.assertEqual(dbg.ip, return_address)
+        self.assertGreater(dbg.stack_pointer, sp)
+        self.assertEqual(len(dbg.frames_of_thread(dbg.active_thread.tid)), depth - 1)
+
+        reason = sleep_and_go(dbg)
+        self.assertEqual(reason, DebugStopReason.ProcessExited)
+
+    def test_breakpoint_changes(self):
+        fpath = name_to_fpath('helloworld_recursion', self.arch)
+        bv = load(fpath)
+        dbg = DebuggerController(bv)
+        self.assertNotIn(dbg.launch_and_wait(), [DebugStopReason.ProcessExited, DebugStopReason.InternalError])
+
+        fib = dbg.data.get_functions_by_name('fib')[0].start
+        version = dbg.breakpoint_version
+        dbg.add_breakpoint(fib)
+        new_version, changes = dbg.get_breakpoint_changes(version)
+        self.assertGreater(new_version, version)
+        self.assertEqual([(change.address, change.added) for change in changes], [(fib, True)])
+
+        dbg.delete_breakpoint(fib)
+        version, changes = dbg.get_breakpoint_changes(new_version)
+        self.assertEqual([(change.address, change.added) for change in changes], [(fib, False)])
+
+        # Nothing changed since the last call
+        self.assertEqual(dbg.get_breakpoint_changes(version), (version, []))
+        dbg.quit_and_wait()
+
+    def test_bulk_breakpoints(self):
+        fpath = name_to_fpath('helloworld_recursion', self.arch)
+        bv = load(fpath)
+        dbg = DebuggerController(bv)
+        dbg.cmd_line = '6'
+        self.assertNotIn(dbg.launch_and_wait(), [DebugStopReason.ProcessExited, DebugStopReason.InternalError])
+
+        # Only the breakpoints that do not exist yet are counted
+        fib = dbg.data.get_functions_by_name('fib')[0].start
+        self.assertEqual(dbg.add_breakpoints([fib, fib]), 1)
+        self.assertEqual(dbg.add_breakpoints([fib]), 0)
+        self.assertEqual([bp.address for bp in dbg.breakpoints].count(fib), 1)
+
+        reason = sleep_and_go(dbg)
+        self.assertEqual(reason, DebugStopReason.Breakpoint)
+        self.assertEqual(dbg.ip, fib)
+        # The events of the bulk operation must not add the breakpoint a second time
+        self.assertEqual([bp.address for bp in dbg.breakpoints].count(fib), 1)
+
+        self.assertEqual(dbg.delete_breakpoints([fib]), 1)
+        self.assertEqual(dbg.delete_breakpoints([fib]), 0)
+        reason = sleep_and_go(dbg)
+        self.assertEqual(reason, DebugStopReason.ProcessExited)
+
+    def test_tracepoint(self):
+        fpath = name_to_fpath('helloworld_recursion', self.arch)
+        bv = load(fpath)
+        dbg = DebuggerController(bv)
+        dbg.cmd_line = '6'
+        self.assertNotIn(dbg.launch_and_wait(), [DebugStopReason.ProcessExited, DebugStopReason.InternalError])
+
+        fib = dbg.data.get_functions_by_name('fib')[0].start
+        self.assertFalse(dbg.add_tracepoint(fib, '1 +'))
+        self.assertTrue(dbg.add_tracepoint(fib, self.first_argument()))
+        bp = [bp for bp in dbg.breakpoints if bp.address == fib][0]
+        self.assertTrue(bp.is_tracepoint)
+
+        # The tracepoint never stops the target, and fib(6) takes 25 calls
+        reason = sleep_and_go(dbg)
+        self.assertEqual(reason, DebugStopReason.ProcessExited)
+        records = dbg.drain_trace_records()
+        self.assertEqual(len(records), 25)
+        self.assertEqual(records[0].address, fib)
+        self.assertEqual(records[0].values, [6])
+        self.assertEqual(records[1].values, [5])
+        self.assertEqual(dbg.drain_trace_records(), [])
+        self.assertEqual(dbg.dropped_trace_record_count, 0)
+
+    @unittest.skipIf(platform.system() == 'Windows', 'Watchpoints are only supported by the LLDB adapter')
+    def test_watchpoint(self):
+        fpath = name_to_fpath('helloworld_recursion', self.arch)
+        bv = load(fpath)
+        dbg = DebuggerController(bv)
+        dbg.cmd_line = '6'
+        self.assertNotIn(dbg.launch_and_wait(), [DebugStopReason.ProcessExited, DebugStopReason.InternalError])
+
+        # The calls of the target write their frames below the current stack pointer
+        address = (dbg.stack_pointer - 0x200) & ~7
+        self.assertTrue(dbg.add_watchpoint(address, 8, DebugWatchpointType.WriteWatchpoint, record=True))
+        self.assertFalse(dbg.add_watchpoint(address, 8))
+        self.assertFalse(dbg.add_watchpoint(address - 0x10, 3))
+        self.assertEqual([wp.address for wp in dbg.watchpoints], [address])
+
+        # A watchpoint set from the backend console is tracked too, once the adapter reports it
+        other = address - 0x100
+        dbg.execute_backend_command(f'watchpoint set expression -w write -s 4 -- {other:#x}')
+        for _ in range(50):
+            if other in [wp.address for wp in dbg.watchpoints]:
+                break
+            time.sleep(0.1)
+        watchpoints = {wp.address: wp for wp in dbg.watchpoints}
+        self.assertEqual(len(watchpoints), 2)
+        self.assertEqual(watchpoints[other].size, 4)
+        self.assertFalse(watchpoints[other].record)
+        self.assertTrue(dbg.delete_watchpoint(other))
+        self.assertFalse(dbg.delete_watchpoint(other))
+
+        # The recording watchpoint never stops the target
+        reason = sleep_and_go(dbg)
+        self.assertEqual(reason, DebugStopReason.ProcessExited)
+        hits = dbg.drain_watchpoint_hits()
+        self.assertGreater(len(hits), 0)
+        self.assertEqual(hits[0].address, address)
+        self.assertEqual(dbg.watchpoints, [])
+
+    def test_coverage(self):
+        fpath = name_to_fpath('helloworld_recursion', self.arch)
+        bv = load(fpath)
+        dbg = DebuggerController(bv)
+        dbg.clear_coverage()
+        dbg.cmd_line = '6'
+        self.assertNotIn(dbg.launch_and_wait(), [DebugStopReason.ProcessExited, DebugStopReason.InternalError])
+
+        fib = dbg.data.get_functions_by_name('fib')[0]
+        blocks = dbg.add_coverage(fib)
+        self.assertEqual(blocks, len(fib.basic_blocks))
+        self.assertEqual(dbg.add_coverage(fib), 0)
+        self.assertEqual(dbg.coverage_hit_count, 0)
+
+        # The coverage breakpoints never stop the target, and fib(6) reaches both of its returns
+        reason = sleep_and_go(dbg)
+        self.assertEqual(reason, DebugStopReason.ProcessExited)
+        hits = dbg.get_coverage_hits()
+        self.assertEqual(len(hits), dbg.coverage_hit_count)
+        self.assertGreater(len(hits), 1)
+        self.assertLessEqual(len(hits), blocks)
+        self.assertEqual(hits[0], fib.start)
+        self.assertEqual(len(set(hits)), len(hits))
+
+        dbg.clear_coverage()
+        self.assertEqual(dbg.coverage_block_count, 0)
+        self.assertEqual(dbg.coverage_hit_count, 0)
+
     def test_register_read_write(self):
         fpath = name_to_fpath('helloworld', self.arch)
         bv = load(fpath)
@@ -244,6 +473,61 @@ class DebuggerAPI(unittest.TestCase):
 
         dbg.quit_and_wait()
 
+    def test_record_execution(self):
+        fpath = name_to_fpath('helloworld', self.arch)
+        bv = load(fpath)
+        dbg = DebuggerController(bv)
+        self.assertNotIn(dbg.launch_and_wait(), [DebugStopReason.ProcessExited, DebugStopReason.InternalError])
+        settings = Settings()
+        settings.set_bool('debugger.recordExecution', True)
+        try:
+            self.assertTrue(dbg.is_reverse_execution_supported)
+            self.assertFalse(dbg.is_ttd)
+
+            # Record a few steps, and go back to the start by replaying them
+            trace = [(dbg.ip, dbg.stack_pointer)]
+            for _ in range(5):
+                self.assertEqual(sleep_and_step_into(dbg), DebugStopReason.SingleStep)
+                trace.append((dbg.ip, dbg.stack_pointer))
+            for i in range(4, -1, -1):
+                time.sleep(0.1)
+                self.assertNotIn(dbg.step_into_reverse_and_wait(),
+                                 [DebugStopReason.ProcessExited, DebugStopReason.InternalError])
+                self.assertEqual((dbg.ip, dbg.stack_pointer), trace[i])
+
+            # Stepping forward replays the journal until its end
+            for i in range(1, 6):
+                self.assertNotIn(sleep_and_step_into(dbg), [DebugStopReason.ProcessExited, DebugStopReason.InternalError])
+                self.assertEqual((dbg.ip, dbg.stack_pointer), trace[i])
+        finally:
+            settings.reset('debugger.recordExecution')
+
+        self.assertFalse(dbg.is_reverse_execution_supported)
+        reason = sleep_and_go(dbg)
+        self.assertEqual(reason, DebugStopReason.ProcessExited)
+
+    def test_memory_read_into(self):
+        fpath = name_to_fpath('helloworld', self.arch)
+        bv = load(fpath)
+        dbg = DebuggerController(bv)
+        self.assertNotIn(dbg.launch_and_wait(), [DebugStopReason.ProcessExited, DebugStopReason.InternalError])
+
+        addr = dbg.ip + 10
+        data = bytes(dbg.read_memory(addr, 256))
+        buffer = bytearray(256)
+        self.assertEqual(dbg.read_memory_into(addr, buffer), 256)
+        self.assertEqual(bytes(buffer), data)
+        self.assertEqual(dbg.read_memory_into(addr, buffer, 16), 16)
+        self.assertEqual(dbg.read_memory_into(0, buffer), 0)
+
+        # The ranges are stored one after another, and an unreadable range does not stop the others
+        buffer = bytearray(32)
+        self.assertEqual(dbg.read_memory_ranges([(addr, 16), (0, 8), (addr + 32, 8)], buffer), [16, 0, 8])
+        self.assertEqual(bytes(buffer[:16]), data[:16])
+        self.assertEqual(bytes(buffer[24:]), data[32:40])
+
+        dbg.quit_and_wait()
+
     # @unittest.skip
     def test_thread(self):
         fpath = name_to_fpath('helloworld_thread', self.arch)
@@ -14,6 +14,11 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
+#include <QCoreApplication>
+#include <QPointer>
+#include <algorithm>
+#include <map>
+#include <thread>
 #include "attachprocess.h"
 
 
@@ -23,12 +28,19 @@ using namespace std;
 
 constexpr int SortFilterRole = Qt::UserRole + 1;
 
-ProcessItem::ProcessItem(uint32_t pid, std::string processName) : m_pid(pid), m_processName(processName) {}
+// How often the list is refreshed while the dialog is open, in milliseconds
+constexpr int ProcessListRefreshInterval = 3000;
+
+ProcessItem::ProcessItem(const DebugProcess& process) :
+	m_pid(process.m_pid), m_processName(process.m_processName), m_parentPid(process.m_parentPid),
+	m_user(process.m_user), m_arch(process.m_arch), m_commandLine(process.m_commandLine)
+{}
 
 
 bool ProcessItem::operator==(const ProcessItem& other) const
 {
-	return (m_pid == other.pid()) && (m_processName == other.processName());
+	return (m_pid == other.pid()) && (m_processName == other.processName()) && (m_parentPid == other.parentPid())
+		&& (m_user == other.user()) && (m_arch == other.arch()) && (m_commandLine == other.commandLine());
 }
 
 
@@ -70,7 +82,7 @@ QModelIndex ProcessListModel::index(int row, int column, const QModelIndex&) con
 		return QModelIndex();
 	}
 
-	return createIndex(row, column, (void*)&m_items[row]);
+	return createIndex(row, column);
 }
 
 
@@ -79,33 +91,43 @@ QVariant ProcessListModel::data(const QModelIndex& index, int role) const
 	if (index.column() >= columnCount() || (size_t)index.row() >= m_items.size())
 		return QVariant();
 
-	ProcessItem* item = static_cast<ProcessItem*>(index.internalPointer());
-	if (!item)
-		return QVariant();
+	// The rows move around as processes start and exit, so they are looked up by index rather than by a pointer
+	const ProcessItem& item = m_items[index.row()];
 
 	if ((role != Qt::DisplayRole) && (role != Qt::SizeHintRole) && (role != SortFilterRole))
 		return QVariant();
 
+	QString text;
 	switch (index.column())
 	{
 	case ProcessListModel::PidColumn:
-	{
-		QString text = QString::asprintf("%d", item->pid());
-		if (role == Qt::SizeHintRole)
-			return QVariant((qulonglong)text.size());
-
-		return QVariant(text);
-	}
+		text = QString::asprintf("%d", item.pid());
+		break;
+	case ProcessListModel::ParentPidColumn:
+		// Zero when unknown, and there is no process 0 to attach to anyways
+		if (item.parentPid() != 0)
+			text = QString::asprintf("%d", item.parentPid());
+		break;
+	case ProcessListModel::UserColumn:
+		text = QString::fromStdString(item.user());
+		break;
+	case ProcessListModel::ArchColumn:
+		text = QString::fromStdString(item.arch());
+		break;
 	case ProcessListModel::ProcessNameColumn:
-	{
-		QString text = QString::fromStdString(item->processName());
-		if (role == Qt::SizeHintRole)
-			return QVariant((qulonglong)text.size());
-
-		return QVariant(text);
-	}
+		text = QString::fromStdString(item.processName());
+		break;
+	case ProcessListModel::CommandLineColumn:
+		text = QString::fromStdString(item.commandLine());
+		break;
+	default:
+		return QVariant();
 	}
-	return QVariant();
+
+	if (role == Qt::SizeHintRole)
+		return QVariant((qulonglong)text.size());
+
+	return QVariant(text);
 }
 
 
@@ -121,24 +143,61 @@ QVariant ProcessListModel::headerData(int column, Qt::Orientation orientation, i
 	{
 	case ProcessListModel::PidColumn:
 		return "PID";
+	case ProcessListModel::ParentPidColumn:
+		return "PPID";
+	case ProcessListModel::UserColumn:
+		return "User";
+	case ProcessListModel::ArchColumn:
+		return "Arch";
 	case ProcessListModel::ProcessNameColumn:
 		return "Name";
+	case ProcessListModel::CommandLineColumn:
+		return "Command Line";
 	}
 	return QVariant();
 }
 
 
-void ProcessListModel::updateRows(std::vector<DebugProcess> processList)
+void ProcessListModel::updateRows(const std::vector<DebugProcess>& processList)
 {
-	beginResetModel();
-
-	std::vector<ProcessItem> newProcessList;
+	std::map<uint32_t, ProcessItem> newItems;
 	for (const DebugProcess& process : processList)
-		newProcessList.emplace_back(process.m_pid, process.m_processName);
+		newItems.emplace(process.m_pid, ProcessItem(process));
 
-	m_items = newProcessList;
+	// Drop the processes that have exited, and update the ones that are still there in place. Going backwards keeps
+	// the indices of the rows that are yet to be visited valid.
+	for (int row = (int)m_items.size() - 1; row >= 0; row--)
+	{
+		auto iter = newItems.find(m_items[row].pid());
+		if (iter == newItems.end())
+		{
+			beginRemoveRows(QModelIndex(), row, row);
+			m_items.erase(m_items.begin() + row);
+			endRemoveRows();
+			continue;
+		}
 
-	endResetModel();
+		if (iter->second != m_items[row])
+		{
+			m_items[row] = iter->second;
+			emit dataChanged(index(row, 0), index(row, columnCount() - 1));
+		}
+		newItems.erase(iter);
+	}
+
+	// The new processes go where the current sort order puts them, or at the end when the list is not sorted
+	for (const auto& [pid, item] : newItems)
+	{
+		auto position = m_items.end();
+		if (m_sortColumn != -1)
+			position = std::upper_bound(m_items.begin(), m_items.end(), item,
+				[this](const ProcessItem& a, const ProcessItem& b) { return lessThan(a, b); });
+
+		int row = (int)(position - m_items.begin());
+		beginInsertRows(QModelIndex(), row, row);
+		m_items.insert(position, item);
+		endInsertRows();
+	}
 }
 
 ProcessItemDelegate::ProcessItemDelegate(QWidget* parent) : QStyledItemDelegate(parent)
@@ -166,10 +225,14 @@ void ProcessItemDelegate::paint(QPainter* painter, const QStyleOptionViewItem& o
 	switch (idx.column())
 	{
 	case ProcessListModel::PidColumn:
+	case ProcessListModel::ParentPidColumn:
 		painter->setPen(getThemeColor(NumberColor).rgba());
 		painter->drawText(textRect, data.toString());
 		break;
+	case ProcessListModel::UserColumn:
+	case ProcessListModel::ArchColumn:
 	case ProcessListModel::ProcessNameColumn:
+	case ProcessListModel::CommandLineColumn:
 		painter->setPen(option.palette.color(QPalette::WindowText).rgba());
 		painter->drawText(textRect, data.toString());
 		break;
@@ -202,25 +265,36 @@ ProcessListFilterProxyModel::ProcessListFilterProxyModel(QObject* parent) : QSor
 	setFilterCaseSensitivity(Qt::CaseInsensitive);
 }
 
-void ProcessListModel::sort(int col, Qt::SortOrder order)
+bool ProcessListModel::lessThan(const ProcessItem& a, const ProcessItem& b) const
 {
-	std::sort(m_items.begin(), m_items.end(), [&](ProcessItem a, ProcessItem b) {
-		if (col == ProcessListModel::PidColumn)
-		{
-			if (order == Qt::AscendingOrder)
-				return a.pid() < b.pid();
-			else
-				return a.pid() > b.pid();
-		}
-		else if (col == ProcessListModel::ProcessNameColumn)
-		{
-			if (order == Qt::AscendingOrder)
-				return a.processName() < b.processName();
-			else
-				return a.processName() > b.processName();
-		}
+	const ProcessItem& lhs = (m_sortOrder == Qt::AscendingOrder) ? a : b;
+	const ProcessItem& rhs = (m_sortOrder == Qt::AscendingOrder) ? b : a;
+	switch (m_sortColumn)
+	{
+	case ProcessListModel::PidColumn:
+		return lhs.pid() < rhs.pid();
+	case ProcessListModel::ParentPidColumn:
+		return lhs.parentPid() < rhs.parentPid();
+	case ProcessListModel::UserColumn:
+		return lhs.user() < rhs.user();
+	case ProcessListModel::ArchColumn:
+		return lhs.arch() < rhs.arch();
+	case ProcessListModel::ProcessNameColumn:
+		return lhs.processName() < rhs.processName();
+	case ProcessListModel::CommandLineColumn:
+		return lhs.commandLine() < rhs.commandLine();
+	default:
 		return false;
-	});
+	}
+}
+
+
+void ProcessListModel::sort(int col, Qt::SortOrder order)
+{
+	m_sortColumn = col;
+	m_sortOrder = order;
+	std::stable_sort(m_items.begin(), m_items.end(),
+		[this](const ProcessItem& a, const ProcessItem& b) { return lessThan(a, b); });
 }
 
 
@@ -298,6 +372,13 @@ ProcessListWidget::ProcessListWidget(QWidget* parent, DbgRef<DebuggerController>
 
 	// TODO: context menu copy
 
+	m_refreshTimer = new QTimer(this);
+	m_refreshTimer->setInterval(ProcessListRefreshInterval);
+	connect(m_refreshTimer, &QTimer::timeout, this, &ProcessListWidget::updateContent);
+	m_refreshTimer->start();
+
+	// Creating the adapter is not thread safe, so it is done here rather than on the worker thread
+	m_controller->ActivateDebugAdapter();
 	updateContent();
 }
 
@@ -305,18 +386,65 @@ ProcessListWidget::ProcessListWidget(QWidget* parent, DbgRef<DebuggerController>
 ProcessListWidget::~ProcessListWidget(){}
 
 
+void ProcessListWidget::stopRefreshing()
+{
+	m_refreshTimer->stop();
+	m_refreshPending = false;
+}
+
+
 void ProcessListWidget::updateColumnWidths()
 {
-	resizeColumnToContents(ProcessListModel::PidColumn);
-	resizeColumnToContents(ProcessListModel::ProcessNameColumn);
+	// The command line is the last column, which stretches to the rest of the width
+	for (int column = 0; column < ProcessListModel::CommandLineColumn; column++)
+		resizeColumnToContents(column);
 }
 
 
 void ProcessListWidget::updateContent()
 {
-	std::vector<DebugProcess> processList = m_controller->GetProcessList();
+	if (m_refreshInFlight)
+	{
+		m_refreshPending = true;
+		return;
+	}
+
+	m_refreshInFlight = true;
+	m_refreshPending = false;
+
+	QPointer<ProcessListWidget> self(this);
+	DbgRef<DebuggerController> controller = m_controller;
+	std::thread([=]() {
+		std::vector<DebugProcess> processList = controller->GetAdapterProcessList();
+		QMetaObject::invokeMethod(
+			QCoreApplication::instance(),
+			[=]() {
+				if (self)
+					self->updateContentFinished(processList);
+			},
+			Qt::QueuedConnection);
+	}).detach();
+}
+
+
+void ProcessListWidget::updateContentFinished(std::vector<DebugProcess> processList)
+{
+	m_refreshInFlight = false;
+	if (m_refreshPending)
+	{
+		// A refresh was asked for while this one was running, so the list it read may already be outdated
+		updateContent();
+		return;
+	}
+
 	m_model->updateRows(processList);
-	updateColumnWidths();
+	// Only size the columns to the first list, so they do not jump around while the user is reading them
+	if (m_firstLoad)
+	{
+		m_firstLoad = false;
+		updateColumnWidths();
+	}
+	emit contentUpdated(processList.size());
 }
 
 
@@ -342,7 +470,7 @@ void ProcessListWidget::activateFirstItem() {}
 AttachProcessDialog::AttachProcessDialog(QWidget* parent, DbgRef<DebuggerController> controller) : QDialog(parent)
 {
 	setWindowTitle("Attach to process");
-	setMinimumSize(UIContext::getScaledWindowSize(450, 600));
+	setMinimumSize(UIContext::getScaledWindowSize(700, 600));
 	setSizeGripEnabled(true);
 	setModal(true);
 
@@ -365,6 +493,11 @@ AttachProcessDialog::AttachProcessDialog(QWidget* parent, DbgRef<DebuggerControl
 	QHBoxLayout* buttonLayout = new QHBoxLayout();
 	buttonLayout->setContentsMargins(0, 0, 0, 0);
 
+	m_statusLabel = new QLabel("Loading processes...");
+	connect(m_processListWidget, &ProcessListWidget::contentUpdated,
+		[this](size_t count) { m_statusLabel->setText(QString::asprintf("%zu processes", count)); });
+	buttonLayout->addWidget(m_statusLabel);
+
 	QPushButton* cancelButton = new QPushButton("Cancel");
 	connect(cancelButton, &QPushButton::clicked, [&]() { reject(); });
 
@@ -389,6 +522,13 @@ uint32_t AttachProcessDialog::GetSelectedPid()
 	return m_processListWidget->GetSelectedPid();
 }
 
+void AttachProcessDialog::done(int result)
+{
+	// The dialog is only hidden once it is done, so it would keep listing the processes while the debugger attaches
+	m_processListWidget->stopRefreshing();
+	QDialog::done(result);
+}
+
 void AttachProcessDialog::apply()
 {
 	m_selectedPid = m_processListWidget->GetSelectedPid();
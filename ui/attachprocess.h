@@ -25,6 +25,8 @@ limitations under the License.
 #include <QTableView>
 #include <QHeaderView>
 #include <QStyledItemDelegate>
+#include <QLabel>
+#include <QTimer>
 #include "debuggerapi.h"
 #include "ui.h"
 
@@ -34,11 +36,19 @@ class ProcessItem
 private:
 	uint32_t m_pid;
 	std::string m_processName;
+	uint32_t m_parentPid;
+	std::string m_user;
+	std::string m_arch;
+	std::string m_commandLine;
 
 public:
-	ProcessItem(uint32_t pid, std::string processName);
+	ProcessItem(const DebugProcess& process);
 	uint32_t pid() const { return m_pid; }
 	std::string processName() const { return m_processName; }
+	uint32_t parentPid() const { return m_parentPid; }
+	std::string user() const { return m_user; }
+	std::string arch() const { return m_arch; }
+	std::string commandLine() const { return m_commandLine; }
 	bool operator==(const ProcessItem& other) const;
 	bool operator!=(const ProcessItem& other) const;
 	bool operator<(const ProcessItem& other) const;
@@ -53,12 +63,22 @@ class ProcessListModel : public QAbstractTableModel
 
 protected:
 	std::vector<ProcessItem> m_items;
+	// The order set by the last sort(), which the processes that show up later are inserted in. -1 when unsorted.
+	int m_sortColumn = -1;
+	Qt::SortOrder m_sortOrder = Qt::AscendingOrder;
+
+	bool lessThan(const ProcessItem& a, const ProcessItem& b) const;
 
 public:
 	enum ColumnHeaders
 	{
 		PidColumn,
+		ParentPidColumn,
+		UserColumn,
+		ArchColumn,
 		ProcessNameColumn,
+		CommandLineColumn,
+		ColumnCount,
 	};
 
 	ProcessListModel(QWidget* parent);
@@ -74,14 +94,16 @@ public:
 	virtual int columnCount(const QModelIndex& parent = QModelIndex()) const override
 	{
 		(void)parent;
-		return 2;
+		return ColumnCount;
 	}
 	ProcessItem getRow(int row) const;
 	virtual QVariant data(const QModelIndex& i, int role) const override;
 	virtual QVariant headerData(int column, Qt::Orientation orientation, int role) const override;
 	virtual void sort(int col, Qt::SortOrder order) override;
-	
-	void updateRows(std::vector<DebugProcess> processList);
+
+	// Only the rows of the processes that started, exited or changed are touched, so the selection and the scroll
+	// position survive a refresh
+	void updateRows(const std::vector<DebugProcess>& processList);
 };
 
 
@@ -127,6 +149,14 @@ class ProcessListWidget : public QTableView, public FilterTarget
 	ContextMenuManager* m_contextMenuManager;
 	Menu* m_menu;
 
+	// The list is read on a worker thread, since it can take a while, especially from a remote platform
+	QTimer* m_refreshTimer;
+	bool m_refreshInFlight = false;
+	bool m_refreshPending = false;
+	bool m_firstLoad = true;
+
+	void updateContentFinished(std::vector<DebugProcess> processList);
+
 	virtual void contextMenuEvent(QContextMenuEvent* event) override;
 
 	virtual void setFilter(const std::string& filter) override;
@@ -154,6 +184,11 @@ public:
 	}
 
 	void updateColumnWidths();
+	// Stops the periodic refresh, e.g., once the dialog is accepted
+	void stopRefreshing();
+
+signals:
+	void contentUpdated(size_t count);
 
 public slots:
 	void updateContent();
@@ -168,11 +203,13 @@ private:
 	ProcessListWidget* m_processListWidget;
 	FilteredView* m_filter;
 	FilterEdit* m_separateEdit;
+	QLabel* m_statusLabel;
 	uint32_t m_selectedPid {};
 
 public:
 	AttachProcessDialog(QWidget* parent, DbgRef<DebuggerController> controller);
 	uint32_t GetSelectedPid();
+	virtual void done(int result) override;
 
 private Q_SLOTS:
 	void apply();
@@ -17,7 +17,10 @@ limitations under the License.
 #include <QPainter>
 #include <QHeaderView>
 #include <QFileInfo>
+#include <map>
+#include <set>
 #include "breakpointswidget.h"
+#include "watchpointdialog.h"
 #include "ui.h"
 #include "menus.h"
 #include "fmt/format.h"
@@ -31,9 +34,16 @@ BreakpointItem::BreakpointItem(bool enabled, const ModuleNameAndOffset location,
 {}
 
 
+BreakpointItem::BreakpointItem(const DebugWatchpoint& watchpoint) :
+	m_enabled(true), m_location({"", watchpoint.address}), m_address(watchpoint.address), m_isWatchpoint(true),
+	m_watchpoint(watchpoint)
+{}
+
+
 bool BreakpointItem::operator==(const BreakpointItem& other) const
 {
-	return (m_enabled == other.enabled()) && (m_location == other.location()) && (m_address == other.address());
+	return (m_enabled == other.enabled()) && (m_location == other.location()) && (m_address == other.address())
+		&& (m_isWatchpoint == other.isWatchpoint());
 }
 
 
@@ -45,6 +55,8 @@ bool BreakpointItem::operator!=(const BreakpointItem& other) const
 
 bool BreakpointItem::operator<(const BreakpointItem& other) const
 {
+	if (m_isWatchpoint != other.isWatchpoint())
+		return other.isWatchpoint();
 	if (m_enabled < other.enabled())
 		return true;
 	else if (m_enabled > other.enabled())
@@ -107,7 +119,18 @@ QVariant DebugBreakpointsListModel::data(const QModelIndex& index, int role) con
 	case DebugBreakpointsListModel::LocationColumn:
 	{
 		QString text;
-		if (item->location().module == "")
+		if (item->isWatchpoint())
+		{
+			const auto& watchpoint = item->watchpoint();
+			const char* type = "read/write";
+			if (watchpoint.type == ReadWatchpoint)
+				type = "read";
+			else if (watchpoint.type == WriteWatchpoint)
+				type = "write";
+			text = QString::fromStdString(fmt::format("{} watchpoint, {} bytes{}, {} hits", type, watchpoint.size,
+				watchpoint.record ? ", recording" : "", watchpoint.hitCount));
+		}
+		else if (item->location().module == "")
 		{
 			text = QString::fromStdString(fmt::format("0x{:x}", item->location().offset));
 		}
@@ -166,6 +189,102 @@ void DebugBreakpointsListModel::updateRows(std::vector<BreakpointItem> newRows)
 }
 
 
+// The breakpoints are listed before the watchpoints
+static std::vector<BreakpointItem>::iterator FindFirstWatchpoint(std::vector<BreakpointItem>& items)
+{
+	return std::find_if(items.begin(), items.end(), [](const BreakpointItem& item) { return item.isWatchpoint(); });
+}
+
+
+void DebugBreakpointsListModel::applyBreakpointChanges(const std::vector<DebugBreakpointChange>& changes)
+{
+	// Updating the rows one by one is a linear search per change, so large batches, e.g., adding the breakpoints of a
+	// coverage run, rebuild the list in one pass instead
+	static constexpr size_t MaxRowByRowChanges = 256;
+
+	if (changes.size() > MaxRowByRowChanges)
+	{
+		// The final state of every breakpoint in the batch, true if it ends up added
+		std::map<ModuleNameAndOffset, bool> finalState;
+		for (const DebugBreakpointChange& change : changes)
+			finalState[{change.module, change.offset}] = change.added;
+
+		std::vector<BreakpointItem> newRows;
+		newRows.reserve(m_items.size() + changes.size());
+		std::set<ModuleNameAndOffset> present;
+		auto watchpoints = FindFirstWatchpoint(m_items);
+		for (auto iter = m_items.begin(); iter != watchpoints; iter++)
+		{
+			auto state = finalState.find(iter->location());
+			if ((state != finalState.end()) && !state->second)
+				continue;
+			present.insert(iter->location());
+			newRows.push_back(*iter);
+		}
+
+		// Append the added ones in the order they were added, like the core does
+		for (const DebugBreakpointChange& change : changes)
+		{
+			ModuleNameAndOffset location {change.module, change.offset};
+			if (change.added && finalState[location] && present.insert(location).second)
+				newRows.emplace_back(false, location, change.address);
+		}
+
+		newRows.insert(newRows.end(), watchpoints, m_items.end());
+		updateRows(std::move(newRows));
+		return;
+	}
+
+	for (const DebugBreakpointChange& change : changes)
+	{
+		ModuleNameAndOffset location {change.module, change.offset};
+		auto iter = std::find_if(m_items.begin(), m_items.end(), [&](const BreakpointItem& item) {
+			return !item.isWatchpoint() && (item.location() == location);
+		});
+
+		if (change.added)
+		{
+			if (iter != m_items.end())
+				continue;
+
+			auto position = FindFirstWatchpoint(m_items);
+			int row = (int)(position - m_items.begin());
+			beginInsertRows(QModelIndex(), row, row);
+			// Same as GetBreakpoints(), which does not know whether a breakpoint is active in the target either
+			m_items.emplace(position, false, location, change.address);
+			endInsertRows();
+		}
+		else if (iter != m_items.end())
+		{
+			int row = (int)(iter - m_items.begin());
+			beginRemoveRows(QModelIndex(), row, row);
+			m_items.erase(iter);
+			endRemoveRows();
+		}
+	}
+}
+
+
+void DebugBreakpointsListModel::updateWatchpoints(const std::vector<BreakpointItem>& watchpoints)
+{
+	auto first = FindFirstWatchpoint(m_items);
+	int row = (int)(first - m_items.begin());
+	if (first != m_items.end())
+	{
+		beginRemoveRows(QModelIndex(), row, (int)m_items.size() - 1);
+		m_items.erase(first, m_items.end());
+		endRemoveRows();
+	}
+
+	if (!watchpoints.empty())
+	{
+		beginInsertRows(QModelIndex(), row, row + (int)watchpoints.size() - 1);
+		m_items.insert(m_items.end(), watchpoints.begin(), watchpoints.end());
+		endInsertRows();
+	}
+}
+
+
 DebugBreakpointsItemDelegate::DebugBreakpointsItemDelegate(QWidget* parent) : QStyledItemDelegate(parent)
 {
 	updateFonts();
@@ -278,6 +397,12 @@ DebugBreakpointsWidget::DebugBreakpointsWidget(ViewFrame* view, BinaryViewRef da
 	m_actionHandler.bindAction(
 		addBreakpointActionName, UIAction([&]() { add(); }));
 
+	QString addWatchpointActionName = QString::fromStdString("Add Watchpoint...");
+	UIAction::registerAction(addWatchpointActionName);
+	m_menu->addAction(addWatchpointActionName, "Options", MENU_ORDER_NORMAL);
+	m_actionHandler.bindAction(addWatchpointActionName,
+		UIAction([&]() { addWatchpoint(); }, [&]() { return m_controller->IsConnected(); }));
+
 	connect(this, &QTableView::doubleClicked, this, &DebugBreakpointsWidget::onDoubleClicked);
 
 	updateContent();
@@ -322,7 +447,7 @@ void DebugBreakpointsWidget::jump()
 	UIContext* context = UIContext::contextForWidget(this);
 	ViewFrame* frame = context->getCurrentViewFrame();
 	if (m_controller->GetData())
-		frame->navigate(m_controller->GetData(), bp.address(), true, true);
+		frame->navigate(m_controller->GetData(), m_controller->LiveToViewAddress(bp.address()), true, true);
 }
 
 
@@ -364,29 +489,68 @@ void DebugBreakpointsWidget::add()
 }
 
 
+void DebugBreakpointsWidget::addWatchpoint()
+{
+	uint64_t address = 0;
+	UIContext* ctxt = UIContext::contextForWidget(this);
+	if (ctxt && ctxt->getCurrentViewFrame())
+		address = ctxt->getCurrentViewFrame()->getCurrentOffset();
+
+	auto dialog = new AddWatchpointDialog(this, m_controller, address);
+	dialog->show();
+}
+
+
 void DebugBreakpointsWidget::remove()
 {
 	QModelIndexList sel = selectionModel()->selectedRows();
 	std::vector<ModuleNameAndOffset> breakpointsToRemove;
+	std::vector<uint64_t> watchpointsToRemove;
 
 	for (const QModelIndex& index : sel)
 	{
 		// We cannot delete the breakpoint inside this loop because deleting a breakpoint will cause this widget to
 		// remove the breakpoint from the list, which will invalidate the index of the remaining breakpoints.
 		BreakpointItem bp = m_model->getRow(index.row());
-		breakpointsToRemove.push_back(bp.location());
+		if (bp.isWatchpoint())
+			watchpointsToRemove.push_back(bp.address());
+		else
+			breakpointsToRemove.push_back(bp.location());
 	}
 
 	for (const auto& bp : breakpointsToRemove)
 		m_controller->DeleteBreakpoint(bp);
+	for (uint64_t address : watchpointsToRemove)
+		m_controller->DeleteWatchpoint(address);
 }
 
 
 void DebugBreakpointsWidget::updateContent()
 {
+	std::vector<BreakpointItem> watchpoints;
+	for (const DebugWatchpoint& watchpoint : m_controller->GetWatchpoints())
+		watchpoints.emplace_back(watchpoint);
+
+	// With thousands of breakpoints, getting the whole list on every update is the expensive part, so only the changes
+	// since the last update are retrieved, unless the core cannot provide them
+	std::vector<DebugBreakpointChange> changes;
+	uint64_t version = 0;
+	if (m_breakpointVersionValid && m_controller->GetBreakpointChanges(m_breakpointVersion, version, changes))
+	{
+		m_breakpointVersion = version;
+		m_model->applyBreakpointChanges(changes);
+		m_model->updateWatchpoints(watchpoints);
+		return;
+	}
+
+	// Get the version before the list. A change in between is then applied again on the next update, which is
+	// harmless, rather than missed.
+	m_breakpointVersion = m_controller->GetBreakpointVersion();
+	m_breakpointVersionValid = true;
 	std::vector<DebugBreakpoint> breakpoints = m_controller->GetBreakpoints();
 
 	std::vector<BreakpointItem> bps;
+	bps.reserve(breakpoints.size() + watchpoints.size());
 	for (const DebugBreakpoint& bp : breakpoints)
 	{
 		ModuleNameAndOffset info;
@@ -395,5 +559,6 @@ void DebugBreakpointsWidget::updateContent()
 		bps.emplace_back(bp.enabled, info, bp.address);
 	}
 
+	bps.insert(bps.end(), watchpoints.begin(), watchpoints.end());
 	m_model->updateRows(bps);
 }
@@ -38,12 +38,18 @@ private:
 	bool m_enabled;
 	ModuleNameAndOffset m_location;
 	uint64_t m_address;
+	// Watchpoints are listed along with the breakpoints. They only have an address.
+	bool m_isWatchpoint = false;
+	DebugWatchpoint m_watchpoint {};
 
 public:
 	BreakpointItem(bool enabled, const ModuleNameAndOffset location, uint64_t remoteAddress);
+	BreakpointItem(const DebugWatchpoint& watchpoint);
 	bool enabled() const { return m_enabled; }
 	ModuleNameAndOffset location() const { return m_location; }
 	uint64_t address() const { return m_address; }
+	bool isWatchpoint() const { return m_isWatchpoint; }
+	const DebugWatchpoint& watchpoint() const { return m_watchpoint; }
 	bool operator==(const BreakpointItem& other) const;
 	bool operator!=(const BreakpointItem& other) const;
 	bool operator<(const BreakpointItem& other) const;
@@ -88,6 +94,10 @@ public:
 	virtual QVariant data(const QModelIndex& i, int role) const override;
 	virtual QVariant headerData(int column, Qt::Orientation orientation, int role) const override;
 	void updateRows(std::vector<BreakpointItem> newRows);
+	// Applies the breakpoints added or removed since the last update, and replaces the watchpoints, without resetting
+	// the whole model
+	void applyBreakpointChanges(const std::vector<DebugBreakpointChange>& changes);
+	void updateWatchpoints(const std::vector<BreakpointItem>& watchpoints);
 };
 
 
@@ -116,6 +126,10 @@ class DebugBreakpointsWidget : public QTableView
 	DebugBreakpointsListModel* m_model;
 	DebugBreakpointsItemDelegate* m_delegate;
 
+	// The version of the breakpoint list shown in the model, so only the changes since then need to be retrieved
+	uint64_t m_breakpointVersion = 0;
+	bool m_breakpointVersionValid = false;
+
 	QPoint m_last_selected_point {};
 	QHeaderView* m_horizontal_header;
 	QHeaderView* m_vertical_header;
@@ -145,6 +159,7 @@ private slots:
 	void remove();
 	void onDoubleClicked();
 	void add();
+	void addWatchpoint();
 
 public slots:
 	void updateContent();
@@ -106,8 +106,8 @@ DebugControlsWidget::DebugControlsWidget(QWidget* parent, const std::string name
 	});
 	m_actionSettings->setToolTip(getToolTip("Debug Adapter Settings"));
 
-	if(m_controller->IsTTD())
-		addSeparator(); //TODO: IsTTD only updates when the adapter is connected. This leaves the separator in place when the adapter is disconnected.
+	if(m_controller->IsReverseExecutionSupported())
+		addSeparator(); //TODO: IsReverseExecutionSupported only updates when the adapter is connected. This leaves the separator in place when the adapter is disconnected.
 	
 	m_actionGoBack = addAction(getColoredIcon(":/debugger/resume-reverse", red), "Go Backwards", [this]() {
 		performGoReverse();
@@ -462,8 +462,8 @@ void DebugControlsWidget::updateButtons()
 		setStoppingEnabled(true);
 		setSteppingEnabled(false);
 		setReverseSteppingEnabled(false);
-		m_actionStepIntoBack->setVisible(m_controller->IsTTD());
-		m_actionStepOverBack->setVisible(m_controller->IsTTD());
+		m_actionStepIntoBack->setVisible(m_controller->IsReverseExecutionSupported());
+		m_actionStepOverBack->setVisible(m_controller->IsReverseExecutionSupported());
 		
 		m_actionPause->setEnabled(true);
 		m_actionResume->setEnabled(false);
@@ -479,14 +479,14 @@ void DebugControlsWidget::updateButtons()
 		setStartingEnabled(false);
 		setStoppingEnabled(true);
 		setSteppingEnabled(true);
-		setReverseSteppingEnabled(m_controller->IsTTD());
+		setReverseSteppingEnabled(m_controller->IsReverseExecutionSupported());
 		m_actionPause->setEnabled(false);
 		m_actionResume->setEnabled(true);
-		m_actionGoBack->setEnabled(m_controller->IsTTD());
+		m_actionGoBack->setEnabled(m_controller->IsReverseExecutionSupported());
 
 		m_actionRun->setVisible(false);
 		m_actionPause->setVisible(false);
 		m_actionResume->setVisible(true);
-		m_actionGoBack->setVisible(m_controller->IsTTD());
+		m_actionGoBack->setVisible(m_controller->IsReverseExecutionSupported());
 	}
 }
@@ -19,6 +19,8 @@ limitations under the License.
 #include <QGuiApplication>
 #include <QMimeData>
 #include <QClipboard>
+#include <QCoreApplication>
+#include <thread>
 #include "ui.h"
 #include "debuggerinfowidget.h"
 #include "lowlevelilinstruction.h"
@@ -43,7 +45,20 @@ DebugInfoSidebarWidget::DebugInfoSidebarWidget(BinaryViewRef data): SidebarWidge
 }
 
 
-std::vector<DebuggerInfoEntry> DebuggerInfoTable::getInfoForLLILCalls(LowLevelILFunctionRef llil,
+DebuggerInfoEvaluator::DebuggerInfoEvaluator(BinaryViewRef data, DebuggerControllerRef debugger,
+	std::shared_ptr<std::atomic<size_t>> currentGeneration, size_t generation):
+	m_data(data), m_debugger(debugger), m_currentGeneration(currentGeneration), m_generation(generation)
+{
+}
+
+
+bool DebuggerInfoEvaluator::cancelled() const
+{
+	return m_currentGeneration->load() != m_generation;
+}
+
+
+std::vector<DebuggerInfoEntry> DebuggerInfoEvaluator::getInfoForLLILCalls(LowLevelILFunctionRef llil,
 	const LowLevelILInstruction &instr)
 {
 	std::vector<DebuggerInfoEntry> result;
@@ -124,7 +139,7 @@ std::vector<DebuggerInfoEntry> DebuggerInfoTable::getInfoForLLILCalls(LowLevelIL
 }
 
 
-std::vector<DebuggerInfoEntry> DebuggerInfoTable::getInfoForLLILConditions(LowLevelILFunctionRef llil,
+std::vector<DebuggerInfoEntry> DebuggerInfoEvaluator::getInfoForLLILConditions(LowLevelILFunctionRef llil,
 	const LowLevelILInstruction &instr)
 {
 	std::vector<DebuggerInfoEntry> result;
@@ -157,12 +172,15 @@ std::vector<DebuggerInfoEntry> DebuggerInfoTable::getInfoForLLILConditions(LowLe
 }
 
 
-std::vector<DebuggerInfoEntry> DebuggerInfoTable::getInfoForLLIL(LowLevelILFunctionRef llil, const LowLevelILInstruction &instr)
+std::vector<DebuggerInfoEntry> DebuggerInfoEvaluator::getInfoForLLIL(LowLevelILFunctionRef llil, const LowLevelILInstruction &instr)
 {
 	std::vector<DebuggerInfoEntry> result;
 	auto func = llil->GetFunction();
 	for (const auto operand: instr.GetOperands())
 	{
+		if (cancelled())
+			return result;
+
 		switch (operand.GetType())
 		{
 		case ExprLowLevelOperand:
@@ -195,6 +213,9 @@ std::vector<DebuggerInfoEntry> DebuggerInfoTable::getInfoForLLIL(LowLevelILFunct
 		}
 	}
 
+	if (cancelled())
+		return result;
+
 	// Display the info of the function arguments if the current LLIL is a call instruction
 	auto lines = getInfoForLLILCalls(llil, instr);
 	if (!lines.empty())
@@ -209,13 +230,16 @@ std::vector<DebuggerInfoEntry> DebuggerInfoTable::getInfoForLLIL(LowLevelILFunct
 }
 
 
-std::vector<DebuggerInfoEntry> DebuggerInfoTable::getInfoForMLIL(MediumLevelILFunctionRef mlil,
+std::vector<DebuggerInfoEntry> DebuggerInfoEvaluator::getInfoForMLIL(MediumLevelILFunctionRef mlil,
 	const MediumLevelILInstruction& instr)
 {
 	std::vector<DebuggerInfoEntry> result;
 	auto func = mlil->GetFunction();
 	for (const auto operand: instr.GetOperands())
 	{
+		if (cancelled())
+			return result;
+
 		switch (operand.GetType())
 		{
 		case ExprMediumLevelOperand:
@@ -248,6 +272,9 @@ std::vector<DebuggerInfoEntry> DebuggerInfoTable::getInfoForMLIL(MediumLevelILFu
 		}
 	}
 
+	if (cancelled())
+		return result;
+
 	// Display the info of the function arguments if the current MLIL is a call instruction
 	auto lines = getInfoForMLILCalls(mlil, instr);
 	if (!lines.empty())
@@ -262,7 +289,7 @@ std::vector<DebuggerInfoEntry> DebuggerInfoTable::getInfoForMLIL(MediumLevelILFu
 }
 
 
-std::vector<DebuggerInfoEntry> DebuggerInfoTable::getInfoForMLILCalls(MediumLevelILFunctionRef mlil,
+std::vector<DebuggerInfoEntry> DebuggerInfoEvaluator::getInfoForMLILCalls(MediumLevelILFunctionRef mlil,
 	const MediumLevelILInstruction &instr)
 {
 	std::vector<DebuggerInfoEntry> result;
@@ -343,7 +370,7 @@ std::vector<DebuggerInfoEntry> DebuggerInfoTable::getInfoForMLILCalls(MediumLeve
 }
 
 
-std::vector<DebuggerInfoEntry> DebuggerInfoTable::getInfoForMLILConditions(MediumLevelILFunctionRef mlil,
+std::vector<DebuggerInfoEntry> DebuggerInfoEvaluator::getInfoForMLILConditions(MediumLevelILFunctionRef mlil,
 	const MediumLevelILInstruction &instr)
 {
 	std::vector<DebuggerInfoEntry> result;
@@ -376,13 +403,16 @@ std::vector<DebuggerInfoEntry> DebuggerInfoTable::getInfoForMLILConditions(Mediu
 }
 
 
-std::vector<DebuggerInfoEntry> DebuggerInfoTable::getInfoForHLIL(HighLevelILFunctionRef hlil,
+std::vector<DebuggerInfoEntry> DebuggerInfoEvaluator::getInfoForHLIL(HighLevelILFunctionRef hlil,
 	const HighLevelILInstruction& instr)
 {
 	std::vector<DebuggerInfoEntry> result;
 	auto func = hlil->GetFunction();
 	for (const auto operand: instr.GetOperands())
 	{
+		if (cancelled())
+			return result;
+
 		switch (operand.GetType())
 		{
 		case ExprHighLevelOperand:
@@ -421,6 +451,9 @@ std::vector<DebuggerInfoEntry> DebuggerInfoTable::getInfoForHLIL(HighLevelILFunc
 		}
 	}
 
+	if (cancelled())
+		return result;
+
 	// Display the info of the function arguments if the current HLIL is a call instruction
 	auto lines = getInfoForHLILCalls(hlil, instr);
 	if (!lines.empty())
@@ -435,7 +468,7 @@ std::vector<DebuggerInfoEntry> DebuggerInfoTable::getInfoForHLIL(HighLevelILFunc
 }
 
 
-std::vector<DebuggerInfoEntry> DebuggerInfoTable::getInfoForHLILCalls(HighLevelILFunctionRef hlil,
+std::vector<DebuggerInfoEntry> DebuggerInfoEvaluator::getInfoForHLILCalls(HighLevelILFunctionRef hlil,
 	const HighLevelILInstruction &instr)
 {
 	std::vector<DebuggerInfoEntry> result;
@@ -516,7 +549,7 @@ std::vector<DebuggerInfoEntry> DebuggerInfoTable::getInfoForHLILCalls(HighLevelI
 }
 
 
-std::vector<DebuggerInfoEntry> DebuggerInfoTable::getInfoForHLILConditions(HighLevelILFunctionRef hlil,
+std::vector<DebuggerInfoEntry> DebuggerInfoEvaluator::getInfoForHLILConditions(HighLevelILFunctionRef hlil,
 	const HighLevelILInstruction &instr)
 {
 	std::vector<DebuggerInfoEntry> result;
@@ -551,26 +584,28 @@ std::vector<DebuggerInfoEntry> DebuggerInfoTable::getInfoForHLILConditions(HighL
 }
 
 
-vector<DebuggerInfoEntry> DebuggerInfoTable::getILInfoEntries(const ViewLocation &location)
+vector<DebuggerInfoEntry> DebuggerInfoEvaluator::getILInfoEntries(const DebuggerInfoRequest& request)
 {
 	vector<DebuggerInfoEntry> result;
 	if (!m_debugger->IsConnected())
 		return result;
 
-	switch (location.getILViewType().type)
+	switch (request.ilType)
 	{
 	case NormalFunctionGraph:
 	{
-		auto func = location.getFunction();
+		auto func = request.function;
 		if (!func)
 			break;
-		auto addr = location.getOffset();
+		auto addr = request.address;
 		auto llil = func->GetLowLevelILIfAvailable();
 		if (!llil)
 			break;
 		auto llils = func->GetLowLevelILInstructionsForAddress(func->GetArchitecture(), addr);
 		for (const auto index: llils)
 		{
+			if (cancelled())
+				break;
 			auto instr = llil->GetInstruction(index);
 			auto entries = getInfoForLLIL(llil, instr);
 			result.insert(result.end(), entries.begin(), entries.end());
@@ -579,30 +614,30 @@ vector<DebuggerInfoEntry> DebuggerInfoTable::getILInfoEntries(const ViewLocation
 	}
 	case LowLevelILFunctionGraph:
 	{
-		auto func = location.getFunction();
+		auto func = request.function;
 		if (!func)
 			break;
 		auto llil = func->GetLowLevelILIfAvailable();
 		if (!llil)
 			break;
-		if (location.getInstrIndex() == BN_INVALID_EXPR)
+		if (request.instrIndex == BN_INVALID_EXPR)
 			break;
-		auto instr = llil->GetInstruction(location.getInstrIndex());
+		auto instr = llil->GetInstruction(request.instrIndex);
 		auto entries = getInfoForLLIL(llil, instr);
 		result.insert(result.end(), entries.begin(), entries.end());
 		break;
 	}
 	case MediumLevelILFunctionGraph:
 	{
-		auto func = location.getFunction();
+		auto func = request.function;
 		if (!func)
 			break;
 		auto mlil = func->GetMediumLevelILIfAvailable();
 		if (!mlil)
 			break;
-		if (location.getInstrIndex() == BN_INVALID_EXPR)
+		if (request.instrIndex == BN_INVALID_EXPR)
 			break;
-		auto instr = mlil->GetInstruction(location.getInstrIndex());
+		auto instr = mlil->GetInstruction(request.instrIndex);
 		auto entries = getInfoForMLIL(mlil, instr);
 		result.insert(result.end(), entries.begin(), entries.end());
 		break;
@@ -610,15 +645,15 @@ vector<DebuggerInfoEntry> DebuggerInfoTable::getILInfoEntries(const ViewLocation
 	case HighLevelILFunctionGraph:
 	case HighLevelLanguageRepresentationFunctionGraph:
 	{
-		auto func = location.getFunction();
+		auto func = request.function;
 		if (!func)
 			break;
 		auto hlil = func->GetHighLevelILIfAvailable();
 		if (!hlil)
 			break;
-		if (location.getInstrIndex() == BN_INVALID_EXPR)
+		if (request.instrIndex == BN_INVALID_EXPR)
 			break;
-		auto instr = hlil->GetInstruction(location.getInstrIndex());
+		auto instr = hlil->GetInstruction(request.instrIndex);
 		auto entries = getInfoForHLIL(hlil, instr);
 		result.insert(result.end(), entries.begin(), entries.end());
 		break;
@@ -818,7 +853,7 @@ QVariant DebuggerInfoEntryItemModel::data(const QModelIndex &index, int role) co
 }
 
 
-void DebuggerInfoEntryItemModel::updateRows(std::vector<DebuggerInfoEntry>& newRows)
+void DebuggerInfoEntryItemModel::updateRows(const std::vector<DebuggerInfoEntry>& newRows)
 {
 	beginResetModel();
 	m_infoEntries = newRows;
@@ -874,6 +909,42 @@ DebuggerInfoTable::DebuggerInfoTable(BinaryViewRef data): m_data(data)
 	horizontalHeader()->setStretchLastSection(true);
 
 	connect(this, &QTableView::doubleClicked, this, &DebuggerInfoTable::onDoubleClicked);
+
+	m_generation = std::make_shared<std::atomic<size_t>>(0);
+	m_updateTimer = new QTimer(this);
+	m_updateTimer->setSingleShot(true);
+	m_updateTimer->setInterval(100);
+	connect(m_updateTimer, &QTimer::timeout, this, &DebuggerInfoTable::evaluateCurrentRequest);
+
+	m_debuggerEventCallback = m_debugger->RegisterEventCallback(
+		[&](const DebuggerEvent& event) {
+			switch (event.type)
+			{
+			case TargetStoppedEventType:
+			case ActiveThreadChangedEvent:
+			case RegisterChangedEvent:
+			case ThreadStateChangedEvent:
+			case ForceMemoryCacheUpdateEvent:
+			case TargetExitedEventType:
+			case DetachedEventType:
+			{
+				QMetaObject::invokeMethod(this, [this]() { invalidateCache(); }, Qt::QueuedConnection);
+				break;
+			}
+			default:
+				break;
+			}
+		},
+		"Debugger Info");
+}
+
+
+DebuggerInfoTable::~DebuggerInfoTable()
+{
+	// Abandon the evaluation that may still be running
+	m_generation->fetch_add(1);
+	if (m_debugger)
+		m_debugger->RemoveEventCallback(m_debuggerEventCallback);
 }
 
 
@@ -882,12 +953,106 @@ void DebuggerInfoTable::updateContents(const ViewLocation &location)
 	if (!location.isValid() || !location.getFunction())
 		return;
 
-	auto info = getILInfoEntries(location);
-	m_model->updateRows(info);
+	DebuggerInfoRequest request;
+	request.function = location.getFunction();
+	request.functionStart = request.function->GetStart();
+	request.ilType = location.getILViewType().type;
+	request.address = location.getOffset();
+	request.instrIndex = location.getInstrIndex();
+	request.stopGeneration = m_stopGeneration;
+	m_currentRequest = request;
+	// Whatever is being evaluated for the previous location is of no use anymore
+	m_generation->fetch_add(1);
+
+	// Revisiting an instruction in the same stop needs no target I/O, so it is shown right away
+	if (auto it = m_cache.find(request); it != m_cache.end())
+	{
+		m_updateTimer->stop();
+		m_model->updateRows(it->second);
+		updateColumnWidths();
+		return;
+	}
+
+	// Restarting the timer means nothing is evaluated until the cursor settles
+	m_updateTimer->start();
+}
+
+
+void DebuggerInfoTable::evaluateCurrentRequest()
+{
+	if (!m_currentRequest.has_value())
+		return;
+
+	auto request = m_currentRequest.value();
+	request.stopGeneration = m_stopGeneration;
+	auto generation = m_generation->fetch_add(1) + 1;
+
+	if (!m_debugger->IsConnected())
+	{
+		m_model->updateRows({});
+		updateColumnWidths();
+		return;
+	}
+
+	if (auto it = m_cache.find(request); it != m_cache.end())
+	{
+		m_model->updateRows(it->second);
+		updateColumnWidths();
+		return;
+	}
+
+	QPointer<DebuggerInfoTable> self(this);
+	BinaryViewRef data = m_data;
+	DebuggerControllerRef debugger = m_debugger;
+	auto currentGeneration = m_generation;
+	std::thread([=]() {
+		DebuggerInfoEvaluator evaluator(data, debugger, currentGeneration, generation);
+		auto entries = evaluator.getILInfoEntries(request);
+		// A cancelled evaluation may be incomplete, so it is neither shown nor cached
+		if (currentGeneration->load() != generation)
+			return;
+
+		QMetaObject::invokeMethod(
+			QCoreApplication::instance(),
+			[=]() {
+				if (self)
+					self->evaluationFinished(request, generation, entries);
+			},
+			Qt::QueuedConnection);
+	}).detach();
+}
+
+
+void DebuggerInfoTable::evaluationFinished(const DebuggerInfoRequest& request, size_t generation,
+	const std::vector<DebuggerInfoEntry>& entries)
+{
+	if (m_generation->load() != generation)
+		return;
+
+	if (request.stopGeneration != m_stopGeneration)
+		return;
+
+	// The cache only ever holds results of the current stop, but keep it bounded for long stops anyway
+	if (m_cache.size() >= 256)
+		m_cache.clear();
+	m_cache[request] = entries;
+
+	m_model->updateRows(entries);
 	updateColumnWidths();
 }
 
 
+void DebuggerInfoTable::invalidateCache()
+{
+	m_stopGeneration++;
+	m_cache.clear();
+
+	// Re-evaluate what is currently shown against the new target state
+	if (m_currentRequest.has_value())
+		m_updateTimer->start();
+}
+
+
 void DebuggerInfoTable::updateColumnWidths()
 {
 	resizeColumnToContents(ExprColumn);
@@ -920,7 +1085,7 @@ void DebuggerInfoTable::onDoubleClicked()
 		return;
 
 	if (m_debugger->GetData())
-		frame->navigate(m_debugger->GetData(), value, true, true);
+		frame->navigate(m_debugger->GetData(), m_debugger->LiveToViewAddress(value), true, true);
 }
 
 
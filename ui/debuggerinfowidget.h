@@ -21,6 +21,13 @@ limitations under the License.
 #include <QModelIndex>
 #include <QTableView>
 #include <QStyledItemDelegate>
+#include <QPointer>
+#include <QTimer>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <optional>
+#include <tuple>
 #include "inttypes.h"
 #include "binaryninjaapi.h"
 #include "viewframe.h"
@@ -78,7 +85,7 @@ public:
 	virtual int columnCount(const QModelIndex& parent = QModelIndex()) const override;
 
 	virtual QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
-	void updateRows(std::vector<DebuggerInfoEntry>& newRows);
+	void updateRows(const std::vector<DebuggerInfoEntry>& newRows);
 	virtual QVariant headerData(int column, Qt::Orientation orientation, int role) const override;
 	DebuggerInfoEntry getRow(int row) const;
 };
@@ -103,17 +110,37 @@ public:
 };
 
 
-class DebuggerInfoTable : public QTableView
+// The IL instruction the sidebar shows the info of, together with the stop generation it is evaluated in. It only
+// holds plain values and references, so it can be handed to the background evaluator and used as a cache key.
+struct DebuggerInfoRequest
 {
-Q_OBJECT;
+	FunctionRef function;
+	uint64_t functionStart;
+	BNFunctionGraphType ilType;
+	uint64_t address;
+	size_t instrIndex;
+	size_t stopGeneration;
+
+	bool operator<(const DebuggerInfoRequest& other) const
+	{
+		return std::tie(functionStart, ilType, address, instrIndex, stopGeneration)
+			< std::tie(other.functionStart, other.ilType, other.address, other.instrIndex, other.stopGeneration);
+	}
+};
 
-	DebuggerInfoEntryItemModel* m_model;
-	DebuggerInfoEntryItemDelegate* m_itemDelegate;
 
+// Computes the entries of one request on a worker thread. It holds its own references to the view and the controller,
+// so it outlives the table if the sidebar is closed in the middle of an evaluation. The work is abandoned between
+// operands once the table has moved on to another request.
+class DebuggerInfoEvaluator
+{
 	BinaryViewRef m_data;
 	DebuggerControllerRef m_debugger;
+	std::shared_ptr<std::atomic<size_t>> m_currentGeneration;
+	size_t m_generation;
+
+	bool cancelled() const;
 
-	std::vector<DebuggerInfoEntry> getILInfoEntries(const ViewLocation& location);
 	std::vector<DebuggerInfoEntry> getInfoForLLIL(LowLevelILFunctionRef llil, const LowLevelILInstruction& instr);
 	std::vector<DebuggerInfoEntry> getInfoForLLILCalls(LowLevelILFunctionRef llil, const LowLevelILInstruction& instr);
 	std::vector<DebuggerInfoEntry> getInfoForLLILConditions(LowLevelILFunctionRef llil, const LowLevelILInstruction& instr);
@@ -126,6 +153,38 @@ Q_OBJECT;
 	std::vector<DebuggerInfoEntry> getInfoForHLILCalls(HighLevelILFunctionRef hlil, const HighLevelILInstruction& instr);
 	std::vector<DebuggerInfoEntry> getInfoForHLILConditions(HighLevelILFunctionRef hlil, const HighLevelILInstruction& instr);
 
+public:
+	DebuggerInfoEvaluator(BinaryViewRef data, DebuggerControllerRef debugger,
+		std::shared_ptr<std::atomic<size_t>> currentGeneration, size_t generation);
+
+	std::vector<DebuggerInfoEntry> getILInfoEntries(const DebuggerInfoRequest& request);
+};
+
+
+class DebuggerInfoTable : public QTableView
+{
+Q_OBJECT;
+
+	DebuggerInfoEntryItemModel* m_model;
+	DebuggerInfoEntryItemDelegate* m_itemDelegate;
+
+	BinaryViewRef m_data;
+	DebuggerControllerRef m_debugger;
+	size_t m_debuggerEventCallback;
+
+	// Cursor movements are coalesced by this timer before anything is evaluated
+	QTimer* m_updateTimer;
+	std::optional<DebuggerInfoRequest> m_currentRequest;
+	// Bumped for every new request; a background evaluation stops once it no longer matches
+	std::shared_ptr<std::atomic<size_t>> m_generation;
+	// Bumped whenever the target state changes, which invalidates every cached result
+	size_t m_stopGeneration = 0;
+	std::map<DebuggerInfoRequest, std::vector<DebuggerInfoEntry>> m_cache;
+
+	void evaluateCurrentRequest();
+	void evaluationFinished(const DebuggerInfoRequest& request, size_t generation,
+		const std::vector<DebuggerInfoEntry>& entries);
+	void invalidateCache();
 	void updateColumnWidths();
 
 private slots:
@@ -133,6 +192,7 @@ private slots:
 
 public:
 	DebuggerInfoTable(BinaryViewRef data);
+	~DebuggerInfoTable();
 	void updateFonts();
 
 	void updateContents(const ViewLocation& location);
@@ -90,10 +90,19 @@ void DebuggerWidget::uiEventHandler(const DebuggerEvent& event)
 	case RegisterChangedEvent:
 		updateContent();
 		break;
+	case ResumeEventType:
+	case StepIntoEventType:
+		m_registersWidget->cancelHints();
+		break;
 	case RelativeBreakpointAddedEvent:
 	case AbsoluteBreakpointAddedEvent:
 	case RelativeBreakpointRemovedEvent:
 	case AbsoluteBreakpointRemovedEvent:
+	case WatchpointAddedEvent:
+	case WatchpointRemovedEvent:
+	case BreakpointsChangedEvent:
+	// Watchpoints are gone along with the process
+	case TargetExitedEventType:
 		m_breakpointsWidget->updateContent();
 		break;
 	default:
@@ -424,7 +424,7 @@ void DebugModulesWidget::jumpToStart()
 		return;
 
 	if (m_controller->GetData())
-		frame->navigate(m_controller->GetData(), address, true, true);
+		frame->navigate(m_controller->GetData(), m_controller->LiveToViewAddress(address), true, true);
 }
 
 
@@ -450,7 +450,7 @@ void DebugModulesWidget::jumpToEnd()
 		return;
 
 	if (m_controller->GetData())
-		frame->navigate(m_controller->GetData(), address, true, true);
+		frame->navigate(m_controller->GetData(), m_controller->LiveToViewAddress(address), true, true);
 }
 
 
@@ -534,7 +534,7 @@ void DebugModulesWidget::onDoubleClicked()
 		return;
 
 	if (m_controller->GetData())
-		frame->navigate(m_controller->GetData(), address, true, true);
+		frame->navigate(m_controller->GetData(), m_controller->LiveToViewAddress(address), true, true);
 };
 
 
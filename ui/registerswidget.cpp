@@ -21,6 +21,8 @@ limitations under the License.
 #include <QGuiApplication>
 #include <QMimeData>
 #include <QClipboard>
+#include <QCoreApplication>
+#include <thread>
 #include "pane.h"
 #include "util.h"
 #include "clickablelabel.h"
@@ -206,18 +208,18 @@ QVariant DebugRegistersListModel::headerData(int column, Qt::Orientation orienta
 }
 
 
-std::set<std::string> DebugRegistersListModel::getUsedRegisterNames()
+std::set<std::string> DebugRegistersListModel::getUsedRegisterNames(DebuggerController* controller)
 {
 	std::set<std::string> usedRegisterNames;
-	if (!m_controller->GetData())
+	if (!controller->GetData())
 		return usedRegisterNames;
 
-	auto pc = m_controller->IP();
-	auto arch = m_controller->GetData()->GetDefaultArchitecture();
+	auto pc = controller->IP();
+	auto arch = controller->GetData()->GetDefaultArchitecture();
 	if (!arch)
 		return usedRegisterNames;
 
-	auto functions = m_controller->GetData()->GetAnalysisFunctionsContainingAddress(pc);
+	auto functions = controller->GetData()->GetAnalysisFunctionsContainingAddress(pc);
 	if (functions.empty() || (!functions[0]))
 		return usedRegisterNames;
 
@@ -236,50 +238,92 @@ std::set<std::string> DebugRegistersListModel::getUsedRegisterNames()
 }
 
 
-void DebugRegistersListModel::updateRows(std::vector<DebugRegister> newRows)
+void DebugRegistersListModel::updateRows(
+	std::vector<DebugRegister> newRows, const std::set<std::string>& usedRegisterNames)
 {
-	const auto usedRegisterNames = getUsedRegisterNames();
+	// If we get an empty list of used registers, we wish to show all regs
 	bool emptyUsedRegisters = usedRegisterNames.size() == 0;
 
-	// TODO: This might cause performance problems. We can instead only update the chained registers.
-	// However, the cost for that is we need to attach an index to each item and sort accordingly
-	beginResetModel();
-	std::map<std::string, uint64_t> oldRegValues;
-	for (const DebugRegisterItem& item : m_items)
-		oldRegValues[item.name()] = item.value();
+	bool sameRegisters = (newRows.size() == m_items.size());
+	for (size_t i = 0; sameRegisters && (i < newRows.size()); i++)
+	{
+		if (newRows[i].m_name != m_items[i].name())
+			sameRegisters = false;
+	}
 
-	m_items.clear();
-	if (newRows.size() == 0)
+	if (!sameRegisters)
 	{
+		// The register set changed (e.g., first stop, or a different architecture), so there is nothing to diff
+		// against and a reset is the cheapest option
+		std::map<std::string, uint64_t> oldRegValues;
+		for (const DebugRegisterItem& item : m_items)
+			oldRegValues[item.name()] = item.value();
+
+		beginResetModel();
+		m_items.clear();
+		for (const DebugRegister& reg : newRows)
+		{
+			auto iter = oldRegValues.find(reg.m_name);
+			DebugRegisterValueStatus status = DebugRegisterValueNormal;
+			if ((iter != oldRegValues.end()) && (iter->second != reg.m_value))
+				status = DebugRegisterValueChanged;
+
+			bool used = (emptyUsedRegisters || (usedRegisterNames.find(reg.m_name) != usedRegisterNames.end()));
+			m_items.emplace_back(reg.m_name, reg.m_value, status, reg.m_hint, used);
+		}
 		endResetModel();
 		return;
 	}
 
-	for (const DebugRegister& reg : newRows)
+	// Same registers in the same order: update in place and only notify the views about the rows that changed.
+	// Adjacent changed rows are reported as one range to keep the number of signals down.
+	int firstChangedRow = -1;
+	for (size_t i = 0; i <= newRows.size(); i++)
 	{
-		auto iter = oldRegValues.find(reg.m_name);
-		DebugRegisterValueStatus status;
-		if (iter == oldRegValues.end())
-		{
-			status = DebugRegisterValueNormal;
-		}
-		else
+		bool changed = false;
+		if (i < newRows.size())
 		{
-			if (iter->second == reg.m_value)
-			{
-				status = DebugRegisterValueNormal;
-			}
-			else
+			const DebugRegister& reg = newRows[i];
+			DebugRegisterItem& item = m_items[i];
+			bool valueChanged = (item.value() != reg.m_value);
+			DebugRegisterValueStatus status = valueChanged ? DebugRegisterValueChanged : DebugRegisterValueNormal;
+			bool used = (emptyUsedRegisters || (usedRegisterNames.find(reg.m_name) != usedRegisterNames.end()));
+			// Keep the old hint while the value is unchanged; the new one is filled in by updateHint() later
+			std::string hint = (valueChanged || !reg.m_hint.empty()) ? reg.m_hint : item.hint();
+
+			changed = valueChanged || (item.valueStatus() != status) || (item.used() != used) || (item.hint() != hint);
+			if (changed)
 			{
-				status = DebugRegisterValueChanged;
+				item.setValue(reg.m_value);
+				item.setValueStatus(status);
+				item.setUsed(used);
+				item.setHint(hint);
 			}
 		}
 
-		// If we get an empty list of used registers, we wish to show all regs
-		bool used = (emptyUsedRegisters || (usedRegisterNames.find(reg.m_name) != usedRegisterNames.end()));
-		m_items.emplace_back(reg.m_name, reg.m_value, status, reg.m_hint, used);
+		if (changed && (firstChangedRow == -1))
+		{
+			firstChangedRow = (int)i;
+		}
+		else if (!changed && (firstChangedRow != -1))
+		{
+			emit dataChanged(index(firstChangedRow, NameColumn), index((int)i - 1, HintColumn));
+			firstChangedRow = -1;
+		}
+	}
+}
+
+
+void DebugRegistersListModel::updateHint(uint64_t value, const std::string& hint)
+{
+	for (size_t i = 0; i < m_items.size(); i++)
+	{
+		if ((m_items[i].value() != value) || (m_items[i].hint() == hint))
+			continue;
+
+		m_items[i].setHint(hint);
+		emit dataChanged(index((int)i, HintColumn), index((int)i, HintColumn));
 	}
-	endResetModel();
 }
 
 
@@ -506,7 +550,7 @@ DebugRegistersWidget::DebugRegistersWidget(ViewFrame* view, BinaryViewRef data,
 
 void DebugRegistersWidget::notifyRegistersChanged(std::vector<DebugRegister> regs)
 {
-	m_model->updateRows(regs);
+	m_model->updateRows(regs, DebugRegistersListModel::getUsedRegisterNames(m_controller));
 	updateColumnWidths();
 }
 
@@ -528,8 +572,100 @@ void DebugRegistersWidget::updateContent()
 	if (!m_controller->IsConnected())
 		return;
 
-	std::vector<DebugRegister> registers = m_controller->GetRegisters();
-	notifyRegistersChanged(registers);
+	if (m_fetchInFlight)
+	{
+		m_fetchPending = true;
+		return;
+	}
+
+	fetchRegisters();
+}
+
+
+void DebugRegistersWidget::fetchRegisters()
+{
+	m_fetchInFlight = true;
+	m_fetchPending = false;
+	// Tell the hint worker of the previous fetch (if any) to stop
+	m_generation->fetch_add(1);
+
+	QPointer<DebugRegistersWidget> self(this);
+	DbgRef<DebuggerController> controller = m_controller;
+	std::thread([=]() {
+		auto registers = controller->GetRegisters(false);
+		auto usedRegisterNames = DebugRegistersListModel::getUsedRegisterNames(controller);
+		QMetaObject::invokeMethod(
+			QCoreApplication::instance(),
+			[=]() {
+				if (self)
+					self->registersFetched(registers, usedRegisterNames);
+			},
+			Qt::QueuedConnection);
+	}).detach();
+}
+
+
+void DebugRegistersWidget::registersFetched(std::vector<DebugRegister> regs, std::set<std::string> usedRegisterNames)
+{
+	m_fetchInFlight = false;
+	if (m_fetchPending)
+	{
+		// The target has changed again while we were fetching; these values are already outdated
+		updateContent();
+		return;
+	}
+
+	m_model->updateRows(regs, usedRegisterNames);
+	updateColumnWidths();
+	computeHints(m_generation->load());
+}
+
+
+void DebugRegistersWidget::computeHints(size_t generation)
+{
+	// Hints of the used registers first, since those are the ones shown by default. Each distinct value is only
+	// looked up once.
+	std::vector<uint64_t> values;
+	std::set<uint64_t> seen;
+	for (bool usedPass : {true, false})
+	{
+		for (int i = 0; i < m_model->rowCount(); i++)
+		{
+			auto item = m_model->getRow(i);
+			if ((item.used() == usedPass) && seen.insert(item.value()).second)
+				values.push_back(item.value());
+		}
+	}
+
+	QPointer<DebugRegistersWidget> self(this);
+	DbgRef<DebuggerController> controller = m_controller;
+	auto currentGeneration = m_generation;
+	std::thread([=]() {
+		for (uint64_t value : values)
+		{
+			// The generation is bumped when the target resumes, but the event that does so may still be on its way
+			// to the main thread, so the target is checked as well
+			if ((currentGeneration->load() != generation) || controller->IsRunning())
+				return;
+
+			std::string hint = controller->GetAddressInformation(value);
+			QMetaObject::invokeMethod(
+				QCoreApplication::instance(),
+				[=]() {
+					if (self && (self->m_generation->load() == generation))
+						self->m_model->updateHint(value, hint);
+				},
+				Qt::QueuedConnection);
+		}
+
+		QMetaObject::invokeMethod(
+			QCoreApplication::instance(),
+			[=]() {
+				if (self && (self->m_generation->load() == generation))
+					self->updateColumnWidths();
+			},
+			Qt::QueuedConnection);
+	}).detach();
 }
 
 
@@ -576,7 +712,7 @@ void DebugRegistersWidget::jump()
 		return;
 
 	if (m_controller->GetData())
-		frame->navigate(m_controller->GetData(), value, true, true);
+		frame->navigate(m_controller->GetData(), m_controller->LiveToViewAddress(value), true, true);
 }
 
 
@@ -713,7 +849,7 @@ void DebugRegistersWidget::jumpInNewPaneInternal(const QModelIndex &index)
 		if (newViewFrame)
 		{
 			newViewFrame->disableSync();
-			newViewFrame->navigate(m_controller->GetData(), value);
+			newViewFrame->navigate(m_controller->GetData(), m_controller->LiveToViewAddress(value));
 		}
 	}
 }
@@ -872,6 +1008,12 @@ void DebugRegistersContainer::updateFonts()
 }
 
 
+void DebugRegistersContainer::cancelHints()
+{
+	m_register->cancelHints();
+}
+
+
 // TODO: Group this with other settings key constants if more pop up.
 constexpr auto HideUnusedRegistersKey = "ui/debugger/registers/hideUnused";
 
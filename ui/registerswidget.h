@@ -22,6 +22,9 @@ limitations under the License.
 #include <QTableView>
 #include <QStyledItemDelegate>
 #include <QSortFilterProxyModel>
+#include <QPointer>
+#include <atomic>
+#include <memory>
 #include "inttypes.h"
 #include "binaryninjaapi.h"
 #include "viewframe.h"
@@ -66,6 +69,8 @@ public:
 	DebugRegisterValueStatus valueStatus() const { return m_valueStatus; }
 	void setValueStatus(DebugRegisterValueStatus newStatus) { m_valueStatus = newStatus; }
 	std::string hint() const { return m_hint; }
+	void setHint(const std::string& hint) { m_hint = hint; }
+	void setUsed(bool used) { m_used = used; }
 	bool operator==(const DebugRegisterItem& other) const;
 	bool operator!=(const DebugRegisterItem& other) const;
 	bool operator<(const DebugRegisterItem& other) const;
@@ -111,10 +116,14 @@ public:
 	DebugRegisterItem getRow(int row) const;
 	virtual QVariant data(const QModelIndex& i, int role) const override;
 	virtual QVariant headerData(int column, Qt::Orientation orientation, int role) const override;
-	void updateRows(std::vector<DebugRegister> newRows);
+	// Only emits dataChanged for the rows that actually changed, unless the set of registers itself is different
+	void updateRows(std::vector<DebugRegister> newRows, const std::set<std::string>& usedRegisterNames);
+	// Fills in the hint of every row whose value is `value`
+	void updateHint(uint64_t value, const std::string& hint);
 	bool setData(const QModelIndex& index, const QVariant& value, int role = Qt::EditRole) override;
 
-	std::set<std::string> getUsedRegisterNames();
+	// This only talks to the controller, so it is safe to call from a background thread
+	static std::set<std::string> getUsedRegisterNames(DebuggerController* controller);
 };
 
 
@@ -172,6 +181,14 @@ class DebugRegistersWidget : public QTableView, public FilterTarget
 	QTimer* m_hoverTimer;
 	QPointF m_previewPos;
 
+	// Registers and their hints are fetched on background threads, so that stepping over a slow (e.g., remote)
+	// connection does not block the UI. Only one register fetch runs at a time; an update requested meanwhile is
+	// coalesced into a single follow-up fetch. The generation is bumped on every fetch so stale hint workers can
+	// bail out early and their results are dropped.
+	bool m_fetchInFlight = false;
+	bool m_fetchPending = false;
+	std::shared_ptr<std::atomic<size_t>> m_generation = std::make_shared<std::atomic<size_t>>(0);
+
 	virtual void contextMenuEvent(QContextMenuEvent* event) override;
 
 	bool selectionNotEmpty();
@@ -188,10 +205,16 @@ class DebugRegistersWidget : public QTableView, public FilterTarget
 
 	void startHoverTimer(QMouseEvent* event);
 
+	void fetchRegisters();
+	void registersFetched(std::vector<DebugRegister> regs, std::set<std::string> usedRegisterNames);
+	void computeHints(size_t generation);
+
 public:
 	DebugRegistersWidget(ViewFrame* view, BinaryViewRef data, Menu* menu);
 	void notifyRegistersChanged(std::vector<DebugRegister> regs);
 	void updateFonts();
+	// Stops the hint worker of the last fetch, e.g., when the target resumes and its memory is no longer readable
+	void cancelHints() { m_generation->fetch_add(1); }
 
 private slots:
 	void setToZero();
@@ -226,4 +249,5 @@ public:
 	DebugRegistersContainer(ViewFrame* view, BinaryViewRef data, Menu* menu);
 	void updateContent();
 	void updateFonts();
+	void cancelHints();
 };
@@ -17,6 +17,11 @@ limitations under the License.
 #include <QPainter>
 #include <QHeaderView>
 #include <QLineEdit>
+#include <QCoreApplication>
+#include <QPointer>
+#include <algorithm>
+#include <set>
+#include <thread>
 #include "stackwidget.h"
 #include "fmt/format.h"
 
@@ -210,43 +215,371 @@ QVariant DebugStackListModel::headerData(int column, Qt::Orientation orientation
 
 void DebugStackListModel::updateRows(std::vector<DebugStackItem> newRows)
 {
-	// TODO: This might cause performance problems. We can instead only update the chagned registers.
-	// However, the cost for that is we need to attach an index to each item and sort accordingly
-	std::map<ptrdiff_t, uint64_t> oldValues;
-	for (const DebugStackItem& item : m_items)
-		oldValues[item.offset()] = item.value();
-
-	beginResetModel();
+	bool sameLayout = (newRows.size() == m_items.size());
+	for (size_t i = 0; sameLayout && (i < newRows.size()); i++)
+	{
+		if (newRows[i].offset() != m_items[i].offset())
+			sameLayout = false;
+	}
 
-	m_items.clear();
-	if (newRows.empty())
+	if (!sameLayout)
 	{
+		std::map<ptrdiff_t, uint64_t> oldValues;
+		for (const DebugStackItem& item : m_items)
+			oldValues[item.offset()] = item.value();
+
+		beginResetModel();
+		m_items.clear();
+		// The window now ends at the last of the new rows; fetchMore() continues from there
+		m_slotsBelow = (size_t)std::count_if(
+			newRows.begin(), newRows.end(), [](const DebugStackItem& row) { return row.offset() > 0; });
+		for (const DebugStackItem& row : newRows)
+		{
+			auto iter = oldValues.find(row.offset());
+			DebugStackValueStatus status = DebugStackValueNormal;
+			if ((iter != oldValues.end()) && (iter->second != row.value()))
+				status = DebugStackValueChanged;
+			m_items.emplace_back(row.offset(), row.address(), row.value(), row.hint(), status);
+		}
 		endResetModel();
 		return;
 	}
 
-	for (const DebugStackItem& row : newRows)
+	// Same window as before: update in place and only report the rows that changed, in contiguous ranges
+	int firstChangedRow = -1;
+	for (size_t i = 0; i <= newRows.size(); i++)
 	{
-		auto iter = oldValues.find(row.offset());
-		DebugStackValueStatus status;
-		if (iter == oldValues.end())
+		bool changed = false;
+		if (i < newRows.size())
 		{
-			status = DebugStackValueNormal;
+			const DebugStackItem& row = newRows[i];
+			DebugStackItem& item = m_items[i];
+			bool valueChanged = (item.value() != row.value());
+			DebugStackValueStatus status = valueChanged ? DebugStackValueChanged : DebugStackValueNormal;
+			// Keep the old hint while the value is unchanged; the hint worker refreshes it later
+			std::string hint = (valueChanged || !row.hint().empty()) ? row.hint() : item.hint();
+			changed = valueChanged || (item.address() != row.address()) || (item.valueStatus() != status)
+				|| (item.hint() != hint);
+			if (changed)
+				item = DebugStackItem(row.offset(), row.address(), row.value(), hint, status);
 		}
-		else
+
+		if (changed && (firstChangedRow == -1))
+		{
+			firstChangedRow = (int)i;
+		}
+		else if (!changed && (firstChangedRow != -1))
+		{
+			emit dataChanged(index(firstChangedRow, OffsetColumn), index((int)i - 1, HintColumn));
+			firstChangedRow = -1;
+		}
+	}
+}
+
+
+static uint64_t ReadStackValue(const uint8_t* data, size_t addressSize, BNEndianness endianness)
+{
+	uint64_t value = 0;
+	for (size_t i = 0; i < addressSize; i++)
+	{
+		size_t byteIndex = (endianness == LittleEndian) ? (addressSize - 1 - i) : i;
+		value = (value << 8) | data[byteIndex];
+	}
+	return value;
+}
+
+
+// Reads `count` consecutive stack slots, starting `firstSlot` slots away from the stack pointer, with one memory read.
+// Slots that cannot be read show up as -1, like they did with the old slot-by-slot reader.
+static std::vector<DebugStackItem> ReadStackSlots(DebuggerController* controller, uint64_t stackPointer,
+	ptrdiff_t firstSlot, size_t count, size_t addressSize, BNEndianness endianness)
+{
+	std::vector<DebugStackItem> result;
+	if (addressSize == 0 || addressSize > sizeof(uint64_t))
+		return result;
+
+	// Do not wrap around below address 0
+	ptrdiff_t lowestSlot = -(ptrdiff_t)(stackPointer / addressSize);
+	if (firstSlot < lowestSlot)
+	{
+		size_t skipped = (size_t)(lowestSlot - firstSlot);
+		if (skipped >= count)
+			return result;
+		count -= skipped;
+		firstSlot = lowestSlot;
+	}
+
+	const uint64_t start = stackPointer + firstSlot * (ptrdiff_t)addressSize;
+	DataBuffer buffer = controller->ReadMemory(start, count * addressSize);
+	const uint8_t* data = (const uint8_t*)buffer.GetData();
+	result.reserve(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		uint64_t value = -1ULL;
+		if ((i + 1) * addressSize <= buffer.GetLength())
+			value = ReadStackValue(data + i * addressSize, addressSize, endianness);
+
+		ptrdiff_t offset = (firstSlot + (ptrdiff_t)i) * (ptrdiff_t)addressSize;
+		result.emplace_back(offset, stackPointer + offset, value, "");
+	}
+
+	return result;
+}
+
+
+static std::string GetStackValueHint(const uint8_t* data, size_t length, size_t addressSize, BNEndianness endianness)
+{
+	std::string str((const char*)data, length);
+	const auto canPrint =
+		std::all_of(str.begin(), str.end(), [](unsigned char c) { return c == '\n' || std::isprint(c); });
+	if (str.size() > 3 && canPrint)
+		return fmt::format("\"{}\"", str);
+
+	if (length >= addressSize)
+		return fmt::format("{:x}", ReadStackValue(data, addressSize, endianness));
+
+	return "";
+}
+
+
+// Computes the hint (string or dereferenced pointer) for every value. Instead of reading each target separately,
+// the targets are sorted and those close to each other are fetched with a single read.
+static std::map<uint64_t, std::string> ComputeStackHints(DebuggerController* controller,
+	const std::vector<uint64_t>& values, size_t addressSize, BNEndianness endianness,
+	const std::function<bool()>& isCancelled)
+{
+	constexpr uint64_t hintReadSize = 128;
+	// Anything in the first page is a small integer rather than a pointer, and reading it would just fail
+	constexpr uint64_t minimumPointer = 0x1000;
+	// Nearby targets are merged as long as the merged read stays within this size
+	constexpr uint64_t maxMergedReadSize = 0x1000;
+
+	std::set<uint64_t> targets;
+	for (uint64_t value : values)
+	{
+		if ((value >= minimumPointer) && (value <= UINT64_MAX - hintReadSize))
+			targets.insert(value);
+	}
+
+	std::map<uint64_t, std::string> hints;
+	auto iter = targets.begin();
+	while (iter != targets.end())
+	{
+		if (isCancelled())
+			break;
+
+		const uint64_t clusterStart = *iter;
+		uint64_t clusterEnd = *iter + hintReadSize;
+		auto clusterBegin = iter;
+		size_t clusterSize = 1;
+		for (++iter; iter != targets.end(); ++iter)
+		{
+			if ((*iter > clusterEnd + hintReadSize) || (*iter + hintReadSize - clusterStart > maxMergedReadSize))
+				break;
+			clusterEnd = *iter + hintReadSize;
+			clusterSize++;
+		}
+
+		DataBuffer buffer = controller->ReadMemory(clusterStart, clusterEnd - clusterStart);
+		for (auto target = clusterBegin; target != iter; ++target)
 		{
-			if (iter->second == row.value())
+			const uint64_t offset = *target - clusterStart;
+			if (offset + addressSize <= buffer.GetLength())
 			{
-				status = DebugStackValueNormal;
+				const size_t length = (size_t)std::min<uint64_t>(hintReadSize, buffer.GetLength() - offset);
+				hints[*target] =
+					GetStackValueHint((const uint8_t*)buffer.GetData() + offset, length, addressSize, endianness);
 			}
-			else
+			else if (clusterSize > 1)
 			{
-				status = DebugStackValueChanged;
+				// The merged read can come back short when the cluster straddles an unmapped page. Fall back to
+				// reading this target by itself so it gets the same hint as it would have without merging.
+				DataBuffer single = controller->ReadMemory(*target, hintReadSize);
+				if (single.GetLength() > 0)
+				{
+					hints[*target] = GetStackValueHint(
+						(const uint8_t*)single.GetData(), single.GetLength(), addressSize, endianness);
+				}
 			}
 		}
-		m_items.emplace_back(row.offset(), row.address(), row.value(), row.hint(), status);
 	}
-	endResetModel();
+
+	return hints;
+}
+
+
+void DebugStackListModel::refresh()
+{
+	if (m_refreshInFlight)
+	{
+		m_refreshPending = true;
+		return;
+	}
+
+	m_refreshInFlight = true;
+	m_refreshPending = false;
+	m_generation->fetch_add(1);
+
+	// The target has stopped again, or the active thread changed, so the rows fetched by fetchMore() are dropped
+	m_slotsBelow = DefaultSlotsBelow;
+
+	QPointer<DebugStackListModel> self(this);
+	DbgRef<DebuggerController> controller = m_controller;
+	const size_t slotsAbove = m_slotsAbove;
+	const size_t slotsBelow = m_slotsBelow;
+	std::thread([=]() {
+		uint64_t stackPointer = controller->StackPointer();
+		size_t addressSize = 0;
+		BNEndianness endianness = LittleEndian;
+		std::vector<DebugStackItem> rows;
+		if (auto arch = controller->GetRemoteArchitecture())
+		{
+			addressSize = arch->GetAddressSize();
+			endianness = arch->GetEndianness();
+			rows = ReadStackSlots(controller, stackPointer, -(ptrdiff_t)slotsAbove, slotsAbove + slotsBelow + 1,
+				addressSize, endianness);
+		}
+
+		QMetaObject::invokeMethod(
+			QCoreApplication::instance(),
+			[=]() {
+				if (self)
+					self->refreshFinished(stackPointer, addressSize, endianness, rows);
+			},
+			Qt::QueuedConnection);
+	}).detach();
+}
+
+
+void DebugStackListModel::refreshFinished(
+	uint64_t stackPointer, size_t addressSize, BNEndianness endianness, std::vector<DebugStackItem> rows)
+{
+	m_refreshInFlight = false;
+	// A fetchMore() that was running against the previous stop is now stale
+	m_fetchingMore = false;
+	if (m_refreshPending)
+	{
+		// The target has moved on while we were reading; do not bother showing outdated values
+		refresh();
+		return;
+	}
+
+	m_stackPointer = stackPointer;
+	m_addressSize = addressSize;
+	m_endianness = endianness;
+	m_reachedStackEnd = false;
+	updateRows(rows);
+	computeHints(m_generation->load(), rows);
+}
+
+
+bool DebugStackListModel::canFetchMore(const QModelIndex& parent) const
+{
+	// Hard cap, so scrolling past the top of the stack into unrelated memory stops eventually
+	constexpr size_t maxSlotsBelow = 0x1000;
+	if (parent.isValid())
+		return false;
+
+	return !m_items.empty() && !m_refreshInFlight && !m_fetchingMore && !m_reachedStackEnd
+		&& (m_slotsBelow < maxSlotsBelow);
+}
+
+
+void DebugStackListModel::fetchMore(const QModelIndex& parent)
+{
+	static constexpr size_t fetchMoreSlots = 64;
+	if (!canFetchMore(parent))
+		return;
+
+	m_fetchingMore = true;
+	QPointer<DebugStackListModel> self(this);
+	DbgRef<DebuggerController> controller = m_controller;
+	const size_t generation = m_generation->load();
+	const uint64_t stackPointer = m_stackPointer;
+	const size_t addressSize = m_addressSize;
+	const BNEndianness endianness = m_endianness;
+	const ptrdiff_t firstSlot = (ptrdiff_t)m_slotsBelow + 1;
+	std::thread([=]() {
+		auto rows = ReadStackSlots(controller, stackPointer, firstSlot, fetchMoreSlots, addressSize, endianness);
+		QMetaObject::invokeMethod(
+			QCoreApplication::instance(),
+			[=]() {
+				if (self)
+					self->moreRowsFetched(generation, rows);
+			},
+			Qt::QueuedConnection);
+	}).detach();
+}
+
+
+void DebugStackListModel::moreRowsFetched(size_t generation, std::vector<DebugStackItem> rows)
+{
+	if (generation != m_generation->load())
+		return;
+
+	m_fetchingMore = false;
+	// Stop offering more rows once we run off the end of the mapped stack
+	if (rows.empty()
+		|| std::all_of(rows.begin(), rows.end(), [](const DebugStackItem& item) { return item.value() == -1ULL; }))
+	{
+		m_reachedStackEnd = true;
+		return;
+	}
+
+	beginInsertRows(QModelIndex(), (int)m_items.size(), (int)(m_items.size() + rows.size() - 1));
+	m_items.insert(m_items.end(), rows.begin(), rows.end());
+	m_slotsBelow += rows.size();
+	endInsertRows();
+
+	computeHints(generation, rows);
+}
+
+
+void DebugStackListModel::computeHints(size_t generation, const std::vector<DebugStackItem>& rows)
+{
+	std::vector<uint64_t> values;
+	values.reserve(rows.size());
+	for (const auto& row : rows)
+		values.push_back(row.value());
+	std::set<uint64_t> computed(values.begin(), values.end());
+
+	QPointer<DebugStackListModel> self(this);
+	DbgRef<DebuggerController> controller = m_controller;
+	auto currentGeneration = m_generation;
+	const size_t addressSize = m_addressSize;
+	const BNEndianness endianness = m_endianness;
+	std::thread([=]() {
+		auto hints = ComputeStackHints(controller, values, addressSize, endianness,
+			[&]() { return currentGeneration->load() != generation; });
+		QMetaObject::invokeMethod(
+			QCoreApplication::instance(),
+			[=]() {
+				if (self && (self->m_generation->load() == generation))
+					self->updateHints(computed, hints);
+			},
+			Qt::QueuedConnection);
+	}).detach();
+}
+
+
+void DebugStackListModel::updateHints(const std::set<uint64_t>& values, const std::map<uint64_t, std::string>& hints)
+{
+	for (size_t i = 0; i < m_items.size(); i++)
+	{
+		if (values.find(m_items[i].value()) == values.end())
+			continue;
+
+		// Values that got no hint (e.g., not a pointer) should not keep a hint left over from an earlier stop
+		std::string hint;
+		if (auto iter = hints.find(m_items[i].value()); iter != hints.end())
+			hint = iter->second;
+
+		if (m_items[i].hint() == hint)
+			continue;
+
+		m_items[i].setHint(hint);
+		emit dataChanged(index((int)i, HintColumn), index((int)i, HintColumn));
+	}
 }
 
 
@@ -403,6 +736,16 @@ DebugStackWidget::DebugStackWidget(const QString& name, ViewFrame* view, BinaryV
 	m_table->resizeColumnsToContents();
 	m_table->resizeRowsToContents();
 
+	// Rows arrive asynchronously, so resize whenever the model actually changes
+	m_resizeTimer = new QTimer(this);
+	m_resizeTimer->setSingleShot(true);
+	m_resizeTimer->setInterval(0);
+	connect(m_resizeTimer, &QTimer::timeout, m_table, &QTableView::resizeColumnsToContents);
+	auto scheduleResize = [this]() { m_resizeTimer->start(); };
+	connect(m_model, &QAbstractItemModel::modelReset, this, scheduleResize);
+	connect(m_model, &QAbstractItemModel::rowsInserted, this, scheduleResize);
+	connect(m_model, &QAbstractItemModel::dataChanged, this, scheduleResize);
+
 	QVBoxLayout* layout = new QVBoxLayout;
 	layout->setContentsMargins(0, 0, 0, 0);
 	layout->setSpacing(0);
@@ -435,81 +778,5 @@ void DebugStackWidget::updateContent()
 	if (!m_controller->GetData())
 		return;
 
-	std::vector<DebugStackItem> stackItems;
-	BinaryReader* reader = new BinaryReader(m_controller->GetData());
-	uint64_t stackPointer = m_controller->StackPointer();
-	size_t addressSize = m_controller->GetRemoteArchitecture()->GetAddressSize();
-	for (ptrdiff_t i = -8; i < 60 + 1; i++)
-	{
-		ptrdiff_t offset = i * addressSize;
-		if ((offset < 0) && (stackPointer < (uint64_t)-offset))
-			continue;
-
-		uint64_t address = stackPointer + offset;
-
-		reader->Seek(address);
-
-		uint64_t value = -1ULL;
-
-		try
-		{
-			switch (addressSize)
-			{
-			case 1:
-				value = reader->Read8();
-				break;
-			case 2:
-				value = reader->Read16();
-				break;
-			case 4:
-				value = reader->Read32();
-				break;
-			case 8:
-				value = reader->Read64();
-				break;
-			default:
-				break;
-			}
-		}
-		catch (const std::exception&)
-		{
-			/* TODO: just ignoring this is probably not a great idea... */
-		}
-
-		std::string hint {};
-		if (m_controller)
-		{
-			const DataBuffer memory = m_controller->ReadMemory(value, 128);
-			std::string reg_string;
-			if (memory.GetLength() > 0)
-				reg_string = std::string((const char*)memory.GetData(), memory.GetLength());
-			else
-				reg_string = "x";
-			const auto can_print = std::all_of(reg_string.begin(), reg_string.end(), [](unsigned char c) {
-				return c == '\n' || std::isprint(c);
-			});
-
-			if (!reg_string.empty() && reg_string.size() > 3 && can_print)
-			{
-				hint = fmt::format("\"{}\"", reg_string);
-			}
-			else
-			{
-				DataBuffer buffer = m_controller->ReadMemory(value, addressSize);
-				if (buffer.GetLength() > 0)
-				{
-					hint = fmt::format("{:x}", *reinterpret_cast<std::uintptr_t*>(buffer.GetData()));
-				}
-				else
-				{
-					hint = "";
-				}
-			}
-		}
-
-		stackItems.emplace_back(offset, address, value, hint);
-	}
-	delete reader;
-
-	notifyStackChanged(stackItems);
+	m_model->refresh();
 }
@@ -21,6 +21,10 @@ limitations under the License.
 #include <QModelIndex>
 #include <QTableView>
 #include <QStyledItemDelegate>
+#include <QTimer>
+#include <atomic>
+#include <memory>
+#include <set>
 #include "inttypes.h"
 #include "binaryninjaapi.h"
 #include "viewframe.h"
@@ -57,6 +61,7 @@ public:
 	uint64_t address() const { return m_address; }
 	uint64_t value() const { return m_value; }
 	std::string hint() const { return m_hint; }
+	void setHint(const std::string& hint) { m_hint = hint; }
 	void setValue(uint64_t value) { m_value = value; }
 	DebugStackValueStatus valueStatus() const { return m_valueStatus; }
 	void setValueStatus(DebugStackValueStatus newStatus) { m_valueStatus = newStatus; }
@@ -78,6 +83,31 @@ protected:
 	ViewFrame* m_view;
 	std::vector<DebugStackItem> m_items;
 
+	// The rows cover the stack slots [sp - m_slotsAbove, sp + m_slotsBelow], in units of the address size. The whole
+	// window is fetched with a single memory read on a background thread, and it grows downwards (fetchMore) as the
+	// user scrolls to the bottom. Every refresh starts over from the default window, so a deep scroll at one stop
+	// does not make the later ones read more. Hints are computed afterwards by another worker and filled in when ready.
+	static constexpr size_t DefaultSlotsBelow = 60;
+	uint64_t m_stackPointer = 0;
+	size_t m_addressSize = 0;
+	BNEndianness m_endianness = LittleEndian;
+	size_t m_slotsAbove = 8;
+	size_t m_slotsBelow = DefaultSlotsBelow;
+	bool m_refreshInFlight = false;
+	bool m_refreshPending = false;
+	bool m_fetchingMore = false;
+	bool m_reachedStackEnd = false;
+	// Bumped on every refresh, so workers started for an older stop can tell their results are stale
+	std::shared_ptr<std::atomic<size_t>> m_generation = std::make_shared<std::atomic<size_t>>(0);
+
+	void refreshFinished(uint64_t stackPointer, size_t addressSize, BNEndianness endianness,
+		std::vector<DebugStackItem> rows);
+	void moreRowsFetched(size_t generation, std::vector<DebugStackItem> rows);
+	void computeHints(size_t generation, const std::vector<DebugStackItem>& rows);
+	// Only the rows holding one of the values are updated, since the hints may be for some of the rows only, e.g.,
+	// the ones fetched by fetchMore()
+	void updateHints(const std::set<uint64_t>& values, const std::map<uint64_t, std::string>& hints);
+
 public:
 	enum ColumnHeaders
 	{
@@ -108,6 +138,11 @@ public:
 	virtual QVariant headerData(int column, Qt::Orientation orientation, int role) const override;
 	void updateRows(std::vector<DebugStackItem> newRows);
 	bool setData(const QModelIndex& index, const QVariant& value, int role = Qt::EditRole) override;
+
+	// Re-reads the current stack window in the background
+	void refresh();
+	virtual bool canFetchMore(const QModelIndex& parent) const override;
+	virtual void fetchMore(const QModelIndex& parent) override;
 };
 
 
@@ -137,6 +172,8 @@ class DebugStackWidget : public QWidget
 	QTableView* m_table;
 	DebugStackListModel* m_model;
 	DebugStackItemDelegate* m_delegate;
+	// Resizing the columns measures every row, so the changes of one batch of rows or hints only resize them once
+	QTimer* m_resizeTimer;
 
 	//void shouldBeVisible()
 
@@ -14,6 +14,7 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
+#include <unordered_set>
 #include "threadframes.h"
 
 FrameItem::~FrameItem()
@@ -24,10 +25,65 @@ FrameItem::~FrameItem()
 
 void FrameItem::appendChild(FrameItem* item)
 {
+	item->m_row = (int)m_childItems.size();
 	m_childItems.append(item);
 }
 
 
+void FrameItem::insertChildren(int position, const QList<FrameItem*>& children)
+{
+	for (int i = 0; i < (int)children.size(); i++)
+		m_childItems.insert(position + i, children[i]);
+	updateChildRows(position);
+}
+
+
+void FrameItem::removeChildren(int position, int count)
+{
+	for (int i = 0; i < count; i++)
+		delete m_childItems.takeAt(position);
+	updateChildRows(position);
+}
+
+
+void FrameItem::updateChildRows(int first)
+{
+	for (int i = first; i < (int)m_childItems.size(); i++)
+		m_childItems[i]->m_row = i;
+}
+
+
+void FrameItem::assignFrom(const FrameItem& other)
+{
+	m_isFrame = other.m_isFrame;
+	m_isFrozen = other.m_isFrozen;
+	m_tid = other.m_tid;
+	m_threadPc = other.m_threadPc;
+	m_frameIndex = other.m_frameIndex;
+	m_module = other.m_module;
+	m_function = other.m_function;
+	m_framePc = other.m_framePc;
+	m_sp = other.m_sp;
+	m_fp = other.m_fp;
+}
+
+
+bool FrameItem::hasSameContents(const FrameItem& other) const
+{
+	return (m_isFrame == other.m_isFrame) && (m_isFrozen == other.m_isFrozen) && (m_tid == other.m_tid)
+		&& (m_threadPc == other.m_threadPc) && (m_frameIndex == other.m_frameIndex) && (m_module == other.m_module)
+		&& (m_function == other.m_function) && (m_framePc == other.m_framePc) && (m_sp == other.m_sp)
+		&& (m_fp == other.m_fp);
+}
+
+
+void FrameItem::updateThread(const DebugThread& thread)
+{
+	m_isFrozen = thread.m_isFrozen;
+	m_threadPc = thread.m_rip;
+}
+
+
 FrameItem* FrameItem::child(int row)
 {
 	if (row < 0 || row >= m_childItems.size())
@@ -51,7 +107,7 @@ FrameItem* FrameItem::parentItem()
 int FrameItem::row() const
 {
 	if (m_parentItem)
-		return m_parentItem->m_childItems.indexOf(const_cast<FrameItem*>(this));
+		return m_row;
 
 	return 0;
 }
@@ -106,7 +162,7 @@ QVariant ThreadFrameModel::data(const QModelIndex& index, int role) const
 		if (item->isFrame())
 			return QVariant();
 
-		auto isActiveThread = m_controller->GetActiveThread().m_tid == item->tid();
+		auto isActiveThread = m_activeThreadId == item->tid();
 
 		QString text = QString::asprintf("%s0x%x @ 0x%" PRIx64, isActiveThread ? "(*) " : "", item->tid(), item->threadPc());
 		if (role == Qt::SizeHintRole)
@@ -169,34 +225,167 @@ QVariant ThreadFrameModel::data(const QModelIndex& index, int role) const
 
 void ThreadFrameModel::updateRows(DebuggerController* controller)
 {
-	beginResetModel();
+	std::vector<DebugThread> threads = controller->GetThreads();
+	const uint32_t oldActiveThreadId = m_activeThreadId;
+	m_activeThreadId = controller->GetActiveThread().m_tid;
 
-	if (rootItem)
+	std::unordered_map<uint32_t, const DebugThread*> threadsByTid;
+	for (const DebugThread& thread : threads)
+		threadsByTid[thread.m_tid] = &thread;
+
+	// Remove the threads that are gone, walking backwards so that contiguous runs go out in one removal
+	for (int row = rootItem->childCount() - 1; row >= 0;)
 	{
-		delete rootItem;
-		rootItem = new FrameItem();
+		if (threadsByTid.find(rootItem->child(row)->tid()) != threadsByTid.end())
+		{
+			row--;
+			continue;
+		}
+
+		int last = row;
+		while ((row >= 0) && (threadsByTid.find(rootItem->child(row)->tid()) == threadsByTid.end()))
+			row--;
+
+		beginRemoveRows(QModelIndex(), row + 1, last);
+		rootItem->removeChildren(row + 1, last - row);
+		endRemoveRows();
 	}
 
-	QList<FrameItem*> parents;
-	parents << rootItem;
+	// Update the threads that are still around. Their frames are only re-read if they have been loaded already.
+	std::unordered_set<uint32_t> knownThreads;
+	for (int row = 0; row < rootItem->childCount(); row++)
+	{
+		FrameItem* item = rootItem->child(row);
+		const DebugThread& thread = *threadsByTid[item->tid()];
+		knownThreads.insert(item->tid());
 
-	std::vector<DebugThread> threads = controller->GetThreads();
+		bool activeChanged = (item->tid() == oldActiveThreadId) != (item->tid() == m_activeThreadId);
+		if ((item->isFrozen() != thread.m_isFrozen) || (item->threadPc() != thread.m_rip) || activeChanged)
+		{
+			item->updateThread(thread);
+			emit dataChanged(index(row, StateColumn), index(row, ThreadColumn));
+		}
+
+		if (item->framesLoaded())
+			updateFrames(item, index(row, 0));
+	}
+
+	// Append the new threads. They start without frames; those are fetched when the thread gets expanded.
+	QList<FrameItem*> newThreads;
 	for (const DebugThread& thread : threads)
 	{
-		parents.last()->appendChild(new FrameItem(thread, parents.last()));
+		if (knownThreads.find(thread.m_tid) == knownThreads.end())
+			newThreads.append(new FrameItem(thread, rootItem));
+	}
 
-		parents << parents.last()->child(parents.last()->childCount() - 1);
+	if (!newThreads.empty())
+	{
+		int first = rootItem->childCount();
+		beginInsertRows(QModelIndex(), first, first + (int)newThreads.size() - 1);
+		rootItem->insertChildren(first, newThreads);
+		endInsertRows();
+	}
+}
 
-		std::vector<DebugFrame> frames = controller->GetFramesOfThread(thread.m_tid);
-		for (const DebugFrame& frame : frames)
-		{
-			parents.last()->appendChild(new FrameItem(thread, frame, parents.last()));
-		}
 
-		parents.pop_back();
+void ThreadFrameModel::updateFrames(FrameItem* threadItem, const QModelIndex& threadIndex)
+{
+	DebugThread thread(threadItem->tid(), threadItem->threadPc());
+	std::vector<DebugFrame> frames = m_controller->GetFramesOfThread(thread.m_tid);
+
+	// Frames are matched by position. A frame whose (index, pc) and the rest of its contents are unchanged is left
+	// alone; otherwise the existing item is updated in place.
+	int common = std::min((int)frames.size(), threadItem->childCount());
+	for (int row = 0; row < common; row++)
+	{
+		FrameItem* item = threadItem->child(row);
+		const DebugFrame& frame = frames[row];
+		if ((item->frameIndex() == frame.m_index) && (item->framePc() == frame.m_pc) && (item->sp() == frame.m_sp)
+			&& (item->fp() == frame.m_fp))
+			continue;
+
+		FrameItem updated(thread, frame, threadItem);
+		if (item->hasSameContents(updated))
+			continue;
+
+		item->assignFrom(updated);
+		emit dataChanged(index(row, 0, threadIndex), index(row, columnCount() - 1, threadIndex));
 	}
 
-	endResetModel();
+	if (threadItem->childCount() > (int)frames.size())
+	{
+		beginRemoveRows(threadIndex, (int)frames.size(), threadItem->childCount() - 1);
+		threadItem->removeChildren((int)frames.size(), threadItem->childCount() - (int)frames.size());
+		endRemoveRows();
+	}
+	else if ((int)frames.size() > threadItem->childCount())
+	{
+		QList<FrameItem*> newFrames;
+		for (size_t i = threadItem->childCount(); i < frames.size(); i++)
+			newFrames.append(new FrameItem(thread, frames[i], threadItem));
+
+		int first = threadItem->childCount();
+		beginInsertRows(threadIndex, first, first + (int)newFrames.size() - 1);
+		threadItem->insertChildren(first, newFrames);
+		endInsertRows();
+	}
+}
+
+
+bool ThreadFrameModel::hasChildren(const QModelIndex& parent) const
+{
+	if (!parent.isValid())
+		return rootItem->childCount() > 0;
+
+	if (parent.column() > 0)
+		return false;
+
+	// Threads always look expandable, even though their frames have not been fetched yet
+	FrameItem* item = static_cast<FrameItem*>(parent.internalPointer());
+	if (!item->isFrame())
+		return !item->framesLoaded() || (item->childCount() > 0);
+
+	return false;
+}
+
+
+bool ThreadFrameModel::canFetchMore(const QModelIndex& parent) const
+{
+	if (!parent.isValid())
+		return false;
+
+	FrameItem* item = static_cast<FrameItem*>(parent.internalPointer());
+	return item && !item->isFrame() && !item->framesLoaded();
+}
+
+
+void ThreadFrameModel::fetchMore(const QModelIndex& parent)
+{
+	if (!canFetchMore(parent))
+		return;
+
+	FrameItem* item = static_cast<FrameItem*>(parent.internalPointer());
+	item->setFramesLoaded(true);
+	updateFrames(item, parent);
+}
+
+
+void ThreadFrameModel::releaseFrames(const QModelIndex& parent)
+{
+	if (!parent.isValid())
+		return;
+
+	FrameItem* item = static_cast<FrameItem*>(parent.internalPointer());
+	if (!item || item->isFrame() || !item->framesLoaded())
+		return;
+
+	if (item->childCount() > 0)
+	{
+		beginRemoveRows(parent, 0, item->childCount() - 1);
+		item->removeChildren(0, item->childCount());
+		endRemoveRows();
+	}
+	item->setFramesLoaded(false);
 }
 
 
@@ -320,7 +509,9 @@ void ThreadFramesItemDelegate::paint(
 		FrameItem* threadItem = static_cast<FrameItem*>(idx.internalPointer());
 		if (threadItem)
 		{
-			auto currentTid = m_debugger->GetActiveThread().m_tid;
+			// Ask the model rather than the controller, since this runs for every repaint
+			auto model = qobject_cast<const ThreadFrameModel*>(idx.model());
+			auto currentTid = model ? model->activeThreadId() : m_debugger->GetActiveThread().m_tid;
 			if (!threadItem->isFrame() && (currentTid == threadItem->tid()))
 			{
 				QFont font = m_font;
@@ -611,6 +802,8 @@ ThreadFramesWidget::ThreadFramesWidget(QWidget* parent, ViewFrame* frame, Binary
 	// TODO: set as active thread action?
 
 	connect(this, &QTreeView::doubleClicked, this, &ThreadFramesWidget::onDoubleClicked);
+	// Collapsed threads do not need their frames refreshed on every stop; they are fetched again on expansion
+	connect(this, &QTreeView::collapsed, m_model, &ThreadFrameModel::releaseFrames);
 
 	m_debuggerEventCallback = m_debugger->RegisterEventCallback(
 		[&](const DebuggerEvent& event) {
@@ -652,7 +845,7 @@ void ThreadFramesWidget::expandCurrentThread()
 		if (!item)
 			return;
 
-		if (m_debugger->GetActiveThread().m_tid == item->tid())
+		if (m_model->activeThreadId() == item->tid())
 		{
 			expand(index);
 			return;
@@ -739,7 +932,7 @@ void ThreadFramesWidget::onDoubleClicked()
 		return;
 
 	if (m_debugger->GetData())
-		frame->navigate(m_debugger->GetData(), addrToJump, true, true);
+		frame->navigate(m_debugger->GetData(), m_debugger->LiveToViewAddress(addrToJump), true, true);
 }
 
 
@@ -69,6 +69,13 @@ public:
 	~FrameItem();
 
 	void appendChild(FrameItem* child);
+	void insertChildren(int position, const QList<FrameItem*>& children);
+	void removeChildren(int position, int count);
+	// Copies the displayed fields of `other`, but keeps this item's place in the tree, so that model indexes
+	// pointing at it stay valid
+	void assignFrom(const FrameItem& other);
+	bool hasSameContents(const FrameItem& other) const;
+	void updateThread(const DebugThread& thread);
 
 	FrameItem* child(int row);
 	int childCount() const;
@@ -85,8 +92,13 @@ public:
 	size_t frameIndex() const { return m_frameIndex; }
 	std::string module() const { return m_module; }
 	std::string function() const { return m_function; }
+	// Frames of a thread are only fetched when the thread is expanded
+	bool framesLoaded() const { return m_framesLoaded; }
+	void setFramesLoaded(bool loaded) { m_framesLoaded = loaded; }
 
 private:
+	void updateChildRows(int first);
+
 	bool m_isFrame {false};
 	bool m_isFrozen {false};
 	uint32_t m_tid {};
@@ -97,9 +109,12 @@ private:
 	uint64_t m_framePc {};
 	uint64_t m_sp {};
 	uint64_t m_fp {};
+	bool m_framesLoaded {false};
+	// Cached position in the parent, so parent() does not have to search the (possibly huge) thread list
+	int m_row {0};
 
 	QList<FrameItem*> m_childItems;
-	FrameItem* m_parentItem;
+	FrameItem* m_parentItem {nullptr};
 };
 
 Q_DECLARE_METATYPE(FrameItem);
@@ -134,11 +149,23 @@ public:
 		(void)parent;
 		return 8;
 	}
+	bool hasChildren(const QModelIndex& parent = QModelIndex()) const override;
+	bool canFetchMore(const QModelIndex& parent) const override;
+	void fetchMore(const QModelIndex& parent) override;
+
+	// Diffs the threads by tid against the current tree, and refreshes the frames of the threads whose frames have
+	// been loaded. The tree is never reset, so expansion, selection and scroll position survive a stop.
 	void updateRows(DebuggerController* controller);
+	// Drops the frames of a collapsed thread, so they are not refreshed on every stop
+	void releaseFrames(const QModelIndex& parent);
+	uint32_t activeThreadId() const { return m_activeThreadId; }
 
 private:
 	FrameItem* rootItem;
 	DebuggerControllerRef m_controller = nullptr;
+	uint32_t m_activeThreadId = 0;
+
+	void updateFrames(FrameItem* threadItem, const QModelIndex& threadIndex);
 };
 
 
@@ -24,6 +24,7 @@ limitations under the License.
 #include "QPainter"
 #include <QStatusBar>
 #include <QCoreApplication>
+#include <set>
 #include "fmt/format.h"
 #include "threadframes.h"
 #include "syncgroup.h"
@@ -86,6 +87,7 @@ static void BreakpointToggleCallback(BinaryView* view, uint64_t addr)
 
 	if (isAbsoluteAddress)
 	{
+		addr = controller->ViewToLiveAddress(addr);
 		if (controller->ContainsBreakpoint(addr))
 		{
 			controller->DeleteBreakpoint(addr);
@@ -122,7 +124,7 @@ static void JumpToIPCallback(BinaryView* view, UIContext* context)
 		return;
 
 	if (controller->GetData())
-		frame->navigate(controller->GetData(), controller->IP(), true, true);
+		frame->navigate(controller->GetData(), controller->LiveToViewAddress(controller->IP()), true, true);
 }
 
 
@@ -237,7 +239,7 @@ void GlobalDebuggerUI::SetupMenu(UIContext* context)
 		return controller->IsConnected() && (!controller->IsRunning());
 	};
 
-	auto connectedAndStoppedWithTTD = [=](const UIActionContext& ctxt) {
+	auto connectedAndStoppedWithReverse = [=](const UIActionContext& ctxt) {
 		if (!ctxt.binaryView)
 			return false;
 		if (!DebuggerController::ControllerExists(ctxt.binaryView))
@@ -246,7 +248,7 @@ void GlobalDebuggerUI::SetupMenu(UIContext* context)
 		if (!controller)
 			return false;
 
-		return controller->IsConnected() && (!controller->IsRunning()) && controller->IsTTD();
+		return controller->IsConnected() && (!controller->IsRunning()) && controller->IsReverseExecutionSupported();
 	};
 
 	auto connectedAndRunning = [=](const UIActionContext& ctxt) {
@@ -418,7 +420,7 @@ void GlobalDebuggerUI::SetupMenu(UIContext* context)
 
 				controller->GoReverse();
 			},
-			connectedAndStoppedWithTTD));
+			connectedAndStoppedWithReverse));
 
 	UIAction::registerAction("Step Into", QKeySequence(Qt::Key_F7));
 	context->globalActions()->bindAction("Step Into",
@@ -453,7 +455,7 @@ void GlobalDebuggerUI::SetupMenu(UIContext* context)
 					graphType = ctxt.context->getCurrentView()->getILViewType().type;
 				controller->StepIntoReverse(graphType);
 			},
-			connectedAndStoppedWithTTD));
+			connectedAndStoppedWithReverse));
 
 	UIAction::registerAction("Step Over", QKeySequence(Qt::Key_F8));
 	context->globalActions()->bindAction("Step Over",
@@ -488,7 +490,7 @@ void GlobalDebuggerUI::SetupMenu(UIContext* context)
 					graphType = ctxt.context->getCurrentView()->getILViewType().type;
 				controller->StepOverReverse(graphType);
 			},
-			connectedAndStoppedWithTTD));
+			connectedAndStoppedWithReverse));
 
 	UIAction::registerAction("Step Return", QKeySequence(Qt::ControlModifier | Qt::Key_F9));
 	context->globalActions()->bindAction("Step Return",
@@ -517,7 +519,7 @@ void GlobalDebuggerUI::SetupMenu(UIContext* context)
 
 				controller->StepReturnReverse();
 			},
-			connectedAndStoppedWithTTD));
+			connectedAndStoppedWithReverse));
 
 	UIAction::registerAction("Run To Here", QKeySequence(Qt::Key_F4));
 	context->globalActions()->bindAction("Run To Here",
@@ -635,6 +637,51 @@ void GlobalDebuggerUI::SetupMenu(UIContext* context)
 			requireBinaryView));
 	debuggerMenu->addAction("Toggle Breakpoint", "Breakpoint");
 
+	UIAction::registerAction("Add Function to Coverage");
+	context->globalActions()->bindAction("Add Function to Coverage",
+		UIAction(
+			[=](const UIActionContext& ctxt) {
+				if (!ctxt.binaryView || !ctxt.function)
+					return;
+				auto controller = DebuggerController::GetController(ctxt.binaryView);
+				if (!controller)
+					return;
+
+				controller->AddCoverage({ctxt.function->GetStart()});
+			},
+			[=](const UIActionContext& ctxt) { return ctxt.binaryView && ctxt.function; }));
+	debuggerMenu->addAction("Add Function to Coverage", "Coverage");
+
+	UIAction::registerAction("Add All Functions to Coverage");
+	context->globalActions()->bindAction("Add All Functions to Coverage",
+		UIAction(
+			[=](const UIActionContext& ctxt) {
+				if (!ctxt.binaryView)
+					return;
+				auto controller = DebuggerController::GetController(ctxt.binaryView);
+				if (!controller)
+					return;
+
+				controller->AddCoverage();
+			},
+			requireBinaryView));
+	debuggerMenu->addAction("Add All Functions to Coverage", "Coverage");
+
+	UIAction::registerAction("Clear Coverage");
+	context->globalActions()->bindAction("Clear Coverage",
+		UIAction(
+			[=](const UIActionContext& ctxt) {
+				if (!ctxt.binaryView)
+					return;
+				auto controller = DebuggerController::GetController(ctxt.binaryView);
+				if (!controller)
+					return;
+
+				controller->ClearCoverage();
+			},
+			requireBinaryView));
+	debuggerMenu->addAction("Clear Coverage", "Coverage");
+
 	UIAction::registerAction("Connect to Debug Server");
 	context->globalActions()->bindAction("Connect to Debug Server",
 		UIAction(
@@ -1092,8 +1139,8 @@ void DebuggerUI::openDebuggerSideBar(ViewFrame* frame)
 
 void DebuggerUI::removeOldIPHighlight()
 {
-	uint64_t lastIP = m_controller->GetLastIP();
-	uint64_t address = m_controller->IP();
+	uint64_t lastIP = m_controller->LiveToViewAddress(m_controller->GetLastIP());
+	uint64_t address = m_controller->LiveToViewAddress(m_controller->IP());
 	if (address == lastIP)
 		return;
 
@@ -1130,8 +1177,8 @@ void DebuggerUI::updateIPHighlight()
 {
 	removeOldIPHighlight();
 
-	uint64_t lastIP = m_controller->GetLastIP();
-	uint64_t address = m_controller->IP();
+	uint64_t lastIP = m_controller->LiveToViewAddress(m_controller->GetLastIP());
+	uint64_t address = m_controller->LiveToViewAddress(m_controller->IP());
 	if (address == lastIP)
 		return;
 
@@ -1163,10 +1210,98 @@ void DebuggerUI::updateIPHighlight()
 }
 
 
+// Brings the breakpoint tags and highlights in line with the breakpoint list in one pass. This is used after
+// breakpoints are added or removed in bulk, which does not send an event for every breakpoint.
+void DebuggerUI::syncBreakpointTags()
+{
+	BinaryViewRef data = m_controller->GetData();
+	if (!data)
+		return;
+
+	std::set<uint64_t> addresses;
+	uint64_t fileSegmentsStart = m_controller->GetViewFileSegmentsStart();
+	std::string inputFile = m_controller->GetInputFile();
+	for (const DebugBreakpoint& breakpoint : m_controller->GetBreakpoints())
+	{
+		ModuleNameAndOffset relative;
+		relative.module = breakpoint.module;
+		relative.offset = breakpoint.offset;
+		addresses.insert(m_controller->RelativeAddressToAbsolute(relative));
+		if (DebugModule::IsSameBaseModule(breakpoint.module, inputFile))
+			addresses.insert(fileSegmentsStart + breakpoint.offset);
+	}
+
+	TagTypeRef tagType = getBreakpointTagType(data);
+	auto id = data->BeginUndoActions();
+	std::set<uint64_t> tagged;
+	for (const TagReference& ref : data->GetAllTagReferencesOfType(tagType))
+	{
+		if ((ref.refType != TagReference::AddressTagReference) || !ref.func)
+			continue;
+
+		if (addresses.find(ref.addr) != addresses.end())
+		{
+			tagged.insert(ref.addr);
+			continue;
+		}
+
+		ref.func->SetAutoInstructionHighlight(ref.arch, ref.addr, NoHighlightColor);
+		ref.func->RemoveUserAddressTag(ref.arch, ref.addr, ref.tag);
+	}
+
+	for (uint64_t address : addresses)
+	{
+		if (tagged.find(address) != tagged.end())
+			continue;
+
+		for (FunctionRef func : data->GetAnalysisFunctionsContainingAddress(address))
+		{
+			func->SetAutoInstructionHighlight(data->GetDefaultArchitecture(), address, RedHighlightColor);
+			func->CreateUserAddressTag(data->GetDefaultArchitecture(), address, tagType, "breakpoint");
+		}
+	}
+	data->ForgetUndoActions(id);
+}
+
+
+static void SetBlockHighlight(BinaryViewRef data, uint64_t address, BNHighlightStandardColor color)
+{
+	for (FunctionRef func : data->GetAnalysisFunctionsContainingAddress(address))
+	{
+		BasicBlockRef block = func->GetBasicBlockAtAddress(func->GetArchitecture(), address);
+		if (block && (block->GetStart() == address))
+			block->SetAutoBasicBlockHighlight(color);
+	}
+}
+
+
+// Highlights the coverage blocks hit since the last update. Only the new hits are fetched, so this stays cheap when
+// the target stops often. With reset, e.g., after the coverage is cleared, the old highlights are removed first.
+void DebuggerUI::updateCoverageHighlights(bool reset)
+{
+	BinaryViewRef data = m_controller->GetData();
+	if (!data)
+		return;
+
+	if (reset)
+	{
+		for (uint64_t address : m_coverageHighlights)
+			SetBlockHighlight(data, address, NoHighlightColor);
+		m_coverageHighlights.clear();
+	}
+
+	for (uint64_t address : m_controller->GetCoverageHits(m_coverageHighlights.size()))
+	{
+		SetBlockHighlight(data, address, GreenHighlightColor);
+		m_coverageHighlights.push_back(address);
+	}
+}
+
+
 void DebuggerUI::navigateToCurrentIP()
 {
-	uint64_t address = m_controller->IP();
-	uint64_t lastIp = m_controller->GetLastIP();
+	uint64_t address = m_controller->LiveToViewAddress(m_controller->IP());
+	uint64_t lastIp = m_controller->LiveToViewAddress(m_controller->GetLastIP());
 	if (address == lastIp)
 		return;
 
@@ -1212,6 +1347,7 @@ void DebuggerUI::updateUI(const DebuggerEvent& event)
 	case TargetExitedEventType:
 	{
 		removeOldIPHighlight();
+		updateCoverageHighlights();
 		ViewFrame* frame = m_context->getCurrentViewFrame();
 		FileContext* fileContext = frame->getFileContext();
 		fileContext->refreshDataViewCache();
@@ -1238,6 +1374,7 @@ void DebuggerUI::updateUI(const DebuggerEvent& event)
 
 		navigateToCurrentIP();
 		updateIPHighlight();
+		updateCoverageHighlights();
 		checkFocusDebuggerConsole();
 		break;
 	}
@@ -1267,6 +1404,8 @@ void DebuggerUI::updateUI(const DebuggerEvent& event)
 			}
 
 			m_controller->ReAddDebuggerMemoryRegion();
+			// The blocks moved along with the view
+			updateCoverageHighlights(true);
 
 			ViewFrame* frame = m_context->getCurrentViewFrame();
 			FileContext* fileContext = frame->getFileContext();
@@ -1421,6 +1560,12 @@ void DebuggerUI::updateUI(const DebuggerEvent& event)
 		}
 		break;
 	}
+	case BreakpointsChangedEvent:
+		syncBreakpointTags();
+		break;
+	case CoverageChangedEvent:
+		updateCoverageHighlights(true);
+		break;
 	case RegisterChangedEvent:
 	{
 		navigateToCurrentIP();
@@ -72,6 +72,9 @@ private:
 
 	size_t m_eventCallback;
 
+	// Start addresses of the highlighted coverage blocks, in the order of the hits reported by the controller
+	std::vector<uint64_t> m_coverageHighlights;
+
 public:
 	DebuggerUI(UIContext* context, DebuggerControllerRef controller);
 	~DebuggerUI();
@@ -87,6 +90,8 @@ public:
 	void openDebuggerSideBar(ViewFrame* frame = nullptr);
 	void removeOldIPHighlight();
 	void updateIPHighlight();
+	void syncBreakpointTags();
+	void updateCoverageHighlights(bool reset = false);
 	void navigateToCurrentIP();
 	void checkFocusDebuggerConsole();
 
@@ -0,0 +1,106 @@
+/*
+Copyright 2020-2024 Vector 35 Inc.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <QMessageBox>
+#include "watchpointdialog.h"
+#include "fmt/format.h"
+
+using namespace BinaryNinjaDebuggerAPI;
+using namespace BinaryNinja;
+using namespace std;
+
+AddWatchpointDialog::AddWatchpointDialog(QWidget* parent, DebuggerControllerRef controller, uint64_t address) :
+	QDialog(parent), m_controller(controller), m_defaultAddress(address)
+{
+	setWindowTitle("Add Watchpoint");
+	setMinimumSize(UIContext::getScaledWindowSize(400, 160));
+	setAttribute(Qt::WA_DeleteOnClose);
+
+	setModal(true);
+	QVBoxLayout* layout = new QVBoxLayout;
+	layout->setSpacing(0);
+
+	m_addressEntry = new QLineEdit(this);
+	m_addressEntry->setText(QString::fromStdString(fmt::format("0x{:x}", address)));
+
+	m_sizeEntry = new QComboBox(this);
+	for (const char* size : {"1", "2", "4", "8"})
+		m_sizeEntry->addItem(size);
+	size_t addressSize = 8;
+	if (m_controller->GetData() && m_controller->GetData()->GetDefaultArchitecture())
+		addressSize = m_controller->GetData()->GetDefaultArchitecture()->GetAddressSize();
+	m_sizeEntry->setCurrentText(QString::number(addressSize));
+
+	m_typeEntry = new QComboBox(this);
+	m_typeEntry->addItem("Write", WriteWatchpoint);
+	m_typeEntry->addItem("Read", ReadWatchpoint);
+	m_typeEntry->addItem("Read/Write", ReadWriteWatchpoint);
+
+	m_recordEntry = new QCheckBox(this);
+	m_recordEntry->setToolTip("Record every hit along with the old and new value, and resume the target instead of "
+							  "stopping. Retrieve the hits with dbg.drain_watchpoint_hits().");
+
+	QFormLayout* formLayout = new QFormLayout;
+	formLayout->addRow("Address", m_addressEntry);
+	formLayout->addRow("Size", m_sizeEntry);
+	formLayout->addRow("Type", m_typeEntry);
+	formLayout->addRow("Record without stopping", m_recordEntry);
+
+	QHBoxLayout* buttonLayout = new QHBoxLayout;
+	buttonLayout->setContentsMargins(0, 0, 0, 0);
+
+	QPushButton* cancelButton = new QPushButton("Cancel");
+	connect(cancelButton, &QPushButton::clicked, [&]() { reject(); });
+	QPushButton* acceptButton = new QPushButton("Accept");
+	connect(acceptButton, &QPushButton::clicked, [&]() { apply(); });
+	acceptButton->setDefault(true);
+
+	buttonLayout->addStretch(1);
+	buttonLayout->addWidget(cancelButton);
+	buttonLayout->addWidget(acceptButton);
+
+	layout->addSpacing(10);
+	layout->addLayout(formLayout);
+	layout->addStretch(1);
+	layout->addSpacing(10);
+	layout->addLayout(buttonLayout);
+	setLayout(layout);
+}
+
+
+void AddWatchpointDialog::apply()
+{
+	uint64_t address = 0;
+	std::string errorString;
+	if (!BinaryView::ParseExpression(m_controller->GetData(), m_addressEntry->text().toStdString(), address,
+			m_defaultAddress, errorString))
+	{
+		QMessageBox::warning(this, "Invalid Address", QString::fromStdString(errorString));
+		return;
+	}
+
+	size_t size = m_sizeEntry->currentText().toULongLong();
+	auto type = (DebugWatchpointType)m_typeEntry->currentData().toInt();
+	if (!m_controller->AddWatchpoint(address, size, type, m_recordEntry->isChecked()))
+	{
+		QMessageBox::warning(this, "Failed to Add Watchpoint",
+			"The watchpoint could not be added. The target may have run out of hardware watchpoints, or the address "
+			"may not be aligned to the size.");
+		return;
+	}
+
+	accept();
+}